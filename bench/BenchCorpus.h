@@ -0,0 +1,45 @@
+#pragma once
+#include "CorpusGenerator.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Synthetic German patent-style text for the benchmarks
+ *
+ * Thin wrapper around CorpusGenerator: a fixed vocabulary with two ordinal
+ * pairs, where errorPercent of the mentions carry a planted error split
+ * evenly between missing numbers, conflicting numbers and wrong articles,
+ * so the error detectors have work proportional to it.
+ */
+namespace BenchCorpus {
+    inline CorpusGenerator::Options options(size_t targetChars, int errorPercent) {
+        CorpusGenerator::Options options;
+        options.targetChars = targetChars;
+        options.vocabularySize = 30;
+        options.ordinalPairs = 2;
+        options.multiWordPairs = 0;  // Adjective pairs need a manual toggle, ordinals are auto-detected
+        options.missingNumberPercent = (errorPercent + 2) / 3;
+        options.conflictPercent = (errorPercent + 1) / 3;
+        options.wrongArticlePercent = errorPercent / 3;
+        return options;
+    }
+
+    inline std::wstring generate(size_t targetChars, int errorPercent) {
+        return CorpusGenerator::generate(options(targetChars, errorPercent)).text;
+    }
+
+    /**
+     * @brief Cached corpus so large documents are generated once per process
+     */
+    inline const std::wstring& get(size_t targetChars, int errorPercent) {
+        static std::map<std::pair<size_t, int>, std::wstring> cache;
+        auto key = std::make_pair(targetChars, errorPercent);
+        auto it = cache.find(key);
+        if (it == cache.end()) {
+            it = cache.emplace(key, generate(targetChars, errorPercent)).first;
+        }
+        return it->second;
+    }
+}
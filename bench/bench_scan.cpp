@@ -0,0 +1,242 @@
+#include <benchmark/benchmark.h>
+#include "BenchCorpus.h"
+#include "AnalysisContext.h"
+#include "ErrorDetectorHelper.h"
+#include "GermanTextAnalyzer.h"
+#include "OrdinalDetector.h"
+#include "RE2RegexHelper.h"
+#include "RegexPatterns.h"
+#include "TextScanner.h"
+#include <re2/re2.h>
+
+namespace {
+
+// Document sizes (characters) and error densities (percent of mentions)
+const std::vector<int64_t> SIZES = {10 << 10, 100 << 10, 1 << 20, 10 << 20, 50 << 20};
+const std::vector<int64_t> DENSITIES = {0, 5, 20};
+
+constexpr int DEFAULT_DENSITY = 5;
+
+// range(0) = size; benchmarks over error density pass it as range(1)
+const std::wstring& corpusFor(const benchmark::State& state) {
+    return BenchCorpus::get(static_cast<size_t>(state.range(0)), DEFAULT_DENSITY);
+}
+
+const std::wstring& corpusWithDensity(const benchmark::State& state) {
+    return BenchCorpus::get(static_cast<size_t>(state.range(0)), static_cast<int>(state.range(1)));
+}
+
+void setThroughput(benchmark::State& state, const std::wstring& text) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(text.size()));
+}
+
+// Same preparation as ScanPipeline::run
+void prepareContext(const std::wstring& text, GermanTextAnalyzer& analyzer,
+                    const re2::RE2& singleWordRegex, const re2::RE2& twoWordRegex,
+                    AnalysisContext& ctx) {
+    ctx.clearResults();
+    ctx.multiWordBaseStems =
+        OrdinalDetector::detectOrdinalPatterns(text, twoWordRegex, true, analyzer);
+    TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+}
+
+// Words of the document, for the stemming benchmarks
+std::vector<std::wstring> wordsOf(const std::wstring& text) {
+    re2::RE2 wordRegex(RegexPatterns::WORD_PATTERN);
+    std::vector<std::wstring> words;
+    RE2RegexHelper::MatchIterator iter(text, wordRegex);
+    while (iter.hasNext()) {
+        words.emplace_back(iter.next()[0]);
+    }
+    return words;
+}
+
+} // namespace
+
+// RE2RegexHelper
+
+static void BM_MatchIteratorConstruction(benchmark::State& state) {
+    const std::wstring& text = corpusFor(state);
+    re2::RE2 pattern(RegexPatterns::SINGLE_WORD_PATTERN);
+    for (auto _ : state) {
+        RE2RegexHelper::MatchIterator iter(text, pattern);
+        benchmark::DoNotOptimize(iter.hasNext());
+    }
+    setThroughput(state, text);
+}
+BENCHMARK(BM_MatchIteratorConstruction)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+static void runPattern(benchmark::State& state, const char* patternText) {
+    const std::wstring& text = corpusFor(state);
+    re2::RE2 pattern(patternText);
+    size_t matches = 0;
+    for (auto _ : state) {
+        RE2RegexHelper::MatchIterator iter(text, pattern);
+        matches = 0;
+        while (iter.hasNext()) {
+            benchmark::DoNotOptimize(iter.next());
+            ++matches;
+        }
+    }
+    state.counters["matches"] = static_cast<double>(matches);
+    setThroughput(state, text);
+}
+
+static void BM_Pattern_SingleWord(benchmark::State& state) {
+    runPattern(state, RegexPatterns::SINGLE_WORD_PATTERN);
+}
+BENCHMARK(BM_Pattern_SingleWord)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+static void BM_Pattern_TwoWord(benchmark::State& state) {
+    runPattern(state, RegexPatterns::TWO_WORD_PATTERN);
+}
+BENCHMARK(BM_Pattern_TwoWord)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+static void BM_Pattern_Word(benchmark::State& state) {
+    runPattern(state, RegexPatterns::WORD_PATTERN);
+}
+BENCHMARK(BM_Pattern_Word)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+// Stemming
+
+static void BM_StemWord_Cold(benchmark::State& state) {
+    const std::vector<std::wstring> words = wordsOf(corpusFor(state));
+    GermanTextAnalyzer analyzer;
+    for (auto _ : state) {
+        analyzer.clearCache();
+        for (const auto& original : words) {
+            std::wstring word = original;
+            analyzer.stemWord(word);
+            benchmark::DoNotOptimize(word.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * words.size()));
+}
+BENCHMARK(BM_StemWord_Cold)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+static void BM_StemWord_Warm(benchmark::State& state) {
+    const std::vector<std::wstring> words = wordsOf(corpusFor(state));
+    GermanTextAnalyzer analyzer;
+    for (const auto& original : words) {
+        std::wstring word = original;
+        analyzer.stemWord(word);
+    }
+    for (auto _ : state) {
+        for (const auto& original : words) {
+            std::wstring word = original;
+            analyzer.stemWord(word);
+            benchmark::DoNotOptimize(word.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * words.size()));
+}
+BENCHMARK(BM_StemWord_Warm)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+// Scan phases
+
+static void BM_OrdinalDetector(benchmark::State& state) {
+    const std::wstring& text = corpusFor(state);
+    re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+    GermanTextAnalyzer analyzer;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            OrdinalDetector::detectOrdinalPatterns(text, twoWordRegex, true, analyzer));
+    }
+    setThroughput(state, text);
+}
+BENCHMARK(BM_OrdinalDetector)->ArgsProduct({SIZES})->Unit(benchmark::kMillisecond);
+
+static void BM_ScanText(benchmark::State& state) {
+    const std::wstring& text = corpusWithDensity(state);
+    re2::RE2 singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN);
+    re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+    GermanTextAnalyzer analyzer;
+    AnalysisContext ctx;
+    for (auto _ : state) {
+        ctx.clearResults();
+        TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+        benchmark::DoNotOptimize(ctx.db.occurrences.size());
+    }
+    state.counters["occurrences"] = static_cast<double>(ctx.db.occurrences.size());
+    state.counters["arena_peak_bytes"] = static_cast<double>(ctx.arena.peakBytes());
+    setThroughput(state, text);
+}
+BENCHMARK(BM_ScanText)->ArgsProduct({SIZES, DENSITIES})->Unit(benchmark::kMillisecond);
+
+// Error detection (each iteration rescans untimed, since detection output lives in the scan arena)
+
+static void BM_FindUnnumberedWords(benchmark::State& state) {
+    const std::wstring& text = corpusWithDensity(state);
+    re2::RE2 singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN);
+    re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+    re2::RE2 wordRegex(RegexPatterns::WORD_PATTERN);
+    GermanTextAnalyzer analyzer;
+    AnalysisContext ctx;
+    wxTextAttr style;
+    size_t errors = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        prepareContext(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+        ErrorPositions noNumber(ctx.arena.resource());
+        state.ResumeTiming();
+
+        ErrorDetectorHelper::findUnnumberedWords(text, analyzer, wordRegex, ctx, nullptr, style,
+                                                 noNumber);
+        errors = noNumber.size();
+    }
+    state.counters["errors"] = static_cast<double>(errors);
+    setThroughput(state, text);
+}
+BENCHMARK(BM_FindUnnumberedWords)->ArgsProduct({SIZES, DENSITIES})->Unit(benchmark::kMillisecond);
+
+static void BM_CheckArticleUsage(benchmark::State& state) {
+    const std::wstring& text = corpusWithDensity(state);
+    re2::RE2 singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN);
+    re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+    GermanTextAnalyzer analyzer;
+    AnalysisContext ctx;
+    wxTextAttr style;
+    size_t errors = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        prepareContext(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+        ErrorPositions wrongArticle(ctx.arena.resource());
+        state.ResumeTiming();
+
+        ErrorDetectorHelper::checkArticleUsage(text, analyzer, ctx, nullptr, style,
+                                               wrongArticle);
+        errors = wrongArticle.size();
+    }
+    state.counters["errors"] = static_cast<double>(errors);
+    setThroughput(state, text);
+}
+BENCHMARK(BM_CheckArticleUsage)->ArgsProduct({SIZES, DENSITIES})->Unit(benchmark::kMillisecond);
+
+// Conflict graph plus the wrong term/BZ list, as after every scan in ScanPipeline::run
+static void BM_ConflictDetection(benchmark::State& state) {
+    const std::wstring& text = corpusWithDensity(state);
+    re2::RE2 singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN);
+    re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+    GermanTextAnalyzer analyzer;
+    AnalysisContext ctx;
+    wxTextAttr style;
+    size_t errors = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        prepareContext(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+        ErrorPositions wrongTermBz(ctx.arena.resource());
+        state.ResumeTiming();
+
+        ctx.buildConflicts();
+        ErrorDetectorHelper::highlightConflicts(ctx, nullptr, style, wrongTermBz);
+        errors = wrongTermBz.size();
+    }
+    state.counters["errors"] = static_cast<double>(errors);
+    state.counters["conflicts"] = static_cast<double>(ctx.conflicts.size());
+    setThroughput(state, text);
+}
+BENCHMARK(BM_ConflictDetection)->ArgsProduct({SIZES, DENSITIES})->Unit(benchmark::kMillisecond);
+
+// JSON results: --benchmark_out=<file> (JSON is the default out format)
+BENCHMARK_MAIN();
@@ -0,0 +1,244 @@
+// Performance regression gate (bz_perf_gate, ctest label perf_tests)
+//
+// Runs a fixed set of scan workloads on BenchCorpus documents, normalizes
+// each against the frozen ReferenceScanner on a 256 KB document and compares
+// with the baseline (see PerfGate.h).
+//
+// Usage: bz_perf_gate [options] <baseline.json>
+//   --repetitions N       Timed runs per workload, the median counts (default 5)
+//   --filter TEXT         Only workloads whose name contains TEXT
+//   --update              Rewrite the baseline with this machine's results
+//
+// The committed bench/perf_baseline.json was recorded on a developer machine;
+// CI records its own with the pull request's base and gates against that.
+//
+// Exit status 1 if any workload lost more throughput than its tolerance.
+
+#include "BenchCorpus.h"
+#include "AnalysisContext.h"
+#include "ErrorDetectorHelper.h"
+#include "GermanTextAnalyzer.h"
+#include "OrdinalDetector.h"
+#include "PerfGate.h"
+#include "RE2RegexHelper.h"
+#include "ReferenceScanner.h"
+#include "RegexPatterns.h"
+#include "ScanPipeline.h"
+#include "TextScanner.h"
+#include <re2/re2.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr size_t MB = 1 << 20;
+constexpr int DENSITY = 5;
+
+void printUsage() {
+    std::cerr << "Usage: bz_perf_gate [--repetitions N] [--filter TEXT] [--update] <baseline.json>\n";
+}
+
+// Regexes, analyzer and context shared by the workloads, as in a GUI session
+struct Scanner {
+    re2::RE2 singleWordRegex{RegexPatterns::SINGLE_WORD_PATTERN};
+    re2::RE2 twoWordRegex{RegexPatterns::TWO_WORD_PATTERN};
+    re2::RE2 wordRegex{RegexPatterns::WORD_PATTERN};
+    GermanTextAnalyzer analyzer;
+    AnalysisContext ctx;
+    wxTextAttr style;
+
+    // Same preparation as ScanPipeline::run
+    void prepare(const std::wstring& text) {
+        ctx.clearResults();
+        ctx.multiWordBaseStems = OrdinalDetector::detectOrdinalPatterns(text, twoWordRegex, true, analyzer);
+        TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+    }
+};
+
+// Same kind of work as the gated workloads (RE2, stemming, lookups), but frozen
+PerfGate::Workload referenceWorkload() {
+    auto scanner = std::make_shared<ReferenceScanner>(true);
+    return {"ReferenceScanner::run/256KB", 0, {}, [scanner] { scanner->run(BenchCorpus::get(256 * 1024, DENSITY)); }};
+}
+
+std::vector<PerfGate::Workload> workloads() {
+    auto scanner = std::make_shared<Scanner>();
+    std::vector<PerfGate::Workload> result;
+
+    result.push_back({"RE2RegexHelper::MatchIterator/single-word/5MB", 0.15, {}, [scanner] {
+        const std::wstring& text = BenchCorpus::get(5 * MB, DENSITY);
+        RE2RegexHelper::MatchIterator iter(text, scanner->singleWordRegex);
+        while (iter.hasNext()) {
+            iter.next();
+        }
+    }});
+
+    result.push_back({"OrdinalDetector::detectOrdinalPatterns/5MB", 0.15, {}, [scanner] {
+        const std::wstring& text = BenchCorpus::get(5 * MB, DENSITY);
+        OrdinalDetector::detectOrdinalPatterns(text, scanner->twoWordRegex, true, scanner->analyzer);
+    }});
+
+    result.push_back({"TextScanner::scanText/5MB", 0.15,
+                      [scanner] {
+                          const std::wstring& text = BenchCorpus::get(5 * MB, DENSITY);
+                          scanner->ctx.clearResults();
+                          scanner->ctx.multiWordBaseStems = OrdinalDetector::detectOrdinalPatterns(
+                              text, scanner->twoWordRegex, true, scanner->analyzer);
+                      },
+                      [scanner] {
+                          TextScanner::scanText(BenchCorpus::get(5 * MB, DENSITY), scanner->analyzer,
+                                                scanner->singleWordRegex, scanner->twoWordRegex, scanner->ctx);
+                      }});
+
+    result.push_back({"ErrorDetectorHelper::findUnnumberedWords/1MB", 0.15,
+                      [scanner] { scanner->prepare(BenchCorpus::get(1 * MB, DENSITY)); },
+                      [scanner] {
+                          ErrorPositions noNumber(scanner->ctx.arena.resource());
+                          ErrorDetectorHelper::findUnnumberedWords(BenchCorpus::get(1 * MB, DENSITY),
+                                                                   scanner->analyzer, scanner->wordRegex,
+                                                                   scanner->ctx, nullptr, scanner->style,
+                                                                   noNumber);
+                      }});
+
+    // Runs over the occurrences only; repeated to get well above timer noise
+    result.push_back({"ErrorDetectorHelper::checkArticleUsage/5MBx10", 0.15,
+                      [scanner] { scanner->prepare(BenchCorpus::get(5 * MB, DENSITY)); },
+                      [scanner] {
+                          for (int i = 0; i < 10; ++i) {
+                              ErrorPositions wrongArticle(scanner->ctx.arena.resource());
+                              ErrorDetectorHelper::checkArticleUsage(BenchCorpus::get(5 * MB, DENSITY),
+                                                                     scanner->analyzer, scanner->ctx, nullptr,
+                                                                     scanner->style, wrongArticle);
+                          }
+                      }});
+
+    // Cold stem cache: every distinct word goes through Oleander once
+    result.push_back({"ScanPipeline::run/cold-cache/1MB", 0.20, {}, [] {
+        ScanPipeline pipeline(true);
+        pipeline.run(BenchCorpus::get(1 * MB, DENSITY));
+    }});
+
+    // Rescan with a warm cache, as after an edit in the GUI
+    auto pipeline = std::make_shared<ScanPipeline>(true);
+    result.push_back({"ScanPipeline::run/1MB", 0.15,
+                      [pipeline] { pipeline->run(BenchCorpus::get(1 * MB, DENSITY)); },
+                      [pipeline] { pipeline->run(BenchCorpus::get(1 * MB, DENSITY)); }});
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int repetitions = 5;
+    std::string filter;
+    bool update = false;
+    std::string baselinePath;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--repetitions") {
+                repetitions = std::stoi(next());
+            } else if (arg == "--filter") {
+                filter = next();
+            } else if (arg == "--update") {
+                update = true;
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("unknown option " + arg);
+            } else if (baselinePath.empty()) {
+                baselinePath = arg;
+            } else {
+                throw std::invalid_argument("more than one baseline file");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_perf_gate: " << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+    if (baselinePath.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    PerfGate::Baseline baseline;
+    {
+        std::ifstream in(baselinePath, std::ios::binary);
+        try {
+            if (in) {
+                baseline = PerfGate::loadBaseline(in);
+            } else if (!update) {
+                std::cerr << "bz_perf_gate: cannot read " << baselinePath << " (create it with --update)\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "bz_perf_gate: " << baselinePath << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    const PerfGate::Workload reference = referenceWorkload();
+    std::vector<PerfGate::Workload> selected;
+    for (PerfGate::Workload& workload : workloads()) {
+        if (filter.empty() || workload.name.find(filter) != std::string::npos) {
+            selected.push_back(std::move(workload));
+        }
+    }
+    const std::vector<PerfGate::Measurement> measurements = PerfGate::measure(selected, reference, repetitions);
+    bool regressed = false;
+
+    std::printf("Normalized by %s (median %.1f ms)\n", reference.name.c_str(),
+                measurements.empty() ? 0.0 : measurements.front().referenceSeconds * 1000.0);
+    std::printf("%-50s %10s %10s %10s %9s\n", "Workload", "ms", "normalized", "baseline", "change");
+    for (const PerfGate::Measurement& measurement : measurements) {
+        std::optional<PerfGate::BaselineEntry> entry;
+        if (auto it = baseline.find(measurement.name); it != baseline.end()) {
+            entry = it->second;
+        }
+        const PerfGate::Verdict verdict = PerfGate::judge(measurement, entry);
+        regressed = regressed || verdict.regressed;
+
+        if (verdict.baseline) {
+            std::printf("%-50s %10.1f %10.3f %10.3f %+8.1f%%%s\n", measurement.name.c_str(),
+                        measurement.seconds * 1000.0, verdict.normalized, verdict.baseline->normalized,
+                        (verdict.throughputRatio - 1.0) * 100.0,
+                        verdict.regressed ? "  REGRESSED" : "");
+        } else {
+            std::printf("%-50s %10.1f %10.3f %10s %9s\n", measurement.name.c_str(),
+                        measurement.seconds * 1000.0, verdict.normalized, "-", "new");
+        }
+    }
+
+    if (update) {
+        std::ofstream out(baselinePath, std::ios::binary);
+        PerfGate::saveBaseline(out, PerfGate::updated(baseline, selected, measurements));
+        if (!out) {
+            std::cerr << "bz_perf_gate: cannot write " << baselinePath << "\n";
+            return 1;
+        }
+        std::cout << "Updated " << measurements.size() << " workloads in " << baselinePath << "\n";
+        return 0;
+    }
+    if (regressed) {
+        std::cout << "Throughput regression beyond tolerance. If the change is deliberate, rerun "
+                     "with --update (or build the perf_baseline_update target) and commit the baseline.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,15 +1,23 @@
 #pragma once
 
+#include "ClearedAnchors.h"
+#include "ConflictGraph.h"
 #include "ReferenceDatabase.h"
+#include "ScanArena.h"
 #include <unordered_set>
-#include <set>
 #include <string>
 
 /**
  * @brief Global context for text analysis and scanning
  */
 struct AnalysisContext {
-    ReferenceDatabase db;
+    // Backing memory for all per-scan results; declared before db so it outlives it
+    ScanArena arena;
+
+    ReferenceDatabase db{arena.resource()};
+
+    // Conflicting assignments of db, rebuilt after each scan (buildConflicts)
+    ConflictGraph conflicts{arena.resource()};
 
     // Set of base word STEMS that should trigger multi-word matching
     std::unordered_set<std::wstring> multiWordBaseStems;
@@ -26,10 +34,41 @@ struct AnalysisContext {
     // Set of BZ numbers whose errors have been cleared/ignored by user
     std::unordered_set<std::wstring> clearedErrors;
 
-    // Track cleared text positions (for right-click clear on highlighted text)
-    std::set<std::pair<size_t, size_t>> clearedTextPositions;
+    // Errors cleared in the text (right-click on a highlight); resolved against each scanned text
+    ClearedAnchors clearedTextAnchors;
+
+    // Words never treated as terms on top of the analyzer's built-in ones; ScanPipeline::run applies them
+    std::unordered_set<std::wstring> ignoredWords;
+
+    /**
+     * @brief Report the database, the user/auto term sets and unused arena space
+     *
+     * The arena entry is the reserved block minus what the scan requested, so
+     * it does not double-count the database containers that live in it.
+     */
+    void reportMemory(MemoryReport& report) const {
+        db.reportMemory(report);
+        report.add("ConflictGraph", conflicts.memoryBytes());
+        report.add("Multi-word and user term sets",
+                   MemoryUsage::heapBytes(multiWordBaseStems) +
+                       MemoryUsage::heapBytes(autoDetectedMultiWordStems) +
+                       MemoryUsage::heapBytes(manualMultiWordToggles) +
+                       MemoryUsage::heapBytes(manuallyDisabledMultiWord) +
+                       MemoryUsage::heapBytes(clearedErrors) + clearedTextAnchors.memoryBytes() +
+                       MemoryUsage::heapBytes(ignoredWords));
+        report.add("ScanArena unused reserve",
+                   arena.bufferSize() > arena.bytesInUse() ? arena.bufferSize() - arena.bytesInUse() : 0);
+    }
+
+    // Once db is finalized and whenever clearedErrors changes
+    void buildConflicts() {
+        conflicts.build(db.occurrences, clearedErrors);
+    }
 
+    // Callers must drop their own arena-backed containers first
     void clearResults() {
+        conflicts.clear();
         db.clear();
+        arena.reset();
     }
 };
@@ -0,0 +1,129 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Locale-independent lowercase folding for German and English text
+ *
+ * Covers Basic Latin, Latin-1 Supplement and Latin Extended-A (U+0000..U+017F),
+ * which is everything German and English patent texts use (Ä, Ö, Ü, ß, accented
+ * loan words). Characters outside that range are returned unchanged.
+ *
+ * foldChar() is constexpr so compile-time tables can hash with the same folding
+ * that is applied at runtime. foldInPlace() converts whole words and uses SIMD
+ * for runs of ASCII characters where the target supports it. upperChar() is the
+ * inverse mapping, for capitalizing generated text.
+ */
+namespace CaseFolding {
+    // First code point that is not covered by the folding table
+    constexpr wchar_t TABLE_END = 0x180;
+
+    namespace detail {
+        constexpr wchar_t lowerOf(wchar_t c) {
+            // Basic Latin
+            if (c >= L'A' && c <= L'Z') {
+                return c + 0x20;
+            }
+            // Latin-1 Supplement: À..Þ except the multiplication sign
+            if (c >= 0xC0 && c <= 0xDE && c != 0xD7) {
+                return c + 0x20;
+            }
+            // Latin Extended-A: upper/lower pairs, with a few irregular spots
+            if (c == 0x130) {
+                return L'i';  // İ -> i
+            }
+            if (c == 0x178) {
+                return 0xFF;  // Ÿ -> ÿ
+            }
+            if ((c >= 0x100 && c <= 0x137) || (c >= 0x14A && c <= 0x177)) {
+                return (c % 2 == 0) ? c + 1 : c;
+            }
+            if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) {
+                return (c % 2 == 1) ? c + 1 : c;
+            }
+            return c;
+        }
+
+        constexpr std::array<wchar_t, TABLE_END> buildLowerTable() {
+            std::array<wchar_t, TABLE_END> table{};
+            for (size_t i = 0; i < table.size(); ++i) {
+                table[i] = lowerOf(static_cast<wchar_t>(i));
+            }
+            return table;
+        }
+
+        inline constexpr std::array<wchar_t, TABLE_END> LOWER_TABLE = buildLowerTable();
+
+        // Inverse of LOWER_TABLE; the first uppercase letter wins, so i maps to I and not to İ
+        constexpr std::array<wchar_t, TABLE_END> buildUpperTable() {
+            std::array<wchar_t, TABLE_END> table{};
+            for (size_t i = 0; i < table.size(); ++i) {
+                table[i] = static_cast<wchar_t>(i);
+            }
+            for (size_t i = 0; i < table.size(); ++i) {
+                const wchar_t lower = LOWER_TABLE[i];
+                if (lower != static_cast<wchar_t>(i) && table[static_cast<size_t>(lower)] == lower) {
+                    table[static_cast<size_t>(lower)] = static_cast<wchar_t>(i);
+                }
+            }
+            return table;
+        }
+
+        inline constexpr std::array<wchar_t, TABLE_END> UPPER_TABLE = buildUpperTable();
+    }
+
+    /**
+     * @brief Lowercase a single character (ß and other lowercase letters stay as they are)
+     */
+    constexpr wchar_t foldChar(wchar_t c) {
+        if (static_cast<unsigned long>(c) < static_cast<unsigned long>(TABLE_END)) {
+            return detail::LOWER_TABLE[static_cast<size_t>(c)];
+        }
+        return c;
+    }
+
+    /**
+     * @brief Uppercase a single character (ß has no single-character uppercase and stays)
+     */
+    constexpr wchar_t upperChar(wchar_t c) {
+        if (static_cast<unsigned long>(c) < static_cast<unsigned long>(TABLE_END)) {
+            return detail::UPPER_TABLE[static_cast<size_t>(c)];
+        }
+        return c;
+    }
+
+    /**
+     * @brief Lowercase a buffer in place
+     */
+    void foldInPlace(wchar_t* data, size_t length);
+
+    inline void foldInPlace(std::wstring& word) {
+        foldInPlace(word.data(), word.size());
+    }
+
+    /**
+     * @brief Return a lowercased copy of a string
+     */
+    inline std::wstring folded(std::wstring_view word) {
+        std::wstring result(word);
+        foldInPlace(result);
+        return result;
+    }
+
+    /**
+     * @brief Case-insensitive comparison of two strings without allocating
+     */
+    constexpr bool equalsFolded(std::wstring_view a, std::wstring_view b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (foldChar(a[i]) != foldChar(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "CharClassTables.h"
+#include <cstdint>
+
+/**
+ * @brief Locale-independent character classification for the scanner
+ *
+ * Replaces std::iswalpha / std::iswspace / std::iswdigit, whose results depend
+ * on the process locale and can disagree with what the RE2 patterns in
+ * RegexPatterns.h match. The classes are defined to agree with those patterns:
+ * - isLetter: \p{L}
+ * - isDigit:  \d (ASCII 0-9)
+ * - isSpace:  \s (tab, LF, FF, CR, space)
+ *
+ * Lookup is a two-level table (block index, then flags) generated by
+ * tools/gen_char_class_tables.py, so every call is two loads and no branches
+ * beyond the range check. UTF-16 surrogate halves classify as nothing.
+ */
+namespace CharClass {
+    enum Flags : uint8_t {
+        LETTER = 1,
+        DIGIT = 2,
+        SPACE = 4
+    };
+
+    constexpr uint8_t flags(wchar_t c) {
+        const uint32_t cp = static_cast<uint32_t>(c);
+        if (cp >= detail::TABLE_LIMIT) {
+            return 0;
+        }
+        const uint32_t block = detail::STAGE1[cp >> detail::BLOCK_SHIFT];
+        return detail::STAGE2[(block << detail::BLOCK_SHIFT) |
+                              (cp & ((1u << detail::BLOCK_SHIFT) - 1))];
+    }
+
+    constexpr bool isLetter(wchar_t c) { return (flags(c) & LETTER) != 0; }
+    constexpr bool isDigit(wchar_t c) { return (flags(c) & DIGIT) != 0; }
+    constexpr bool isSpace(wchar_t c) { return (flags(c) & SPACE) != 0; }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Errors the user cleared in the text, anchored by content instead of offsets
+ *
+ * A cleared range [start, end) is remembered as its text (which for a term
+ * error includes the term and the reference number), the word it is anchored
+ * on with the range's offset from that word, and fingerprints of the
+ * CONTEXT_CHARS characters before and after it. The anchor word is the one
+ * the range starts in, else the first word inside the range, else the last
+ * word before it. resolve() maps the anchors back to positions in one pass
+ * over the words of the current text, so an edit above a cleared error no
+ * longer moves the decision onto other text or drops it. contains() is then
+ * a hash lookup.
+ *
+ * A range is found again where its text recurs with the before or the after
+ * context unchanged (all places with the best context match), or, if the
+ * context changed on both sides, where its text occurs exactly once.
+ * Anchors that are not found stay until the text comes back, but resolved()
+ * reports them so that saving can drop them.
+ */
+class ClearedAnchors {
+public:
+    static constexpr size_t CONTEXT_CHARS = 24;
+
+    struct Anchor {
+        uint64_t text = 0;        // Hash of the cleared range
+        uint64_t firstWord = 0;   // Hash of the anchor word (letter/digit run)
+        uint64_t before = 0;      // Hash of up to CONTEXT_CHARS characters before it
+        uint64_t after = 0;       // ... and after it
+        uint32_t length = 0;
+        int32_t offset = 0;       // Range start minus the start of the anchor word
+
+        bool operator==(const Anchor& other) const = default;
+    };
+
+    static Anchor anchorAt(const std::wstring& text, size_t start, size_t end);
+
+    // Clear [start, end) of text; it counts as cleared right away
+    void add(const std::wstring& text, size_t start, size_t end);
+
+    // Add a saved anchor; it takes effect with the next resolve()
+    void addAnchor(const Anchor& anchor);
+
+    // Recompute the cleared positions for text (call before detection)
+    void resolve(const std::wstring& text);
+
+    bool contains(size_t start, size_t end) const { return m_cleared.count({start, end}) > 0; }
+
+    const std::vector<Anchor>& anchors() const { return m_anchors; }
+    // Whether anchors()[index] was found by the last resolve() or added since
+    bool resolved(size_t index) const { return m_resolved[index]; }
+    size_t size() const { return m_anchors.size(); }
+    bool empty() const { return m_anchors.empty(); }
+    // Positions cleared by the last resolve() and add() calls
+    size_t resolvedCount() const { return m_cleared.size(); }
+
+    void clear();
+    size_t memoryBytes() const;
+
+private:
+    struct RangeHash {
+        size_t operator()(const std::pair<size_t, size_t>& range) const {
+            return std::hash<size_t>()(range.first * 0x9E3779B97F4A7C15ull ^ range.second);
+        }
+    };
+
+    std::vector<Anchor> m_anchors;
+    std::vector<bool> m_resolved;  // Parallel to m_anchors
+    std::unordered_set<std::pair<size_t, size_t>, RangeHash> m_cleared;
+};
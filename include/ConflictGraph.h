@@ -0,0 +1,91 @@
+#pragma once
+
+#include "OccurrenceTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Conflicting assignments as connected components of the BZ-term graph
+ *
+ * Every occurrence is an edge between its BZ and its term (stem ID). build()
+ * joins them with union-find in one pass over the OccurrenceTable; a
+ * component with more than one BZ or more than one term is a conflict, listed
+ * with its BZs, terms and every occurrence in it. Per BZ, per term and per
+ * occurrence it also keeps flags (a BZ conflicts if it names several terms or
+ * its only term has another BZ, user-cleared BZs are not flagged), so the
+ * list views and the highlighter read the same precomputed answer.
+ *
+ * All arrays allocate from the given memory resource (normally the ScanArena).
+ */
+class ConflictGraph {
+public:
+    static constexpr uint32_t NO_CONFLICT = UINT32_MAX;
+
+    // IDs into the OccurrenceTable the graph was built from; occurrences in document order
+    struct Conflict {
+        std::span<const uint32_t> bzIds;
+        std::span<const uint32_t> stemIds;
+        std::span<const uint32_t> occurrences;
+    };
+
+    explicit ConflictGraph(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // occurrences must be finalized
+    void build(const OccurrenceTable& occurrences, const std::unordered_set<std::wstring>& clearedErrors);
+    void clear();
+
+    size_t size() const { return m_bzOffsets.empty() ? 0 : m_bzOffsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    Conflict conflict(size_t index) const;
+    uint32_t conflictOfBz(uint32_t bzId) const { return bzId < m_bzConflict.size() ? m_bzConflict[bzId] : NO_CONFLICT; }
+    uint32_t conflictOfStem(uint32_t stemId) const {
+        return stemId < m_stemConflict.size() ? m_stemConflict[stemId] : NO_CONFLICT;
+    }
+
+    // Whether the BZ has an error, cleared or not (offer "Clear"/"Restore")
+    bool bzConflicts(uint32_t bzId) const { return hasFlag(m_bzFlags, bzId, CONFLICTS); }
+    // Warning icon in the BZ list: conflicting and not cleared
+    bool bzFlagged(uint32_t bzId) const { return hasFlag(m_bzFlags, bzId, FLAGGED); }
+    // Warning icon in the term list: several BZs, or its BZ is flagged
+    bool stemFlagged(uint32_t stemId) const { return hasFlag(m_stemFlags, stemId, FLAGGED); }
+
+    // Occurrences to highlight as wrong term/number, in document order
+    const std::pmr::vector<uint32_t>& flaggedOccurrences() const { return m_flagged; }
+
+    /**
+     * @brief "Welle, Lager <-> 10, 12" for a conflict: the first spelling of each term and its BZs
+     */
+    std::wstring describe(size_t index, const OccurrenceTable& occurrences, const std::wstring& text) const;
+
+    size_t memoryBytes() const;
+
+private:
+    static constexpr uint8_t CONFLICTS = 1;
+    static constexpr uint8_t FLAGGED = 2;
+
+    // IDs the graph does not know (OccurrenceTable::NO_ID) have no flags
+    static bool hasFlag(const std::pmr::vector<uint8_t>& flags, uint32_t id, uint8_t flag) {
+        return id < flags.size() && (flags[id] & flag) != 0;
+    }
+
+    std::pmr::memory_resource* m_resource;
+
+    std::pmr::vector<uint8_t> m_bzFlags;
+    std::pmr::vector<uint8_t> m_stemFlags;
+    std::pmr::vector<uint32_t> m_bzConflict;
+    std::pmr::vector<uint32_t> m_stemConflict;
+    std::pmr::vector<uint32_t> m_flagged;
+
+    // CSR lists per conflict: BZs of conflict c are m_bzs[m_bzOffsets[c] .. m_bzOffsets[c + 1])
+    std::pmr::vector<uint32_t> m_bzOffsets;
+    std::pmr::vector<uint32_t> m_bzs;
+    std::pmr::vector<uint32_t> m_stemOffsets;
+    std::pmr::vector<uint32_t> m_stems;
+    std::pmr::vector<uint32_t> m_occurrenceOffsets;
+    std::pmr::vector<uint32_t> m_occurrences;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "utils_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Synthetic patent-style descriptions with known expected results
+ *
+ * Generates deterministic German or English text from a fixed seed: a
+ * vocabulary of numbered terms is introduced with an indefinite article and
+ * referenced with a definite one, interleaved with reference-free sentences.
+ * Ordinal pairs ("erste/zweite Welle") and adjective pairs ("oberes/unteres
+ * Lager") produce multi-word terms. A configurable share of the mentions
+ * carries a planted error (missing number, wrong article, conflicting number).
+ *
+ * Alongside the text the generator records the ground truth a correct scan
+ * must reproduce: the BZ -> original words mapping, the multi-word base stems
+ * to enable, the conflicting BZs and every planted error range. Positions are
+ * character offsets into the generated std::wstring.
+ *
+ * Used by the benchmarks, the scanner tests and the bz_corpus_gen tool.
+ */
+class CorpusGenerator {
+public:
+    enum class Language {
+        GERMAN,
+        ENGLISH
+    };
+
+    struct Options {
+        Language language = Language::GERMAN;
+        size_t targetChars = 100000;
+
+        // Number of distinct numbered terms (capped by the built-in word lists)
+        size_t vocabularySize = 30;
+
+        // Share of sentences that mention terms, in percent (the rest is filler)
+        int referenceDensity = 70;
+
+        // Base nouns used as "erste X" / "zweite X" and "oberes X" / "unteres X";
+        // each pair contributes two terms to the vocabulary
+        size_t ordinalPairs = 2;
+        size_t multiWordPairs = 1;
+
+        // German only: false transliterates ä/ö/ü/ß to ae/oe/ue/ss
+        bool umlauts = true;
+
+        // Share of mentions with a planted error, in percent of all mentions
+        int missingNumberPercent = 0;
+        int conflictPercent = 0;
+        int wrongArticlePercent = 0;
+
+        uint32_t seed = 42;
+    };
+
+    enum class ErrorKind {
+        MISSING_NUMBER,  // Term without its number; range covers the term words
+        WRONG_ARTICLE,   // Definite on first mention or indefinite later; range covers the article
+        CONFLICT         // Term with another term's number; range covers term and number
+    };
+
+    struct PlantedError {
+        ErrorKind kind;
+        size_t start;
+        size_t end;
+        std::wstring bz;  // The term's own BZ, or for CONFLICT the reused one
+    };
+
+    struct GroundTruth {
+        // Expected ReferenceDatabase::bzToOriginalWords
+        std::map<std::wstring, std::set<std::wstring>, BZComparatorForMap> bzToOriginalWords;
+
+        // Stems to put into AnalysisContext::multiWordBaseStems before scanning
+        std::set<std::wstring> multiWordBaseStems;
+
+        // Subset of multiWordBaseStems that OrdinalDetector finds on its own
+        std::set<std::wstring> ordinalBaseStems;
+
+        // BZs with several terms, or whose term has another BZ (ConflictGraph::bzFlagged)
+        std::set<std::wstring, BZComparatorForMap> conflictingBz;
+
+        // In document order
+        std::vector<PlantedError> errors;
+
+        size_t count(ErrorKind kind) const;
+    };
+
+    struct Corpus {
+        std::wstring text;
+        GroundTruth truth;
+    };
+
+    static Corpus generate(const Options& options);
+
+    /**
+     * @brief Write the text as UTF-8
+     */
+    static void writeText(std::ostream& out, const std::wstring& text);
+
+    /**
+     * @brief Write options and ground truth as a JSON document (UTF-8)
+     */
+    static void writeGroundTruth(std::ostream& out, const Options& options, const GroundTruth& truth);
+
+    static const char* errorKindName(ErrorKind kind);
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CorpusGenerator.h"
+#include "ScanSnapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Differential testing of a scan engine against the ReferenceScanner
+ *
+ * An Engine maps an Input (a text and the user's decisions) to a
+ * ScanSnapshot. A campaign scans a synthetic corpus with its paragraph table
+ * and random mutations of it with the reference and the candidate engine (by
+ * default ScanPipeline) and stops at the first input on which the snapshots
+ * differ. Mutated inputs also get random decisions: paragraph starts added or
+ * dropped, errors, conflicting BZs and terms cleared or ignored. The
+ * diverging input is then shrunk by delta debugging to a small text with as
+ * few decisions as still diverge.
+ *
+ * Used by the bz_diff tool, the bz_fuzz libFuzzer target and the tests. New
+ * engines plug in as another Engine.
+ */
+class DifferentialHarness {
+public:
+    struct Input {
+        std::wstring text;
+        ScanDecisions decisions;
+
+        Input() = default;
+        // A plain text is an input without decisions
+        Input(std::wstring text, ScanDecisions decisions = {})
+            : text(std::move(text)), decisions(std::move(decisions)) {}
+
+        bool operator==(const Input& other) const = default;
+    };
+
+    using Engine = std::function<ScanSnapshot(const Input&)>;
+
+    // Fresh engines; exceptions are caught into ScanSnapshot::exception
+    static Engine referenceEngine(bool useGerman);
+    static Engine pipelineEngine(bool useGerman);
+
+    struct Options {
+        CorpusGenerator::Options corpus;  // Language also selects the engines' language
+        size_t mutations = 200;           // Mutated inputs after the unmodified corpus
+        size_t maxEditsPerMutation = 4;
+        uint32_t seed = 1;
+        bool minimize = true;
+    };
+
+    struct Divergence {
+        size_t iteration = 0;     // 0 = the unmodified corpus
+        Input input;              // Input on which the engines first disagreed
+        Input minimized;          // Smallest diverging input found (input if not minimized)
+        std::string description;  // ScanSnapshot::firstDivergence on the minimized input
+    };
+
+    /**
+     * @brief Run a campaign; nullopt if the engines agreed on every input
+     *
+     * progress, if given, receives one line per 50 inputs.
+     */
+    static std::optional<Divergence> run(const Options& options, const Engine& reference,
+                                         const Engine& candidate, std::ostream* progress = nullptr);
+
+    // Difference between the engines on input, nullopt if they agree
+    static std::optional<std::string> compare(const Input& input, const Engine& reference,
+                                              const Engine& candidate);
+
+    // The corpus text with a paragraph starting after every line break, as a DOCX import reports it
+    static Input corpusInput(const std::wstring& text);
+
+    /**
+     * @brief Apply 1..maxEdits random edits shaped like patent text changes
+     *
+     * Deletes, duplicates or moves spans, inserts terms, numbers, articles,
+     * ordinals, umlauts and whitespace, and changes digits and letter case.
+     * Paragraph starts and cleared ranges move with the text like the GUI
+     * moves them; cleared ranges an edit touches are dropped.
+     */
+    static Input mutate(const Input& input, std::mt19937& rng, size_t maxEdits);
+
+    /**
+     * @brief Randomly change the decisions of input
+     *
+     * Drops the paragraph table or adds and removes starts, clears some of
+     * the errors and conflicting BZs of snapshot (a scan of input) and
+     * ignores some of its single-word terms.
+     */
+    static void decide(Input& input, const ScanSnapshot& snapshot, std::mt19937& rng);
+
+    /**
+     * @brief Shrink input while stillFails holds
+     *
+     * ddmin over chunks of the text, then characters, with the decisions
+     * following the text; then each decision is dropped if it is not needed.
+     */
+    static Input minimize(const Input& input, const std::function<bool(const Input&)>& stillFails);
+
+    /**
+     * @brief Decode fuzzer bytes as UTF-8; invalid sequences and surrogates become U+FFFD
+     */
+    static std::wstring decodeFuzzInput(const uint8_t* data, size_t size);
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "TextDecoder.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Chunked decoding of a text file for progressive display
+ *
+ * load() walks a MappedFile front to back, decodes chunkBytes at a time with
+ * TextDecoder and hands each decoded piece to the sink, so at most one chunk
+ * of decoded text exists besides what the sink keeps. Line ends are
+ * normalized to '\n' (also across chunk boundaries), as wxRichTextCtrl
+ * reports them, so scan positions match the text control. Files starting
+ * with a ZIP signature are read as Word documents by DocxImporter.
+ *
+ * MainWindow runs load() on a loader thread and appends the chunks to the
+ * text control; bz_cli uses loadAll().
+ */
+class DocumentLoader {
+public:
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 512 * 1024;
+
+    // chunk may be moved from; bytesDone counts input bytes including the BOM
+    using ChunkSink = std::function<void(std::wstring&& chunk, size_t bytesDone, size_t bytesTotal)>;
+
+    enum class Format {
+        TEXT,
+        DOCX
+    };
+
+    struct Result {
+        Format format = Format::TEXT;
+        TextDecoder::Encoding encoding = TextDecoder::Encoding::UTF8;
+        size_t characters = 0;   // Total decoded length
+        bool completed = false;  // false if stopped early
+        size_t paragraphs = 0;   // Text: lines, DOCX: w:p elements
+        // DOCX only: offset of each w:p in the decoded text, ascending, for
+        // TextScanner::scanText. 32 bits like the occurrence table; a part is
+        // at most ZipArchive's 512 MB entry limit. Empty for text files, whose
+        // line breaks do not end a reference sign.
+        std::vector<uint32_t> paragraphStarts;
+    };
+
+    /**
+     * @brief Decode file into sink chunk by chunk; checks stop between chunks
+     *
+     * Throws std::runtime_error for a corrupt .docx; text files always decode.
+     */
+    static Result load(const MappedFile& file, const ChunkSink& sink, std::stop_token stop = {},
+                       size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+
+    /**
+     * @brief Whole file as one string; throws std::runtime_error if it cannot be read
+     */
+    static std::wstring loadAll(const std::string& path, TextDecoder::Encoding* encoding = nullptr);
+};
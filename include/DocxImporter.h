@@ -0,0 +1,33 @@
+#pragma once
+
+#include "DocumentLoader.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <stop_token>
+
+/**
+ * @brief Text and paragraph table of a Word .docx file, streamed
+ *
+ * word/document.xml is inflated straight out of the mapped ZIP archive and
+ * tokenized with XmlReader while it decompresses; no DOM and no unpacked copy
+ * of the part exist. Run text (w:t) is collected in document order; every
+ * paragraph (w:p) ends with '\n' and its start offset goes to
+ * Result::paragraphStarts. w:tab becomes '\t', w:br and w:cr '\n',
+ * w:noBreakHyphen '-'; deleted text, field instructions and the Fallback
+ * branch of mc:AlternateContent are skipped.
+ *
+ * DocumentLoader::load() calls this for files with a ZIP signature. Corrupt
+ * archives and non-Word ZIP files throw std::runtime_error.
+ */
+class DocxImporter {
+public:
+    /**
+     * @brief Decode file into sink in pieces of about chunkCharacters
+     *
+     * bytesDone reports how far the compressed part has been read; stop is
+     * checked between deflate blocks.
+     */
+    static DocumentLoader::Result load(const MappedFile& file, const DocumentLoader::ChunkSink& sink,
+                                       std::stop_token stop = {},
+                                       size_t chunkCharacters = DocumentLoader::DEFAULT_CHUNK_BYTES);
+};
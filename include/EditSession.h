@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A recorded editing session: a start text plus timestamped edits
+ *
+ * Sessions are replayed by LatencyReplay to measure edit-to-highlight
+ * latency. They come from the GUI (BZ_RECORD_SESSION=<file>, see Recorder)
+ * or from synthesize().
+ *
+ * File format (UTF-8, one record per line; \\, \n, \r, \t escaped):
+ *
+ *   bz-edit-session 1
+ *   text <initial text>
+ *   <ms> + <position> <inserted text>
+ *   <ms> - <position> <length>
+ *
+ * Positions and lengths count wchar_t, like wxTextCtrl positions.
+ */
+struct EditSession {
+    struct Edit {
+        enum class Kind { INSERT, ERASE };
+
+        int64_t timeMs = 0;    // Since session start
+        Kind kind = Kind::INSERT;
+        size_t position = 0;
+        std::wstring text;     // INSERT only
+        size_t length = 0;     // ERASE only
+    };
+
+    std::wstring initialText;
+    std::vector<Edit> edits;
+
+    /**
+     * @brief Apply an edit to a text; positions past the end are clamped
+     */
+    static void apply(std::wstring& text, const Edit& edit);
+
+    /**
+     * @brief The single edit turning before into after
+     *
+     * Finds the common prefix and suffix; a replacement is reported as an
+     * ERASE followed by an INSERT at the same time. Returns no edits if the
+     * texts are equal.
+     */
+    static std::vector<Edit> diff(const std::wstring& before, const std::wstring& after, int64_t timeMs);
+
+    /**
+     * @brief Move a paragraph table (DocumentLoader::Result::paragraphStarts) along with an edit
+     *
+     * Text inserted at a paragraph start joins that paragraph. A paragraph
+     * whose start is erased, or whose preceding break is, merges into the
+     * previous one.
+     */
+    static void shiftParagraphs(std::vector<uint32_t>& paragraphStarts, const Edit& edit);
+    // The same for erasing erased characters at position, then inserting inserted ones there
+    static void shiftParagraphs(std::vector<uint32_t>& paragraphStarts, size_t position, size_t erased,
+                                size_t inserted);
+
+    // Final text after all edits
+    std::wstring finalText() const;
+
+    // Throws std::runtime_error on malformed input
+    static EditSession load(std::istream& in);
+    void save(std::ostream& out) const;
+
+    struct SynthesisOptions {
+        size_t bursts = 20;             // Typing bursts at random word boundaries
+        size_t minBurstChars = 5;
+        size_t maxBurstChars = 40;
+        int64_t minKeyIntervalMs = 60;  // Between keystrokes within a burst
+        int64_t maxKeyIntervalMs = 220;
+        int64_t minPauseMs = 800;       // Between bursts
+        int64_t maxPauseMs = 6000;
+        int backspacePercent = 8;       // Chance per keystroke of a typo + backspace
+        uint32_t seed = 42;
+    };
+
+    /**
+     * @brief Typing session on top of a document
+     *
+     * Each burst types a phrase built from the document's own "term number"
+     * pairs one character at a time, with occasional corrections.
+     */
+    static EditSession synthesize(const std::wstring& text, const SynthesisOptions& options);
+
+    /**
+     * @brief Appends the edits of a live GUI session to a session file
+     *
+     * Every edit is written and flushed immediately, so a crash keeps the
+     * session recorded up to that point.
+     */
+    class Recorder {
+    public:
+        Recorder(const std::string& path, const std::wstring& initialText);
+
+        bool isOpen() const { return static_cast<bool>(m_out); }
+
+        // Record the change from the previously seen text to currentText
+        void record(const std::wstring& currentText);
+
+    private:
+        std::ofstream m_out;
+        std::wstring m_lastText;
+        std::chrono::steady_clock::time_point m_start;
+    };
+};
@@ -2,11 +2,13 @@
 #include "TextAnalyzer.h"
 #include "english_stem.h"
 #include "utils_core.h"
+#include "Lexicon.h"
+#include "MemoryReport.h"
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <unordered_map>
 #include <utility>
-#include <locale>
 
 /**
  * @brief English language text analysis utilities
@@ -15,7 +17,7 @@
  * - Stemming (using Oleander library with caching)
  * - Article detection (definite/indefinite)
  * - Word extraction and validation
- * - Proper English locale handling for case conversion
+ * - Locale-independent case folding (see CaseFolding.h)
  */
 class EnglishTextAnalyzer : public TextAnalyzer {
 public:
@@ -32,30 +34,29 @@ public:
                         const std::unordered_set<std::wstring>& multiWordBaseStems) override;
 
     // Article checking
-    bool isIndefiniteArticle(const std::wstring& word) const override;
-    bool isDefiniteArticle(const std::wstring& word) const override;
+    bool isIndefiniteArticle(std::wstring_view word) const override;
+    bool isDefiniteArticle(std::wstring_view word) const override;
 
     // Word filtering
-    bool isIgnoredWord(const std::wstring& word) const override;
+    bool isIgnoredWord(std::wstring_view word) const override;
+    void addIgnoredWord(std::wstring_view word) override;
 
     // Cache management (for diagnostics)
     size_t getCacheSize() const override { return m_stemCache.size(); }
+    size_t getCacheMemoryBytes() const override { return MemoryUsage::heapBytes(m_stemCache); }
     void clearCache() override { m_stemCache.clear(); }
 
 private:
     stemming::english_stem<> m_englishStemmer;
     
-    // English locale for proper character handling
-    std::locale m_englishLocale;
-    const std::ctype<wchar_t>* m_ctypeFacet;
-    
     // Cache for stemming results to avoid repeated expensive operations
     mutable std::unordered_map<std::wstring, std::wstring> m_stemCache;
 
-    // Static sets for fast article lookup
-    static const std::unordered_set<std::wstring> s_indefiniteArticles;
-    static const std::unordered_set<std::wstring> s_definiteArticles;
-    
-    // Static set for ignored words
-    static const std::unordered_set<std::wstring> s_ignoredWords;
+    // Compile-time tables for fast article lookup
+    static const Lexicon::TableView<bool> s_indefiniteArticles;
+    static const Lexicon::TableView<bool> s_definiteArticles;
+
+    // Built-in ignored words plus any user-supplied additions
+    static const Lexicon::TableView<bool> s_ignoredWords;
+    Lexicon::WordTable<bool> m_ignoredWords;
 };
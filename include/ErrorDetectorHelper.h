@@ -18,6 +18,10 @@
  * - Unnumbered words (terms that should have reference numbers but don't)
  * - Article usage errors (definite vs indefinite articles)
  * - Conflicting assignments (same number for different terms)
+ *
+ * Detected ranges are appended to the list of their category and, if textBox
+ * is not null, highlighted in it. Passing nullptr runs detection headless.
+ * The list of all errors is ErrorIndex::build()'s merge of the categories.
  */
 class ErrorDetectorHelper {
 public:
@@ -31,8 +35,7 @@ public:
         AnalysisContext& ctx,
         wxRichTextCtrl* textBox,
         const wxTextAttr& warningStyle,
-        std::vector<std::pair<int, int>>& noNumberPositions,
-        std::vector<std::pair<int, int>>& allErrorsPositions
+        ErrorPositions& noNumberPositions
     );
 
     /**
@@ -44,27 +47,40 @@ public:
         AnalysisContext& ctx,
         wxRichTextCtrl* textBox,
         const wxTextAttr& articleWarningStyle,
-        std::vector<std::pair<int, int>>& wrongArticlePositions,
-        std::vector<std::pair<int, int>>& allErrorsPositions
+        ErrorPositions& wrongArticlePositions
     );
 
     /**
-     * @brief Check if a uniquely assigned reference number exists
+     * @brief Highlight the occurrences ctx.conflicts flags as wrong term/number
+     *
+     * Reads the graph from ctx.buildConflicts(); appends in document order
+     * and skips positions cleared in the text.
      */
-    static bool isUniquelyAssigned(
-        const std::wstring& bz,
+    static void highlightConflicts(
         AnalysisContext& ctx,
         wxRichTextCtrl* textBox,
         const wxTextAttr& conflictStyle,
-        std::vector<std::pair<int, int>>& wrongTermBzPositions,
-        std::vector<std::pair<int, int>>& allErrorsPositions
+        ErrorPositions& wrongTermBzPositions
+    );
+
+    /**
+     * @brief Apply style to every range of positions
+     *
+     * For the lists of a headless run (ScanPipeline) that are shown later.
+     */
+    static void highlight(
+        wxRichTextCtrl* textBox,
+        const ErrorPositions& positions,
+        const wxTextAttr& style
     );
 
     /**
      * @brief Check if a position has been manually cleared by the user
+     *
+     * Positions come from the last ClearedAnchors::resolve(); the lookup is a hash probe.
      */
     static bool isPositionCleared(
-        const std::set<std::pair<size_t, size_t>>& clearedTextPositions,
+        const ClearedAnchors& clearedTextAnchors,
         size_t start,
         size_t end
     );
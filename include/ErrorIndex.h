@@ -0,0 +1,59 @@
+#pragma once
+
+#include "utils_core.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+
+/**
+ * @brief Sorted error lists with cursor-relative navigation and hit testing
+ *
+ * build() sorts each category list by (start, end) and removes duplicates
+ * (a no-op check for lists that are already sorted), then fills the "all
+ * errors" list by a k-way merge of the categories instead of sorting their
+ * concatenation. An error in several categories appears there once.
+ *
+ * nextAfter(), previousBefore() and errorAt() are binary searches, so
+ * navigation and right-click lookups stay O(log n) at 100,000 errors.
+ */
+class ErrorIndex {
+public:
+    enum Category { NoNumber, WrongTermBz, WrongArticle, CategoryCount };
+
+    /**
+     * @brief Sort and de-duplicate the categories, then merge them into all
+     *
+     * Replaces the contents of all; it is the only producer of that list.
+     */
+    void build(const std::array<ErrorPositions*, CategoryCount>& categories, ErrorPositions& all);
+
+    void clear();
+
+    size_t count(Category category) const { return m_counts[category]; }
+    size_t total() const { return m_total; }
+
+    /**
+     * @brief Index of the first error after the range [from, to)
+     *
+     * Errors are ordered by (start, end), so with from == to (a caret) this is
+     * the first error starting at or after it; with the range of an error it is
+     * the one following that error. Wraps to the first error; nullopt if empty.
+     */
+    static std::optional<size_t> nextAfter(const ErrorPositions& positions, long from, long to);
+
+    // Last error before the range [from, to) in the same order; wraps to the last error
+    static std::optional<size_t> previousBefore(const ErrorPositions& positions, long from, long to);
+
+    /**
+     * @brief Index in all (as passed to the last build()) of an error containing position
+     *
+     * Where errors overlap, the one starting last wins. Only errors within
+     * the longest error length before position are looked at.
+     */
+    std::optional<size_t> errorAt(const ErrorPositions& all, long position) const;
+
+private:
+    std::array<size_t, CategoryCount> m_counts{};
+    size_t m_total = 0;
+    int m_longest = 0;  // Longest error in characters, bounds the look-back of errorAt()
+};
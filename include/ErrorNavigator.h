@@ -1,6 +1,7 @@
 #pragma once
 #include <utility>
 #include <vector>
+#include "utils_core.h"
 #include "wx/richtext/richtextctrl.h"
 #include "wx/stattext.h"
 
@@ -9,35 +10,37 @@
  *
  * Manages navigation through error positions in text with forward/backward buttons.
  * Reduces code duplication by providing a single implementation for all error types.
+ * Steps are taken from the selection in the text control, or from the caret if
+ * nothing is selected, so navigation continues from wherever the user clicked.
  */
 class ErrorNavigator {
 public:
     /**
-     * @brief Navigate to next error in the list
-     * @param positions Vector of (start, end) position pairs
-     * @param currentIndex Reference to current selection index (-1 = none selected)
+     * @brief Navigate to the first error after the cursor, wrapping around
+     * @param positions Vector of (start, end) position pairs, sorted (ErrorIndex::build)
+     * @param currentIndex Set to the index of the selected error, unchanged if positions is empty
      * @param textCtrl Text control to update selection
      * @param label Label to update with "N/Total" text
      */
-    static void selectNext(const std::vector<std::pair<int, int>>& positions,
+    static void selectNext(const ErrorPositions& positions,
                           int& currentIndex,
                           wxRichTextCtrl* textCtrl,
                           wxStaticText* label);
 
     /**
-     * @brief Navigate to previous error in the list
-     * @param positions Vector of (start, end) position pairs
-     * @param currentIndex Reference to current selection index (-1 = none selected)
+     * @brief Navigate to the last error before the cursor, wrapping around
+     * @param positions Vector of (start, end) position pairs, sorted (ErrorIndex::build)
+     * @param currentIndex Set to the index of the selected error, unchanged if positions is empty
      * @param textCtrl Text control to update selection
      * @param label Label to update with "N/Total" text
      */
-    static void selectPrevious(const std::vector<std::pair<int, int>>& positions,
+    static void selectPrevious(const ErrorPositions& positions,
                               int& currentIndex,
                               wxRichTextCtrl* textCtrl,
                               wxStaticText* label);
 
 private:
-    static void updateSelection(const std::vector<std::pair<int, int>>& positions,
+    static void updateSelection(const ErrorPositions& positions,
                                int currentIndex,
                                wxRichTextCtrl* textCtrl,
                                wxStaticText* label);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <vector>
+
+/**
+ * @brief Streaming raw DEFLATE (RFC 1951) decoder
+ *
+ * Decodes a complete compressed buffer (typically a slice of a MappedFile)
+ * and hands the output to a sink in pieces of up to 64 KB, keeping only the
+ * 32 KB back-reference window plus one flush buffer in memory. Huffman codes
+ * of up to 10 bits are decoded with a lookup table, longer ones bit by bit.
+ *
+ * Used by ZipArchive for DOCX import; there is no zlib dependency. Corrupt or
+ * truncated input throws std::runtime_error.
+ */
+class Inflater {
+public:
+    // out is valid for the duration of the call
+    using Sink = std::function<void(const uint8_t* out, size_t size)>;
+
+    Inflater();
+
+    /**
+     * @brief Decode data; returns the number of output bytes
+     *
+     * stop is checked between blocks; a stopped inflate returns early.
+     */
+    size_t inflate(const uint8_t* data, size_t size, const Sink& sink, std::stop_token stop = {});
+
+    // Input bytes consumed so far by the running inflate() (for progress)
+    size_t inputConsumed() const { return m_inPos; }
+
+private:
+    static constexpr int FAST_BITS = 10;
+
+    struct Huffman {
+        uint16_t counts[16];    // Codes per length
+        uint16_t symbols[320];  // Symbols ordered by code
+        uint16_t fast[1 << FAST_BITS];  // (symbol << 4) | length, 0 = longer code
+    };
+
+    void buildHuffman(Huffman& table, const uint8_t* lengths, size_t count);
+    int decodeSymbol(const Huffman& table);
+    uint32_t bits(int count);
+    void refill();
+    void storedBlock();
+    void codesBlock(const Huffman& literals, const Huffman& distances);
+    void dynamicTables(Huffman& literals, Huffman& distances);
+    void put(uint8_t byte);
+    void flush(size_t keep);
+
+    const uint8_t* m_in = nullptr;
+    size_t m_inSize = 0;
+    size_t m_inPos = 0;
+    uint64_t m_bitBuffer = 0;
+    int m_bitCount = 0;
+    int m_overrun = 0;  // Zero bytes fed past the end of input
+
+    std::vector<uint8_t> m_window;  // 2 x 32 KB: history, then new output
+    size_t m_windowPos = 0;
+    size_t m_flushed = 0;  // Bytes of m_window already given to the sink
+    size_t m_total = 0;
+    const Sink* m_sink = nullptr;
+
+    Huffman m_fixedLiterals;
+    Huffman m_fixedDistances;
+};
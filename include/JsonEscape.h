@@ -0,0 +1,117 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief JSON string escaping (RFC 8259) shared by every JSON writer
+ *
+ * '"', '\\' and all control characters are escaped (\n, \r, \t by name, the
+ * rest as \u00XX); everything else is written as UTF-8. Wide text is walked
+ * by code point, combining surrogate pairs where wchar_t is UTF-16; lone
+ * surrogates and values above U+10FFFF become U+FFFD. UTF-8 input is copied
+ * byte for byte apart from the escapes.
+ *
+ * Used by ReportExporter, the Chrome trace export and the corpus ground truth.
+ */
+namespace JsonEscape {
+    // Calls emit(char32_t) for each code point of s
+    template <typename Emit>
+    void forEachCodePoint(std::wstring_view s, Emit emit) {
+        for (size_t i = 0; i < s.size(); ++i) {
+            char32_t c = static_cast<char32_t>(s[i]);
+            if constexpr (sizeof(wchar_t) == 2) {
+                if (c >= 0xD800 && c < 0xDC00 && i + 1 < s.size() && s[i + 1] >= 0xDC00 && s[i + 1] < 0xE000) {
+                    c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<char32_t>(s[i + 1]) - 0xDC00);
+                    ++i;
+                }
+            }
+            emit(c);
+        }
+    }
+
+    inline void appendUtf8(std::string& out, char32_t c) {
+        if ((c >= 0xD800 && c < 0xE000) || c > 0x10FFFF) {
+            c = 0xFFFD;  // Lone surrogate or out of range
+        }
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    namespace detail {
+        // Escape for an ASCII character, or nullptr if it is written as is
+        inline const char* escapeOf(char32_t c, char (&control)[7]) {
+            switch (c) {
+            case U'"': return "\\\"";
+            case U'\\': return "\\\\";
+            case U'\n': return "\\n";
+            case U'\r': return "\\r";
+            case U'\t': return "\\t";
+            default:
+                if (c < 0x20) {
+                    static const char HEX[] = "0123456789abcdef";
+                    control[0] = '\\';
+                    control[1] = 'u';
+                    control[2] = '0';
+                    control[3] = '0';
+                    control[4] = HEX[c >> 4];
+                    control[5] = HEX[c & 0xF];
+                    control[6] = '\0';
+                    return control;
+                }
+                return nullptr;
+            }
+        }
+    }
+
+    // String content without the quotes
+    inline void append(std::string& out, std::wstring_view text) {
+        char control[7];
+        forEachCodePoint(text, [&](char32_t c) {
+            if (const char* escape = detail::escapeOf(c, control)) {
+                out += escape;
+            } else {
+                appendUtf8(out, c);
+            }
+        });
+    }
+
+    inline void append(std::string& out, std::string_view utf8) {
+        char control[7];
+        for (char c : utf8) {
+            if (const char* escape = detail::escapeOf(static_cast<unsigned char>(c), control)) {
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    // Quoted string
+    inline void write(std::ostream& out, std::wstring_view text) {
+        std::string quoted = "\"";
+        append(quoted, text);
+        quoted += '"';
+        out << quoted;
+    }
+
+    inline void write(std::ostream& out, std::string_view utf8) {
+        std::string quoted = "\"";
+        append(quoted, utf8);
+        quoted += '"';
+        out << quoted;
+    }
+}
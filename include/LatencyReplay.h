@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EditSession.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Replays an edit session through a model of the GUI scan scheduling
+ *
+ * The replay runs in virtual time. Edits arrive at their recorded times; the
+ * UI thread handles them and the scan events one at a time, the way
+ * MainWindow does:
+ *
+ * - debounceFunc: every edit restarts the debounce timer
+ * - scanText (timer): cancel and join the running scan (it stops at the
+ *   end of its current phase unless already detecting), snapshot the text,
+ *   start a scan thread
+ * - scanTextBackground: ScanPipeline::run (ordinal detection, term scan,
+ *   detectors), then CallAfter
+ * - updateUIAfterScan: waits for m_dataMutex if a newer scan is running,
+ *   then styles the text
+ *
+ * Phase durations are not modelled: every scan really runs ScanPipeline on
+ * the text snapshot and uses its measured PhaseTimings, so results reflect
+ * the current scanner. An edit's latency runs from its arrival to the end of
+ * the first UI update that shows a scan including it.
+ */
+class LatencyReplay {
+public:
+    struct Options {
+        bool useGerman = true;
+        double debounceMs = 500;      // MainWindow::debounceFunc
+        double styleCostPerErrorUs = 0;  // Added to each UI update per highlighted error
+    };
+
+    struct Report {
+        std::vector<double> editLatencyMs;  // Per edit, in session order
+        std::vector<double> uiStallMs;      // Per blocking UI handler (join wait, UI update)
+        std::vector<double> inputDelayMs;   // Per edit, wait for a busy UI thread
+        size_t scansStarted = 0;
+        size_t scansCancelled = 0;          // Stopped early by a newer scan
+        size_t uiUpdates = 0;
+        double sessionMs = 0;               // Virtual time until the last update
+
+        // Nearest-rank percentile (0 < q <= 1) of values; 0 when empty
+        static double percentile(std::vector<double> values, double q);
+        static double total(const std::vector<double>& values);
+    };
+
+    static Report replay(const EditSession& session, const Options& options);
+};
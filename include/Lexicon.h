@@ -0,0 +1,232 @@
+#pragma once
+#include "CaseFolding.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Allocation-free, case-insensitive word lookup tables
+ *
+ * Small fixed word lists (articles, ignored words, ordinals) are built at
+ * compile time into perfect-hash tables: every key lands in its own slot, so a
+ * lookup is one hash over the case-folded probe plus one comparison. Probes are
+ * std::wstring_view and are folded on the fly, so no lowercase temporary is
+ * ever created.
+ *
+ * WordTable layers runtime additions (e.g. user-supplied ignored words) on top
+ * of a compile-time table using the same hash, so callers see one structure.
+ */
+namespace Lexicon {
+    /**
+     * @brief FNV-1a over case-folded characters with a final avalanche step
+     */
+    constexpr uint32_t hashFolded(std::wstring_view word, uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+        for (wchar_t c : word) {
+            h ^= static_cast<uint32_t>(CaseFolding::foldChar(c));
+            h *= 16777619u;
+        }
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    template <typename Value>
+    struct Entry {
+        std::wstring_view word;
+        Value value;
+    };
+
+    /**
+     * @brief Non-owning view of a compile-time table (cheap to copy, constexpr)
+     */
+    template <typename Value>
+    struct TableView {
+        const Entry<Value>* entries = nullptr;
+        const uint8_t* slots = nullptr;  // 0 = empty, otherwise entry index + 1
+        uint32_t mask = 0;
+        uint32_t seed = 0;
+        size_t minLength = 1;
+        size_t maxLength = 0;
+
+        constexpr const Value* find(std::wstring_view word) const {
+            if (word.size() < minLength || word.size() > maxLength) {
+                return nullptr;
+            }
+            uint8_t slot = slots[hashFolded(word, seed) & mask];
+            if (slot == 0) {
+                return nullptr;
+            }
+            const Entry<Value>& entry = entries[slot - 1];
+            return CaseFolding::equalsFolded(entry.word, word) ? &entry.value : nullptr;
+        }
+
+        constexpr bool contains(std::wstring_view word) const {
+            return find(word) != nullptr;
+        }
+    };
+
+    /**
+     * @brief Perfect-hash table generated at compile time
+     *
+     * The constructor searches for a seed that maps all N keys to distinct
+     * slots; if none is found the constant evaluation fails, so a bad word
+     * list is a compile error rather than a runtime surprise.
+     */
+    template <typename Value, size_t N>
+    class StaticTable {
+        static_assert(N > 0 && N < 255, "StaticTable supports 1..254 entries");
+        static constexpr size_t TABLE_SIZE = std::bit_ceil(N * 4);
+
+    public:
+        constexpr explicit StaticTable(const Entry<Value> (&entries)[N]) {
+            for (size_t i = 0; i < N; ++i) {
+                for (wchar_t c : entries[i].word) {
+                    if (CaseFolding::foldChar(c) != c) {
+                        throw "Lexicon entries must be lowercase";
+                    }
+                }
+                m_entries[i] = entries[i];
+                m_minLength = std::min(m_minLength, entries[i].word.size());
+                m_maxLength = std::max(m_maxLength, entries[i].word.size());
+            }
+
+            for (uint32_t seed = 0; seed < 100000; ++seed) {
+                if (tryPlace(seed)) {
+                    m_seed = seed;
+                    return;
+                }
+            }
+            throw "Lexicon: no collision-free seed found";
+        }
+
+        constexpr TableView<Value> view() const {
+            return {m_entries.data(), m_slots.data(),
+                    static_cast<uint32_t>(TABLE_SIZE - 1), m_seed, m_minLength, m_maxLength};
+        }
+
+    private:
+        constexpr bool tryPlace(uint32_t seed) {
+            m_slots.fill(0);
+            for (size_t i = 0; i < N; ++i) {
+                size_t slot = hashFolded(m_entries[i].word, seed) & (TABLE_SIZE - 1);
+                if (m_slots[slot] != 0) {
+                    return false;
+                }
+                m_slots[slot] = static_cast<uint8_t>(i + 1);
+            }
+            return true;
+        }
+
+        std::array<Entry<Value>, N> m_entries{};
+        std::array<uint8_t, TABLE_SIZE> m_slots{};
+        uint32_t m_seed = 0;
+        size_t m_minLength = SIZE_MAX;
+        size_t m_maxLength = 0;
+    };
+
+    /**
+     * @brief Build a compile-time word set (value is always true)
+     */
+    template <size_t N>
+    constexpr StaticTable<bool, N> makeWordSet(const wchar_t* const (&words)[N]) {
+        Entry<bool> entries[N];
+        for (size_t i = 0; i < N; ++i) {
+            entries[i] = {words[i], true};
+        }
+        return StaticTable<bool, N>(entries);
+    }
+
+    /**
+     * @brief Compile-time table extended with words added at runtime
+     *
+     * Built-in words stay in the constexpr table; added words are stored folded
+     * in an open-addressing table hashed with the same function and seed.
+     * Lookups never allocate.
+     */
+    template <typename Value>
+    class WordTable {
+    public:
+        constexpr explicit WordTable(TableView<Value> builtIn) : m_builtIn(builtIn) {}
+
+        void add(std::wstring_view word, Value value) {
+            if (word.empty()) {
+                return;
+            }
+            if (size_t index = findAdded(word); index != NOT_FOUND) {
+                m_added[index].second = value;
+                return;
+            }
+            if ((m_added.size() + 1) * 2 > m_slots.size()) {
+                rehash(std::max<size_t>(16, m_slots.size() * 2));
+            }
+            m_added.emplace_back(CaseFolding::folded(word), value);
+            insertSlot(m_added.size() - 1);
+        }
+
+        const Value* find(std::wstring_view word) const {
+            if (const Value* value = m_builtIn.find(word)) {
+                return value;
+            }
+            size_t index = findAdded(word);
+            return index != NOT_FOUND ? &m_added[index].second : nullptr;
+        }
+
+        bool contains(std::wstring_view word) const {
+            return find(word) != nullptr;
+        }
+
+        size_t addedCount() const { return m_added.size(); }
+
+        void clearAdded() {
+            m_added.clear();
+            m_slots.clear();
+        }
+
+    private:
+        static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+        size_t findAdded(std::wstring_view word) const {
+            if (m_added.empty()) {
+                return NOT_FOUND;
+            }
+            size_t mask = m_slots.size() - 1;
+            for (size_t slot = hashFolded(word, m_builtIn.seed) & mask;; slot = (slot + 1) & mask) {
+                uint32_t index = m_slots[slot];
+                if (index == 0) {
+                    return NOT_FOUND;
+                }
+                if (CaseFolding::equalsFolded(m_added[index - 1].first, word)) {
+                    return index - 1;
+                }
+            }
+        }
+
+        void insertSlot(size_t index) {
+            size_t mask = m_slots.size() - 1;
+            size_t slot = hashFolded(m_added[index].first, m_builtIn.seed) & mask;
+            while (m_slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot] = static_cast<uint32_t>(index + 1);
+        }
+
+        void rehash(size_t size) {
+            m_slots.assign(size, 0);
+            for (size_t i = 0; i < m_added.size(); ++i) {
+                insertSlot(i);
+            }
+        }
+
+        TableView<Value> m_builtIn;
+        std::vector<std::pair<std::wstring, Value>> m_added;
+        std::vector<uint32_t> m_slots;
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "utils_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct AnalysisContext;
+
+/**
+ * @brief Rows of the BZ and term lists for one scan, ready to display
+ *
+ * Built on the scan thread right after the ConflictGraph and published to
+ * the UI as a shared_ptr<const ListSnapshot>. The virtual list models read
+ * their cells straight from it while painting, so refreshing the lists is a
+ * pointer swap and a new row count. Everything is copied out of the scan
+ * arena: a snapshot stays valid while the next scan clears and refills the
+ * AnalysisContext.
+ *
+ * build() also diffs the rows against the snapshot the UI currently shows,
+ * so a rescan after a small edit updates a few rows in place instead of
+ * resetting the lists (and losing their selection and scroll position).
+ */
+struct ListSnapshot {
+    // One reference sign, in BZ order (bzToStems)
+    struct BzRow {
+        std::wstring bz;
+        std::wstring terms;      // First spelling of each of its terms, "Welle; Lager"
+        std::wstring firstTerm;  // firstSpelling() of the term of its first occurrence
+        bool flagged = false;    // Warning icon: conflicting and not cleared
+
+        bool operator==(const BzRow& other) const = default;
+    };
+
+    // One term, in order of its first occurrence
+    struct TermRow {
+        StemVector stem;
+        std::wstring term;             // First spelling
+        std::vector<std::wstring> bzs;  // Numeric order
+        std::wstring bzText;           // "10, 12"
+        bool flagged = false;
+
+        bool operator==(const TermRow& other) const = default;
+    };
+
+    /**
+     * @brief Row operations that turn the rows of the base snapshot into these
+     *
+     * Rows are matched by BZ or stem; matched rows that would have to move
+     * are deleted and inserted again. Apply the deletions, then the
+     * insertions in ascending order, then the changes.
+     */
+    struct Diff {
+        uint64_t baseGeneration = 0;  // 0: no base, show the rows from scratch
+        std::vector<unsigned int> deleted;   // Rows of the base, ascending
+        std::vector<unsigned int> inserted;  // Rows of this snapshot, ascending
+        std::vector<std::pair<unsigned int, unsigned int>> changed;  // (base row, row) with different cells
+
+        size_t operations() const { return deleted.size() + inserted.size() + changed.size(); }
+    };
+
+    uint64_t generation = 0;  // Unique per snapshot
+    std::vector<BzRow> bzRows;
+    std::vector<TermRow> termRows;
+    Diff bzDiff;
+    Diff termDiff;
+
+    /**
+     * @brief Rows of a finished scan of text; ctx.conflicts must be built
+     * @param base Snapshot currently displayed, to diff against (may be null)
+     */
+    static std::shared_ptr<const ListSnapshot> build(const AnalysisContext& ctx, const std::wstring& text,
+                                                     const ListSnapshot* base = nullptr);
+
+    size_t memoryBytes() const;
+};
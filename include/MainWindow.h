@@ -4,12 +4,18 @@
 #include "OrdinalDetector.h"
 #include "RE2RegexHelper.h"
 #include "AnalysisContext.h"
+#include "EditSession.h"
+#include "DocumentLoader.h"
+#include "ErrorIndex.h"
+#include "ReportExporter.h"
+#include "ScanPipeline.h"
+#include "SnapshotListModel.h"
 #include "utils.h"
 #include "wx/notebook.h"
 #include "wx/richtext/richtextctrl.h"
 #include "wx/textctrl.h"
 #include "wx/timer.h"
-#include "wx/treelist.h"
+#include "wx/gauge.h"
 #include <map>
 #include <memory>
 #include <re2/re2.h>
@@ -20,6 +26,10 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+#include <vector>
 
 class MainWindow : public wxFrame {
   // Forward declaration for testing
@@ -27,6 +37,12 @@ class MainWindow : public wxFrame {
 public:
   MainWindow();
 
+  // Append every edit of this session to a file for LatencyReplay (bz_replay)
+  void startSessionRecording(const std::string &path);
+
+  // Replace the text with a UTF-8, UTF-16 or Latin-1 file, loaded in the background
+  void openFile(const std::string &path);
+
 private:
   // Setup methods
   void setupUi();
@@ -38,18 +54,12 @@ private:
   void scanTextBackground();
   void updateUIAfterScan();
   void debounceFunc(wxCommandEvent &event);
+  // Shift m_paragraphStarts along with an insertion or deletion in the text box
+  void onTextContentChanged(wxRichTextEvent &event);
 
   // Display methods
-  void fillListTree();
-  void fillBzList();
-  void fillTermList();
-  bool isUniquelyAssigned(const std::wstring &bz);
-  std::wstring getFirstOccurrenceWord(const StemVector& stem) const;
-
-  // Error detection
-  void findUnnumberedWords();
-  void checkArticleUsage();
-  void highlightConflicts();
+  void publishLists();
+  void highlightErrors();
 
   // Navigation methods
   void selectNextAllError(wxCommandEvent &event);
@@ -62,60 +72,89 @@ private:
   void selectPreviousWrongArticle(wxCommandEvent &event);
 
   // Context menu handling
-  void onTreeListContextMenu(wxTreeListEvent &event);
-  void onTermListContextMenu(wxTreeListEvent &event);
-  void onTreeListItemActivated(wxTreeListEvent &event);
-  void onTermListItemActivated(wxTreeListEvent &event);
+  void onTreeListContextMenu(wxDataViewEvent &event);
+  void onTermListContextMenu(wxDataViewEvent &event);
+  void onTreeListItemActivated(wxDataViewEvent &event);
+  void onTermListItemActivated(wxDataViewEvent &event);
+  void onBzListContextMenu(wxDataViewEvent &event);
   void onTextRightClick(wxMouseEvent &event);
   void clearTextError(size_t start, size_t end);
   bool isPositionCleared(size_t start, size_t end) const;
+  // Apply change to the decisions in m_ctx and rescan; queued while a scan holds m_dataMutex.
+  // Must not be called with m_dataMutex held.
+  void changeDecisions(std::function<void()> change);
+  // Show menu and return the chosen id (m_popupChoice instead of the user, in tests)
+  int choosePopupItem(wxMenu &menu, const wxPoint &position = wxDefaultPosition);
+  // Lock on m_dataMutex, not owned while a scan replaces the arena-backed results
+  std::unique_lock<std::mutex> tryLockResults();
+  // Text the shown error positions refer to (m_fullText may already be rescanned)
+  const std::wstring &shownText() const { return m_fullTextShown ? m_fullText : m_shownText; }
 
   // Menu handlers for restoring errors
   void onRestoreTextboxErrors(wxCommandEvent &event);
   void onRestoreOverviewErrors(wxCommandEvent &event);
   void onRestoreAllErrors(wxCommandEvent &event);
+  void onRestoreIgnoredWords(wxCommandEvent &event);
+  void onShowStatistics(wxCommandEvent &event);
+  void onShowMemoryReport(wxCommandEvent &event);
+  void showTextDialog(const wxString &title, const std::string &text);
+  void onOpenFile(wxCommandEvent &event);
+  void onExportReport(wxCommandEvent &event);
+  void onSaveSession(wxCommandEvent &event);
+  void onClose(wxCloseEvent &event);
+  void saveSession();
+  // Write the shown results; refused (false) while a scan or a rescan for changed decisions is pending
+  bool exportReport(const std::string &path, ReportExporter::Format format);
+  // Show the results saved next to documentPath instead of scanning; false if a scan is needed
+  bool restoreSession(const std::string &documentPath);
   void toggleMultiWordTerm(const std::wstring &baseStem);
   void clearError(const std::wstring &bz);
+  // Never treat word as a term (AnalysisContext::ignoredWords)
+  void ignoreWord(const std::wstring &word);
 
   // Help menu
   void onAbout(wxCommandEvent &event);
 
-    // RE2 regex patterns (optimized for performance)
-    // Single word + number: captures (word)(number)
-    // Pattern: word followed by whitespace and number
-    re2::RE2 m_singleWordRegex;
-
-    // Two words + number: captures (word1)(word2)(number)
-    // Pattern: word followed by word followed by number
-    re2::RE2 m_twoWordRegex;
-
-    // Single word (for finding unnumbered references)
-    re2::RE2 m_wordRegex;
+  // File loading: chunks arrive via CallAfter, tagged with the load generation
+  void appendLoadedChunk(uint64_t generation, const std::wstring &chunk,
+                         size_t bytesDone, size_t bytesTotal);
+  void finishLoad(uint64_t generation, const std::string &path,
+                  const DocumentLoader::Result &result);
+  void cancelLoad();
 
 public:
-  // Current text analyzer (polymorphic)
-  std::unique_ptr<TextAnalyzer> m_currentAnalyzer;
-
   // Test accessors
   AnalysisContext& getContext() { return m_ctx; }
+  TextAnalyzer* getAnalyzer() { return &m_pipeline.analyzer(); }
   wxRichTextCtrl* getTextBox() { return m_textBox; }
-  std::vector<std::pair<int, int>>& getWrongTermBzPositions() { return m_wrongTermBzPositions; }
-  std::vector<std::pair<int, int>>& getNoNumberPositions() { return m_noNumberPositions; }
+  const ErrorPositions& getWrongTermBzPositions() const { return m_pipeline.wrongTermBzErrors(); }
+  const ErrorPositions& getNoNumberPositions() const { return m_pipeline.noNumberErrors(); }
   std::shared_ptr<wxStaticText> getNoNumberLabel() { return m_noNumberLabel; }
-  std::shared_ptr<wxRichTextCtrl> getBzList() { return m_bzList; }
-  std::shared_ptr<wxTreeListCtrl> getTermList() { return m_termList; }
-  std::shared_ptr<wxTreeListCtrl> getTreeList() { return m_treeList; }
+  std::shared_ptr<wxDataViewCtrl> getBzList() { return m_bzList; }
+  std::shared_ptr<wxDataViewCtrl> getTermList() { return m_termList; }
+  std::shared_ptr<wxDataViewCtrl> getTreeList() { return m_treeList; }
+  SnapshotListModel* getTreeModel() { return m_treeModel.get(); }
+  SnapshotListModel* getTermModel() { return m_termModel.get(); }
   void testToggleMultiWord(const std::wstring& stem) { toggleMultiWordTerm(stem); }
   void testClearError(const std::wstring& bz) { clearError(bz); }
   void testRestoreAllErrors() { wxCommandEvent e; onRestoreAllErrors(e); }
+  void testRestoreIgnoredWords() { wxCommandEvent e; onRestoreIgnoredWords(e); }
   void testOnLanguageChanged() { wxCommandEvent e; onLanguageChanged(e); }
   wxRadioBox* getLanguageSelector() { return m_languageSelector; }
   wxTimer& getDebounceTimer() { return m_debounceTimer; }
   void testScanText(wxTimerEvent& event) { scanText(event); }
   void testDebounceFunc(wxCommandEvent& event) { debounceFunc(event); }
+  void setPopupChoice(std::function<int(wxMenu&)> choice) { m_popupChoice = std::move(choice); }
 
 private:
   std::wstring m_fullText;
+  // Paragraph table m_fullText is scanned with, taken from m_paragraphStarts by scanText()
+  std::vector<uint32_t> m_fullTextParagraphs;
+
+  // Last file loaded with openFile(), "" for typed text; source of exported reports
+  std::string m_documentPath;
+  // Paragraph table of the loaded Word document, shifted along with every edit (UI thread only)
+  std::vector<uint32_t> m_paragraphStarts;
 
   // Text styles
   wxTextAttr m_neutralStyle;
@@ -126,13 +165,44 @@ private:
   // Debounce timer for text changes
   wxTimer m_debounceTimer;
 
+  // Replaces the user's choice in context menus (tests only)
+  std::function<int(wxMenu &)> m_popupChoice;
+
+  // Set while recording an edit session (BZ_RECORD_SESSION)
+  std::unique_ptr<EditSession::Recorder> m_sessionRecorder;
+
   // Thread synchronization for background scanning
   std::jthread m_scanThread;
   std::mutex m_dataMutex;
   std::atomic<bool> m_cancelScan{false};
-
-  // Application state and analysis results
-  AnalysisContext m_ctx;
+  // Whether m_ctx holds the complete scan of m_fullText (guarded by m_dataMutex)
+  bool m_resultsValid{false};
+  // Decision changes made while a scan held m_dataMutex, applied in order
+  // when its result is published (UI thread only)
+  std::vector<std::function<void()>> m_pendingDecisions;
+  // Whether the UI shows the results of m_fullText; if not, m_shownText holds
+  // the text it shows while m_fullText is scanned (UI thread only)
+  bool m_fullTextShown{false};
+  std::wstring m_shownText;
+
+  // Background file loading. At most MAX_CHUNKS_IN_FLIGHT decoded chunks wait
+  // in the event queue, so a large file is never held twice in memory.
+  static constexpr size_t MAX_CHUNKS_IN_FLIGHT = 2;
+  bool m_loading{false};
+  bool m_loadScanStarted{false};
+  uint64_t m_loadGeneration{0};
+  size_t m_chunksInFlight{0};
+  std::mutex m_loadMutex;
+  std::condition_variable_any m_loadCondition;
+  wxGauge *m_loadGauge{nullptr};
+  // Declared after the state it uses: destroyed (stopped and joined) first
+  std::jthread m_loadThread;
+
+  // Scan, detection and their results (guarded by m_dataMutex); the scan
+  // thread runs it, the UI thread shows its error lists
+  ScanPipeline m_pipeline;
+  // m_pipeline.context(): the decisions and the last scan
+  AnalysisContext &m_ctx;
 
   // keeping track of the position of the cursor when browsing occurences
   std::unordered_map<std::wstring, int> m_bzCurrentOccurrence;
@@ -143,10 +213,18 @@ private:
   wxRichTextCtrl *m_textBox;
   wxRadioBox *m_languageSelector;
   void onLanguageChanged(wxCommandEvent &event);
-  std::shared_ptr<wxRichTextCtrl> m_bzList;
-  std::shared_ptr<wxTreeListCtrl> m_termList;
-  std::shared_ptr<wxImageList> m_imageList;
-  std::shared_ptr<wxTreeListCtrl> m_treeList;
+  std::shared_ptr<wxDataViewCtrl> m_bzList;
+  std::shared_ptr<wxDataViewCtrl> m_termList;
+  std::shared_ptr<wxDataViewCtrl> m_treeList;
+
+  // Virtual models of the three lists, all showing m_listSnapshot
+  wxObjectDataPtr<SnapshotListModel> m_bzModel;
+  wxObjectDataPtr<SnapshotListModel> m_termModel;
+  wxObjectDataPtr<SnapshotListModel> m_treeModel;
+  // Rows of the last scan, built on the scan thread as a diff against the
+  // rows the models show (both guarded by m_dataMutex)
+  std::shared_ptr<const ListSnapshot> m_listSnapshot;
+  std::shared_ptr<const ListSnapshot> m_shownListSnapshot;
 
   // Navigation buttons
   std::shared_ptr<wxButton> m_buttonForwardAllErrors;
@@ -158,20 +236,16 @@ private:
   std::shared_ptr<wxButton> m_buttonForwardWrongArticle;
   std::shared_ptr<wxButton> m_buttonBackwardWrongArticle;
 
-  // Error position lists: stores (start, end) position pairs
-  std::vector<std::pair<int, int>> m_allErrorsPositions;
+  // Selected entry and "N/Total" label of each error list of m_pipeline
   int m_allErrorsSelected{-1};
   std::shared_ptr<wxStaticText> m_allErrorsLabel;
 
-  std::vector<std::pair<int, int>> m_noNumberPositions;
   int m_noNumberSelected{-1};
   std::shared_ptr<wxStaticText> m_noNumberLabel;
 
-  std::vector<std::pair<int, int>> m_wrongTermBzPositions;
   int m_wrongTermBzSelected{-1};
   std::shared_ptr<wxStaticText> m_wrongTermBzLabel;
 
-  std::vector<std::pair<int, int>> m_wrongArticlePositions;
   int m_wrongArticleSelected{-1};
   std::shared_ptr<wxStaticText> m_wrongArticleLabel;
 };
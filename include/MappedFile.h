@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Pages are loaded by the OS on first access, so opening a large file costs
+ * no copy and the decoder reads it sequentially straight from the page cache.
+ * Empty files map to data() == nullptr, size() == 0. The constructor throws
+ * std::runtime_error when the file cannot be opened or mapped.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Per-structure memory accounting for large documents
+ *
+ * Each major structure adds its estimated bytes to a report
+ * (ReferenceDatabase::reportMemory, TextAnalyzer::getCacheMemoryBytes, ...).
+ * ScanPipeline and MainWindow assemble the full report; bz_cli
+ * --memory-report and Tools -> Memory report... print it.
+ *
+ * Sizes are estimates computed from container capacities plus typical
+ * node and bucket overhead (see MemoryUsage), without allocator rounding.
+ * They are meant for comparing structures and catching regressions.
+ */
+class MemoryReport {
+public:
+    struct Entry {
+        std::string name;
+        size_t bytes;
+        bool transient;  // Only alive during a scan pass (peak, not steady state)
+    };
+
+    void add(std::string name, size_t bytes, bool transient = false);
+
+    const std::vector<Entry>& entries() const { return m_entries; }
+    size_t totalBytes() const;
+
+    // Bytes of the entry with this name, 0 if absent
+    size_t bytesOf(const std::string& name) const;
+
+    // Size of the scanned document, for the per-million-characters column
+    void setInputCharacters(size_t characters) { m_inputCharacters = characters; }
+    size_t inputCharacters() const { return m_inputCharacters; }
+    double bytesPerMillionCharacters() const;
+
+    // Human-readable table, largest entries first
+    void write(std::ostream& out) const;
+
+    // Resident set size of this process, 0 where not available
+    static size_t processResidentBytes();
+
+private:
+    std::vector<Entry> m_entries;
+    size_t m_inputCharacters = 0;
+};
+
+/**
+ * @brief Heap-size estimates for the standard containers used by the scanner
+ *
+ * heapBytes(x) is the memory owned by x outside sizeof(x): string buffers
+ * beyond the small-string buffer, vector capacity, and per-node/bucket
+ * storage of node-based containers, recursively for their elements.
+ */
+namespace MemoryUsage {
+    // Per-node bookkeeping (libstdc++: next pointer + cached hash; rb-tree header)
+    inline constexpr size_t HASH_NODE_OVERHEAD = 2 * sizeof(void*);
+    inline constexpr size_t TREE_NODE_OVERHEAD = 4 * sizeof(void*);
+
+    template <typename T>
+    size_t heapBytes(const T&);
+    template <typename C, typename Tr, typename A>
+    size_t heapBytes(const std::basic_string<C, Tr, A>& s);
+    template <typename A, typename B>
+    size_t heapBytes(const std::pair<A, B>& p);
+    template <typename T, typename A>
+    size_t heapBytes(const std::vector<T, A>& v);
+    template <typename K, typename H, typename E, typename A>
+    size_t heapBytes(const std::unordered_set<K, H, E, A>& s);
+    template <typename K, typename V, typename H, typename E, typename A>
+    size_t heapBytes(const std::unordered_map<K, V, H, E, A>& m);
+    template <typename K, typename C, typename A>
+    size_t heapBytes(const std::set<K, C, A>& s);
+    template <typename K, typename V, typename C, typename A>
+    size_t heapBytes(const std::map<K, V, C, A>& m);
+
+    // Scalars and other types without owned storage
+    template <typename T>
+    size_t heapBytes(const T&) {
+        return 0;
+    }
+
+    template <typename C, typename Tr, typename A>
+    size_t heapBytes(const std::basic_string<C, Tr, A>& s) {
+        static const size_t inlineCapacity = std::basic_string<C, Tr, A>().capacity();
+        return s.capacity() > inlineCapacity ? (s.capacity() + 1) * sizeof(C) : 0;
+    }
+
+    template <typename A, typename B>
+    size_t heapBytes(const std::pair<A, B>& p) {
+        return heapBytes(p.first) + heapBytes(p.second);
+    }
+
+    template <typename Range>
+    size_t elementHeapBytes(const Range& range) {
+        size_t bytes = 0;
+        if constexpr (!std::is_trivially_copyable_v<typename Range::value_type>) {
+            for (const auto& element : range) {
+                bytes += heapBytes(element);
+            }
+        }
+        return bytes;
+    }
+
+    template <typename T, typename A>
+    size_t heapBytes(const std::vector<T, A>& v) {
+        return v.capacity() * sizeof(T) + elementHeapBytes(v);
+    }
+
+    template <typename K, typename H, typename E, typename A>
+    size_t heapBytes(const std::unordered_set<K, H, E, A>& s) {
+        return s.bucket_count() * sizeof(void*) + s.size() * (HASH_NODE_OVERHEAD + sizeof(K)) +
+               elementHeapBytes(s);
+    }
+
+    template <typename K, typename V, typename H, typename E, typename A>
+    size_t heapBytes(const std::unordered_map<K, V, H, E, A>& m) {
+        return m.bucket_count() * sizeof(void*) +
+               m.size() * (HASH_NODE_OVERHEAD + sizeof(std::pair<const K, V>)) + elementHeapBytes(m);
+    }
+
+    template <typename K, typename C, typename A>
+    size_t heapBytes(const std::set<K, C, A>& s) {
+        return s.size() * (TREE_NODE_OVERHEAD + sizeof(K)) + elementHeapBytes(s);
+    }
+
+    template <typename K, typename V, typename C, typename A>
+    size_t heapBytes(const std::map<K, V, C, A>& m) {
+        return m.size() * (TREE_NODE_OVERHEAD + sizeof(std::pair<const K, V>)) + elementHeapBytes(m);
+    }
+}
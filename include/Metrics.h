@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Process-wide counters and histograms for the scan pipeline
+ *
+ * Metrics are registered by name (plus an optional Prometheus label set) and
+ * live for the whole process; the returned references stay valid, so hot
+ * paths look them up once into a function-local static and then only do a
+ * relaxed atomic add:
+ *
+ *   static Metrics::Counter& hits = Metrics::counter("bz_stem_cache_hits_total", "...");
+ *   hits.add();
+ *
+ * writeText() dumps everything in the Prometheus text exposition format; the
+ * GUI statistics dialog and bz_cli --stats / --metrics-file use it.
+ */
+namespace Metrics {
+    class Counter {
+    public:
+        void add(uint64_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+        uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+        void reset() { m_value.store(0, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> m_value{0};
+    };
+
+    /**
+     * @brief Fixed-bucket histogram (cumulative "le" buckets on export)
+     */
+    class Histogram {
+    public:
+        explicit Histogram(std::vector<double> upperBounds);
+
+        void observe(double value);
+
+        const std::vector<double>& upperBounds() const { return m_upperBounds; }
+        // Per-bucket (non-cumulative) counts; the last entry is the +Inf bucket
+        std::vector<uint64_t> bucketCounts() const;
+        uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+        double sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+        // Upper bound of the bucket holding the q-quantile (0 < q <= 1)
+        double quantileUpperBound(double q) const;
+
+        void reset();
+
+    private:
+        std::vector<double> m_upperBounds;
+        std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+        std::atomic<uint64_t> m_count{0};
+        std::atomic<double> m_sum{0.0};
+    };
+
+    // Millisecond buckets for scan and UI latencies
+    inline const std::vector<double> LATENCY_BUCKETS_MS = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000,
+    };
+
+    /**
+     * @brief Register (or find) a metric
+     *
+     * labels is the inside of a Prometheus label set, e.g. size="1M". Name,
+     * help and type must be consistent across calls for the same name.
+     */
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& upperBounds, const std::string& labels = "");
+
+    // Label for latency-by-document-size histograms, named after the size
+    // class's upper bound: size="10K" (< 10,000 chars) ... size="10M+"
+    std::string sizeLabel(size_t characters);
+
+    // Zero every value; registrations stay
+    void resetAll();
+
+    void writeText(std::ostream& out);
+
+    // Write via a temporary file and rename, so a scraper never sees half a file
+    bool writeTextFile(const std::string& path);
+}
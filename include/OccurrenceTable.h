@@ -0,0 +1,191 @@
+#pragma once
+
+#include "utils_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief How an occurrence was matched
+ */
+enum class OccurrenceKind : uint8_t {
+    SINGLE_WORD,  // "Lager 10"
+    MULTI_WORD    // "erstes Lager 10"
+};
+
+class OccurrenceTable;
+
+/**
+ * @brief Read-only view of the (start, length) positions of one BZ or stem
+ *
+ * Iterates a CSR index slice; elements are produced by value as
+ * std::pair<size_t, size_t> so existing `auto [start, len]` loops keep working.
+ */
+class PositionRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<size_t, size_t>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator() = default;
+        iterator(const uint32_t* index, const OccurrenceTable* table)
+            : m_index(index), m_table(table) {}
+
+        value_type operator*() const;
+        value_type operator[](difference_type n) const { return *(*this + n); }
+        uint32_t occurrence() const { return *m_index; }
+
+        iterator& operator++() { ++m_index; return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++m_index; return tmp; }
+        iterator& operator--() { --m_index; return *this; }
+        iterator operator--(int) { iterator tmp = *this; --m_index; return tmp; }
+        iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        friend iterator operator+(iterator it, difference_type n) { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) { return a.m_index - b.m_index; }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_index == b.m_index; }
+        friend auto operator<=>(const iterator& a, const iterator& b) { return a.m_index <=> b.m_index; }
+
+    private:
+        const uint32_t* m_index = nullptr;
+        const OccurrenceTable* m_table = nullptr;
+    };
+
+    PositionRange() = default;
+    PositionRange(const uint32_t* first, const uint32_t* last, const OccurrenceTable* table)
+        : m_first(first), m_last(last), m_table(table) {}
+
+    iterator begin() const { return {m_first, m_table}; }
+    iterator end() const { return {m_last, m_table}; }
+    size_t size() const { return static_cast<size_t>(m_last - m_first); }
+    bool empty() const { return m_first == m_last; }
+    std::pair<size_t, size_t> operator[](size_t i) const { return begin()[i]; }
+    std::pair<size_t, size_t> front() const { return (*this)[0]; }
+    std::pair<size_t, size_t> back() const { return (*this)[size() - 1]; }
+
+    // Occurrence indices into the owning table (document order)
+    const uint32_t* indexBegin() const { return m_first; }
+    const uint32_t* indexEnd() const { return m_last; }
+
+private:
+    const uint32_t* m_first = nullptr;
+    const uint32_t* m_last = nullptr;
+    const OccurrenceTable* m_table = nullptr;
+};
+
+/**
+ * @brief Flat structure-of-arrays storage for every matched occurrence
+ *
+ * Each occurrence is stored exactly once as (start, length, stem ID, BZ ID,
+ * kind) in parallel arrays. BZ strings and StemVectors are interned to dense
+ * IDs. After the scan, finalize() puts the rows into document order and builds
+ * CSR-style per-BZ and per-stem indexes (offsets + occurrence indices) in one
+ * counting pass, so "all positions of BZ 10" is a contiguous slice and "all
+ * occurrences in document order" is a linear sweep over the arrays.
+ *
+ * All arrays allocate from the given memory resource (normally the ScanArena).
+ */
+class OccurrenceTable {
+public:
+    static constexpr uint32_t NO_ID = UINT32_MAX;
+
+    explicit OccurrenceTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Interning
+    uint32_t internBz(const std::wstring& bz);
+    uint32_t internStem(const StemVector& stem);
+    uint32_t findBz(const std::wstring& bz) const;
+    uint32_t findStem(const StemVector& stem) const;
+    const std::wstring& bzName(uint32_t bzId) const { return m_bzNames[bzId]; }
+    const StemVector& stem(uint32_t stemId) const { return m_stems[stemId]; }
+    size_t bzCount() const { return m_bzNames.size(); }
+    size_t stemCount() const { return m_stems.size(); }
+
+    /**
+     * @brief Append an occurrence (any order; finalize() sorts)
+     */
+    void add(uint32_t bzId, uint32_t stemId, size_t start, size_t length, OccurrenceKind kind);
+
+    /**
+     * @brief Sort rows into document order and build the per-BZ/per-stem indexes
+     */
+    void finalize();
+    bool isFinalized() const { return m_finalized; }
+
+    // Column access (row i, document order after finalize())
+    size_t size() const { return m_start.size(); }
+    bool empty() const { return m_start.empty(); }
+    size_t start(size_t i) const { return m_start[i]; }
+    size_t length(size_t i) const { return m_length[i]; }
+    uint32_t stemId(size_t i) const { return m_stemId[i]; }
+    uint32_t bzId(size_t i) const { return m_bzId[i]; }
+    OccurrenceKind kind(size_t i) const { return m_kind[i]; }
+    const std::pmr::vector<uint32_t>& starts() const { return m_start; }
+
+    // CSR views (valid after finalize())
+    PositionRange positionsOfBz(uint32_t bzId) const;
+    PositionRange positionsOfStem(uint32_t stemId) const;
+
+    /**
+     * @brief Display form of a stem: its first occurrence in text without the trailing number
+     *
+     * "" if the stem has no occurrence. Used by the term lists, conflict
+     * descriptions, reports and ReferenceDatabase::stemToFirstWord.
+     */
+    std::wstring firstSpelling(uint32_t stemId, const std::wstring& text) const;
+
+    /**
+     * @brief Whether any occurrence starts exactly at pos (binary search)
+     */
+    bool hasOccurrenceStartingAt(size_t pos) const;
+
+    /**
+     * @brief Drop all rows and keys, returning every array's storage to the resource
+     */
+    void clear();
+
+    // Estimated bytes of all columns, indexes and interned keys
+    size_t memoryBytes() const;
+
+private:
+    std::pmr::memory_resource* m_resource;
+
+    // Occurrence columns
+    std::pmr::vector<uint32_t> m_start;
+    std::pmr::vector<uint32_t> m_length;
+    std::pmr::vector<uint32_t> m_stemId;
+    std::pmr::vector<uint32_t> m_bzId;
+    std::pmr::vector<OccurrenceKind> m_kind;
+
+    // Start index of each run of increasing start positions (scan passes append sorted runs)
+    std::pmr::vector<size_t> m_runStarts;
+
+    // CSR indexes: occurrences of BZ b are m_bzIndex[m_bzOffsets[b] .. m_bzOffsets[b + 1])
+    std::pmr::vector<uint32_t> m_bzOffsets;
+    std::pmr::vector<uint32_t> m_bzIndex;
+    std::pmr::vector<uint32_t> m_stemOffsets;
+    std::pmr::vector<uint32_t> m_stemIndex;
+
+    // Interned keys
+    std::pmr::vector<std::wstring> m_bzNames;
+    std::pmr::unordered_map<std::wstring, uint32_t> m_bzIds;
+    std::pmr::vector<StemVector> m_stems;
+    std::pmr::unordered_map<StemVector, uint32_t, StemVectorHash> m_stemIds;
+
+    bool m_finalized = false;
+};
+
+inline PositionRange::iterator::value_type PositionRange::iterator::operator*() const {
+    return {m_table->start(*m_index), m_table->length(*m_index)};
+}
@@ -3,10 +3,12 @@
 #include "utils_core.h"
 #include "RE2RegexHelper.h"
 #include "TextAnalyzer.h"
+#include "Lexicon.h"
 #include <re2/re2.h>
 #include <unordered_set>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Detects ordinal prefix patterns (first/second) for automatic multi-word term detection
@@ -57,7 +59,7 @@ private:
      * @param outType Output parameter: the ordinal type if found
      * @return true if the word is a German ordinal
      */
-    static bool isGermanOrdinal(const std::wstring& word, OrdinalType& outType);
+    static bool isGermanOrdinal(std::wstring_view word, OrdinalType& outType);
 
     /**
      * @brief Check if a word is an English ordinal and return its type
@@ -66,15 +68,9 @@ private:
      * @param outType Output parameter: the ordinal type if found
      * @return true if the word is an English ordinal
      */
-    static bool isEnglishOrdinal(const std::wstring& word, OrdinalType& outType);
+    static bool isEnglishOrdinal(std::wstring_view word, OrdinalType& outType);
 
-    // Static ordinal word sets for German (all common declensions)
-    static const std::unordered_set<std::wstring> s_germanFirstOrdinals;      // erste, ersten, erstes, erster
-    static const std::unordered_set<std::wstring> s_germanSecondOrdinals;     // zweite, zweiten, zweites, zweiter
-    static const std::unordered_set<std::wstring> s_germanThirdOrdinals;      // dritte, dritten, drittes, dritter
-
-    // Static ordinal word sets for English
-    static const std::unordered_set<std::wstring> s_englishFirstOrdinals;     // first
-    static const std::unordered_set<std::wstring> s_englishSecondOrdinals;    // second
-    static const std::unordered_set<std::wstring> s_englishThirdOrdinals;     // third
+    // Compile-time ordinal tables: word -> ordinal type (all common declensions)
+    static const Lexicon::TableView<OrdinalType> s_germanOrdinals;   // erste/zweite/dritte...
+    static const Lexicon::TableView<OrdinalType> s_englishOrdinals;  // first/second/third
 };
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Abstract, description and claims of a patent XML file as scan text
+ *
+ * Understands the publication formats built on WIPO ST.36 (EP, WO and US
+ * full-text XML) and the DocDB exchange format: elements are matched by
+ * local name, so namespace prefixes such as exch: do not matter. The file
+ * is tokenized with XmlReader straight from its memory mapping and the
+ * section text is decoded directly into the caller's buffer, which the
+ * scanner then reads; there is no DOM and no second copy of the document.
+ *
+ * Inside a section, p, heading, claim-text, li and table rows become lines;
+ * other whitespace, including the indentation of pretty-printed XML,
+ * collapses to single spaces. Formulae (maths, chemistry) and images are
+ * left out. Each kept section ends with '\n'; the sections follow each
+ * other in document order without gaps.
+ *
+ * Only sections in one language are kept (EP grants carry claims in three
+ * languages): the requested one, else the lang attribute of the root
+ * element, else that of the first section.
+ *
+ * Malformed XML and encodings other than UTF-8 throw std::runtime_error.
+ */
+class PatentXmlReader {
+public:
+    enum class SectionKind {
+        ABSTRACT,
+        DESCRIPTION,
+        CLAIMS
+    };
+
+    struct Section {
+        SectionKind kind = SectionKind::DESCRIPTION;
+        std::string language;  // Lowercase lang attribute, "" if none
+        size_t begin = 0;      // [begin, end) in the text
+        size_t end = 0;
+    };
+
+    struct Document {
+        std::string language;           // Language of the kept sections, "" if unknown
+        std::vector<Section> sections;  // Document order
+        size_t skippedSections = 0;     // Sections in other languages
+
+        // Section containing position, or nullptr
+        const Section* sectionAt(size_t position) const;
+    };
+
+    static const char* name(SectionKind kind);
+
+    // True if data starts like an XML document (optional BOM, whitespace, '<')
+    static bool looksLikeXml(const char* data, size_t size);
+
+    /**
+     * @brief Parse data and write the kept sections to text
+     *
+     * text is cleared first but keeps its capacity, so a batch that reuses
+     * one buffer per thread does not allocate per file. language ("de",
+     * "en", ...) overrides the document's own.
+     */
+    static Document read(const char* data, size_t size, std::wstring& text, std::string_view language = {});
+
+    // Same for a file, read through a MappedFile
+    static Document readFile(const std::string& path, std::wstring& text, std::string_view language = {});
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Performance regression gate: normalized timings against a baseline
+ *
+ * Every workload is timed several times in round-robin order, each run right
+ * after a run of a reference workload that does the same kind of work (the
+ * caller passes it; bz_perf_gate uses the frozen ReferenceScanner). The gate
+ * compares each workload's median time divided by the median reference time
+ * of the whole measurement. Clock speed, cache sizes and the compiler move
+ * both by about the same factor; a synthetic calibration loop does not cancel
+ * like that, its speed relative to the scanner changes with the CPU
+ * generation. Medians rather than minimums, because on a shared machine
+ * single runs swing by a third either way and the best of a few is luck.
+ *
+ * Baselines are small JSON files ({"version": 2, "workloads": {name:
+ * {"normalized": x, "tolerance": t}}}). The ratios carry over between
+ * similar machines but not between every pair of CPUs, so CI records its own
+ * baseline at the target branch before gating a change. A workload regresses
+ * when its throughput falls below (1 - tolerance) of the baseline's.
+ *
+ * Used by the bz_perf_gate tool (ctest label perf_tests) and the tests.
+ */
+class PerfGate {
+public:
+    struct Workload {
+        std::string name;
+        double tolerance = 0.15;     // Default for new baseline entries
+        std::function<void()> setup;  // Untimed, before every repetition (may be empty)
+        std::function<void()> run;
+    };
+
+    struct Measurement {
+        std::string name;
+        double seconds = 0;           // Median repetition
+        double referenceSeconds = 0;  // Median reference run of the whole measurement
+        double normalized = 0;        // seconds / referenceSeconds
+    };
+
+    struct BaselineEntry {
+        double normalized = 0;
+        double tolerance = 0.15;
+    };
+    using Baseline = std::map<std::string, BaselineEntry>;
+
+    struct Verdict {
+        std::string name;
+        std::optional<BaselineEntry> baseline;  // nullopt: workload not in the baseline
+        double normalized = 0;
+        double throughputRatio = 1;  // baseline / current; < 1 is slower
+        bool regressed = false;
+    };
+
+    // Format written by saveBaseline(); 1 was normalized by a calibration loop and is rejected
+    static constexpr int BASELINE_VERSION = 2;
+
+    /**
+     * @brief Time repetitions rounds of all workloads, each run preceded by a run of reference
+     *
+     * Setups (also the reference's) run untimed before every run.
+     */
+    static std::vector<Measurement> measure(const std::vector<Workload>& workloads, const Workload& reference,
+                                            int repetitions);
+
+    static Verdict judge(const Measurement& measurement, const std::optional<BaselineEntry>& baseline);
+
+    /**
+     * @brief Parse a baseline file; throws std::runtime_error when malformed
+     */
+    static Baseline loadBaseline(std::istream& in);
+    static void saveBaseline(std::ostream& out, const Baseline& baseline);
+
+    /**
+     * @brief Baseline with the measured values; tolerances of existing entries are kept
+     *
+     * Entries of workloads that were not measured stay untouched.
+     */
+    static Baseline updated(const Baseline& baseline, const std::vector<Workload>& workloads,
+                            const std::vector<Measurement>& measurements);
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <re2/re2.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <codecvt>
 #include <locale>
@@ -13,16 +14,22 @@
  */
 class RE2RegexHelper {
 public:
+    static constexpr size_t MAX_GROUPS = 8;
+
     /**
      * @brief Match result containing captured groups and position information
+     *
+     * Groups are views into the text passed to MatchIterator, so a match
+     * allocates nothing; copy a group into a std::wstring to keep it.
      */
     struct MatchResult {
-        std::vector<std::wstring> groups;  // Captured groups (group 0 is full match)
-        size_t position;                    // Start position in wstring
-        size_t length;                      // Length in wstring characters
+        std::wstring_view groups[MAX_GROUPS];  // Captured groups (group 0 is full match)
+        size_t groupCount = 0;
+        size_t position = 0;                    // Start position in wstring
+        size_t length = 0;                      // Length in wstring characters
 
         // Access captured groups by index
-        const std::wstring& operator[](size_t idx) const {
+        std::wstring_view operator[](size_t idx) const {
             return groups[idx];
         }
     };
@@ -32,19 +39,31 @@ public:
      */
     class MatchIterator {
     public:
-        MatchIterator(const std::wstring& text, const RE2& pattern);
+        // text must outlive the iterator and every MatchResult it returns;
+        // positions are relative to the start of text. Throws
+        // std::invalid_argument if pattern has more than MAX_GROUPS - 1 groups.
+        MatchIterator(std::wstring_view text, const RE2& pattern);
 
         bool hasNext() const { return m_hasMore; }
         MatchResult next();
 
+        // Heap bytes of the UTF-8 copy and the byte -> wchar position map
+        size_t utf8Bytes() const { return m_utf8Text.capacity(); }
+        size_t positionMapBytes() const { return m_wcharPositions.capacity() * sizeof(size_t); }
+
+        // The same sizes for an iterator over text, computed without building one
+        static size_t estimateUtf8Bytes(const std::wstring& text);
+        static size_t estimatePositionMapBytes(const std::wstring& text);
+
     private:
+        std::wstring_view m_text;
         std::string m_utf8Text;
         const RE2& m_pattern;
         size_t m_currentPos;
         bool m_hasMore;
         std::vector<size_t> m_wcharPositions;  // Maps UTF-8 byte pos -> wchar pos
 
-        void buildPositionMap(const std::wstring& text);
+        void buildPositionMap(std::wstring_view text);
         size_t utf8PosToWcharPos(size_t utf8Pos) const;
     };
 
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "utils_core.h"
+#include "OccurrenceTable.h"
+#include "MemoryReport.h"
 #include <map>
+#include <memory_resource>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -10,36 +13,71 @@
 
 /**
  * @brief Consolidates reference number and term mapping data
+ *
+ * Container nodes and arrays come from the memory resource passed at
+ * construction (the per-scan ScanArena in AnalysisContext). Keys keep their
+ * own std::wstring / StemVector storage.
  */
 struct ReferenceDatabase {
+    explicit ReferenceDatabase(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bzToStems(resource), stemToBz(resource), bzToOriginalWords(resource),
+          occurrences(resource), stemToFirstWord(resource), m_resource(resource) {}
+
     // Main data structure: BZ -> set of StemVectors
     // Example: "10" -> {{"lager"}, {"zweit", "lager"}}
-    std::map<std::wstring, std::unordered_set<StemVector, StemVectorHash>, BZComparatorForMap> bzToStems;
+    std::pmr::map<std::wstring, std::pmr::unordered_set<StemVector, StemVectorHash>, BZComparatorForMap> bzToStems;
 
     // Reverse mapping: StemVector -> set of BZs
     // Example: {"zweit", "lager"} -> {"12"}
-    std::unordered_map<StemVector, std::unordered_set<std::wstring>, StemVectorHash> stemToBz;
+    std::pmr::unordered_map<StemVector, std::pmr::unordered_set<std::wstring>, StemVectorHash> stemToBz;
 
     // Original (unstemmed) words for display
     // BZ -> set of original word strings
-    std::unordered_map<std::wstring, std::unordered_set<std::wstring>> bzToOriginalWords;
+    std::pmr::unordered_map<std::wstring, std::pmr::unordered_set<std::wstring>> bzToOriginalWords;
 
     // Position tracking for highlighting and navigation
-    // BZ -> list of (start, length) pairs
-    std::unordered_map<std::wstring, std::vector<std::pair<size_t, size_t>>> bzToPositions;
-
-    // StemVector -> list of (start, length) pairs
-    std::unordered_map<StemVector, std::vector<std::pair<size_t, size_t>>, StemVectorHash> stemToPositions;
+    // Every occurrence stored once; per-BZ and per-stem views are CSR slices
+    OccurrenceTable occurrences;
 
     // Cache of first occurrence words for display
-    std::unordered_map<StemVector, std::wstring, StemVectorHash> stemToFirstWord;
+    std::pmr::unordered_map<StemVector, std::wstring, StemVectorHash> stemToFirstWord;
+
+    void addOccurrence(const std::wstring& bz, const StemVector& stem,
+                       size_t start, size_t length, OccurrenceKind kind) {
+        occurrences.add(occurrences.internBz(bz), occurrences.internStem(stem),
+                        start, length, kind);
+    }
+
+    // Build document order and the per-BZ/per-stem indexes once the scan is done
+    void finalize() {
+        occurrences.finalize();
+    }
+
+    // (start, length) of every occurrence of a BZ / stem, in document order
+    PositionRange positionsOfBz(const std::wstring& bz) const {
+        return occurrences.positionsOfBz(occurrences.findBz(bz));
+    }
+
+    PositionRange positionsOfStem(const StemVector& stem) const {
+        return occurrences.positionsOfStem(occurrences.findStem(stem));
+    }
 
+    // One entry per container (node and array storage lives in the arena)
+    void reportMemory(MemoryReport& report) const {
+        report.add("ReferenceDatabase: bzToStems", MemoryUsage::heapBytes(bzToStems));
+        report.add("ReferenceDatabase: stemToBz", MemoryUsage::heapBytes(stemToBz));
+        report.add("ReferenceDatabase: bzToOriginalWords", MemoryUsage::heapBytes(bzToOriginalWords));
+        report.add("ReferenceDatabase: stemToFirstWord", MemoryUsage::heapBytes(stemToFirstWord));
+        report.add("OccurrenceTable", occurrences.memoryBytes());
+    }
+
+    // Reassign rather than clear() so no container keeps buckets in a released arena
     void clear() {
-        bzToStems.clear();
-        stemToBz.clear();
-        bzToOriginalWords.clear();
-        bzToPositions.clear();
-        stemToPositions.clear();
-        stemToFirstWord.clear();
+        *this = ReferenceDatabase(m_resource);
     }
+
+    std::pmr::memory_resource* resource() const { return m_resource; }
+
+private:
+    std::pmr::memory_resource* m_resource;
 };
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ScanSnapshot.h"
+#include "english_stem.h"
+#include "german_stem.h"
+#include <re2/re2.h>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Frozen reference engine for differential testing
+ *
+ * A deliberately plain re-implementation of ScanPipeline::run() as it behaves
+ * today: ordinal auto-detection, the two-word and single-word term passes per
+ * paragraph, and conflict, unnumbered-word and article detection, honouring
+ * the user's decisions (ScanDecisions). It keeps everything in ordered std
+ * containers, does its own UTF-8 conversion and position mapping and runs RE2
+ * directly, so it shares no code with RE2RegexHelper, TextScanner,
+ * ErrorDetectorHelper, OrdinalDetector, ReferenceDatabase, ConflictGraph,
+ * ClearedAnchors or the ScanArena.
+ *
+ * The language model is its own as well: lowercase folding written out from
+ * the Unicode case pairs instead of the CaseFolding table, letters classified
+ * by RE2's \p{L} instead of CharClass, article and ignored-word lists in
+ * std::set instead of the Lexicon tables, and the Oleander stemmers called
+ * directly. Only the stemmers and the regex patterns are shared.
+ *
+ * Do not optimize this class. When scan semantics change on purpose, change
+ * both engines in the same commit.
+ */
+class ReferenceScanner {
+public:
+    explicit ReferenceScanner(bool useGerman = true);
+
+    ScanSnapshot run(const std::wstring& text, const ScanDecisions& decisions = {});
+
+private:
+    struct Match {
+        size_t position;
+        size_t length;
+        std::vector<std::wstring> groups;  // Group 0 is the full match
+    };
+
+    struct Occurrence {
+        size_t start;
+        size_t length;
+        std::wstring bz;
+        StemVector stem;
+    };
+
+    // Every non-overlapping match of pattern, in text order
+    static std::vector<Match> findAll(const std::wstring& text, const re2::RE2& pattern);
+
+    // Language model
+    std::wstring stem(const std::wstring& word);
+    StemVector stemVector(const std::wstring& word) { return {stem(word)}; }
+    StemVector stemVector(const std::wstring& first, const std::wstring& second) {
+        return {stem(first), stem(second)};
+    }
+    bool isIgnoredWord(const std::wstring& word) const;
+    bool isDefiniteArticle(const std::wstring& word) const;
+    bool isIndefiniteArticle(const std::wstring& word) const;
+    bool isLetter(wchar_t c);
+
+    // The given ranges, and every place their text recurs with the same surroundings
+    static std::set<std::pair<size_t, size_t>> clearedRanges(const std::wstring& text,
+                                                             const std::set<std::pair<size_t, size_t>>& given);
+    bool isCleared(size_t start, size_t end) const { return m_cleared.count({start, end}) > 0; }
+
+    std::set<std::wstring> detectOrdinalStems(const std::wstring& text);
+    void scanTerms(const std::wstring& text, const std::vector<uint32_t>& paragraphStarts,
+                   const std::set<std::wstring>& multiWordStems);
+    void detectConflicts(const std::set<std::wstring>& clearedBz, ScanSnapshot& snapshot) const;
+    void detectUnnumberedWords(const std::wstring& text, const std::set<std::wstring>& multiWordStems,
+                               ScanSnapshot& snapshot);
+    void detectArticleErrors(const std::wstring& text, ScanSnapshot& snapshot);
+
+    bool isMultiWordBase(const std::wstring& word, const std::set<std::wstring>& multiWordStems);
+
+    bool m_useGerman;
+    stemming::german_stem<> m_germanStemmer;
+    stemming::english_stem<> m_englishStemmer;
+    re2::RE2 m_letterRegex;
+    std::map<wchar_t, bool> m_letters;  // isLetter() answers so far
+    re2::RE2 m_singleWordRegex;
+    re2::RE2 m_twoWordRegex;
+    re2::RE2 m_wordRegex;
+
+    // Per-run state
+    std::set<std::wstring> m_ignoredWords;  // Lowercase user words
+    std::set<std::pair<size_t, size_t>> m_cleared;
+    std::map<std::wstring, std::set<StemVector, StemVectorComparator>, BZComparatorForMap> m_bzToStems;
+    std::map<StemVector, std::set<std::wstring>, StemVectorComparator> m_stemToBz;
+    std::map<std::wstring, std::set<std::wstring>, BZComparatorForMap> m_bzToOriginalWords;
+    std::vector<Occurrence> m_occurrences;  // Document order after scanTerms()
+};
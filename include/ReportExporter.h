@@ -0,0 +1,63 @@
+#pragma once
+
+#include "AnalysisContext.h"
+#include "utils_core.h"
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+class ScanPipeline;
+
+/**
+ * @brief Machine-readable report of one scan: JSON, CSV or SARIF 2.1.0
+ *
+ * Serializes the ReferenceDatabase (reference number -> terms -> positions)
+ * and the error lists straight from the scan results. Output goes through a
+ * 64 KB buffer to the stream as it is produced, so memory does not grow
+ * with the report; only a line-start index of the text is built, for the
+ * line/column fields.
+ *
+ * Positions are half-open [start, end) character offsets into the scanned
+ * text, lines and columns are 1-based. All strings are UTF-8.
+ *
+ * - JSON: summary counts, references with their terms and occurrences,
+ *   errors with kind, position and snippet.
+ * - CSV (RFC 4180): one row per occurrence (kind "reference") and per error,
+ *   columns kind,bz,term,start,end,line,column,text.
+ * - SARIF: one run whose results are the errors, with rules
+ *   missing-number, wrong-term and wrong-article.
+ */
+class ReportExporter {
+public:
+    enum class Format {
+        JSON,
+        CSV,
+        SARIF
+    };
+
+    // Borrowed views of one scan; all must stay valid during write()
+    struct Report {
+        std::string source;    // Document path as given, "" for unsaved text
+        std::string language;  // "de" or "en"
+        const std::wstring& text;
+        const AnalysisContext& context;
+        const ErrorPositions& noNumber;
+        const ErrorPositions& wrongTermBz;
+        const ErrorPositions& wrongArticle;
+        const ErrorPositions& allErrors;
+    };
+
+    static Report fromPipeline(const ScanPipeline& pipeline, const std::wstring& text, std::string source,
+                               std::string language);
+
+    // "json", "csv" or "sarif" (case-sensitive); false if unknown
+    static bool parseFormat(std::string_view name, Format& format);
+
+    // File extension including the dot
+    static const char* extension(Format format);
+
+    static void write(std::ostream& out, Format format, const Report& report);
+
+    // False if the file cannot be written
+    static bool writeFile(const std::string& path, Format format, const Report& report);
+};
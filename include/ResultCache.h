@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+struct AnalysisContext;
+class ScanPipeline;
+
+/**
+ * @brief Content-addressed cache of scan results on local disk
+ *
+ * Entries are session files (SessionFile) named after key(): the hash of the
+ * text, its length, its paragraph table, the language,
+ * SessionFile::ANALYZER_VERSION and the decisions that change the results
+ * (manual multi-word toggles and exclusions, cleared numbers and text
+ * anchors). A document that was analyzed before with the same settings is
+ * then restored by ScanPipeline::restore() instead of scanned, whatever file
+ * or family member it came from.
+ *
+ * The directory is kept under maxBytes by evicting the least recently used
+ * entries; use is tracked in memory and in the file modification times, so
+ * the order survives restarts. Safe to share between threads; several
+ * processes may use the same directory (an entry another one evicted is a
+ * miss).
+ */
+class ResultCache {
+public:
+    static constexpr uint64_t DEFAULT_MAX_BYTES = 256ull << 20;
+
+    // Creates directory if needed; throws std::runtime_error if it cannot
+    explicit ResultCache(const std::filesystem::path& directory, uint64_t maxBytes = DEFAULT_MAX_BYTES);
+
+    // paragraphStarts as passed to ScanPipeline::run; none leaves the key of the plain text
+    static uint64_t key(const std::wstring& text, bool german, const AnalysisContext& ctx,
+                        std::span<const uint32_t> paragraphStarts = {});
+
+    /**
+     * @brief Restore the results for text into pipeline if they are cached
+     *
+     * Uses the pipeline's language and current decisions for the key. Returns
+     * false on a miss; damaged entries are removed and count as misses.
+     */
+    bool lookup(ScanPipeline& pipeline, const std::wstring& text, std::span<const uint32_t> paragraphStarts = {});
+
+    /**
+     * @brief Store the results of pipeline.run(text, paragraphStarts), then evict down to maxBytes
+     *
+     * Entries that are already cached (or being written by another thread)
+     * are skipped. Throws std::runtime_error if the entry cannot be written.
+     */
+    void store(const ScanPipeline& pipeline, const std::wstring& text,
+               std::span<const uint32_t> paragraphStarts = {});
+
+    size_t entryCount() const;
+    uint64_t sizeBytes() const;
+    uint64_t maxBytes() const { return m_maxBytes; }
+
+private:
+    struct Entry {
+        uint64_t bytes = 0;
+        uint64_t lastUse = 0;  // Tick of m_clock, or file time order for entries found on disk
+    };
+
+    std::filesystem::path pathFor(uint64_t key) const;
+    void touch(uint64_t key, const std::filesystem::path& path);
+    void forget(uint64_t key);
+    void evictLocked();
+
+    std::filesystem::path m_directory;
+    uint64_t m_maxBytes;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::unordered_set<uint64_t> m_writing;
+    uint64_t m_totalBytes = 0;
+    uint64_t m_clock = 0;
+};
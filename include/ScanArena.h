@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * @brief Monotonic memory arena for everything that lives for one scan
+ *
+ * Per-scan containers (ReferenceDatabase, OccurrenceTable, intermediate match
+ * lists, error position vectors) allocate from resource(). Deallocation is a
+ * no-op; reset() releases the whole scan at once. The initial buffer grows to
+ * the previous scan's high-water mark, so a rescan of a similar document is
+ * served from one block without touching the global heap.
+ *
+ * Every container allocated from the arena must be destroyed or reassigned
+ * to a fresh empty container before reset() is called.
+ */
+class ScanArena {
+public:
+    static constexpr size_t DEFAULT_INITIAL_SIZE = 64 * 1024;
+
+    explicit ScanArena(size_t initialSize = DEFAULT_INITIAL_SIZE);
+
+    ScanArena(const ScanArena&) = delete;
+    ScanArena& operator=(const ScanArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &m_counter; }
+
+    /**
+     * @brief Release all per-scan memory in O(1)
+     *
+     * If the finished scan outgrew the initial buffer, the buffer is
+     * reallocated once to the high-water size for the next scan.
+     */
+    void reset();
+
+    // Instrumentation (bytes requested by containers, excluding arena overhead)
+    size_t bytesInUse() const { return m_counter.bytesInUse; }
+    size_t lastScanBytes() const { return m_lastScanBytes; }
+    size_t peakBytes() const { return std::max(m_peakBytes, m_counter.bytesInUse); }
+    size_t bufferSize() const { return m_bufferSize; }
+
+private:
+    // Forwards to the monotonic resource and counts requested bytes
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        std::pmr::memory_resource* upstream = nullptr;
+        size_t bytesInUse = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    void createResource();
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_bufferSize;
+    std::optional<std::pmr::monotonic_buffer_resource> m_monotonic;
+    CountingResource m_counter;
+
+    size_t m_lastScanBytes = 0;
+    size_t m_peakBytes = 0;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "AnalysisContext.h"
+#include "ErrorIndex.h"
+#include "MemoryReport.h"
+#include "TextAnalyzer.h"
+#include "utils_core.h"
+#include <re2/re2.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class SessionFile;
+
+/**
+ * @brief The scan and detection of a text, without a text control
+ *
+ * run() performs ordinal auto-detection, the term scan, the first-spelling
+ * table, and detection of conflicting numbers, unnumbered words and article
+ * usage, and records scan metrics. MainWindow calls it on its scan thread
+ * and only applies the resulting error lists as highlights; the command-line
+ * tools and tests call it directly. Results stay valid until the next run().
+ */
+class ScanPipeline {
+public:
+    explicit ScanPipeline(bool useGerman = true);
+
+    /**
+     * @brief Scan text and detect its errors
+     * @param paragraphStarts As for TextScanner::scanText: the loaded document's table, or none
+     * @param cancel Checked between the phases; once set, run() stops and returns false
+     *        with the results cleared or incomplete
+     */
+    bool run(const std::wstring& text, std::span<const uint32_t> paragraphStarts = {},
+             const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief Take the scan results of text from a session instead of scanning
+     *
+     * Restores session into context() and, if it was written by save(), the
+     * error lists and flagged numbers as well; only the conflict graph and
+     * the error index are rebuilt. Other sessions run the detection half.
+     * Returns false (and changes nothing) if the session was saved for other
+     * text or in the other language.
+     */
+    bool restore(const SessionFile& session, const std::wstring& text);
+
+    // SessionFile::save() of the last run() on text, with its detection results
+    void save(const std::string& path, const std::wstring& text) const;
+
+    AnalysisContext& context() { return m_ctx; }
+    const AnalysisContext& context() const { return m_ctx; }
+    // Replaced by setLanguage() and when a word leaves context().ignoredWords;
+    // user ignored words belong in context().ignoredWords, which run() adds to it
+    TextAnalyzer& analyzer() { return *m_analyzer; }
+    bool german() const;
+
+    /**
+     * @brief Switch the analyzer, keeping the decisions in context()
+     *
+     * Auto-detected multi-word stems belong to the old language and are
+     * dropped; the results stay those of the last run() until the next one.
+     */
+    void setLanguage(bool useGerman);
+
+    // Error message of the first regex pattern that failed to compile, "" if all did
+    std::string patternError() const;
+
+    // All lists are sorted and de-duplicated; allErrors() is their merge
+    const ErrorPositions& allErrors() const { return m_allErrorsPositions; }
+    const ErrorPositions& noNumberErrors() const { return m_noNumberPositions; }
+    const ErrorPositions& wrongTermBzErrors() const { return m_wrongTermBzPositions; }
+    const ErrorPositions& wrongArticleErrors() const { return m_wrongArticlePositions; }
+    const ErrorIndex& errorIndex() const { return m_errorIndex; }
+
+    // Reference numbers flagged by context().conflicts (not cleared), in BZ order
+    const std::vector<std::wstring>& conflictingBz() const { return m_conflictingBz; }
+
+    /**
+     * @brief Wall time of the phases of the last run()
+     *
+     * The cancel flag is checked after each phase. All of them run on the
+     * scan thread in the GUI, which afterwards only applies the highlights.
+     */
+    struct PhaseTimings {
+        double ordinalMs = 0;  // Clearing results + ordinal auto-detection
+        double scanMs = 0;     // TextScanner::scanText + first spellings
+        double detectMs = 0;   // Conflicts, unnumbered words, articles, sorting
+    };
+    const PhaseTimings& lastTimings() const { return m_timings; }
+
+    /**
+     * @brief Add every structure of the last run() on text to report
+     *
+     * Includes the document itself and the per-pass regex buffers. These are
+     * estimated from text rather than rebuilt, so this is cheap enough to
+     * call on the UI thread.
+     */
+    void reportMemory(MemoryReport& report, const std::wstring& text) const;
+
+private:
+    /**
+     * @brief Ordinal auto-detection on text, then ctx.multiWordBaseStems = manual + auto - disabled
+     *
+     * Also records the auto-detected stems in ctx.autoDetectedMultiWordStems.
+     */
+    static void detectMultiWordStems(const std::wstring& text, const re2::RE2& twoWordRegex, bool german,
+                                     TextAnalyzer& analyzer, AnalysisContext& ctx);
+
+    // Record one finished scan in bz_scans_total and bz_scan_duration_ms
+    static void recordScanMetrics(size_t characters, double milliseconds);
+
+    void resetErrors();
+    // Bring the analyzer's added ignored words in line with ctx.ignoredWords
+    void applyIgnoredWords();
+    // ctx.db.stemToFirstWord from the occurrence table
+    void collectFirstSpellings(const std::wstring& text);
+    // Conflicts, unnumbered words, articles and sorting; fills m_timings.detectMs
+    void detect(const std::wstring& text);
+
+    std::unique_ptr<TextAnalyzer> m_analyzer;
+    // ctx.ignoredWords as last added to m_analyzer
+    std::unordered_set<std::wstring> m_analyzerIgnoredWords;
+    re2::RE2 m_singleWordRegex;
+    re2::RE2 m_twoWordRegex;
+    re2::RE2 m_wordRegex;
+
+    AnalysisContext m_ctx;
+
+    // Arena-backed: reassigned before every m_ctx.clearResults()
+    ErrorPositions m_allErrorsPositions;
+    ErrorPositions m_noNumberPositions;
+    ErrorPositions m_wrongTermBzPositions;
+    ErrorPositions m_wrongArticlePositions;
+    ErrorIndex m_errorIndex;
+
+    std::vector<std::wstring> m_conflictingBz;
+    PhaseTimings m_timings;
+};
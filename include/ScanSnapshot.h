@@ -0,0 +1,81 @@
+#pragma once
+
+#include "utils_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ScanPipeline;
+
+/**
+ * @brief Engine-independent user decisions a scan runs with
+ *
+ * The paragraph table of a loaded document, the reference numbers whose
+ * conflict was cleared (AnalysisContext::clearedErrors), error ranges cleared
+ * in the text and words never to treat as terms. Cleared ranges are offsets
+ * into the scanned text; an engine with content anchors clears them there and
+ * wherever the same text recurs with the same surroundings.
+ */
+struct ScanDecisions {
+    std::vector<uint32_t> paragraphStarts;         // Ascending; empty scans the text as one paragraph
+    std::set<std::wstring> clearedBz;
+    std::set<std::pair<size_t, size_t>> clearedRanges;  // [start, end)
+    std::set<std::wstring> ignoredWords;
+
+    bool operator==(const ScanDecisions& other) const = default;
+
+    bool empty() const {
+        return paragraphStarts.empty() && clearedBz.empty() && clearedRanges.empty() && ignoredWords.empty();
+    }
+
+    // One line per kind of decision (UTF-8), empty if there are none
+    std::string describe() const;
+};
+
+/**
+ * @brief Engine-independent result of one scan, for comparing scan engines
+ *
+ * Holds everything the GUI shows after a scan: the BZ -> terms mapping, the
+ * occurrence positions per BZ, the multi-word stems in effect, the
+ * conflicting BZs and every error category. Containers are ordered and the
+ * per-category error lists sorted, so two engines agree exactly when their
+ * snapshots compare equal, whatever order they detect things in.
+ */
+struct ScanSnapshot {
+    using Range = std::pair<size_t, size_t>;  // (start, length) of an occurrence
+    using ErrorRange = std::pair<int, int>;   // (start, end) as in ErrorPositions
+
+    std::map<std::wstring, std::set<StemVector, StemVectorComparator>, BZComparatorForMap> bzToStems;
+    std::map<std::wstring, std::set<std::wstring>, BZComparatorForMap> bzToOriginalWords;
+    std::map<std::wstring, std::vector<Range>, BZComparatorForMap> bzPositions;  // Document order
+    std::set<std::wstring> multiWordBaseStems;
+
+    std::vector<std::wstring> conflictingBz;  // BZ order
+    std::vector<ErrorRange> allErrors;
+    std::vector<ErrorRange> noNumberErrors;
+    std::vector<ErrorRange> wrongTermBzErrors;
+    std::vector<ErrorRange> wrongArticleErrors;
+
+    // Exception type (e.g. "std::out_of_range") instead of results when the engine threw
+    std::optional<std::string> exception;
+
+    bool operator==(const ScanSnapshot& other) const = default;
+
+    /**
+     * @brief Snapshot of the last ScanPipeline::run()
+     */
+    static ScanSnapshot capture(const ScanPipeline& pipeline);
+
+    /**
+     * @brief Describe the first difference between expected and actual (UTF-8)
+     *
+     * Fields are compared in declaration order; nullopt if they are equal.
+     */
+    static std::optional<std::string> firstDivergence(const ScanSnapshot& expected,
+                                                      const ScanSnapshot& actual);
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "AnalysisContext.h"
+#include "MappedFile.h"
+#include "utils_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Binary snapshot of a document's analysis and the user's decisions
+ *
+ * A session is stored next to the document (pathFor()) and records the hash
+ * and length of the scanned text, the language, the scan results
+ * (occurrence table, original words, first words, multi-word stems) and the
+ * user decisions (cleared numbers, cleared text anchors, manual multi-word
+ * toggles, ignored words), along with the ANALYZER_VERSION that produced the
+ * results.
+ * Saved with a Detection, it also holds the error lists and the flagged
+ * numbers, so restoring needs no detection pass either. Reopening an
+ * unchanged document restores the results without scanning; for a changed
+ * one, or one saved by another analyzer version, the decisions are carried
+ * over and the normal scan runs.
+ *
+ * The file is memory-mapped and validated when opened; restore() reads
+ * straight from the mapping. Layout (little-endian, version 1):
+ *
+ *   header    magic "BZSESSN\0", u32 version, u8 sizeof(wchar_t), u8 language
+ *             (0 German, 1 English), u16 reserved, u64 text hash, u64 text
+ *             length, u32 section count, u32 analyzer version
+ *   directory per section: u32 id, u32 element count, u64 offset, u64 bytes
+ *   sections  8-byte aligned; strings are (u32 offset, u32 length) references
+ *             into a pool of wchar_t, positions count wchar_t like the editor
+ *
+ * Unknown section IDs are skipped, so later versions can add sections.
+ * Malformed files throw std::runtime_error.
+ */
+class SessionFile {
+public:
+    static constexpr uint32_t VERSION = 1;
+    // Bump whenever a change to the analyzers or scanner changes scan results
+    static constexpr uint32_t ANALYZER_VERSION = 1;
+
+    // Sidecar file of a document: "<document>.bzsession"
+    static std::string pathFor(const std::string& documentPath);
+
+    // 64-bit FNV-1a over the text's wchar_t units
+    static uint64_t hashText(const std::wstring& text);
+
+    // Detection results of the scan that go with ctx (see ScanPipeline)
+    struct Detection {
+        const ErrorPositions* noNumber = nullptr;
+        const ErrorPositions* wrongTermBz = nullptr;
+        const ErrorPositions* wrongArticle = nullptr;
+        const std::vector<std::wstring>* conflictingBz = nullptr;
+    };
+
+    /**
+     * @brief Write ctx (results of the last scan of text) atomically to path
+     *
+     * The file is written under a temporary name and renamed over path.
+     * Cleared text anchors that the last resolve() did not find are left
+     * out. Without detection, the file holds no error lists and restoring it
+     * runs detection. Throws std::runtime_error if it cannot be written.
+     */
+    static void save(const std::string& path, const std::wstring& text, bool german, const AnalysisContext& ctx,
+                     const Detection* detection = nullptr);
+
+    // Map and validate a session file; throws std::runtime_error
+    explicit SessionFile(const std::string& path);
+
+    uint64_t textHash() const { return m_textHash; }
+    size_t textLength() const { return m_textLength; }
+    bool german() const { return m_german; }
+    uint32_t analyzerVersion() const { return m_analyzerVersion; }
+
+    // Whether the session was saved for exactly this text, by this ANALYZER_VERSION
+    bool matches(const std::wstring& text) const;
+
+    /**
+     * @brief Restore the user decisions, which survive edits
+     *
+     * Cleared numbers, cleared text anchors (resolved by the next scan) and
+     * the manual multi-word toggles.
+     */
+    void restoreDecisions(AnalysisContext& ctx) const;
+
+    /**
+     * @brief Replace ctx with the saved scan results and all decisions
+     *
+     * Only valid if matches() holds for the text ctx will be shown with.
+     * Clears the results first, so callers must drop their own arena-backed
+     * containers before (as for AnalysisContext::clearResults()). The cleared
+     * text anchors still need ClearedAnchors::resolve() on that text.
+     */
+    void restore(AnalysisContext& ctx) const;
+
+    // Whether the file was saved with a Detection
+    bool hasDetection() const;
+
+    /**
+     * @brief Replace the error lists and flagged numbers with the saved ones
+     *
+     * Only valid if hasDetection(). The lists keep their allocators.
+     */
+    void restoreDetection(ErrorPositions& noNumber, ErrorPositions& wrongTermBz, ErrorPositions& wrongArticle,
+                          std::vector<std::wstring>& conflictingBz) const;
+
+private:
+    struct Span {
+        const char* data = nullptr;
+        uint32_t count = 0;
+    };
+
+    enum SectionId : uint32_t {
+        STRINGS = 1,           // wchar_t pool
+        BZ_NAMES,              // StringRef per BZ ID
+        STEMS,                 // (u32 first part, u32 part count) per stem ID
+        STEM_PARTS,            // StringRef
+        OCCURRENCES,           // Columns start, length, stem ID, BZ ID (u32) and kind (u8), document order
+        ORIGINAL_WORDS,        // (u32 BZ ID, StringRef)
+        FIRST_WORDS,           // (u32 stem ID, StringRef)
+        MULTI_WORD_STEMS,      // StringRef, one section per set
+        AUTO_DETECTED_STEMS,
+        MANUAL_TOGGLES,
+        MANUALLY_DISABLED,
+        CLEARED_ERRORS,
+        CLEARED_ANCHORS,       // ClearedAnchors::Anchor: u64 text, first word, before, after; u32 length, i32 offset
+        NO_NUMBER_ERRORS,      // (u32 start, u32 end), one section per error list; only with a Detection
+        WRONG_TERM_BZ_ERRORS,
+        WRONG_ARTICLE_ERRORS,
+        CONFLICTING_BZ,        // u32 BZ ID, in ScanPipeline::conflictingBz() order
+        IGNORED_WORDS,         // StringRef; absent in sessions saved before it was added
+        SECTION_COUNT
+    };
+
+    std::wstring string(const char* reference) const;
+    void validateStrings(const Span& span, size_t stride, size_t referenceOffset) const;
+    void restoreSet(SectionId id, std::unordered_set<std::wstring>& set) const;
+    void restoreErrors(SectionId id, ErrorPositions& errors) const;
+
+    MappedFile m_file;
+    uint64_t m_textHash = 0;
+    size_t m_textLength = 0;
+    bool m_german = true;
+    uint32_t m_analyzerVersion = 0;
+    Span m_sections[SECTION_COUNT];
+    const wchar_t* m_pool = nullptr;
+    size_t m_poolSize = 0;
+};
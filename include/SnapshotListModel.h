@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ListSnapshot.h"
+#include <wx/dataview.h>
+#include <wx/icon.h>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Virtual wxDataViewCtrl model over one list of a ListSnapshot
+ *
+ * The control asks for cells only for the rows it paints; they are read
+ * straight from the snapshot. setSnapshot() swaps the pointer and replays the
+ * snapshot's Diff against the rows shown so far: only inserted, deleted and
+ * changed rows are reported to the control, which keeps its selection and
+ * scroll position. Without a matching base, or when most rows changed, it
+ * resets the row count instead.
+ *
+ * Columns:
+ * - BzToTerms:      icon and BZ, terms        ("BZ -> feature")
+ * - TermToBzs:      icon and term, BZs        ("feature -> BZ")
+ * - ReferenceSigns: BZ, first spelling        ("reference sign list")
+ */
+class SnapshotListModel : public wxDataViewVirtualListModel {
+public:
+    enum class View { BzToTerms, TermToBzs, ReferenceSigns };
+
+    // setSnapshot() result when the rows were reset instead of diffed
+    static constexpr size_t RESET = SIZE_MAX;
+
+    SnapshotListModel(View view, const wxIcon& check, const wxIcon& warning);
+
+    // Show snapshot (may be null for empty lists); returns the row notifications sent, or RESET.
+    // The snapshot already shown sends nothing.
+    size_t setSnapshot(std::shared_ptr<const ListSnapshot> snapshot);
+    const std::shared_ptr<const ListSnapshot>& snapshot() const { return m_snapshot; }
+
+    // Rows of the current snapshot, nullptr if row is out of range
+    const ListSnapshot::BzRow* bzRow(unsigned int row) const;
+    const ListSnapshot::TermRow* termRow(unsigned int row) const;
+
+    unsigned int GetColumnCount() const override { return 2; }
+    wxString GetColumnType(unsigned int col) const override;
+    void GetValueByRow(wxVariant& variant, unsigned int row, unsigned int col) const override;
+    bool SetValueByRow(const wxVariant& variant, unsigned int row, unsigned int col) override;
+
+private:
+    // Below this many operations a diff is always replayed
+    static constexpr size_t MIN_RESET_OPERATIONS = 64;
+
+    unsigned int rowCount() const;
+    const ListSnapshot::Diff* diff() const;
+    bool cellDiffers(const ListSnapshot& base, unsigned int baseRow, unsigned int row, unsigned int col) const;
+
+    View m_view;
+    wxIcon m_check;
+    wxIcon m_warning;
+    std::shared_ptr<const ListSnapshot> m_snapshot;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "utils_core.h"
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -22,17 +23,22 @@ public:
     // Check if a word is a base for multi-word terms
     virtual bool isMultiWordBase(std::wstring word, const std::unordered_set<std::wstring>& multiWordBaseStems) = 0;
 
-    // Article checking
-    virtual bool isIndefiniteArticle(const std::wstring& word) const = 0;
-    virtual bool isDefiniteArticle(const std::wstring& word) const = 0;
+    // Article checking (case-insensitive, no allocation)
+    virtual bool isIndefiniteArticle(std::wstring_view word) const = 0;
+    virtual bool isDefiniteArticle(std::wstring_view word) const = 0;
 
     // Word filtering
-    virtual bool isIgnoredWord(const std::wstring& word) const = 0;
+    virtual bool isIgnoredWord(std::wstring_view word) const = 0;
+
+    // Add a user-supplied word to the ignored-word list
+    virtual void addIgnoredWord(std::wstring_view word) = 0;
 
     // Common text utility (implementation identical across languages)
-    std::pair<std::wstring, size_t> findPrecedingWord(const std::wstring& text, size_t pos) const;
+    // The word is a view into text; empty if pos is not preceded by a word
+    std::pair<std::wstring_view, size_t> findPrecedingWord(const std::wstring& text, size_t pos) const;
     
     // Cache management
     virtual size_t getCacheSize() const = 0;
+    virtual size_t getCacheMemoryBytes() const = 0;  // Estimated, see MemoryReport
     virtual void clearCache() = 0;
 };
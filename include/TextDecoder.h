@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Incremental decoding of UTF-8, UTF-16 and Latin-1 bytes to wchar_t
+ *
+ * detect() picks the encoding of a whole file: a byte order mark wins, then
+ * UTF-16 without BOM (many NUL bytes on one side of each pair), then UTF-8 if
+ * every sequence is valid, else Latin-1 (Windows editors' "ANSI" for German
+ * text).
+ *
+ * decode() accepts the bytes in arbitrary chunks: an incomplete UTF-8
+ * sequence, UTF-16 code unit or surrogate pair at the end of a chunk is kept
+ * and completed by the next one, so the output does not depend on where a
+ * file is split. Invalid input becomes U+FFFD. Characters outside the BMP
+ * become surrogate pairs where wchar_t is 16 bits (Windows).
+ */
+class TextDecoder {
+public:
+    enum class Encoding {
+        UTF8,
+        UTF16LE,
+        UTF16BE,
+        LATIN1
+    };
+
+    struct Detection {
+        Encoding encoding = Encoding::UTF8;
+        size_t bomBytes = 0;  // Skip these before decoding
+    };
+
+    static Detection detect(const char* data, size_t size);
+    static const char* name(Encoding encoding);
+
+    explicit TextDecoder(Encoding encoding) : m_encoding(encoding) {}
+
+    /**
+     * @brief Append the characters of the next chunk to out
+     * @param last true for the final chunk; a dangling partial sequence becomes U+FFFD
+     */
+    void decode(const char* data, size_t size, bool last, std::wstring& out);
+
+    Encoding encoding() const { return m_encoding; }
+
+private:
+    void decodeUtf8(const uint8_t* data, size_t size, bool last, std::wstring& out);
+    void decodeUtf16(const uint8_t* data, size_t size, bool last, std::wstring& out);
+
+    Encoding m_encoding;
+    uint8_t m_pending[4] = {};  // Bytes of an incomplete sequence from the previous chunk
+    size_t m_pendingSize = 0;
+    uint32_t m_highSurrogate = 0;  // UTF-16: waiting for the low half
+};
@@ -5,7 +5,11 @@
 #include "TextAnalyzer.h"
 #include "AnalysisContext.h"
 #include <re2/re2.h>
+#include <cstdint>
 #include <map>
+#include <memory_resource>
+#include <span>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -19,6 +23,11 @@
  * - Single-word patterns (e.g., "Lager 10")
  * - Two-word patterns (e.g., "erstes Lager 10")
  * - Building the data structures that map reference numbers to terms
+ *
+ * Given a paragraph table (DocumentLoader::Result::paragraphStarts), the
+ * text is scanned one paragraph at a time: a match never spans two
+ * paragraphs, and overlaps are only checked within the paragraph. Without
+ * one the whole text is a single paragraph.
  */
 class TextScanner {
 public:
@@ -29,43 +38,59 @@ public:
      * @param singleWordRegex Regex for single-word patterns
      * @param twoWordRegex Regex for two-word patterns
      * @param ctx Scanning context and output database
+     * @param paragraphStarts Ascending paragraph offsets into fullText, empty for one paragraph
      */
     static void scanText(
         const std::wstring& fullText,
         TextAnalyzer& analyzer,
         const re2::RE2& singleWordRegex,
         const re2::RE2& twoWordRegex,
-        AnalysisContext& ctx
+        AnalysisContext& ctx,
+        std::span<const uint32_t> paragraphStarts = {}
     );
 
 private:
+    // Per-pass tallies, published to the metrics once per scan
+    struct PassCounts {
+        uint64_t matches = 0;
+        uint64_t recorded = 0;
+        uint64_t overlaps = 0;
+        uint64_t ignored = 0;
+    };
+
     /**
-     * @brief Scan for two-word patterns
+     * @brief Scan one paragraph for two-word patterns
+     * @param offset Position of paragraph in the full text
      */
     static void scanTwoWordPatterns(
-        const std::wstring& fullText,
+        std::wstring_view paragraph,
+        size_t offset,
         TextAnalyzer& analyzer,
         const re2::RE2& twoWordRegex,
         AnalysisContext& ctx,
-        std::vector<std::pair<size_t, size_t>>& matchedRanges
+        std::pmr::vector<std::pair<size_t, size_t>>& matchedRanges,
+        PassCounts& counts
     );
 
     /**
-     * @brief Scan for single-word patterns
+     * @brief Scan one paragraph for single-word patterns
+     * @param offset Position of paragraph in the full text
      */
     static void scanSingleWordPatterns(
-        const std::wstring& fullText,
+        std::wstring_view paragraph,
+        size_t offset,
         TextAnalyzer& analyzer,
         const re2::RE2& singleWordRegex,
         AnalysisContext& ctx,
-        std::vector<std::pair<size_t, size_t>>& matchedRanges
+        std::pmr::vector<std::pair<size_t, size_t>>& matchedRanges,
+        PassCounts& counts
     );
 
     /**
      * @brief Check if a range overlaps with any existing matched ranges
      */
     static bool overlapsExisting(
-        const std::vector<std::pair<size_t, size_t>>& matchedRanges,
+        const std::pmr::vector<std::pair<size_t, size_t>>& matchedRanges,
         size_t start,
         size_t end
     );
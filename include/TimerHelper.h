@@ -1,23 +0,0 @@
-#include <chrono> // for std::chrono functions
-
-class Timer
-{
-private:
-	// Type aliases to make accessing nested type easier
-	using Clock = std::chrono::steady_clock;
-	using Second = std::chrono::duration<double, std::ratio<1> >;
-    using Milliseond = std::chrono::duration<double, std::ratio<1, 1000> >; 
-
-	std::chrono::time_point<Clock> m_beg { Clock::now() };
-
-public:
-	void reset()
-	{
-		m_beg = Clock::now();
-	}
-
-	double elapsed() const
-	{
-		return std::chrono::duration_cast<Milliseond>(Clock::now() - m_beg).count();
-	}
-};
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Low-overhead scoped tracing with Chrome trace_event export
+ *
+ * BZ_TRACE_SCOPE("name") records a span from construction to the end of the
+ * enclosing scope; BZ_TRACE_COUNTER and BZ_TRACE_INSTANT record values and
+ * markers. Each thread writes into its own fixed-size ring buffer without
+ * locks (the oldest events are overwritten), so spans are cheap enough for
+ * every rescan. A disabled span costs one relaxed atomic load.
+ *
+ * Switches:
+ * - compile time: BZ_TRACE_ENABLED=0 (CMake option ENABLE_TRACING=OFF)
+ *   compiles every macro to nothing
+ * - run time: Trace::setEnabled(); the application turns it on when the
+ *   BZ_TRACE environment variable names an output file
+ *
+ * writeChromeJson() produces the trace_event format understood by
+ * chrome://tracing and Perfetto. Names must be string literals (only the
+ * pointer is stored).
+ */
+#ifndef BZ_TRACE_ENABLED
+#define BZ_TRACE_ENABLED 1
+#endif
+
+namespace Trace {
+    enum class Phase : uint8_t {
+        SPAN,     // "X": complete event with duration
+        COUNTER,  // "C": value at a point in time
+        INSTANT   // "i": marker without duration
+    };
+
+    struct Event {
+        const char* name;
+        uint32_t threadId;
+        Phase phase;
+        int64_t startNs;  // Since the trace epoch (process start)
+        int64_t value;    // SPAN: duration in ns, COUNTER: value, INSTANT: unused
+    };
+
+    // Ring slots per thread; snapshot() returns at most RING_CAPACITY - 1 of
+    // them because the slot of a write in progress is never trusted
+    inline constexpr size_t RING_CAPACITY = 16384;
+
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // Label the calling thread in exported traces ("UI", "Scan")
+    void setThreadName(const char* name);
+
+    // Small sequential ID of the calling thread, as used in events
+    uint32_t currentThreadId();
+
+    void counter(const char* name, int64_t value);
+    void instant(const char* name);
+
+    class Span {
+    public:
+        explicit Span(const char* name);
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* m_name;  // nullptr when tracing was off at construction
+        int64_t m_startNs;
+    };
+
+    /**
+     * @brief Events currently held in all thread buffers, ordered by start time
+     *
+     * Safe to call while other threads are recording; events overwritten
+     * during the copy are dropped.
+     */
+    std::vector<Event> snapshot();
+
+    // Forget all recorded events (thread IDs and names are kept)
+    void clear();
+
+    void writeChromeJson(std::ostream& out);
+    bool writeChromeJson(const std::string& path);
+}
+
+#define BZ_TRACE_CONCAT_IMPL(a, b) a##b
+#define BZ_TRACE_CONCAT(a, b) BZ_TRACE_CONCAT_IMPL(a, b)
+
+#if BZ_TRACE_ENABLED
+#define BZ_TRACE_SCOPE(name) ::Trace::Span BZ_TRACE_CONCAT(bzTraceSpan, __LINE__)(name)
+#define BZ_TRACE_COUNTER(name, value) ::Trace::counter(name, static_cast<int64_t>(value))
+#define BZ_TRACE_INSTANT(name) ::Trace::instant(name)
+#else
+#define BZ_TRACE_SCOPE(name) ((void)0)
+#define BZ_TRACE_COUNTER(name, value) ((void)0)
+#define BZ_TRACE_INSTANT(name) ((void)0)
+#endif
@@ -2,7 +2,7 @@
 
 #include <wx/wx.h>
 #include <wx/richtext/richtextctrl.h>
-#include <wx/treelist.h>
+#include <wx/dataview.h>
 #include <wx/notebook.h>
 #include <memory>
 
@@ -19,9 +19,10 @@ public:
         wxNotebook* notebookList;
         wxRichTextCtrl* textBox;
         wxRadioBox* languageSelector;
-        std::shared_ptr<wxRichTextCtrl> bzList;
-        std::shared_ptr<wxTreeListCtrl> termList;
-        std::shared_ptr<wxTreeListCtrl> treeList;
+        // Virtual lists; MainWindow associates their SnapshotListModels
+        std::shared_ptr<wxDataViewCtrl> bzList;
+        std::shared_ptr<wxDataViewCtrl> termList;
+        std::shared_ptr<wxDataViewCtrl> treeList;
 
         // Navigation buttons - All errors
         std::shared_ptr<wxButton> buttonForwardAllErrors;
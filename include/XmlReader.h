@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Push-style (SAX) XML tokenizer for UTF-8 input
+ *
+ * feed() accepts the document in arbitrary pieces and reports elements and
+ * text to a Handler as soon as they are complete; only a token split across
+ * two pieces is buffered, never the document. Character and the five
+ * predefined entity references are decoded, other entities are passed
+ * through unchanged. Comments, processing instructions and the DOCTYPE are
+ * skipped; <x/> reports a start and an end. Nesting is not validated.
+ *
+ * finish() throws std::runtime_error if the input ends inside markup.
+ */
+class XmlReader {
+public:
+    struct Attribute {
+        std::string_view name;
+        std::string value;  // Entities decoded
+    };
+    using Attributes = std::vector<Attribute>;
+
+    // Names and text are only valid during the call; text may arrive in several calls
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual void startElement(std::string_view /*name*/, const Attributes& /*attributes*/) {}
+        virtual void endElement(std::string_view /*name*/) {}
+        virtual void characters(std::string_view /*text*/) {}
+    };
+
+    explicit XmlReader(Handler& handler) : m_handler(handler) {}
+
+    void feed(const char* data, size_t size);
+    void finish();
+
+    // Value of the encoding pseudo-attribute of the XML declaration, or ""
+    const std::string& declaredEncoding() const { return m_declaredEncoding; }
+
+    // "w:p" -> "p"
+    static std::string_view localName(std::string_view name);
+
+    // Value of the named attribute, or nullptr
+    static const std::string* attribute(const Attributes& attributes, std::string_view name);
+
+private:
+    size_t parse(std::string_view input, bool final);
+    size_t markup(std::string_view input, bool final);
+    void startTag(std::string_view tag);
+    void text(std::string_view raw);
+    void decodeEntities(std::string_view raw, std::string& out);
+
+    Handler& m_handler;
+    std::string m_pending;  // Unfinished token from the previous feed()
+    std::string m_decoded;
+    Attributes m_attributes;
+    std::string m_declaredEncoding;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Inflater.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Read-only view of a ZIP archive held in a MappedFile
+ *
+ * The constructor reads the central directory; extract() streams one entry
+ * (stored or deflated) to a sink straight from the mapping and verifies its
+ * CRC-32, so only the inflate window is ever held in memory. Just enough of
+ * the format for Office documents: no ZIP64, no encryption, no multi-disk
+ * archives. Malformed archives throw std::runtime_error.
+ *
+ * A small deflated entry can expand to gigabytes, so extract() refuses
+ * entries declared larger than maxEntryBytes and stops as soon as an entry
+ * produces more than its declared size.
+ */
+class ZipArchive {
+public:
+    // Far above any real word/document.xml
+    static constexpr size_t DEFAULT_MAX_ENTRY_BYTES = 512 * 1024 * 1024;
+
+    struct Entry {
+        std::string name;
+        uint16_t method = 0;  // 0 = stored, 8 = deflated
+        uint32_t crc = 0;
+        size_t compressedSize = 0;
+        size_t uncompressedSize = 0;
+        size_t localHeaderOffset = 0;
+    };
+
+    // file must outlive the archive
+    explicit ZipArchive(const MappedFile& file, size_t maxEntryBytes = DEFAULT_MAX_ENTRY_BYTES);
+
+    // True if the data starts with a local file header signature
+    static bool isZip(const char* data, size_t size);
+
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+    // Entry with exactly this name, or nullptr
+    const Entry* find(std::string_view name) const;
+
+    /**
+     * @brief Stream the uncompressed entry to sink; returns its size
+     *
+     * A stopped extract returns early without checking the CRC.
+     */
+    size_t extract(const Entry& entry, const Inflater::Sink& sink, std::stop_token stop = {});
+
+    // File offset up to which the running extract() has read (for progress)
+    size_t bytesRead() const;
+
+private:
+    const MappedFile& m_file;
+    size_t m_maxEntryBytes;
+    std::vector<Entry> m_entries;
+    Inflater m_inflater;
+    size_t m_dataOffset = 0;    // Start of the entry being extracted
+    size_t m_storedRead = 0;    // Bytes copied so far when the entry is stored
+    bool m_deflating = false;
+};
@@ -1,16 +1,20 @@
 #pragma once
+#include "CharClass.h"
 #include <functional>
+#include <memory_resource>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <string>
-#include <cwctype>
 
 // Type alias for a stemmed term (vector of stemmed words)
 // Single-word term: {"vorricht"}
 // Multi-word term: {"zweit", "lager"}
 using StemVector = std::vector<std::wstring>;
 
+// (start, end) text ranges of detected errors; per-scan, so arena-allocatable
+using ErrorPositions = std::pmr::vector<std::pair<int, int>>;
+
 // Hash function for StemVector to use in unordered containers
 struct StemVectorHash {
     size_t operator()(const StemVector& vec) const {
@@ -36,8 +40,8 @@ struct BZComparatorForMap {
         }
 
         // Check if first character is numeric before calling std::stoi
-        bool a_starts_with_digit = !a.empty() && std::iswdigit(a[0]);
-        bool b_starts_with_digit = !b.empty() && std::iswdigit(b[0]);
+        bool a_starts_with_digit = !a.empty() && CharClass::isDigit(a[0]);
+        bool b_starts_with_digit = !b.empty() && CharClass::isDigit(b[0]);
 
         // If one starts with a digit and the other doesn't, digit-starting comes first
         if (a_starts_with_digit && !b_starts_with_digit) {
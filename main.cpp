@@ -1,12 +1,40 @@
 #include "MainWindow.h"
+#include "Trace.h"
+#include <cstdlib>
+#include <string>
 
 class MyApp : public wxApp {
 public:
   virtual bool OnInit() {
+    // BZ_TRACE=<file> records scan/UI spans and writes a Chrome trace on exit
+    if (const char* tracePath = std::getenv("BZ_TRACE")) {
+      m_tracePath = tracePath;
+      Trace::setEnabled(true);
+      Trace::setThreadName("UI");
+    }
+
     MainWindow *frame = new MainWindow();
+    // BZ_RECORD_SESSION=<file> records the edits for bz_replay
+    if (const char* sessionPath = std::getenv("BZ_RECORD_SESSION")) {
+      frame->startSessionRecording(sessionPath);
+    }
     frame->Show();
+    // A file given on the command line is opened like File -> Open
+    if (argc > 1) {
+      frame->openFile(argv[1].utf8_string());
+    }
     return true;
   }
+
+  virtual int OnExit() {
+    if (!m_tracePath.empty() && !Trace::writeChromeJson(m_tracePath)) {
+      wxLogError("Could not write trace file %s", m_tracePath);
+    }
+    return wxApp::OnExit();
+  }
+
+private:
+  std::string m_tracePath;
 };
 
 wxIMPLEMENT_APP(MyApp);
@@ -0,0 +1,70 @@
+#include "CaseFolding.h"
+#include <cwchar>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BZ_CASEFOLD_SSE2 1
+#endif
+
+namespace {
+
+#ifdef BZ_CASEFOLD_SSE2
+// Lowercase one 16-byte block if it is pure ASCII. Returns false (and leaves
+// the block untouched) when any lane is outside ASCII, so the caller can fall
+// back to the table for that block.
+inline bool foldAsciiBlock(wchar_t* p) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+#if WCHAR_MAX > 0xFFFF
+    // Lanes are signed 32-bit, so negative values must be rejected as well
+    const __m128i nonAscii = _mm_or_si128(
+        _mm_cmpgt_epi32(v, _mm_set1_epi32(0x7F)),
+        _mm_cmplt_epi32(v, _mm_setzero_si128()));
+    if (_mm_movemask_epi8(nonAscii) != 0) {
+        return false;
+    }
+    const __m128i isUpper = _mm_and_si128(
+        _mm_cmpgt_epi32(v, _mm_set1_epi32(L'A' - 1)),
+        _mm_cmplt_epi32(v, _mm_set1_epi32(L'Z' + 1)));
+    v = _mm_add_epi32(v, _mm_and_si128(isUpper, _mm_set1_epi32(0x20)));
+#else
+    // UTF-16 code units are unsigned; after the bias they compare as signed
+    const __m128i nonAscii = _mm_cmpgt_epi16(
+        _mm_xor_si128(v, _mm_set1_epi16(static_cast<short>(0x8000))),
+        _mm_set1_epi16(static_cast<short>(0x8000 + 0x7F - 0x10000)));
+    if (_mm_movemask_epi8(nonAscii) != 0) {
+        return false;
+    }
+    const __m128i isUpper = _mm_and_si128(
+        _mm_cmpgt_epi16(v, _mm_set1_epi16(L'A' - 1)),
+        _mm_cmplt_epi16(v, _mm_set1_epi16(L'Z' + 1)));
+    v = _mm_add_epi16(v, _mm_and_si128(isUpper, _mm_set1_epi16(0x20)));
+#endif
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    return true;
+}
+#endif
+
+inline void foldScalar(wchar_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = CaseFolding::foldChar(data[i]);
+    }
+}
+
+} // namespace
+
+void CaseFolding::foldInPlace(wchar_t* data, size_t length) {
+    size_t i = 0;
+
+#ifdef BZ_CASEFOLD_SSE2
+    constexpr size_t lanes = 16 / sizeof(wchar_t);
+    for (; i + lanes <= length; i += lanes) {
+        if (!foldAsciiBlock(data + i)) {
+            foldScalar(data + i, lanes);
+        }
+    }
+#endif
+
+    foldScalar(data + i, length - i);
+}
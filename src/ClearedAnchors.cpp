@@ -0,0 +1,202 @@
+#include "ClearedAnchors.h"
+#include "CharClass.h"
+#include "Trace.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+inline uint64_t step(uint64_t hash, wchar_t c) {
+    return (hash ^ static_cast<uint32_t>(c)) * FNV_PRIME;
+}
+
+uint64_t hashRange(const std::wstring& text, size_t start, size_t end) {
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = start; i < end; ++i) {
+        hash = step(hash, text[i]);
+    }
+    return hash;
+}
+
+inline bool isWordChar(wchar_t c) {
+    return (CharClass::flags(c) & (CharClass::LETTER | CharClass::DIGIT)) != 0;
+}
+
+uint64_t before(const std::wstring& text, size_t start) {
+    return hashRange(text, start - std::min(start, ClearedAnchors::CONTEXT_CHARS), start);
+}
+
+uint64_t after(const std::wstring& text, size_t end) {
+    return hashRange(text, end, std::min(text.size(), end + ClearedAnchors::CONTEXT_CHARS));
+}
+
+} // namespace
+
+ClearedAnchors::Anchor ClearedAnchors::anchorAt(const std::wstring& text, size_t start, size_t end) {
+    // The word the range starts in, else the first word inside it, else the last word before it
+    size_t wordStart = start;
+    if (isWordChar(text[start])) {
+        while (wordStart > 0 && isWordChar(text[wordStart - 1])) {
+            --wordStart;
+        }
+    } else {
+        while (wordStart < end && !isWordChar(text[wordStart])) {
+            ++wordStart;
+        }
+        if (wordStart == end) {
+            wordStart = start;
+            while (wordStart > 0 && !isWordChar(text[wordStart - 1])) {
+                --wordStart;
+            }
+            while (wordStart > 0 && isWordChar(text[wordStart - 1])) {
+                --wordStart;
+            }
+        }
+    }
+    size_t wordEnd = wordStart;
+    while (wordEnd < text.size() && isWordChar(text[wordEnd])) {
+        ++wordEnd;
+    }
+    Anchor anchor;
+    anchor.text = hashRange(text, start, end);
+    anchor.firstWord = hashRange(text, wordStart, wordEnd);
+    anchor.before = before(text, start);
+    anchor.after = after(text, end);
+    anchor.length = static_cast<uint32_t>(end - start);
+    anchor.offset = static_cast<int32_t>(start) - static_cast<int32_t>(wordStart);
+    return anchor;
+}
+
+void ClearedAnchors::add(const std::wstring& text, size_t start, size_t end) {
+    if (start >= end || end > text.size()) {
+        return;
+    }
+    const Anchor anchor = anchorAt(text, start, end);
+    const auto existing = std::find(m_anchors.begin(), m_anchors.end(), anchor);
+    if (existing == m_anchors.end()) {
+        m_anchors.push_back(anchor);
+        m_resolved.push_back(true);
+    } else {
+        m_resolved[existing - m_anchors.begin()] = true;
+    }
+    m_cleared.emplace(start, end);
+}
+
+void ClearedAnchors::addAnchor(const Anchor& anchor) {
+    if (std::find(m_anchors.begin(), m_anchors.end(), anchor) == m_anchors.end()) {
+        m_anchors.push_back(anchor);
+        m_resolved.push_back(false);
+    }
+}
+
+void ClearedAnchors::resolve(const std::wstring& text) {
+    BZ_TRACE_SCOPE("ClearedAnchors::resolve");
+    m_cleared.clear();
+    m_resolved.assign(m_anchors.size(), false);
+    if (m_anchors.empty()) {
+        return;
+    }
+
+    // Anchors with the same text share the text and context hashing at each candidate
+    struct Group {
+        uint64_t text;
+        uint32_t length;
+        int32_t offset;
+        std::vector<uint32_t> anchors;
+    };
+    std::unordered_map<uint64_t, std::vector<Group>> byFirstWord;
+    for (uint32_t i = 0; i < m_anchors.size(); ++i) {
+        const Anchor& anchor = m_anchors[i];
+        std::vector<Group>& groups = byFirstWord[anchor.firstWord];
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) {
+            return g.text == anchor.text && g.length == anchor.length && g.offset == anchor.offset;
+        });
+        if (group == groups.end()) {
+            groups.push_back({anchor.text, anchor.length, anchor.offset, {}});
+            group = groups.end() - 1;
+        }
+        group->anchors.push_back(i);
+    }
+    struct Candidates {
+        int bestScore = 0;           // Context sides that still match (0..2)
+        std::vector<size_t> best;    // Starts with bestScore
+        size_t textMatches = 0;
+        size_t lastTextMatch = 0;
+    };
+    std::vector<Candidates> candidates(m_anchors.size());
+
+    // One pass over the words; every range is placed relative to its anchor word
+    const size_t n = text.size();
+    size_t i = 0;
+    while (i < n) {
+        if (!isWordChar(text[i])) {
+            ++i;
+            continue;
+        }
+        size_t wordEnd = i;
+        uint64_t word = FNV_OFFSET;
+        while (wordEnd < n && isWordChar(text[wordEnd])) {
+            word = step(word, text[wordEnd]);
+            ++wordEnd;
+        }
+        const auto groups = byFirstWord.find(word);
+        if (groups != byFirstWord.end()) {
+            for (const Group& group : groups->second) {
+                if (group.offset < 0 && static_cast<size_t>(-group.offset) > i) {
+                    continue;
+                }
+                const size_t start = i + group.offset;
+                const size_t end = start + group.length;
+                if (end > n || hashRange(text, start, end) != group.text) {
+                    continue;
+                }
+                const uint64_t beforeHash = before(text, start);
+                const uint64_t afterHash = after(text, end);
+                for (uint32_t a : group.anchors) {
+                    const Anchor& anchor = m_anchors[a];
+                    Candidates& c = candidates[a];
+                    ++c.textMatches;
+                    c.lastTextMatch = start;
+                    const int score = (beforeHash == anchor.before) + (afterHash == anchor.after);
+                    if (score > c.bestScore) {
+                        c.bestScore = score;
+                        c.best.clear();
+                    }
+                    if (score == c.bestScore && score > 0) {
+                        c.best.push_back(start);
+                    }
+                }
+            }
+        }
+        i = wordEnd;
+    }
+
+    for (size_t a = 0; a < m_anchors.size(); ++a) {
+        const Candidates& c = candidates[a];
+        if (c.bestScore > 0) {
+            for (size_t start : c.best) {
+                m_cleared.emplace(start, start + m_anchors[a].length);
+            }
+            m_resolved[a] = true;
+        } else if (c.textMatches == 1) {
+            m_cleared.emplace(c.lastTextMatch, c.lastTextMatch + m_anchors[a].length);
+            m_resolved[a] = true;
+        }
+    }
+}
+
+void ClearedAnchors::clear() {
+    m_anchors.clear();
+    m_resolved.clear();
+    m_cleared.clear();
+}
+
+size_t ClearedAnchors::memoryBytes() const {
+    // Node-based set: one node (pair + next pointer + cached hash) per entry plus the bucket array
+    return m_anchors.capacity() * sizeof(Anchor) + m_resolved.capacity() / 8 +
+           m_cleared.size() * (sizeof(std::pair<size_t, size_t>) + 2 * sizeof(void*)) +
+           m_cleared.bucket_count() * sizeof(void*);
+}
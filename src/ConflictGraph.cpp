@@ -0,0 +1,179 @@
+#include "ConflictGraph.h"
+#include "MemoryReport.h"
+#include "Trace.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+constexpr uint32_t NONE = OccurrenceTable::NO_ID;
+constexpr uint32_t SEVERAL = OccurrenceTable::NO_ID - 1;
+
+// Remember the first neighbour, or SEVERAL once a second one shows up
+inline void addNeighbour(uint32_t& neighbour, uint32_t id) {
+    if (neighbour == NONE) {
+        neighbour = id;
+    } else if (neighbour != id) {
+        neighbour = SEVERAL;
+    }
+}
+
+uint32_t find(std::pmr::vector<uint32_t>& parent, uint32_t node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];  // Path halving
+        node = parent[node];
+    }
+    return node;
+}
+
+// Fill a CSR slice per conflict from the conflict of each item; items stay in ID order
+void buildLists(const std::pmr::vector<uint32_t>& conflictOf, size_t conflicts,
+                std::pmr::vector<uint32_t>& offsets, std::pmr::vector<uint32_t>& items) {
+    offsets.assign(conflicts + 1, 0);
+    for (const uint32_t c : conflictOf) {
+        if (c != ConflictGraph::NO_CONFLICT) {
+            ++offsets[c + 1];
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    items.resize(offsets.back());
+    std::pmr::vector<uint32_t> next(offsets.begin(), offsets.end() - 1, offsets.get_allocator());
+    for (uint32_t id = 0; id < conflictOf.size(); ++id) {
+        if (conflictOf[id] != ConflictGraph::NO_CONFLICT) {
+            items[next[conflictOf[id]]++] = id;
+        }
+    }
+}
+
+} // namespace
+
+ConflictGraph::ConflictGraph(std::pmr::memory_resource* resource)
+    : m_resource(resource),
+      m_bzFlags(resource), m_stemFlags(resource), m_bzConflict(resource), m_stemConflict(resource),
+      m_flagged(resource),
+      m_bzOffsets(resource), m_bzs(resource), m_stemOffsets(resource), m_stems(resource),
+      m_occurrenceOffsets(resource), m_occurrences(resource) {}
+
+void ConflictGraph::build(const OccurrenceTable& occurrences,
+                          const std::unordered_set<std::wstring>& clearedErrors) {
+    BZ_TRACE_SCOPE("ConflictGraph::build");
+    clear();
+    const uint32_t bzCount = static_cast<uint32_t>(occurrences.bzCount());
+    const uint32_t stemCount = static_cast<uint32_t>(occurrences.stemCount());
+
+    // Nodes 0..bzCount-1 are BZs, the rest terms; every occurrence is an edge
+    std::pmr::vector<uint32_t> parent(bzCount + stemCount, m_resource);
+    std::iota(parent.begin(), parent.end(), 0u);
+    std::pmr::vector<uint32_t> stemOfBz(bzCount, NONE, m_resource);
+    std::pmr::vector<uint32_t> bzOfStem(stemCount, NONE, m_resource);
+    for (size_t i = 0; i < occurrences.size(); ++i) {
+        const uint32_t bzId = occurrences.bzId(i);
+        const uint32_t stemId = occurrences.stemId(i);
+        addNeighbour(stemOfBz[bzId], stemId);
+        addNeighbour(bzOfStem[stemId], bzId);
+        const uint32_t a = find(parent, bzId);
+        const uint32_t b = find(parent, bzCount + stemId);
+        if (a != b) {
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    // A component is a conflict unless it is a single BZ with a single term
+    std::pmr::vector<uint32_t> componentSize(parent.size(), 0, m_resource);
+    for (uint32_t node = 0; node < parent.size(); ++node) {
+        ++componentSize[find(parent, node)];
+    }
+    std::pmr::vector<uint32_t> conflictOfRoot(parent.size(), NO_CONFLICT, m_resource);
+    uint32_t conflicts = 0;
+    auto conflictOf = [&](uint32_t node) {
+        const uint32_t root = find(parent, node);
+        if (componentSize[root] <= 2) {
+            return NO_CONFLICT;
+        }
+        if (conflictOfRoot[root] == NO_CONFLICT) {
+            conflictOfRoot[root] = conflicts++;  // Numbered by lowest BZ ID
+        }
+        return conflictOfRoot[root];
+    };
+    m_bzConflict.resize(bzCount);
+    for (uint32_t bzId = 0; bzId < bzCount; ++bzId) {
+        m_bzConflict[bzId] = conflictOf(bzId);
+    }
+    m_stemConflict.resize(stemCount);
+    for (uint32_t stemId = 0; stemId < stemCount; ++stemId) {
+        m_stemConflict[stemId] = conflictOf(bzCount + stemId);
+    }
+
+    // Per BZ: several terms, or its only term has several BZs
+    m_bzFlags.assign(bzCount, 0);
+    std::pmr::vector<uint8_t> highlightStem(stemCount, 0, m_resource);
+    for (uint32_t bzId = 0; bzId < bzCount; ++bzId) {
+        const uint32_t stemId = stemOfBz[bzId];
+        if (stemId == NONE || (stemId != SEVERAL && bzOfStem[stemId] != SEVERAL)) {
+            continue;
+        }
+        m_bzFlags[bzId] = CONFLICTS;
+        if (clearedErrors.count(occurrences.bzName(bzId)) == 0) {
+            m_bzFlags[bzId] |= FLAGGED;
+            // A BZ whose only term is shared highlights every occurrence of that term
+            if (stemId != SEVERAL) {
+                highlightStem[stemId] = 1;
+            }
+        }
+    }
+    m_stemFlags.assign(stemCount, 0);
+    for (uint32_t stemId = 0; stemId < stemCount; ++stemId) {
+        const uint32_t bzId = bzOfStem[stemId];
+        if (bzId == SEVERAL || bzFlagged(bzId)) {
+            m_stemFlags[stemId] = CONFLICTS | FLAGGED;
+        }
+    }
+    for (uint32_t i = 0; i < occurrences.size(); ++i) {
+        if (bzFlagged(occurrences.bzId(i)) || highlightStem[occurrences.stemId(i)]) {
+            m_flagged.push_back(i);
+        }
+    }
+
+    buildLists(m_bzConflict, conflicts, m_bzOffsets, m_bzs);
+    buildLists(m_stemConflict, conflicts, m_stemOffsets, m_stems);
+    std::pmr::vector<uint32_t> conflictOfOccurrence(occurrences.size(), m_resource);
+    for (size_t i = 0; i < occurrences.size(); ++i) {
+        conflictOfOccurrence[i] = m_bzConflict[occurrences.bzId(i)];
+    }
+    buildLists(conflictOfOccurrence, conflicts, m_occurrenceOffsets, m_occurrences);
+}
+
+void ConflictGraph::clear() {
+    // Reassign rather than clear() so no array keeps a buffer in a released arena
+    *this = ConflictGraph(m_resource);
+}
+
+ConflictGraph::Conflict ConflictGraph::conflict(size_t index) const {
+    auto slice = [index](const std::pmr::vector<uint32_t>& offsets, const std::pmr::vector<uint32_t>& items) {
+        return std::span<const uint32_t>(items.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    };
+    return {slice(m_bzOffsets, m_bzs), slice(m_stemOffsets, m_stems),
+            slice(m_occurrenceOffsets, m_occurrences)};
+}
+
+std::wstring ConflictGraph::describe(size_t index, const OccurrenceTable& occurrences,
+                                     const std::wstring& text) const {
+    const Conflict c = conflict(index);
+    std::wstring terms;
+    for (const uint32_t stemId : c.stemIds) {
+        terms += (terms.empty() ? L"" : L", ") + occurrences.firstSpelling(stemId, text);
+    }
+    std::wstring numbers;
+    for (const uint32_t bzId : c.bzIds) {
+        numbers += (numbers.empty() ? L"" : L", ") + occurrences.bzName(bzId);
+    }
+    return terms + L" <-> " + numbers;
+}
+
+size_t ConflictGraph::memoryBytes() const {
+    return MemoryUsage::heapBytes(m_bzFlags) + MemoryUsage::heapBytes(m_stemFlags) +
+           MemoryUsage::heapBytes(m_bzConflict) + MemoryUsage::heapBytes(m_stemConflict) +
+           MemoryUsage::heapBytes(m_flagged) + MemoryUsage::heapBytes(m_bzOffsets) + MemoryUsage::heapBytes(m_bzs) +
+           MemoryUsage::heapBytes(m_stemOffsets) + MemoryUsage::heapBytes(m_stems) +
+           MemoryUsage::heapBytes(m_occurrenceOffsets) + MemoryUsage::heapBytes(m_occurrences);
+}
@@ -0,0 +1,556 @@
+#include "CorpusGenerator.h"
+#include "GermanTextAnalyzer.h"
+#include "EnglishTextAnalyzer.h"
+#include "RE2RegexHelper.h"
+#include "CaseFolding.h"
+#include "JsonEscape.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <string_view>
+
+namespace {
+
+enum class Gender { MASCULINE, FEMININE, NEUTER };
+
+struct Noun {
+    const wchar_t* word;
+    Gender gender;
+};
+
+// Base nouns; English gender is unused
+constexpr Noun GERMAN_NOUNS[] = {
+    {L"Lager", Gender::NEUTER},       {L"Welle", Gender::FEMININE},      {L"Gehäuse", Gender::NEUTER},
+    {L"Zahnrad", Gender::NEUTER},     {L"Motor", Gender::MASCULINE},     {L"Dichtung", Gender::FEMININE},
+    {L"Flansch", Gender::MASCULINE},  {L"Schraube", Gender::FEMININE},   {L"Kupplung", Gender::FEMININE},
+    {L"Bremse", Gender::FEMININE},    {L"Sensor", Gender::MASCULINE},    {L"Feder", Gender::FEMININE},
+    {L"Hebel", Gender::MASCULINE},    {L"Achse", Gender::FEMININE},      {L"Hohlrad", Gender::NEUTER},
+    {L"Stator", Gender::MASCULINE},   {L"Rotor", Gender::MASCULINE},     {L"Kolben", Gender::MASCULINE},
+    {L"Zylinder", Gender::MASCULINE}, {L"Ventil", Gender::NEUTER},       {L"Leitung", Gender::FEMININE},
+    {L"Pumpe", Gender::FEMININE},     {L"Filter", Gender::MASCULINE},    {L"Träger", Gender::MASCULINE},
+    {L"Öffnung", Gender::FEMININE},   {L"Nut", Gender::FEMININE},        {L"Vorsprung", Gender::MASCULINE},
+    {L"Schalter", Gender::MASCULINE}, {L"Ring", Gender::MASCULINE},      {L"Deckel", Gender::MASCULINE},
+    {L"Platte", Gender::FEMININE},    {L"Hülse", Gender::FEMININE},      {L"Bolzen", Gender::MASCULINE},
+    {L"Zapfen", Gender::MASCULINE},   {L"Scheibe", Gender::FEMININE},    {L"Buchse", Gender::FEMININE},
+    {L"Stift", Gender::MASCULINE},    {L"Rahmen", Gender::MASCULINE},    {L"Klappe", Gender::FEMININE},
+    {L"Düse", Gender::FEMININE},      {L"Rolle", Gender::FEMININE},      {L"Kette", Gender::FEMININE},
+    {L"Gelenk", Gender::NEUTER},      {L"Gewinde", Gender::NEUTER},      {L"Rohr", Gender::NEUTER},
+    {L"Kanal", Gender::MASCULINE},    {L"Spule", Gender::FEMININE},      {L"Magnet", Gender::MASCULINE},
+    {L"Riemen", Gender::MASCULINE},   {L"Schieber", Gender::MASCULINE},
+};
+
+// Compounds take the gender of the base noun ("Antriebs" + "welle")
+constexpr const wchar_t* GERMAN_PREFIXES[] = {
+    L"Antriebs", L"Abtriebs", L"Zwischen", L"Haupt", L"Neben", L"Außen", L"Innen", L"Dreh",
+    L"Halte", L"Führungs", L"Stütz", L"Rück", L"Steuer", L"Kühl", L"Spann", L"Öl",
+};
+
+constexpr Noun ENGLISH_NOUNS[] = {
+    {L"shaft", Gender::NEUTER},     {L"bearing", Gender::NEUTER},   {L"housing", Gender::NEUTER},
+    {L"gear", Gender::NEUTER},      {L"motor", Gender::NEUTER},     {L"seal", Gender::NEUTER},
+    {L"flange", Gender::NEUTER},    {L"screw", Gender::NEUTER},     {L"clutch", Gender::NEUTER},
+    {L"brake", Gender::NEUTER},     {L"sensor", Gender::NEUTER},    {L"spring", Gender::NEUTER},
+    {L"lever", Gender::NEUTER},     {L"axle", Gender::NEUTER},      {L"piston", Gender::NEUTER},
+    {L"cylinder", Gender::NEUTER},  {L"valve", Gender::NEUTER},     {L"pump", Gender::NEUTER},
+    {L"filter", Gender::NEUTER},    {L"carrier", Gender::NEUTER},   {L"opening", Gender::NEUTER},
+    {L"groove", Gender::NEUTER},    {L"projection", Gender::NEUTER},{L"switch", Gender::NEUTER},
+    {L"ring", Gender::NEUTER},      {L"cover", Gender::NEUTER},     {L"plate", Gender::NEUTER},
+    {L"sleeve", Gender::NEUTER},    {L"bolt", Gender::NEUTER},      {L"pin", Gender::NEUTER},
+    {L"disc", Gender::NEUTER},      {L"bushing", Gender::NEUTER},   {L"frame", Gender::NEUTER},
+    {L"flap", Gender::NEUTER},      {L"nozzle", Gender::NEUTER},    {L"roller", Gender::NEUTER},
+    {L"chain", Gender::NEUTER},     {L"joint", Gender::NEUTER},     {L"thread", Gender::NEUTER},
+    {L"tube", Gender::NEUTER},      {L"channel", Gender::NEUTER},   {L"coil", Gender::NEUTER},
+    {L"magnet", Gender::NEUTER},    {L"belt", Gender::NEUTER},      {L"rotor", Gender::NEUTER},
+    {L"stator", Gender::NEUTER},    {L"wheel", Gender::NEUTER},     {L"washer", Gender::NEUTER},
+    {L"bracket", Gender::NEUTER},   {L"slider", Gender::NEUTER},
+};
+
+constexpr const wchar_t* ENGLISH_PREFIXES[] = {
+    L"sub", L"counter", L"inter", L"micro", L"over", L"under", L"main", L"end",
+};
+
+// Modifier stems; German endings are added per article
+struct ModifierPair {
+    const wchar_t* first;
+    const wchar_t* second;
+};
+
+constexpr ModifierPair GERMAN_ORDINALS = {L"erst", L"zweit"};
+constexpr ModifierPair GERMAN_ADJECTIVES[] = {
+    {L"ober", L"unter"}, {L"inner", L"äußer"}, {L"vorder", L"hinter"},
+};
+
+constexpr ModifierPair ENGLISH_ORDINALS = {L"first", L"second"};
+constexpr ModifierPair ENGLISH_ADJECTIVES[] = {
+    {L"upper", L"lower"}, {L"inner", L"outer"}, {L"front", L"rear"},
+};
+
+// Reference sentence: prefix, term A, middle, term B, suffix
+struct Template {
+    const wchar_t* prefix;
+    const wchar_t* middle;
+    const wchar_t* suffix;
+};
+
+// Both terms stay in the nominative so articles match the term's gender
+constexpr Template GERMAN_TEMPLATES[] = {
+    {L"", L" und ", L" sind miteinander verbunden."},
+    {L"Ferner ist ", L" vorgesehen, wobei ", L" daran angrenzt."},
+    {L"Wie in Figur 2 gezeigt, sind ", L" und ", L" koaxial angeordnet."},
+    {L"Dabei bilden ", L" und ", L" gemeinsam eine Baugruppe."},
+    {L"Bei der Vorrichtung sind ", L" und ", L" vorgesehen."},
+    {L"", L" wirkt hierbei so, dass ", L" entlastet wird."},
+};
+
+constexpr const wchar_t* GERMAN_FILLERS[] = {
+    L"Die Anordnung ermöglicht eine kompakte Bauweise.",
+    L"Dadurch wird der Verschleiß deutlich verringert.",
+    L"Diese Ausgestaltung ist besonders vorteilhaft.",
+    L"Weitere Vorteile ergeben sich aus der nachfolgenden Beschreibung.",
+    L"Die Montage gestaltet sich hierdurch besonders einfach.",
+    L"Gemäß einer bevorzugten Ausführungsform ist die Anordnung symmetrisch aufgebaut.",
+    L"Hierbei können übliche Werkstoffe verwendet werden.",
+};
+
+constexpr Template ENGLISH_TEMPLATES[] = {
+    {L"", L" and ", L" are connected to each other."},
+    {L"Further, ", L" is provided, wherein ", L" is adjacent thereto."},
+    {L"As shown in FIG. 2, ", L" and ", L" are arranged coaxially."},
+    {L"Together, ", L" and ", L" form an assembly."},
+    {L"In the device, ", L" and ", L" are provided."},
+    {L"", L" acts such that ", L" is relieved."},
+};
+
+constexpr const wchar_t* ENGLISH_FILLERS[] = {
+    L"This arrangement allows a compact design.",
+    L"Wear is thereby considerably reduced.",
+    L"This configuration is particularly advantageous.",
+    L"Further advantages result from the following description.",
+    L"Assembly is thereby particularly simple.",
+    L"According to a preferred embodiment, the arrangement is symmetrical.",
+    L"Conventional materials may be used here.",
+};
+
+struct Term {
+    std::wstring modifier;  // Ordinal/adjective stem, empty for single-word terms
+    std::wstring noun;
+    Gender gender;
+    std::wstring bz;        // Assigned on the first numbered mention
+    bool introduced = false;
+    int group = -1;         // Index into Generator::m_groups for multi-word terms
+};
+
+struct Group {
+    std::wstring baseStem;
+    bool ordinal;
+    size_t firstTerm;
+    size_t secondTerm;
+};
+
+std::wstring transliterate(std::wstring_view text) {
+    std::wstring out;
+    out.reserve(text.size());
+    for (wchar_t c : text) {
+        switch (c) {
+        case L'ä': out += L"ae"; break;
+        case L'ö': out += L"oe"; break;
+        case L'ü': out += L"ue"; break;
+        case L'Ä': out += L"Ae"; break;
+        case L'Ö': out += L"Oe"; break;
+        case L'Ü': out += L"Ue"; break;
+        case L'ß': out += L"ss"; break;
+        default: out += c; break;
+        }
+    }
+    return out;
+}
+
+// Compound bases keep their first letter lowercase (Öffnung -> Antriebsöffnung)
+std::wstring lowercaseFirst(std::wstring word) {
+    if (!word.empty()) {
+        word[0] = CaseFolding::foldChar(word[0]);
+    }
+    return word;
+}
+
+class Generator {
+public:
+    explicit Generator(const CorpusGenerator::Options& options)
+        : m_options(options),
+          m_german(options.language == CorpusGenerator::Language::GERMAN),
+          m_rng(options.seed) {
+        if (m_german) {
+            m_analyzer = std::make_unique<GermanTextAnalyzer>();
+        } else {
+            m_analyzer = std::make_unique<EnglishTextAnalyzer>();
+        }
+    }
+
+    CorpusGenerator::Corpus run() {
+        buildVocabulary();
+        m_corpus.text.reserve(m_options.targetChars + 256);
+
+        const int missing = std::clamp(m_options.missingNumberPercent, 0, 100);
+        const int conflict = std::clamp(m_options.conflictPercent, 0, 100 - missing);
+        const int article = std::clamp(m_options.wrongArticlePercent, 0, 100 - missing - conflict);
+        m_missingLimit = missing;
+        m_conflictLimit = missing + conflict;
+        m_articleLimit = missing + conflict + article;
+
+        std::uniform_int_distribution<int> percent(0, 99);
+        while (m_corpus.text.size() < m_options.targetChars) {
+            if (m_terms.size() >= 2 && percent(m_rng) < m_options.referenceDensity) {
+                referenceSentence();
+            } else {
+                fillerSentence();
+            }
+            append(percent(m_rng) < 10 ? L"\n" : L" ");
+        }
+
+        collectTruth();
+        return std::move(m_corpus);
+    }
+
+private:
+    // Localized text: transliterated when umlauts are disabled
+    std::wstring localize(std::wstring_view text) const {
+        if (m_german && !m_options.umlauts) {
+            return transliterate(text);
+        }
+        return std::wstring(text);
+    }
+
+    void append(std::wstring_view text) {
+        if (m_german && !m_options.umlauts) {
+            m_corpus.text += transliterate(text);
+        } else {
+            m_corpus.text += text;
+        }
+    }
+
+    // Accept a noun if its stem is new, so no two terms collide after stemming
+    bool claimStem(const std::wstring& noun, std::wstring& stem) {
+        if (m_analyzer->isIgnoredWord(noun)) {
+            return false;
+        }
+        stem = m_analyzer->createStemVector(noun).back();
+        return m_usedStems.insert(stem).second;
+    }
+
+    void buildVocabulary() {
+        const Noun* nouns = m_german ? GERMAN_NOUNS : ENGLISH_NOUNS;
+        const size_t nounCount = m_german ? std::size(GERMAN_NOUNS) : std::size(ENGLISH_NOUNS);
+        const wchar_t* const* prefixes = m_german ? GERMAN_PREFIXES : ENGLISH_PREFIXES;
+        const size_t prefixCount = m_german ? std::size(GERMAN_PREFIXES) : std::size(ENGLISH_PREFIXES);
+
+        // Base nouns first, then compounds, each in seeded random order
+        std::vector<size_t> baseOrder(nounCount);
+        for (size_t i = 0; i < nounCount; ++i) {
+            baseOrder[i] = i;
+        }
+        std::shuffle(baseOrder.begin(), baseOrder.end(), m_rng);
+
+        std::vector<std::pair<size_t, size_t>> compoundOrder;
+        compoundOrder.reserve(prefixCount * nounCount);
+        for (size_t p = 0; p < prefixCount; ++p) {
+            for (size_t n = 0; n < nounCount; ++n) {
+                compoundOrder.emplace_back(p, n);
+            }
+        }
+        std::shuffle(compoundOrder.begin(), compoundOrder.end(), m_rng);
+
+        const size_t vocabulary = m_options.vocabularySize;
+        size_t ordinalGroups = std::min(m_options.ordinalPairs, vocabulary / 2);
+        size_t adjectiveGroups = std::min(m_options.multiWordPairs, (vocabulary - 2 * ordinalGroups) / 2);
+
+        const ModifierPair ordinals = m_german ? GERMAN_ORDINALS : ENGLISH_ORDINALS;
+        const ModifierPair* adjectives = m_german ? GERMAN_ADJECTIVES : ENGLISH_ADJECTIVES;
+        const size_t adjectiveCount = m_german ? std::size(GERMAN_ADJECTIVES) : std::size(ENGLISH_ADJECTIVES);
+
+        for (size_t index : baseOrder) {
+            if (m_terms.size() >= vocabulary) {
+                break;
+            }
+            const Noun& noun = nouns[index];
+            std::wstring word = localize(noun.word);
+            std::wstring stem;
+            if (!claimStem(word, stem)) {
+                continue;
+            }
+
+            if (ordinalGroups > 0 || adjectiveGroups > 0) {
+                const bool ordinal = ordinalGroups > 0;
+                const ModifierPair pair = ordinal ? ordinals : adjectives[m_groups.size() % adjectiveCount];
+                (ordinal ? ordinalGroups : adjectiveGroups)--;
+
+                Group group{stem, ordinal, m_terms.size(), m_terms.size() + 1};
+                m_terms.push_back({localize(pair.first), word, noun.gender, L"", false, static_cast<int>(m_groups.size())});
+                m_terms.push_back({localize(pair.second), word, noun.gender, L"", false, static_cast<int>(m_groups.size())});
+                m_groups.push_back(std::move(group));
+            } else {
+                m_terms.push_back({L"", word, noun.gender, L"", false, -1});
+            }
+        }
+
+        for (const auto& [p, n] : compoundOrder) {
+            if (m_terms.size() >= vocabulary) {
+                break;
+            }
+            std::wstring word = localize(std::wstring(prefixes[p]) + lowercaseFirst(nouns[n].word));
+            std::wstring stem;
+            if (claimStem(word, stem)) {
+                m_terms.push_back({L"", word, nouns[n].gender, L"", false, -1});
+            }
+        }
+    }
+
+    std::wstring articleFor(const Term& term, bool definite) const {
+        if (m_german) {
+            switch (term.gender) {
+            case Gender::MASCULINE: return definite ? L"der" : L"ein";
+            case Gender::FEMININE: return definite ? L"die" : L"eine";
+            case Gender::NEUTER: return definite ? L"das" : L"ein";
+            }
+        }
+        if (definite) {
+            return L"the";
+        }
+        const std::wstring& next = term.modifier.empty() ? term.noun : term.modifier;
+        return std::wstring(L"aeiou").find(next[0]) != std::wstring::npos ? L"an" : L"a";
+    }
+
+    // German adjective ending: weak after the definite article, mixed after the indefinite
+    std::wstring modifierFor(const Term& term, bool definite) const {
+        if (!m_german) {
+            return term.modifier;
+        }
+        if (definite) {
+            return term.modifier + L"e";
+        }
+        switch (term.gender) {
+        case Gender::MASCULINE: return term.modifier + L"er";
+        case Gender::FEMININE: return term.modifier + L"e";
+        case Gender::NEUTER: return term.modifier + L"es";
+        }
+        return term.modifier;
+    }
+
+    void mention(size_t index, bool sentenceStart) {
+        std::uniform_int_distribution<int> percent(0, 99);
+        Term& term = m_terms[index];
+        const bool first = !term.introduced;
+
+        // Missing numbers and conflicts are only planted after the term has its own BZ
+        const int roll = percent(m_rng);
+        const bool missingNumber = !first && roll < m_missingLimit;
+        const bool conflict = !first && !missingNumber && roll < m_conflictLimit && m_introduced.size() >= 2;
+        const bool wrongArticle = !missingNumber && !conflict && roll >= m_conflictLimit && roll < m_articleLimit;
+
+        const bool definite = wrongArticle ? first : !first;
+        std::wstring article = articleFor(term, definite);
+        if (sentenceStart) {
+            article[0] = CaseFolding::upperChar(article[0]);
+        }
+
+        std::wstring& text = m_corpus.text;
+        const size_t articleStart = text.size();
+        append(article);
+        append(L" ");
+
+        const size_t termStart = text.size();
+        if (!term.modifier.empty()) {
+            append(modifierFor(term, definite));
+            append(L" ");
+        }
+        append(term.noun);
+        const size_t termEnd = text.size();
+
+        if (missingNumber) {
+            m_corpus.truth.errors.push_back({CorpusGenerator::ErrorKind::MISSING_NUMBER, termStart, termEnd, term.bz});
+            return;
+        }
+
+        if (first) {
+            term.bz = std::to_wstring(m_nextBz);
+            m_nextBz += 2;
+            term.introduced = true;
+            m_introduced.push_back(index);
+        }
+
+        std::wstring bz = term.bz;
+        if (conflict) {
+            std::uniform_int_distribution<size_t> pick(0, m_introduced.size() - 1);
+            size_t other = m_introduced[pick(m_rng)];
+            while (other == index) {
+                other = m_introduced[pick(m_rng)];
+            }
+            bz = m_terms[other].bz;
+        }
+
+        append(L" ");
+        append(bz);
+
+        m_corpus.truth.bzToOriginalWords[bz].insert(text.substr(termStart, termEnd - termStart));
+        m_bzToTerms[bz].insert(index);
+        m_termToBz[index].insert(bz);
+
+        if (conflict) {
+            m_corpus.truth.errors.push_back({CorpusGenerator::ErrorKind::CONFLICT, termStart, text.size(), bz});
+        }
+        if (wrongArticle) {
+            m_corpus.truth.errors.push_back(
+                {CorpusGenerator::ErrorKind::WRONG_ARTICLE, articleStart, articleStart + article.size(), term.bz});
+        }
+    }
+
+    void referenceSentence() {
+        const Template* templates = m_german ? GERMAN_TEMPLATES : ENGLISH_TEMPLATES;
+        const size_t templateCount = m_german ? std::size(GERMAN_TEMPLATES) : std::size(ENGLISH_TEMPLATES);
+        std::uniform_int_distribution<size_t> pickTemplate(0, templateCount - 1);
+        std::uniform_int_distribution<size_t> pickTerm(0, m_terms.size() - 1);
+
+        const Template& sentence = templates[pickTemplate(m_rng)];
+        const size_t a = pickTerm(m_rng);
+        size_t b = pickTerm(m_rng);
+        while (b == a) {
+            b = pickTerm(m_rng);
+        }
+
+        append(sentence.prefix);
+        mention(a, sentence.prefix[0] == L'\0');
+        append(sentence.middle);
+        mention(b, false);
+        append(sentence.suffix);
+    }
+
+    void fillerSentence() {
+        const wchar_t* const* fillers = m_german ? GERMAN_FILLERS : ENGLISH_FILLERS;
+        const size_t fillerCount = m_german ? std::size(GERMAN_FILLERS) : std::size(ENGLISH_FILLERS);
+        std::uniform_int_distribution<size_t> pickFiller(0, fillerCount - 1);
+        append(fillers[pickFiller(m_rng)]);
+    }
+
+    void collectTruth() {
+        CorpusGenerator::GroundTruth& truth = m_corpus.truth;
+
+        // Mirrors ConflictGraph: several terms on one BZ, or one term on several BZs
+        for (const auto& [bz, terms] : m_bzToTerms) {
+            if (terms.size() > 1 || m_termToBz[*terms.begin()].size() > 1) {
+                truth.conflictingBz.insert(bz);
+            }
+        }
+
+        for (const Group& group : m_groups) {
+            const bool firstUsed = m_terms[group.firstTerm].introduced;
+            const bool secondUsed = m_terms[group.secondTerm].introduced;
+            if (firstUsed || secondUsed) {
+                truth.multiWordBaseStems.insert(group.baseStem);
+            }
+            if (group.ordinal && firstUsed && secondUsed) {
+                truth.ordinalBaseStems.insert(group.baseStem);
+            }
+        }
+    }
+
+    const CorpusGenerator::Options& m_options;
+    const bool m_german;
+    std::mt19937 m_rng;
+    std::unique_ptr<TextAnalyzer> m_analyzer;
+
+    std::vector<Term> m_terms;
+    std::vector<Group> m_groups;
+    std::set<std::wstring> m_usedStems;
+    std::vector<size_t> m_introduced;
+    int m_nextBz = 10;
+
+    int m_missingLimit = 0;
+    int m_conflictLimit = 0;
+    int m_articleLimit = 0;
+
+    std::map<std::wstring, std::set<size_t>> m_bzToTerms;
+    std::map<size_t, std::set<std::wstring>> m_termToBz;
+
+    CorpusGenerator::Corpus m_corpus;
+};
+
+template <typename Set>
+void writeJsonArray(std::ostream& out, const Set& values) {
+    out << '[';
+    bool first = true;
+    for (const auto& value : values) {
+        out << (first ? "" : ", ");
+        JsonEscape::write(out, value);
+        first = false;
+    }
+    out << ']';
+}
+
+} // namespace
+
+size_t CorpusGenerator::GroundTruth::count(ErrorKind kind) const {
+    return static_cast<size_t>(std::count_if(errors.begin(), errors.end(),
+        [kind](const PlantedError& error) { return error.kind == kind; }));
+}
+
+CorpusGenerator::Corpus CorpusGenerator::generate(const Options& options) {
+    return Generator(options).run();
+}
+
+void CorpusGenerator::writeText(std::ostream& out, const std::wstring& text) {
+    out << RE2RegexHelper::wstringToUtf8(text);
+}
+
+const char* CorpusGenerator::errorKindName(ErrorKind kind) {
+    switch (kind) {
+    case ErrorKind::MISSING_NUMBER: return "missing_number";
+    case ErrorKind::WRONG_ARTICLE: return "wrong_article";
+    case ErrorKind::CONFLICT: return "conflict";
+    }
+    return "unknown";
+}
+
+void CorpusGenerator::writeGroundTruth(std::ostream& out, const Options& options, const GroundTruth& truth) {
+    out << "{\n";
+    out << "  \"language\": \"" << (options.language == Language::GERMAN ? "de" : "en") << "\",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"targetChars\": " << options.targetChars << ",\n";
+    out << "  \"vocabularySize\": " << options.vocabularySize << ",\n";
+    out << "  \"referenceDensity\": " << options.referenceDensity << ",\n";
+    out << "  \"ordinalPairs\": " << options.ordinalPairs << ",\n";
+    out << "  \"multiWordPairs\": " << options.multiWordPairs << ",\n";
+    out << "  \"umlauts\": " << (options.umlauts ? "true" : "false") << ",\n";
+    out << "  \"missingNumberPercent\": " << options.missingNumberPercent << ",\n";
+    out << "  \"conflictPercent\": " << options.conflictPercent << ",\n";
+    out << "  \"wrongArticlePercent\": " << options.wrongArticlePercent << ",\n";
+
+    out << "  \"multiWordBaseStems\": ";
+    writeJsonArray(out, truth.multiWordBaseStems);
+    out << ",\n  \"ordinalBaseStems\": ";
+    writeJsonArray(out, truth.ordinalBaseStems);
+    out << ",\n  \"conflictingBz\": ";
+    writeJsonArray(out, truth.conflictingBz);
+
+    out << ",\n  \"bzToOriginalWords\": {";
+    bool first = true;
+    for (const auto& [bz, words] : truth.bzToOriginalWords) {
+        out << (first ? "\n    " : ",\n    ");
+        JsonEscape::write(out, bz);
+        out << ": ";
+        writeJsonArray(out, words);
+        first = false;
+    }
+    out << "\n  },\n";
+
+    out << "  \"errors\": [";
+    first = true;
+    for (const PlantedError& error : truth.errors) {
+        out << (first ? "\n    " : ",\n    ");
+        out << "{\"type\": \"" << errorKindName(error.kind) << "\", \"start\": " << error.start
+            << ", \"end\": " << error.end << ", \"bz\": ";
+        JsonEscape::write(out, error.bz);
+        out << '}';
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,342 @@
+#include "DifferentialHarness.h"
+#include "EditSession.h"
+#include "ReferenceScanner.h"
+#include "ScanPipeline.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// Messages differ between engines, the exception type must not
+std::string exceptionType(const std::exception& e) {
+    if (dynamic_cast<const std::range_error*>(&e)) {
+        return "std::range_error";
+    }
+    if (dynamic_cast<const std::out_of_range*>(&e)) {
+        return "std::out_of_range";
+    }
+    if (dynamic_cast<const std::invalid_argument*>(&e)) {
+        return "std::invalid_argument";
+    }
+    if (dynamic_cast<const std::bad_alloc*>(&e)) {
+        return "std::bad_alloc";
+    }
+    return "std::exception";
+}
+
+template <typename Scan>
+ScanSnapshot guarded(Scan&& scan) {
+    try {
+        return scan();
+    } catch (const std::exception& e) {
+        ScanSnapshot failed;
+        failed.exception = exceptionType(e);
+        return failed;
+    }
+}
+
+// Fragments that exercise the scanner: terms, numbers, articles, ordinals
+const wchar_t* const INSERTIONS[] = {
+    L" 10",      L" 12a",      L" 14'",     L" 1",         L"der ",      L"die ",
+    L"das ",     L"ein ",      L"eine ",    L"the ",       L"a ",        L"an ",
+    L"erste ",   L"zweiten ",  L"first ",   L"second ",    L"Lager ",    L"Welle 20 ",
+    L"Gehäuse ", L"housing ",  L"shaft 20 ", L"ß",         L"Ä",         L"ü",
+    L"\n",       L"  ",        L"\t",       L". ",         L", ",        L"-",
+};
+
+size_t randomBelow(std::mt19937& rng, size_t bound) {
+    return bound == 0 ? 0 : std::uniform_int_distribution<size_t>(0, bound - 1)(rng);
+}
+
+using Input = DifferentialHarness::Input;
+
+// Replace [position, position + erased) by inserted; paragraph starts shift as
+// in the GUI, cleared ranges after the edit move and those it touches are dropped
+void replaceSpan(Input& input, size_t position, size_t erased, const std::wstring& inserted) {
+    erased = std::min(erased, input.text.size() - position);
+    input.text.replace(position, erased, inserted);
+    EditSession::shiftParagraphs(input.decisions.paragraphStarts, position, erased, inserted.size());
+
+    std::set<std::pair<size_t, size_t>> moved;
+    for (const auto& [start, end] : input.decisions.clearedRanges) {
+        if (end <= position) {
+            moved.emplace(start, end);
+        } else if (start >= position + erased) {
+            moved.emplace(start - erased + inserted.size(), end - erased + inserted.size());
+        }
+    }
+    input.decisions.clearedRanges = std::move(moved);
+}
+
+// Each scan of a minimization attempt is a full scan; stop refining after this many
+constexpr size_t MAX_ATTEMPTS = 20000;
+
+// Drop each element of current.decisions.*member that stillFails does not need
+template <typename Container>
+void dropUnneeded(Input& current, Container ScanDecisions::*member,
+                  const std::function<bool(const Input&)>& stillFails, size_t& attempts) {
+    for (size_t i = 0; i < (current.decisions.*member).size() && attempts < MAX_ATTEMPTS;) {
+        Input candidate = current;
+        Container& values = candidate.decisions.*member;
+        values.erase(std::next(values.begin(), static_cast<std::ptrdiff_t>(i)));
+        ++attempts;
+        if (stillFails(candidate)) {
+            current = std::move(candidate);
+        } else {
+            ++i;
+        }
+    }
+}
+
+} // namespace
+
+DifferentialHarness::Engine DifferentialHarness::referenceEngine(bool useGerman) {
+    auto scanner = std::make_shared<ReferenceScanner>(useGerman);
+    return [scanner](const Input& input) {
+        return guarded([&] { return scanner->run(input.text, input.decisions); });
+    };
+}
+
+DifferentialHarness::Engine DifferentialHarness::pipelineEngine(bool useGerman) {
+    auto pipeline = std::make_shared<ScanPipeline>(useGerman);
+    return [pipeline](const Input& input) {
+        return guarded([&] {
+            // The decisions as the GUI keeps them, replacing those of the previous input
+            const ScanDecisions& decisions = input.decisions;
+            AnalysisContext& ctx = pipeline->context();
+            ctx.clearedErrors = {decisions.clearedBz.begin(), decisions.clearedBz.end()};
+            ctx.clearedTextAnchors.clear();
+            for (const auto& [start, end] : decisions.clearedRanges) {
+                ctx.clearedTextAnchors.add(input.text, start, end);
+            }
+            ctx.ignoredWords = {decisions.ignoredWords.begin(), decisions.ignoredWords.end()};
+
+            pipeline->run(input.text, decisions.paragraphStarts);
+            return ScanSnapshot::capture(*pipeline);
+        });
+    };
+}
+
+std::optional<std::string> DifferentialHarness::compare(const Input& input, const Engine& reference,
+                                                        const Engine& candidate) {
+    return ScanSnapshot::firstDivergence(reference(input), candidate(input));
+}
+
+DifferentialHarness::Input DifferentialHarness::corpusInput(const std::wstring& text) {
+    Input input(text);
+    input.decisions.paragraphStarts.push_back(0);
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == L'\n' && i + 1 < text.size()) {
+            input.decisions.paragraphStarts.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+    return input;
+}
+
+std::optional<DifferentialHarness::Divergence> DifferentialHarness::run(const Options& options,
+                                                                        const Engine& reference,
+                                                                        const Engine& candidate,
+                                                                        std::ostream* progress) {
+    const Input corpus = corpusInput(CorpusGenerator::generate(options.corpus).text);
+    std::mt19937 rng(options.seed);
+
+    for (size_t iteration = 0; iteration <= options.mutations; ++iteration) {
+        if (progress && iteration % 50 == 0) {
+            *progress << "input " << iteration << " / " << options.mutations << "\n";
+        }
+
+        Input input = corpus;
+        if (iteration > 0) {
+            input = mutate(corpus, rng, options.maxEditsPerMutation);
+            decide(input, reference(input), rng);
+        }
+        std::optional<std::string> difference = compare(input, reference, candidate);
+        if (!difference) {
+            continue;
+        }
+
+        Divergence divergence;
+        divergence.iteration = iteration;
+        divergence.input = input;
+        divergence.minimized = input;
+        if (options.minimize) {
+            divergence.minimized = minimize(input, [&](const Input& shrunk) {
+                return compare(shrunk, reference, candidate).has_value();
+            });
+            difference = compare(divergence.minimized, reference, candidate);
+        }
+        divergence.description = difference.value_or("");
+        return divergence;
+    }
+    return std::nullopt;
+}
+
+DifferentialHarness::Input DifferentialHarness::mutate(const Input& input, std::mt19937& rng, size_t maxEdits) {
+    Input result = input;
+    std::wstring& text = result.text;
+    const size_t edits = 1 + randomBelow(rng, std::max<size_t>(maxEdits, 1));
+
+    for (size_t edit = 0; edit < edits; ++edit) {
+        const size_t pos = randomBelow(rng, text.size() + 1);
+        const size_t span = std::min(1 + randomBelow(rng, 40), text.size() - pos);
+
+        switch (randomBelow(rng, 6)) {
+        case 0:  // Delete a span
+            replaceSpan(result, pos, span, L"");
+            break;
+        case 1:  // Duplicate a span in place
+            replaceSpan(result, pos, 0, text.substr(pos, span));
+            break;
+        case 2: {  // Copy a span somewhere else
+            const std::wstring piece = text.substr(pos, span);
+            replaceSpan(result, randomBelow(rng, text.size() + 1), 0, piece);
+            break;
+        }
+        case 3:  // Insert a scanner-relevant fragment
+            replaceSpan(result, pos, 0, INSERTIONS[randomBelow(rng, std::size(INSERTIONS))]);
+            break;
+        case 4:  // Change the next digit
+            for (size_t i = pos; i < text.size(); ++i) {
+                if (text[i] >= L'0' && text[i] <= L'9') {
+                    replaceSpan(result, i, 1, std::wstring(1, static_cast<wchar_t>(L'0' + randomBelow(rng, 10))));
+                    break;
+                }
+            }
+            break;
+        default:  // Flip the case of an ASCII letter
+            if (pos < text.size() && ((text[pos] >= L'a' && text[pos] <= L'z') ||
+                                      (text[pos] >= L'A' && text[pos] <= L'Z'))) {
+                replaceSpan(result, pos, 1, std::wstring(1, static_cast<wchar_t>(text[pos] ^ 0x20)));
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+void DifferentialHarness::decide(Input& input, const ScanSnapshot& snapshot, std::mt19937& rng) {
+    ScanDecisions& decisions = input.decisions;
+    std::vector<uint32_t>& starts = decisions.paragraphStarts;
+
+    switch (randomBelow(rng, 4)) {
+    case 0:  // A pasted text has no paragraph table
+        starts.clear();
+        break;
+    case 1: {  // A paragraph starting anywhere, also inside a word
+        const auto start = static_cast<uint32_t>(randomBelow(rng, input.text.size() + 1));
+        if (starts.empty()) {
+            starts.push_back(0);
+        }
+        const auto at = std::lower_bound(starts.begin(), starts.end(), start);
+        if (at == starts.end() || *at != start) {
+            starts.insert(at, start);
+        }
+        break;
+    }
+    case 2:  // Two paragraphs merged
+        if (starts.size() > 1) {
+            starts.erase(starts.begin() + static_cast<std::ptrdiff_t>(1 + randomBelow(rng, starts.size() - 1)));
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Errors cleared from the text, conflicts cleared per BZ
+    for (size_t n = randomBelow(rng, 4); n > 0 && !snapshot.allErrors.empty(); --n) {
+        const ScanSnapshot::ErrorRange& error = snapshot.allErrors[randomBelow(rng, snapshot.allErrors.size())];
+        decisions.clearedRanges.emplace(error.first, error.second);
+    }
+    for (size_t n = randomBelow(rng, 3); n > 0 && !snapshot.conflictingBz.empty(); --n) {
+        decisions.clearedBz.insert(snapshot.conflictingBz[randomBelow(rng, snapshot.conflictingBz.size())]);
+    }
+
+    // Now and then a single-word term the user never wants to see as one
+    if (randomBelow(rng, 4) == 0 && !snapshot.bzToOriginalWords.empty()) {
+        const auto bz = std::next(snapshot.bzToOriginalWords.begin(),
+                                  static_cast<std::ptrdiff_t>(randomBelow(rng, snapshot.bzToOriginalWords.size())));
+        const std::wstring& word =
+            *std::next(bz->second.begin(), static_cast<std::ptrdiff_t>(randomBelow(rng, bz->second.size())));
+        if (word.find(L' ') == std::wstring::npos) {
+            decisions.ignoredWords.insert(word);
+        }
+    }
+}
+
+DifferentialHarness::Input DifferentialHarness::minimize(const Input& input,
+                                                         const std::function<bool(const Input&)>& stillFails) {
+    size_t attempts = 0;
+
+    Input current = input;
+    size_t chunk = std::max<size_t>(current.text.size() / 2, 1);
+    while (attempts < MAX_ATTEMPTS) {
+        bool removedAny = false;
+        for (size_t start = 0; start < current.text.size() && attempts < MAX_ATTEMPTS;) {
+            Input candidate = current;
+            replaceSpan(candidate, start, chunk, L"");
+            ++attempts;
+            if (stillFails(candidate)) {
+                current = std::move(candidate);
+                removedAny = true;
+            } else {
+                start += chunk;
+            }
+        }
+        if (!removedAny) {
+            if (chunk == 1) {
+                break;
+            }
+            chunk /= 2;
+        }
+    }
+
+    dropUnneeded(current, &ScanDecisions::paragraphStarts, stillFails, attempts);
+    dropUnneeded(current, &ScanDecisions::clearedBz, stillFails, attempts);
+    dropUnneeded(current, &ScanDecisions::clearedRanges, stillFails, attempts);
+    dropUnneeded(current, &ScanDecisions::ignoredWords, stillFails, attempts);
+    return current;
+}
+
+std::wstring DifferentialHarness::decodeFuzzInput(const uint8_t* data, size_t size) {
+    constexpr wchar_t REPLACEMENT = 0xFFFD;
+    std::wstring text;
+    text.reserve(size);
+
+    size_t i = 0;
+    while (i < size) {
+        const uint8_t lead = data[i];
+        size_t length = 0;
+        uint32_t code = 0;
+        if (lead < 0x80) {
+            length = 1;
+            code = lead;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            code = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            code = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            code = lead & 0x07;
+        }
+
+        bool valid = length > 0 && i + length <= size;
+        for (size_t k = 1; valid && k < length; ++k) {
+            valid = (data[i + k] & 0xC0) == 0x80;
+            code = (code << 6) | (data[i + k] & 0x3F);
+        }
+        // Overlong forms, surrogates and values outside Unicode (or wchar_t)
+        static constexpr uint32_t MIN_CODE[] = {0, 0, 0x80, 0x800, 0x10000};
+        valid = valid && code >= MIN_CODE[length] && code <= 0x10FFFF && (code < 0xD800 || code > 0xDFFF);
+        if (valid && sizeof(wchar_t) == 2 && code > 0xFFFF) {
+            valid = false;
+        }
+
+        text += valid ? static_cast<wchar_t>(code) : REPLACEMENT;
+        i += valid ? length : 1;
+    }
+    return text;
+}
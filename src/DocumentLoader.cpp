@@ -0,0 +1,81 @@
+#include "DocumentLoader.h"
+#include "DocxImporter.h"
+#include "Trace.h"
+#include "ZipArchive.h"
+#include <algorithm>
+
+DocumentLoader::Result DocumentLoader::load(const MappedFile& file, const ChunkSink& sink,
+                                            std::stop_token stop, size_t chunkBytes) {
+    if (ZipArchive::isZip(file.data(), file.size())) {
+        return DocxImporter::load(file, sink, stop, chunkBytes);
+    }
+
+    BZ_TRACE_SCOPE("DocumentLoader::load");
+    const TextDecoder::Detection detection = TextDecoder::detect(file.data(), file.size());
+    TextDecoder decoder(detection.encoding);
+    chunkBytes = std::max<size_t>(chunkBytes, 1);
+
+    Result result;
+    result.encoding = detection.encoding;
+
+    bool pendingCarriageReturn = false;
+    bool atLineStart = true;
+    size_t offset = std::min(detection.bomBytes, file.size());
+    do {
+        if (stop.stop_requested()) {
+            return result;
+        }
+
+        const size_t length = std::min(chunkBytes, file.size() - offset);
+        const bool last = offset + length == file.size();
+        std::wstring decoded;
+        decoder.decode(file.data() + offset, length, last, decoded);
+        offset += length;
+
+        // "\r\n" and lone "\r" become "\n"; a "\r" ending the chunk waits for the next one
+        std::wstring chunk;
+        chunk.reserve(decoded.size() + 1);
+        auto append = [&](wchar_t c) {
+            if (atLineStart) {
+                ++result.paragraphs;
+            }
+            chunk += c;
+            atLineStart = c == L'\n';
+        };
+        for (wchar_t c : decoded) {
+            if (pendingCarriageReturn) {
+                append(L'\n');
+                pendingCarriageReturn = false;
+                if (c == L'\n') {
+                    continue;
+                }
+            }
+            if (c == L'\r') {
+                pendingCarriageReturn = true;
+            } else {
+                append(c);
+            }
+        }
+        if (last && pendingCarriageReturn) {
+            append(L'\n');
+        }
+
+        result.characters += chunk.size();
+        if (!chunk.empty() || last) {
+            sink(std::move(chunk), offset, file.size());
+        }
+    } while (offset < file.size());
+
+    result.completed = true;
+    return result;
+}
+
+std::wstring DocumentLoader::loadAll(const std::string& path, TextDecoder::Encoding* encoding) {
+    MappedFile file(path);
+    std::wstring text;
+    Result result = load(file, [&](std::wstring&& chunk, size_t, size_t) { text += chunk; });
+    if (encoding) {
+        *encoding = result.encoding;
+    }
+    return text;
+}
@@ -0,0 +1,124 @@
+#include "DocxImporter.h"
+#include "TextDecoder.h"
+#include "Trace.h"
+#include "XmlReader.h"
+#include "ZipArchive.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+constexpr const char* MAIN_DOCUMENT_PART = "word/document.xml";
+
+class DocumentHandler : public XmlReader::Handler {
+public:
+    explicit DocumentHandler(std::vector<uint32_t>& paragraphStarts) : m_paragraphStarts(paragraphStarts) {}
+
+    void startElement(std::string_view name, const XmlReader::Attributes&) override {
+        if (m_skipDepth > 0) {
+            ++m_skipDepth;
+            return;
+        }
+        const std::string_view local = XmlReader::localName(name);
+        if (local == "p") {
+            // A paragraph nested in an empty one (text box) starts at the same offset
+            const auto start = static_cast<uint32_t>(m_emitted + m_text.size());
+            if (m_paragraphStarts.empty() || m_paragraphStarts.back() != start) {
+                m_paragraphStarts.push_back(start);
+            }
+        } else if (local == "r") {
+            ++m_runDepth;
+        } else if (local == "Fallback") {
+            m_skipDepth = 1;  // mc:Choice already holds the same content
+        } else if (m_runDepth > 0) {
+            // Only inside runs: w:pPr/w:tabs/w:tab is a tab stop, not a tab
+            if (local == "t") {
+                m_inText = true;
+            } else if (local == "tab") {
+                m_text += L'\t';
+            } else if (local == "br" || local == "cr") {
+                m_text += L'\n';
+            } else if (local == "noBreakHyphen") {
+                m_text += L'-';
+            }
+        }
+    }
+
+    void endElement(std::string_view name) override {
+        if (m_skipDepth > 0) {
+            --m_skipDepth;
+            return;
+        }
+        const std::string_view local = XmlReader::localName(name);
+        if (local == "p") {
+            m_text += L'\n';
+        } else if (local == "r") {
+            m_runDepth = std::max(m_runDepth, 1) - 1;
+        } else if (local == "t") {
+            m_inText = false;
+        }
+    }
+
+    void characters(std::string_view text) override {
+        if (m_inText && m_skipDepth == 0) {
+            m_decoder.decode(text.data(), text.size(), false, m_text);
+        }
+    }
+
+    size_t pendingCharacters() const { return m_text.size(); }
+
+    std::wstring take() {
+        std::wstring chunk = std::move(m_text);
+        m_text.clear();
+        m_emitted += chunk.size();
+        return chunk;
+    }
+
+private:
+    std::vector<uint32_t>& m_paragraphStarts;
+    TextDecoder m_decoder{TextDecoder::Encoding::UTF8};
+    std::wstring m_text;   // Decoded since the last take()
+    size_t m_emitted = 0;  // Characters already taken
+    int m_runDepth = 0;
+    int m_skipDepth = 0;
+    bool m_inText = false;
+};
+
+} // namespace
+
+DocumentLoader::Result DocxImporter::load(const MappedFile& file, const DocumentLoader::ChunkSink& sink,
+                                          std::stop_token stop, size_t chunkCharacters) {
+    BZ_TRACE_SCOPE("DocxImporter::load");
+    ZipArchive archive(file);
+    const ZipArchive::Entry* entry = archive.find(MAIN_DOCUMENT_PART);
+    if (!entry) {
+        throw std::runtime_error("not a Word document: " + std::string(MAIN_DOCUMENT_PART) + " is missing");
+    }
+    chunkCharacters = std::max<size_t>(chunkCharacters, 1);
+
+    DocumentLoader::Result result;
+    result.format = DocumentLoader::Format::DOCX;
+    DocumentHandler handler(result.paragraphStarts);
+    XmlReader reader(handler);
+
+    archive.extract(*entry, [&](const uint8_t* out, size_t size) {
+        reader.feed(reinterpret_cast<const char*>(out), size);
+        if (handler.pendingCharacters() >= chunkCharacters) {
+            std::wstring chunk = handler.take();
+            result.characters += chunk.size();
+            sink(std::move(chunk), archive.bytesRead(), file.size());
+        }
+    }, stop);
+    result.paragraphs = result.paragraphStarts.size();
+    if (stop.stop_requested()) {
+        return result;
+    }
+    reader.finish();
+
+    std::wstring chunk = handler.take();
+    result.characters += chunk.size();
+    sink(std::move(chunk), file.size(), file.size());
+    result.completed = true;
+    return result;
+}
@@ -0,0 +1,309 @@
+#include "EditSession.h"
+#include "CharClass.h"
+#include "RE2RegexHelper.h"
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const char* const HEADER = "bz-edit-session 1";
+
+std::string escape(const std::wstring& text) {
+    std::string escaped;
+    for (char c : RE2RegexHelper::wstringToUtf8(text)) {
+        switch (c) {
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        case '\t': escaped += "\\t"; break;
+        default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+std::wstring unescape(const std::string& escaped) {
+    std::string raw;
+    raw.reserve(escaped.size());
+    for (size_t i = 0; i < escaped.size(); ++i) {
+        if (escaped[i] != '\\' || i + 1 == escaped.size()) {
+            raw += escaped[i];
+            continue;
+        }
+        switch (escaped[++i]) {
+        case 'n': raw += '\n'; break;
+        case 'r': raw += '\r'; break;
+        case 't': raw += '\t'; break;
+        default: raw += escaped[i]; break;
+        }
+    }
+    return RE2RegexHelper::utf8ToWstring(raw);
+}
+
+void writeEdit(std::ostream& out, const EditSession::Edit& edit) {
+    out << edit.timeMs;
+    if (edit.kind == EditSession::Edit::Kind::INSERT) {
+        out << " + " << edit.position << ' ' << escape(edit.text) << '\n';
+    } else {
+        out << " - " << edit.position << ' ' << edit.length << '\n';
+    }
+}
+
+// "term number" phrases of the document, used as typing material
+std::vector<std::wstring> referencePhrases(const std::wstring& text) {
+    std::vector<std::wstring> phrases;
+    size_t i = 0;
+    while (i < text.size()) {
+        if (!CharClass::isLetter(text[i])) {
+            ++i;
+            continue;
+        }
+        size_t wordEnd = i;
+        while (wordEnd < text.size() && CharClass::isLetter(text[wordEnd])) {
+            ++wordEnd;
+        }
+        size_t numberStart = wordEnd;
+        while (numberStart < text.size() && text[numberStart] == L' ') {
+            ++numberStart;
+        }
+        size_t numberEnd = numberStart;
+        while (numberEnd < text.size() && CharClass::isDigit(text[numberEnd])) {
+            ++numberEnd;
+        }
+        if (numberStart > wordEnd && numberEnd > numberStart && wordEnd - i >= 3) {
+            phrases.push_back(text.substr(i, wordEnd - i) + L" " + text.substr(numberStart, numberEnd - numberStart));
+        }
+        i = wordEnd;
+    }
+    return phrases;
+}
+
+} // namespace
+
+void EditSession::apply(std::wstring& text, const Edit& edit) {
+    const size_t position = std::min(edit.position, text.size());
+    if (edit.kind == Edit::Kind::INSERT) {
+        text.insert(position, edit.text);
+    } else {
+        text.erase(position, std::min(edit.length, text.size() - position));
+    }
+}
+
+std::vector<EditSession::Edit> EditSession::diff(const std::wstring& before, const std::wstring& after,
+                                                 int64_t timeMs) {
+    size_t prefix = 0;
+    const size_t shorter = std::min(before.size(), after.size());
+    while (prefix < shorter && before[prefix] == after[prefix]) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < shorter - prefix &&
+           before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) {
+        ++suffix;
+    }
+
+    std::vector<Edit> edits;
+    const size_t erased = before.size() - prefix - suffix;
+    const size_t inserted = after.size() - prefix - suffix;
+    if (erased > 0) {
+        Edit edit;
+        edit.timeMs = timeMs;
+        edit.kind = Edit::Kind::ERASE;
+        edit.position = prefix;
+        edit.length = erased;
+        edits.push_back(std::move(edit));
+    }
+    if (inserted > 0) {
+        Edit edit;
+        edit.timeMs = timeMs;
+        edit.kind = Edit::Kind::INSERT;
+        edit.position = prefix;
+        edit.text = after.substr(prefix, inserted);
+        edits.push_back(std::move(edit));
+    }
+    return edits;
+}
+
+void EditSession::shiftParagraphs(std::vector<uint32_t>& paragraphStarts, const Edit& edit) {
+    if (edit.kind == Edit::Kind::INSERT) {
+        shiftParagraphs(paragraphStarts, edit.position, 0, edit.text.size());
+    } else {
+        shiftParagraphs(paragraphStarts, edit.position, edit.length, 0);
+    }
+}
+
+void EditSession::shiftParagraphs(std::vector<uint32_t>& paragraphStarts, size_t position, size_t erased,
+                                  size_t inserted) {
+    if (erased > 0) {
+        const size_t end = position + erased;
+        std::erase_if(paragraphStarts, [&](uint32_t start) { return start > position && start <= end; });
+        for (uint32_t& start : paragraphStarts) {
+            if (start > end) {
+                start -= static_cast<uint32_t>(erased);
+            }
+        }
+    }
+    if (inserted > 0) {
+        for (uint32_t& start : paragraphStarts) {
+            if (start > position) {
+                start += static_cast<uint32_t>(inserted);
+            }
+        }
+    }
+}
+
+std::wstring EditSession::finalText() const {
+    std::wstring text = initialText;
+    for (const Edit& edit : edits) {
+        apply(text, edit);
+    }
+    return text;
+}
+
+EditSession EditSession::load(std::istream& in) {
+    std::string line;
+    if (!std::getline(in, line) || line != HEADER) {
+        throw std::runtime_error("not an edit session (missing header)");
+    }
+
+    EditSession session;
+    size_t lineNumber = 1;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (line.rfind("text ", 0) == 0) {
+            session.initialText = unescape(line.substr(5));
+            continue;
+        }
+
+        std::istringstream fields(line);
+        Edit edit;
+        char op = 0;
+        if (!(fields >> edit.timeMs >> op >> edit.position) || (op != '+' && op != '-')) {
+            throw std::runtime_error("malformed edit on line " + std::to_string(lineNumber));
+        }
+        if (op == '+') {
+            edit.kind = Edit::Kind::INSERT;
+            std::string rest;
+            std::getline(fields, rest);
+            edit.text = unescape(rest.empty() ? rest : rest.substr(1));  // Drop the separator
+        } else {
+            edit.kind = Edit::Kind::ERASE;
+            if (!(fields >> edit.length)) {
+                throw std::runtime_error("missing length on line " + std::to_string(lineNumber));
+            }
+        }
+        session.edits.push_back(std::move(edit));
+    }
+    return session;
+}
+
+void EditSession::save(std::ostream& out) const {
+    out << HEADER << '\n';
+    out << "text " << escape(initialText) << '\n';
+    for (const Edit& edit : edits) {
+        writeEdit(out, edit);
+    }
+}
+
+EditSession EditSession::synthesize(const std::wstring& text, const SynthesisOptions& options) {
+    EditSession session;
+    session.initialText = text;
+
+    std::mt19937 rng(options.seed);
+    auto uniform = [&rng](int64_t low, int64_t high) {
+        return std::uniform_int_distribution<int64_t>(low, std::max(low, high))(rng);
+    };
+
+    std::vector<std::wstring> phrases = referencePhrases(text);
+    if (phrases.empty()) {
+        phrases.push_back(L"Element 1");
+    }
+
+    std::wstring current = text;
+    int64_t time = 0;
+    for (size_t burst = 0; burst < options.bursts; ++burst) {
+        time += uniform(options.minPauseMs, options.maxPauseMs);
+
+        // Start typing right after a random space, or at the end
+        size_t position = current.size();
+        if (!current.empty()) {
+            size_t candidate = static_cast<size_t>(uniform(0, static_cast<int64_t>(current.size()) - 1));
+            size_t space = current.find(L' ', candidate);
+            if (space != std::wstring::npos) {
+                position = space + 1;
+            }
+        }
+
+        // Phrases with their numbers, e.g. "Welle 12 und Lager 14 "
+        const size_t burstChars = static_cast<size_t>(
+            uniform(static_cast<int64_t>(options.minBurstChars), static_cast<int64_t>(options.maxBurstChars)));
+        std::wstring typed;
+        while (typed.size() < burstChars) {
+            typed += phrases[static_cast<size_t>(uniform(0, static_cast<int64_t>(phrases.size()) - 1))];
+            typed += L" ";
+        }
+
+        for (wchar_t c : typed) {
+            if (uniform(0, 99) < options.backspacePercent) {
+                Edit typo;
+                typo.timeMs = time;
+                typo.kind = Edit::Kind::INSERT;
+                typo.position = position;
+                typo.text = L"x";
+                apply(current, typo);
+                session.edits.push_back(std::move(typo));
+                time += uniform(options.minKeyIntervalMs, options.maxKeyIntervalMs);
+
+                Edit backspace;
+                backspace.timeMs = time;
+                backspace.kind = Edit::Kind::ERASE;
+                backspace.position = position;
+                backspace.length = 1;
+                apply(current, backspace);
+                session.edits.push_back(std::move(backspace));
+                time += uniform(options.minKeyIntervalMs, options.maxKeyIntervalMs);
+            }
+
+            Edit key;
+            key.timeMs = time;
+            key.kind = Edit::Kind::INSERT;
+            key.position = position++;
+            key.text = std::wstring(1, c);
+            apply(current, key);
+            session.edits.push_back(std::move(key));
+            time += uniform(options.minKeyIntervalMs, options.maxKeyIntervalMs);
+        }
+    }
+    return session;
+}
+
+EditSession::Recorder::Recorder(const std::string& path, const std::wstring& initialText)
+    : m_out(path, std::ios::binary),
+      m_lastText(initialText),
+      m_start(std::chrono::steady_clock::now()) {
+    if (m_out) {
+        m_out << HEADER << '\n' << "text " << escape(initialText) << '\n';
+        m_out.flush();
+    }
+}
+
+void EditSession::Recorder::record(const std::wstring& currentText) {
+    if (!m_out) {
+        return;
+    }
+    const int64_t timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_start).count();
+    for (const Edit& edit : diff(m_lastText, currentText, timeMs)) {
+        writeEdit(m_out, edit);
+    }
+    m_out.flush();
+    m_lastText = currentText;
+}
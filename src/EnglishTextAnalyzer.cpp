@@ -1,44 +1,63 @@
 #include "EnglishTextAnalyzer.h"
-#include <algorithm>
-#include <locale>
+#include "CaseFolding.h"
+#include "Lexicon.h"
+#include "Metrics.h"
 
-// Static member initialization - English articles
-const std::unordered_set<std::wstring> EnglishTextAnalyzer::s_indefiniteArticles = {
+namespace {
+// Compile-time perfect-hash tables (no static-init cost, no allocation on lookup)
+constexpr auto INDEFINITE_ARTICLES = Lexicon::makeWordSet({
     L"a", L"an"
-};
+});
 
-const std::unordered_set<std::wstring> EnglishTextAnalyzer::s_definiteArticles = {
+constexpr auto DEFINITE_ARTICLES = Lexicon::makeWordSet({
     L"the"
-};
+});
 
-EnglishTextAnalyzer::EnglishTextAnalyzer() {
-    // Initialize English locale for proper character handling
-    try {
-        m_englishLocale = std::locale("en_US.UTF-8");
-    } catch (const std::runtime_error&) {
-        // Fallback to default locale if English locale not available
-        m_englishLocale = std::locale("");
-    }
-    m_ctypeFacet = &std::use_facet<std::ctype<wchar_t>>(m_englishLocale);
+constexpr auto IGNORED_WORDS = Lexicon::makeWordSet({
+    // Definite article
+    L"the",
+    // Indefinite articles
+    L"a", L"an",
+    // Figure references
+    L"figure", L"figures",
+    // conjuctions
+    L"and", L"or", L"with"
+});
 }
 
+// Static member initialization - English articles
+constinit const Lexicon::TableView<bool> EnglishTextAnalyzer::s_indefiniteArticles =
+    INDEFINITE_ARTICLES.view();
+constinit const Lexicon::TableView<bool> EnglishTextAnalyzer::s_definiteArticles =
+    DEFINITE_ARTICLES.view();
+constinit const Lexicon::TableView<bool> EnglishTextAnalyzer::s_ignoredWords =
+    IGNORED_WORDS.view();
+
+EnglishTextAnalyzer::EnglishTextAnalyzer() : m_ignoredWords(s_ignoredWords) {}
+
 void EnglishTextAnalyzer::stemWord(std::wstring& word) {
     if (word.empty())
         return;
     
-    // Normalize first character to lowercase using English locale
-    std::transform(word.begin(), word.end(), word.begin(),
-             [this](wchar_t c) { return m_ctypeFacet->tolower(c); });
+    // Normalize to lowercase (locale-independent)
+    CaseFolding::foldInPlace(word);
     
+    static Metrics::Counter& cacheHits =
+        Metrics::counter("bz_stem_cache_hits_total", "Stem lookups answered from the cache");
+    static Metrics::Counter& cacheMisses =
+        Metrics::counter("bz_stem_cache_misses_total", "Stem lookups that ran the stemmer");
+
     // Check cache first
     auto it = m_stemCache.find(word);
     if (it != m_stemCache.end()) {
         // Cache hit - use cached result
+        cacheHits.add();
         word = it->second;
         return;
     }
     
     // Cache miss - perform expensive stemming operation
+    cacheMisses.add();
     std::wstring original = word;
     m_englishStemmer(word);
     
@@ -67,61 +86,22 @@ bool EnglishTextAnalyzer::isMultiWordBase(std::wstring word,
     return multiWordBaseStems.count(word) > 0;
 }
 
-// Optimized: use manual lowercase loop with early exit
-bool EnglishTextAnalyzer::isIndefiniteArticle(const std::wstring& word) const {
-    // Fast path: check length first (English: "a" or "an")
-    if (word.length() < 1 || word.length() > 2) {
-        return false;
-    }
-    
-    // Create lowercase version
-    std::wstring lower;
-    lower.reserve(word.length());
-    for (wchar_t c : word) {
-        lower.push_back(std::tolower(c));
-    }
-    return s_indefiniteArticles.count(lower) > 0;
+bool EnglishTextAnalyzer::isIndefiniteArticle(std::wstring_view word) const {
+    return s_indefiniteArticles.contains(word);
 }
 
-// Optimized: use manual lowercase loop with early exit
-bool EnglishTextAnalyzer::isDefiniteArticle(const std::wstring& word) const {
-    // Fast path: check length first (English: "the" is exactly 3 chars)
-    if (word.length() != 3) {
-        return false;
-    }
-    
-    // Create lowercase version
-    std::wstring lower;
-    lower.reserve(3);
-    for (wchar_t c : word) {
-        lower.push_back(std::tolower(c));
-    }
-    return s_definiteArticles.count(lower) > 0;
+bool EnglishTextAnalyzer::isDefiniteArticle(std::wstring_view word) const {
+    return s_definiteArticles.contains(word);
 }
 
-// Static member initialization - ignored words
-const std::unordered_set<std::wstring> EnglishTextAnalyzer::s_ignoredWords = {
-    // Definite article
-    L"the",
-    // Indefinite articles
-    L"a", L"an",
-    // Figure references
-    L"figure", L"figures",
-    // conjuctions
-    L"and", L"or", L"with"
-};
-
-bool EnglishTextAnalyzer::isIgnoredWord(const std::wstring& word) const {
+bool EnglishTextAnalyzer::isIgnoredWord(std::wstring_view word) const {
     // Words shorter than 3 characters should be ignored
     if (word.length() < 3) {
         return true;
     }
-    
-    // Create lowercase version
-    std::wstring lower;
-    lower.reserve(word.length());
-    for (wchar_t c : word) {
-        lower.push_back(std::tolower(c));
-    }
-    return s_ignoredWords.count(lower) > 0;
+    return m_ignoredWords.contains(word);
+}
+
+void EnglishTextAnalyzer::addIgnoredWord(std::wstring_view word) {
+    m_ignoredWords.add(word, true);
 }
@@ -3,10 +3,28 @@
 #include "EnglishTextAnalyzer.h"
 #include "MainWindow.h"
 #include "RE2RegexHelper.h"
-#include "TimerHelper.h"
-#include <algorithm>
+#include "CharClass.h"
+#include "Metrics.h"
 #include <iostream>
 
+namespace {
+
+// The text control is optional so detection can also run headless
+void applyStyle(wxRichTextCtrl* textBox, long start, long end, const wxTextAttr& style) {
+    static Metrics::Counter& setStyleCalls =
+        Metrics::counter("bz_set_style_calls_total", "wxRichTextCtrl::SetStyle calls for highlights");
+    static Metrics::Counter& highlightedChars =
+        Metrics::counter("bz_highlighted_chars_total", "Characters covered by applied highlight ranges");
+
+    if (textBox) {
+        textBox->SetStyle(start, end, style);
+        setStyleCalls.add();
+        highlightedChars.add(static_cast<uint64_t>(end - start));
+    }
+}
+
+} // namespace
+
 void ErrorDetectorHelper::findUnnumberedWords(
     const std::wstring& fullText,
     TextAnalyzer& analyzer,
@@ -14,35 +32,26 @@ void ErrorDetectorHelper::findUnnumberedWords(
     AnalysisContext& ctx,
     wxRichTextCtrl* textBox,
     const wxTextAttr& warningStyle,
-    std::vector<std::pair<int, int>>& noNumberPositions,
-    std::vector<std::pair<int, int>>& allErrorsPositions
+    ErrorPositions& noNumberPositions
 ) {
-    // Collect start positions of all valid references
-    std::unordered_set<size_t> validStarts;
-    for (const auto &[stem, positions] : ctx.db.stemToPositions) {
-        for (const auto [start, len] : positions) {
-            validStarts.insert(start);
-        }
-    }
-
     // Helper to check if a position is followed by whitespace + number
     auto isFollowedByNumber = [&fullText](size_t wordEnd) -> bool {
         // Skip whitespace after the word
         size_t pos = wordEnd;
-        while (pos < fullText.length() && std::iswspace(fullText[pos])) {
+        while (pos < fullText.length() && CharClass::isSpace(fullText[pos])) {
             pos++;
         }
         // Check if next character is a digit
-        return pos < fullText.length() && std::iswdigit(fullText[pos]);
+        return pos < fullText.length() && CharClass::isDigit(fullText[pos]);
     };
 
-    // Collect all words NOT followed by numbers
+    // Collect all words NOT followed by numbers (views into fullText)
     struct WordMatch {
-        std::wstring word;
+        std::wstring_view word;
         size_t position;
         size_t length;
     };
-    std::vector<WordMatch> wordsWithoutNumbers;
+    std::pmr::vector<WordMatch> wordsWithoutNumbers(ctx.arena.resource());
     wordsWithoutNumbers.reserve(1000);
 
     {
@@ -52,8 +61,8 @@ void ErrorDetectorHelper::findUnnumberedWords(
             size_t pos = match.position;
             size_t len = match.length;
 
-            // Skip if already part of a valid reference
-            if (validStarts.count(pos)) {
+            // Skip if already part of a valid reference (starts are sorted)
+            if (ctx.db.occurrences.hasOccurrenceStartingAt(pos)) {
                 continue;
             }
 
@@ -62,7 +71,7 @@ void ErrorDetectorHelper::findUnnumberedWords(
                 continue;
             }
 
-            wordsWithoutNumbers.push_back({std::move(match.groups[0]), pos, len});
+            wordsWithoutNumbers.push_back({match[0], pos, len});
         }
     }
 
@@ -77,8 +86,8 @@ void ErrorDetectorHelper::findUnnumberedWords(
             continue; // Too far apart
         }
 
-        std::wstring word1 = word1Match.word;
-        std::wstring word2 = word2Match.word;
+        std::wstring word1(word1Match.word);
+        std::wstring word2(word2Match.word);
 
         // Only flag if this is a known multi-word combination
         if (analyzer.isMultiWordBase(word2, ctx.multiWordBaseStems)) {
@@ -87,10 +96,9 @@ void ErrorDetectorHelper::findUnnumberedWords(
             if (ctx.db.stemToBz.count(stemVec)) {
                 size_t startPos = word1Match.position;
                 size_t endPos = word2Match.position + word2Match.length;
-                if (!isPositionCleared(ctx.clearedTextPositions, startPos, endPos)) {
+                if (!isPositionCleared(ctx.clearedTextAnchors, startPos, endPos)) {
                     noNumberPositions.emplace_back(startPos, endPos);
-                    allErrorsPositions.emplace_back(startPos, endPos);
-                    textBox->SetStyle(startPos, endPos, warningStyle);
+                    applyStyle(textBox, startPos, endPos, warningStyle);
                 }
             }
         }
@@ -98,16 +106,15 @@ void ErrorDetectorHelper::findUnnumberedWords(
 
     // Check for single words without numbers
     for (const auto& wordMatch : wordsWithoutNumbers) {
-        StemVector stemVec = analyzer.createStemVector(wordMatch.word);
+        StemVector stemVec = analyzer.createStemVector(std::wstring(wordMatch.word));
 
         // Check if this stem is known from valid references
         if (ctx.db.stemToBz.count(stemVec)) {
             size_t start = wordMatch.position;
             size_t end = wordMatch.position + wordMatch.length;
-            if (!isPositionCleared(ctx.clearedTextPositions, start, end)) {
+            if (!isPositionCleared(ctx.clearedTextAnchors, start, end)) {
                 noNumberPositions.emplace_back(start, end);
-                allErrorsPositions.emplace_back(start, end);
-                textBox->SetStyle(start, end, warningStyle);
+                applyStyle(textBox, start, end, warningStyle);
             }
         }
     }
@@ -119,137 +126,79 @@ void ErrorDetectorHelper::checkArticleUsage(
     AnalysisContext& ctx,
     wxRichTextCtrl* textBox,
     const wxTextAttr& articleWarningStyle,
-    std::vector<std::pair<int, int>>& wrongArticlePositions,
-    std::vector<std::pair<int, int>>& allErrorsPositions
+    ErrorPositions& wrongArticlePositions
 ) {
-    struct OccurrenceInfo {
-        size_t position;
-        size_t length;
-        StemVector stem;
-    };
+    // Occurrences are stored in document order, so this is a linear sweep
+    const OccurrenceTable& occurrences = ctx.db.occurrences;
 
-    std::vector<OccurrenceInfo> allOccurrences;
+    // Track which stems we've seen (indexed by stem ID)
+    std::pmr::vector<bool> seenStems(occurrences.stemCount(), false, ctx.arena.resource());
 
-    // Reserve capacity to reduce allocations
-    size_t totalOccurrences = 0;
-    for (const auto &[stem, positions] : ctx.db.stemToPositions) {
-        totalOccurrences += positions.size();
-    }
-    allOccurrences.reserve(totalOccurrences);
-
-    for (const auto &[stem, positions] : ctx.db.stemToPositions) {
-        for (const auto [start, len] : positions) {
-            allOccurrences.push_back({start, len, stem});
-        }
-    }
-
-    // Sort by position
-    std::sort(allOccurrences.begin(), allOccurrences.end(),
-              [](const OccurrenceInfo &a, const OccurrenceInfo &b) {
-                  return a.position < b.position;
-              });
-
-    // Track which stems we've seen
-    std::unordered_set<StemVector, StemVectorHash> seenStems;
-
-    for (const auto &occ : allOccurrences) {
+    for (size_t i = 0; i < occurrences.size(); ++i) {
+        const uint32_t stemId = occurrences.stemId(i);
         auto [precedingWord, precedingPos] =
-            analyzer.findPrecedingWord(fullText, occ.position);
+            analyzer.findPrecedingWord(fullText, occurrences.start(i));
 
         if (precedingWord.empty()) {
-            seenStems.insert(occ.stem);
+            seenStems[stemId] = true;
             continue;
         }
 
-        bool isFirstOccurrence = (seenStems.count(occ.stem) == 0);
+        bool isFirstOccurrence = !seenStems[stemId];
         size_t articleEnd = precedingPos + precedingWord.length();
 
         if (isFirstOccurrence) {
             // First occurrence: should not be definite article
             if (analyzer.isDefiniteArticle(precedingWord)) {
-                if (!isPositionCleared(ctx.clearedTextPositions, precedingPos, articleEnd)) {
+                if (!isPositionCleared(ctx.clearedTextAnchors, precedingPos, articleEnd)) {
                     wrongArticlePositions.emplace_back(precedingPos, articleEnd);
-                    allErrorsPositions.emplace_back(precedingPos, articleEnd);
-                    textBox->SetStyle(precedingPos, articleEnd, articleWarningStyle);
+                    applyStyle(textBox, precedingPos, articleEnd, articleWarningStyle);
                 }
             }
-            seenStems.insert(occ.stem);
+            seenStems[stemId] = true;
         } else {
             // Subsequent occurrence: should have definite article
             if (analyzer.isIndefiniteArticle(precedingWord)) {
-                if (!isPositionCleared(ctx.clearedTextPositions, precedingPos, articleEnd)) {
+                if (!isPositionCleared(ctx.clearedTextAnchors, precedingPos, articleEnd)) {
                     wrongArticlePositions.emplace_back(precedingPos, articleEnd);
-                    allErrorsPositions.emplace_back(precedingPos, articleEnd);
-                    textBox->SetStyle(precedingPos, articleEnd, articleWarningStyle);
+                    applyStyle(textBox, precedingPos, articleEnd, articleWarningStyle);
                 }
             }
         }
     }
 }
 
-bool ErrorDetectorHelper::isUniquelyAssigned(
-    const std::wstring& bz,
+void ErrorDetectorHelper::highlightConflicts(
     AnalysisContext& ctx,
     wxRichTextCtrl* textBox,
     const wxTextAttr& conflictStyle,
-    std::vector<std::pair<int, int>>& wrongTermBzPositions,
-    std::vector<std::pair<int, int>>& allErrorsPositions
+    ErrorPositions& wrongTermBzPositions
 ) {
-    // Check if this error has been cleared by user
-    if (ctx.clearedErrors.count(bz) > 0) {
-        return true; // Treat as no error
-    }
-
-    const auto &stems = ctx.db.bzToStems.at(bz);
-
-    // Check if multiple different stems are assigned to this BZ
-    if (stems.size() > 1) {
-        // Highlight all occurrences of this BZ
-        const auto &positions = ctx.db.bzToPositions.at(bz);
-        for (const auto i : positions) {
-            size_t start = i.first;
-            size_t len = i.second;
-            if (!isPositionCleared(ctx.clearedTextPositions, start, start + len)) {
-                wrongTermBzPositions.emplace_back(start, start + len);
-                allErrorsPositions.emplace_back(start, start + len);
-                textBox->SetStyle(start, start + len, conflictStyle);
-            }
+    const OccurrenceTable& occurrences = ctx.db.occurrences;
+    for (const uint32_t i : ctx.conflicts.flaggedOccurrences()) {
+        const size_t start = occurrences.start(i);
+        const size_t end = start + occurrences.length(i);
+        if (!isPositionCleared(ctx.clearedTextAnchors, start, end)) {
+            wrongTermBzPositions.emplace_back(start, end);
+            applyStyle(textBox, start, end, conflictStyle);
         }
-        return false;
     }
+}
 
-    // Check if the stem is also used with other BZs
-    for (const auto &stem : stems) {
-        if (ctx.db.stemToBz.at(stem).size() > 1) {
-            // This stem maps to multiple BZs - highlight occurrences
-            const auto &positions = ctx.db.stemToPositions.at(stem);
-            for (const auto i : positions) {
-                size_t start = i.first;
-                size_t len = i.second;
-
-                // Avoid duplicates in the merged list
-                auto pos_pair = std::make_pair(static_cast<int>(start),
-                                               static_cast<int>(start + len));
-                if (std::find(wrongTermBzPositions.begin(),
-                              wrongTermBzPositions.end(),
-                              pos_pair) == wrongTermBzPositions.end() &&
-                    !isPositionCleared(ctx.clearedTextPositions, start, start + len)) {
-                    wrongTermBzPositions.emplace_back(start, start + len);
-                    allErrorsPositions.emplace_back(start, start + len);
-                    textBox->SetStyle(start, start + len, conflictStyle);
-                }
-            }
-            return false;
-        }
+void ErrorDetectorHelper::highlight(
+    wxRichTextCtrl* textBox,
+    const ErrorPositions& positions,
+    const wxTextAttr& style
+) {
+    for (const auto& [start, end] : positions) {
+        applyStyle(textBox, start, end, style);
     }
-
-    return true;
 }
 
 bool ErrorDetectorHelper::isPositionCleared(
-    const std::set<std::pair<size_t, size_t>>& clearedTextPositions,
+    const ClearedAnchors& clearedTextAnchors,
     size_t start,
     size_t end
 ) {
-    return clearedTextPositions.count({start, end}) > 0;
+    return clearedTextAnchors.contains(start, end);
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "ErrorIndex.h"
+#include "Trace.h"
+#include <algorithm>
+
+void ErrorIndex::build(const std::array<ErrorPositions*, CategoryCount>& categories, ErrorPositions& all) {
+    BZ_TRACE_SCOPE("ErrorIndex::build");
+    size_t capacity = 0;
+    m_longest = 0;
+    for (size_t c = 0; c < CategoryCount; ++c) {
+        ErrorPositions& positions = *categories[c];
+        // Articles come out of a document-order sweep; the others need sorting
+        if (!std::is_sorted(positions.begin(), positions.end())) {
+            std::sort(positions.begin(), positions.end());
+        }
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        for (const auto& [start, end] : positions) {
+            m_longest = std::max(m_longest, end - start);
+        }
+        m_counts[c] = positions.size();
+        capacity += positions.size();
+    }
+
+    // With three streams, picking the smallest head is cheaper than a heap
+    all.clear();
+    all.reserve(capacity);
+    std::array<size_t, CategoryCount> heads{};
+    while (true) {
+        size_t smallest = CategoryCount;
+        for (size_t c = 0; c < CategoryCount; ++c) {
+            if (heads[c] < categories[c]->size() &&
+                (smallest == CategoryCount ||
+                 (*categories[c])[heads[c]] < (*categories[smallest])[heads[smallest]])) {
+                smallest = c;
+            }
+        }
+        if (smallest == CategoryCount) {
+            break;
+        }
+        const auto& position = (*categories[smallest])[heads[smallest]++];
+        if (all.empty() || all.back() != position) {
+            all.push_back(position);
+        }
+    }
+    m_total = all.size();
+}
+
+void ErrorIndex::clear() {
+    m_counts.fill(0);
+    m_total = 0;
+    m_longest = 0;
+}
+
+std::optional<size_t> ErrorIndex::nextAfter(const ErrorPositions& positions, long from, long to) {
+    if (positions.empty()) {
+        return std::nullopt;
+    }
+    const auto next = std::upper_bound(positions.begin(), positions.end(),
+                                       std::make_pair(static_cast<int>(from), static_cast<int>(to)));
+    return next == positions.end() ? 0 : static_cast<size_t>(next - positions.begin());
+}
+
+std::optional<size_t> ErrorIndex::previousBefore(const ErrorPositions& positions, long from, long to) {
+    if (positions.empty()) {
+        return std::nullopt;
+    }
+    const auto previous = std::lower_bound(positions.begin(), positions.end(),
+                                           std::make_pair(static_cast<int>(from), static_cast<int>(to)));
+    return previous == positions.begin() ? positions.size() - 1
+                                         : static_cast<size_t>(previous - positions.begin()) - 1;
+}
+
+std::optional<size_t> ErrorIndex::errorAt(const ErrorPositions& all, long position) const {
+    // First error starting after position; candidates are the ones before it
+    size_t i = std::upper_bound(all.begin(), all.end(), position,
+                                [](long value, const std::pair<int, int>& error) { return value < error.first; }) -
+               all.begin();
+    while (i > 0 && all[i - 1].first + m_longest > position) {
+        --i;
+        if (position < all[i].second) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
@@ -1,28 +1,45 @@
 #include "ErrorNavigator.h"
+#include "ErrorIndex.h"
 
-void ErrorNavigator::selectNext(const std::vector<std::pair<int, int>>& positions,
+namespace {
+
+// The range navigation starts from: the selection, or the caret if nothing is selected
+void cursorRange(wxRichTextCtrl* textCtrl, long& from, long& to) {
+    textCtrl->GetSelection(&from, &to);
+    if (from < 0 || to < from) {
+        from = to = textCtrl->GetInsertionPoint();
+    }
+}
+
+} // namespace
+
+void ErrorNavigator::selectNext(const ErrorPositions& positions,
                                 int& currentIndex,
                                 wxRichTextCtrl* textCtrl,
                                 wxStaticText* label) {
-    currentIndex += 1;
-    if (currentIndex >= static_cast<int>(positions.size()) || currentIndex < 0) {
-        currentIndex = 0;
+    long from, to;
+    cursorRange(textCtrl, from, to);
+    const std::optional<size_t> next = ErrorIndex::nextAfter(positions, from, to);
+    if (next) {
+        currentIndex = static_cast<int>(*next);
+        updateSelection(positions, currentIndex, textCtrl, label);
     }
-    updateSelection(positions, currentIndex, textCtrl, label);
 }
 
-void ErrorNavigator::selectPrevious(const std::vector<std::pair<int, int>>& positions,
+void ErrorNavigator::selectPrevious(const ErrorPositions& positions,
                                    int& currentIndex,
                                    wxRichTextCtrl* textCtrl,
                                    wxStaticText* label) {
-    currentIndex -= 1;
-    if (currentIndex >= static_cast<int>(positions.size()) || currentIndex < 0) {
-        currentIndex = positions.size() - 1;
+    long from, to;
+    cursorRange(textCtrl, from, to);
+    const std::optional<size_t> previous = ErrorIndex::previousBefore(positions, from, to);
+    if (previous) {
+        currentIndex = static_cast<int>(*previous);
+        updateSelection(positions, currentIndex, textCtrl, label);
     }
-    updateSelection(positions, currentIndex, textCtrl, label);
 }
 
-void ErrorNavigator::updateSelection(const std::vector<std::pair<int, int>>& positions,
+void ErrorNavigator::updateSelection(const ErrorPositions& positions,
                                      int currentIndex,
                                      wxRichTextCtrl* textCtrl,
                                      wxStaticText* label) {
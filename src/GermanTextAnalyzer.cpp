@@ -1,46 +1,65 @@
 #include "GermanTextAnalyzer.h"
-#include <algorithm>
-#include <locale>
+#include "CaseFolding.h"
+#include "Lexicon.h"
+#include "Metrics.h"
 #include <iostream>
 
-// Static member initialization
-const std::unordered_set<std::wstring> GermanTextAnalyzer::s_indefiniteArticles = {
+namespace {
+// Compile-time perfect-hash tables (no static-init cost, no allocation on lookup)
+constexpr auto INDEFINITE_ARTICLES = Lexicon::makeWordSet({
     L"ein", L"eine", L"eines", L"einen", L"einer", L"einem"
-};
+});
 
-const std::unordered_set<std::wstring> GermanTextAnalyzer::s_definiteArticles = {
+constexpr auto DEFINITE_ARTICLES = Lexicon::makeWordSet({
     L"der", L"die", L"das", L"den", L"dem", L"des"
-};
+});
 
-GermanTextAnalyzer::GermanTextAnalyzer() {
-    // Initialize German locale for proper character handling (ä, ö, ü, ß)
-    try {
-        m_germanLocale = std::locale("de_DE.UTF-8");
-    } catch (const std::runtime_error&) {
-        // Fallback to default locale if German locale not available
-        m_germanLocale = std::locale("");
-    }
-    m_ctypeFacet = &std::use_facet<std::ctype<wchar_t>>(m_germanLocale);
+constexpr auto IGNORED_WORDS = Lexicon::makeWordSet({
+    // Definite articles
+    L"der", L"die", L"das", L"den", L"dem", L"des",
+    // Indefinite articles
+    L"ein", L"eine", L"eines", L"einen", L"einer", L"einem",
+    // Figure references
+    L"figur", L"figuren",
+    // conjunctions
+    L"und", L"oder", L"mit"
+});
 }
 
+// Static member initialization
+constinit const Lexicon::TableView<bool> GermanTextAnalyzer::s_indefiniteArticles =
+    INDEFINITE_ARTICLES.view();
+constinit const Lexicon::TableView<bool> GermanTextAnalyzer::s_definiteArticles =
+    DEFINITE_ARTICLES.view();
+constinit const Lexicon::TableView<bool> GermanTextAnalyzer::s_ignoredWords =
+    IGNORED_WORDS.view();
+
+GermanTextAnalyzer::GermanTextAnalyzer() : m_ignoredWords(s_ignoredWords) {}
+
 
 void GermanTextAnalyzer::stemWord(std::wstring& word) {
     if (word.empty())
         return;
     
-    // Normalize first character to lowercase using German locale (proper handling of Ä, Ö, Ü, etc.)
-    std::transform(word.begin(), word.end(), word.begin(),
-                   [this](wchar_t c) { return m_ctypeFacet->tolower(c); });
+    // Normalize to lowercase (locale-independent, handles Ä, Ö, Ü, etc.)
+    CaseFolding::foldInPlace(word);
     
+    static Metrics::Counter& cacheHits =
+        Metrics::counter("bz_stem_cache_hits_total", "Stem lookups answered from the cache");
+    static Metrics::Counter& cacheMisses =
+        Metrics::counter("bz_stem_cache_misses_total", "Stem lookups that ran the stemmer");
+
     // Check cache first
     auto it = m_stemCache.find(word);
     if (it != m_stemCache.end()) {
         // Cache hit - use cached result
+        cacheHits.add();
         word = it->second;
         return;
     }
     
     // Cache miss - perform expensive stemming operation
+    cacheMisses.add();
     std::wstring original = word;
     m_germanStemmer(word);
     
@@ -69,61 +88,22 @@ bool GermanTextAnalyzer::isMultiWordBase(std::wstring word,
     return multiWordBaseStems.count(word) > 0;
 }
 
-// Optimized: use manual lowercase loop with early exit
-bool GermanTextAnalyzer::isIndefiniteArticle(const std::wstring& word) const {
-    // Fast path: check length first
-    if (word.length() < 3 || word.length() > 6) {
-        return false;
-    }
-    
-    // Create lowercase version only if length is in valid range
-    std::wstring lower;
-    lower.reserve(word.length());
-    for (wchar_t c : word) {
-        lower.push_back(std::tolower(c));
-    }
-    return s_indefiniteArticles.count(lower) > 0;
+bool GermanTextAnalyzer::isIndefiniteArticle(std::wstring_view word) const {
+    return s_indefiniteArticles.contains(word);
 }
 
-// Optimized: use manual lowercase loop with early exit
-bool GermanTextAnalyzer::isDefiniteArticle(const std::wstring& word) const {
-    // Fast path: check length first (all definite articles are exactly 3 chars)
-    if (word.length() != 3) {
-        return false;
-    }
-    
-    // Create lowercase version only if length is valid
-    std::wstring lower;
-    lower.reserve(3);
-    for (wchar_t c : word) {
-        lower.push_back(std::tolower(c));
-    }
-    return s_definiteArticles.count(lower) > 0;
+bool GermanTextAnalyzer::isDefiniteArticle(std::wstring_view word) const {
+    return s_definiteArticles.contains(word);
 }
 
-// Static member initialization - ignored words
-const std::unordered_set<std::wstring> GermanTextAnalyzer::s_ignoredWords = {
-    // Definite articles
-    L"der", L"die", L"das", L"den", L"dem", L"des",
-    // Indefinite articles
-    L"ein", L"eine", L"eines", L"einen", L"einer", L"einem",
-    // Figure references
-    L"figur", L"figuren",
-    // conjunctions
-    L"und", L"oder", L"mit"
-};
-
-bool GermanTextAnalyzer::isIgnoredWord(const std::wstring& word) const {
+bool GermanTextAnalyzer::isIgnoredWord(std::wstring_view word) const {
     // Words shorter than 3 characters should be ignored
     if (word.length() < 3) {
         return true;
     }
-    
-    // Create lowercase version
-    std::wstring lower;
-    lower.reserve(word.length());
-    for (wchar_t c : word) {
-        lower.push_back(std::tolower(c));
-    }
-    return s_ignoredWords.count(lower) > 0;
+    return m_ignoredWords.contains(word);
+}
+
+void GermanTextAnalyzer::addIgnoredWord(std::wstring_view word) {
+    m_ignoredWords.add(word, true);
 }
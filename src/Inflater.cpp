@@ -0,0 +1,303 @@
+#include "Inflater.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t WINDOW_SIZE = 32 * 1024;
+constexpr int MAX_BITS = 15;
+
+constexpr uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t DISTANCE_BASE[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                        33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                        1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Order in which dynamic blocks list the code length code lengths
+constexpr uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+[[noreturn]] void corrupt(const char* what) {
+    throw std::runtime_error(std::string("deflate: ") + what);
+}
+
+uint32_t reverseBits(uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    return reversed;
+}
+
+} // namespace
+
+Inflater::Inflater() : m_window(2 * WINDOW_SIZE) {
+    uint8_t lengths[288];
+    std::memset(lengths, 8, 144);
+    std::memset(lengths + 144, 9, 112);
+    std::memset(lengths + 256, 7, 24);
+    std::memset(lengths + 280, 8, 8);
+    buildHuffman(m_fixedLiterals, lengths, 288);
+    std::memset(lengths, 5, 30);
+    buildHuffman(m_fixedDistances, lengths, 30);
+}
+
+size_t Inflater::inflate(const uint8_t* data, size_t size, const Sink& sink, std::stop_token stop) {
+    m_in = data;
+    m_inSize = size;
+    m_inPos = 0;
+    m_bitBuffer = 0;
+    m_bitCount = 0;
+    m_overrun = 0;
+    m_windowPos = 0;
+    m_flushed = 0;
+    m_total = 0;
+    m_sink = &sink;
+
+    bool last = false;
+    do {
+        if (stop.stop_requested()) {
+            return m_total;
+        }
+        last = bits(1) != 0;
+        switch (bits(2)) {
+        case 0:
+            storedBlock();
+            break;
+        case 1:
+            codesBlock(m_fixedLiterals, m_fixedDistances);
+            break;
+        case 2: {
+            Huffman literals;
+            Huffman distances;
+            dynamicTables(literals, distances);
+            codesBlock(literals, distances);
+            break;
+        }
+        default:
+            corrupt("invalid block type");
+        }
+    } while (!last);
+
+    flush(0);
+    m_sink = nullptr;
+    return m_total;
+}
+
+void Inflater::refill() {
+    while (m_bitCount <= 56) {
+        if (m_inPos < m_inSize) {
+            m_bitBuffer |= static_cast<uint64_t>(m_in[m_inPos++]) << m_bitCount;
+        } else {
+            ++m_overrun;  // Zero padding; consuming it means truncated input
+        }
+        m_bitCount += 8;
+    }
+}
+
+uint32_t Inflater::bits(int count) {
+    if (m_bitCount < count) {
+        refill();
+    }
+    const uint32_t value = static_cast<uint32_t>(m_bitBuffer & ((uint64_t(1) << count) - 1));
+    m_bitBuffer >>= count;
+    m_bitCount -= count;
+    if (m_bitCount < m_overrun * 8) {
+        corrupt("unexpected end of data");
+    }
+    return value;
+}
+
+void Inflater::buildHuffman(Huffman& table, const uint8_t* lengths, size_t count) {
+    std::memset(table.counts, 0, sizeof(table.counts));
+    std::memset(table.fast, 0, sizeof(table.fast));
+    for (size_t symbol = 0; symbol < count; ++symbol) {
+        ++table.counts[lengths[symbol]];
+    }
+    table.counts[0] = 0;
+
+    int left = 1;
+    for (int length = 1; length <= MAX_BITS; ++length) {
+        left = (left << 1) - table.counts[length];
+        if (left < 0) {
+            corrupt("over-subscribed code");
+        }
+    }
+
+    uint16_t offsets[MAX_BITS + 2] = {};
+    uint32_t nextCode[MAX_BITS + 1] = {};
+    uint32_t code = 0;
+    for (int length = 1; length <= MAX_BITS; ++length) {
+        offsets[length + 1] = offsets[length] + table.counts[length];
+        code = (code + table.counts[length - 1]) << 1;
+        nextCode[length] = code;
+    }
+
+    for (size_t symbol = 0; symbol < count; ++symbol) {
+        const int length = lengths[symbol];
+        if (length == 0) {
+            continue;
+        }
+        table.symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+        if (length <= FAST_BITS) {
+            const uint32_t reversed = reverseBits(nextCode[length], length);
+            for (uint32_t i = reversed; i < (1u << FAST_BITS); i += 1u << length) {
+                table.fast[i] = static_cast<uint16_t>((symbol << 4) | length);
+            }
+        }
+        ++nextCode[length];
+    }
+}
+
+int Inflater::decodeSymbol(const Huffman& table) {
+    if (m_bitCount < MAX_BITS) {
+        refill();
+    }
+    const uint16_t entry = table.fast[m_bitBuffer & ((1u << FAST_BITS) - 1)];
+    if (entry != 0) {
+        bits(entry & 15);
+        return entry >> 4;
+    }
+
+    // Canonical decode, one bit at a time (codes longer than FAST_BITS)
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length <= MAX_BITS; ++length) {
+        code |= static_cast<int>(bits(1));
+        const int count = table.counts[length];
+        if (code - count < first) {
+            return table.symbols[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    corrupt("invalid code");
+}
+
+void Inflater::storedBlock() {
+    bits(m_bitCount % 8);  // Skip to the byte boundary
+    const uint32_t length = bits(16);
+    if ((~bits(16) & 0xFFFF) != length) {
+        corrupt("stored block length mismatch");
+    }
+    for (uint32_t i = 0; i < length; ++i) {
+        put(static_cast<uint8_t>(bits(8)));
+    }
+}
+
+void Inflater::codesBlock(const Huffman& literals, const Huffman& distances) {
+    for (;;) {
+        int symbol = decodeSymbol(literals);
+        if (symbol < 256) {
+            put(static_cast<uint8_t>(symbol));
+            continue;
+        }
+        if (symbol == 256) {
+            return;
+        }
+
+        symbol -= 257;
+        if (symbol >= 29) {
+            corrupt("invalid length code");
+        }
+        const size_t length = LENGTH_BASE[symbol] + bits(LENGTH_EXTRA[symbol]);
+        const int distanceSymbol = decodeSymbol(distances);
+        if (distanceSymbol >= 30) {
+            corrupt("invalid distance code");
+        }
+        const size_t distance = DISTANCE_BASE[distanceSymbol] + bits(DISTANCE_EXTRA[distanceSymbol]);
+        if (distance > m_total) {
+            corrupt("distance before start of output");
+        }
+        if (m_windowPos + length < m_window.size()) {
+            // Forward byte copy: an overlapping match repeats its own output
+            uint8_t* out = m_window.data() + m_windowPos;
+            const uint8_t* from = out - distance;
+            for (size_t i = 0; i < length; ++i) {
+                out[i] = from[i];
+            }
+            m_windowPos += length;
+            m_total += length;
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                put(m_window[m_windowPos - distance]);
+            }
+        }
+    }
+}
+
+void Inflater::dynamicTables(Huffman& literals, Huffman& distances) {
+    const size_t literalCount = bits(5) + 257;
+    const size_t distanceCount = bits(5) + 1;
+    const size_t codeLengthCount = bits(4) + 4;
+    if (literalCount > 286 || distanceCount > 30) {
+        corrupt("too many codes");
+    }
+
+    uint8_t lengths[320] = {};
+    for (size_t i = 0; i < codeLengthCount; ++i) {
+        lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(bits(3));
+    }
+    Huffman codeLengths;
+    buildHuffman(codeLengths, lengths, 19);
+
+    std::memset(lengths, 0, sizeof(lengths));
+    size_t index = 0;
+    while (index < literalCount + distanceCount) {
+        const int symbol = decodeSymbol(codeLengths);
+        if (symbol < 16) {
+            lengths[index++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t value = 0;
+        size_t repeat = 0;
+        if (symbol == 16) {
+            if (index == 0) {
+                corrupt("repeat without previous length");
+            }
+            value = lengths[index - 1];
+            repeat = 3 + bits(2);
+        } else if (symbol == 17) {
+            repeat = 3 + bits(3);
+        } else {
+            repeat = 11 + bits(7);
+        }
+        if (index + repeat > literalCount + distanceCount) {
+            corrupt("too many lengths");
+        }
+        std::memset(lengths + index, value, repeat);
+        index += repeat;
+    }
+
+    if (lengths[256] == 0) {
+        corrupt("no end-of-block code");
+    }
+    buildHuffman(literals, lengths, literalCount);
+    buildHuffman(distances, lengths + literalCount, distanceCount);
+}
+
+void Inflater::put(uint8_t byte) {
+    m_window[m_windowPos++] = byte;
+    ++m_total;
+    if (m_windowPos == m_window.size()) {
+        flush(WINDOW_SIZE);
+    }
+}
+
+void Inflater::flush(size_t keep) {
+    if (m_windowPos > m_flushed) {
+        (*m_sink)(m_window.data() + m_flushed, m_windowPos - m_flushed);
+    }
+    if (keep > 0) {
+        std::memmove(m_window.data(), m_window.data() + m_windowPos - keep, keep);
+        m_windowPos = keep;
+    }
+    m_flushed = m_windowPos;
+}
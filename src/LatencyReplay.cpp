@@ -0,0 +1,157 @@
+#include "LatencyReplay.h"
+#include "ScanPipeline.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <optional>
+#include <queue>
+
+namespace {
+
+enum class EventType { EDIT, TIMER, SCAN_DONE };
+
+struct Event {
+    double time;    // Arrival in the UI thread's queue
+    uint64_t seq;   // FIFO among equal arrival times
+    EventType type;
+    size_t index;   // Edit index, timer token or scan index
+};
+
+struct LaterEvent {
+    bool operator()(const Event& a, const Event& b) const {
+        return a.time > b.time || (a.time == b.time && a.seq > b.seq);
+    }
+};
+
+struct ScanRun {
+    double start;
+    double ordinalEnd;      // A cancel stops the scan at the end of its phase,
+    double scanEnd;         // i.e. at one of these two points
+    double end;
+    size_t version;         // Number of edits included
+    double updateMs;        // UI-thread cost of showing the results
+    bool cancelledEarly = false;
+};
+
+} // namespace
+
+double LatencyReplay::Report::percentile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(values.size())));
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+double LatencyReplay::Report::total(const std::vector<double>& values) {
+    return std::accumulate(values.begin(), values.end(), 0.0);
+}
+
+LatencyReplay::Report LatencyReplay::replay(const EditSession& session, const Options& options) {
+    BZ_TRACE_SCOPE("LatencyReplay::replay");
+
+    ScanPipeline pipeline(options.useGerman);
+    auto updateCost = [&]() {
+        return static_cast<double>(pipeline.allErrors().size()) * options.styleCostPerErrorUs / 1000.0;
+    };
+
+    // The initial text is already on screen (and the stem cache warm) when the session starts
+    std::wstring text = session.initialText;
+    pipeline.run(text);
+
+    Report report;
+    const size_t editCount = session.edits.size();
+    report.editLatencyMs.assign(editCount, 0.0);
+    report.inputDelayMs.assign(editCount, 0.0);
+
+    std::priority_queue<Event, std::vector<Event>, LaterEvent> events;
+    uint64_t seq = 0;
+    for (size_t i = 0; i < editCount; ++i) {
+        events.push({static_cast<double>(session.edits[i].timeMs), seq++, EventType::EDIT, i});
+    }
+
+    std::vector<ScanRun> scans;
+    std::optional<size_t> running;  // The scan thread MainWindow would join next
+    double uiFreeAt = 0;
+    size_t version = 0;
+    size_t shownVersion = 0;
+    size_t timerToken = 0;
+
+    while (!events.empty()) {
+        const Event event = events.top();
+        events.pop();
+        double now = std::max(event.time, uiFreeAt);
+
+        switch (event.type) {
+        case EventType::EDIT: {
+            report.inputDelayMs[event.index] = now - event.time;
+            EditSession::apply(text, session.edits[event.index]);
+            ++version;
+            events.push({now + options.debounceMs, seq++, EventType::TIMER, ++timerToken});
+            break;
+        }
+
+        case EventType::TIMER: {
+            if (event.index != timerToken) {
+                break;  // Restarted by a later edit
+            }
+            if (running && scans[*running].end > now) {
+                ScanRun& previous = scans[*running];
+                if (now < previous.scanEnd) {
+                    previous.end = now < previous.ordinalEnd ? previous.ordinalEnd : previous.scanEnd;
+                    previous.cancelledEarly = true;
+                    ++report.scansCancelled;
+                }
+                report.uiStallMs.push_back(previous.end - now);
+                now = previous.end;
+            }
+
+            pipeline.run(text);
+            const ScanPipeline::PhaseTimings& timings = pipeline.lastTimings();
+            ScanRun scan;
+            scan.start = now;
+            scan.ordinalEnd = now + timings.ordinalMs;
+            scan.scanEnd = scan.ordinalEnd + timings.scanMs;
+            scan.end = scan.scanEnd + timings.detectMs;
+            scan.version = version;
+            scan.updateMs = updateCost();
+            scans.push_back(scan);
+            running = scans.size() - 1;
+            ++report.scansStarted;
+            events.push({scan.end, seq++, EventType::SCAN_DONE, scans.size() - 1});
+            break;
+        }
+
+        case EventType::SCAN_DONE: {
+            if (scans[event.index].cancelledEarly) {
+                break;  // Returned before CallAfter
+            }
+            // The handler locks m_dataMutex, held by a newer scan if one is running,
+            // and then shows whatever that newest scan produced
+            double stall = 0;
+            const ScanRun& shown = scans[*running];
+            if (shown.end > now) {
+                stall += shown.end - now;
+                now = shown.end;
+            }
+            stall += shown.updateMs;
+            now += shown.updateMs;
+            report.uiStallMs.push_back(stall);
+            ++report.uiUpdates;
+
+            for (; shownVersion < shown.version; ++shownVersion) {
+                report.editLatencyMs[shownVersion] =
+                    now - static_cast<double>(session.edits[shownVersion].timeMs);
+            }
+            break;
+        }
+        }
+
+        uiFreeAt = now;
+    }
+
+    report.sessionMs = uiFreeAt;
+    return report;
+}
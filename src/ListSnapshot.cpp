@@ -0,0 +1,176 @@
+#include "ListSnapshot.h"
+#include "AnalysisContext.h"
+#include "MemoryReport.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * Rows kept from base are the longest run of matched rows that stays in
+ * order (longest increasing subsequence of their base rows); every other
+ * base row is deleted and every other new row inserted.
+ */
+template <typename Row, typename Key, typename Hash>
+ListSnapshot::Diff diffRows(const std::vector<Row>& base, const std::vector<Row>& rows,
+                            Key Row::*key, uint64_t baseGeneration) {
+    ListSnapshot::Diff diff;
+    diff.baseGeneration = baseGeneration;
+    std::unordered_map<Key, unsigned int, Hash> baseRowOf;
+    baseRowOf.reserve(base.size());
+    for (unsigned int row = 0; row < base.size(); ++row) {
+        baseRowOf.emplace(base[row].*key, row);
+    }
+
+    // Matched (base row, row) pairs in new order
+    std::vector<std::pair<unsigned int, unsigned int>> matched;
+    for (unsigned int row = 0; row < rows.size(); ++row) {
+        const auto found = baseRowOf.find(rows[row].*key);
+        if (found != baseRowOf.end()) {
+            matched.emplace_back(found->second, row);
+        }
+    }
+
+    // Patience sorting: tails[k] ends the best run of length k + 1
+    std::vector<size_t> tails;
+    std::vector<size_t> previous(matched.size(), SIZE_MAX);
+    for (size_t i = 0; i < matched.size(); ++i) {
+        const auto slot = std::lower_bound(tails.begin(), tails.end(), matched[i].first,
+                                           [&](size_t t, unsigned int baseRow) { return matched[t].first < baseRow; });
+        if (slot != tails.begin()) {
+            previous[i] = *(slot - 1);
+        }
+        if (slot == tails.end()) {
+            tails.push_back(i);
+        } else {
+            *slot = i;
+        }
+    }
+    std::vector<uint8_t> baseKept(base.size(), 0);
+    std::vector<uint8_t> rowKept(rows.size(), 0);
+    for (size_t i = tails.empty() ? SIZE_MAX : tails.back(); i != SIZE_MAX; i = previous[i]) {
+        const auto [baseRow, row] = matched[i];
+        baseKept[baseRow] = 1;
+        rowKept[row] = 1;
+        if (!(base[baseRow] == rows[row])) {
+            diff.changed.emplace_back(baseRow, row);
+        }
+    }
+    std::reverse(diff.changed.begin(), diff.changed.end());
+
+    for (unsigned int row = 0; row < base.size(); ++row) {
+        if (!baseKept[row]) {
+            diff.deleted.push_back(row);
+        }
+    }
+    for (unsigned int row = 0; row < rows.size(); ++row) {
+        if (!rowKept[row]) {
+            diff.inserted.push_back(row);
+        }
+    }
+    return diff;
+}
+
+} // namespace
+
+std::shared_ptr<const ListSnapshot> ListSnapshot::build(const AnalysisContext& ctx, const std::wstring& text,
+                                                        const ListSnapshot* base) {
+    BZ_TRACE_SCOPE("ListSnapshot::build");
+    static std::atomic<uint64_t> generations{0};
+    auto snapshot = std::make_shared<ListSnapshot>();
+    snapshot->generation = ++generations;
+    const OccurrenceTable& occurrences = ctx.db.occurrences;
+
+    // Spelled once per term, shared by both lists
+    std::vector<std::wstring> spellings(occurrences.stemCount());
+    std::vector<size_t> firstPosition(occurrences.stemCount(), SIZE_MAX);
+    for (uint32_t stemId = 0; stemId < occurrences.stemCount(); ++stemId) {
+        spellings[stemId] = occurrences.firstSpelling(stemId, text);
+        const PositionRange positions = occurrences.positionsOfStem(stemId);
+        if (!positions.empty()) {
+            firstPosition[stemId] = positions.front().first;
+        }
+    }
+
+    snapshot->bzRows.reserve(ctx.db.bzToStems.size());
+    std::vector<uint32_t> stemIds;
+    for (const auto& [bz, stems] : ctx.db.bzToStems) {
+        BzRow row;
+        row.bz = bz;
+        row.flagged = ctx.conflicts.bzFlagged(occurrences.findBz(bz));
+
+        // Terms in document order, so the text does not change between identical scans
+        stemIds.clear();
+        for (const StemVector& stem : stems) {
+            const uint32_t stemId = occurrences.findStem(stem);
+            if (stemId != OccurrenceTable::NO_ID && !spellings[stemId].empty()) {
+                stemIds.push_back(stemId);
+            }
+        }
+        std::sort(stemIds.begin(), stemIds.end(),
+                  [&](uint32_t a, uint32_t b) { return firstPosition[a] < firstPosition[b]; });
+        for (const uint32_t stemId : stemIds) {
+            row.terms += (row.terms.empty() ? L"" : L"; ") + spellings[stemId];
+        }
+
+        const PositionRange positions = ctx.db.positionsOfBz(bz);
+        if (!positions.empty()) {
+            row.firstTerm = spellings[occurrences.stemId(*positions.indexBegin())];
+        }
+        snapshot->bzRows.push_back(std::move(row));
+    }
+
+    // Keyed by first position for sorting
+    std::vector<std::pair<size_t, TermRow>> termRows;
+    termRows.reserve(ctx.db.stemToBz.size());
+    for (const auto& [stem, bzSet] : ctx.db.stemToBz) {
+        TermRow row;
+        row.stem = stem;
+        const uint32_t stemId = occurrences.findStem(stem);
+        if (stemId != OccurrenceTable::NO_ID) {
+            row.term = spellings[stemId];
+        }
+        row.bzs.assign(bzSet.begin(), bzSet.end());
+        std::sort(row.bzs.begin(), row.bzs.end(), BZComparatorForMap());
+        for (const std::wstring& bz : row.bzs) {
+            row.bzText += (row.bzText.empty() ? L"" : L", ") + bz;
+        }
+        // Several BZs, or its BZ is also assigned to other terms
+        row.flagged = ctx.conflicts.stemFlagged(stemId);
+        termRows.emplace_back(stemId == OccurrenceTable::NO_ID ? SIZE_MAX : firstPosition[stemId], std::move(row));
+    }
+    std::sort(termRows.begin(), termRows.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    snapshot->termRows.reserve(termRows.size());
+    for (auto& [position, row] : termRows) {
+        snapshot->termRows.push_back(std::move(row));
+    }
+
+    if (base != nullptr) {
+        BZ_TRACE_SCOPE("ListSnapshot::diff");
+        snapshot->bzDiff = diffRows<BzRow, std::wstring, std::hash<std::wstring>>(
+            base->bzRows, snapshot->bzRows, &BzRow::bz, base->generation);
+        snapshot->termDiff = diffRows<TermRow, StemVector, StemVectorHash>(
+            base->termRows, snapshot->termRows, &TermRow::stem, base->generation);
+    }
+    return snapshot;
+}
+
+size_t ListSnapshot::memoryBytes() const {
+    size_t bytes = MemoryUsage::heapBytes(bzRows) + MemoryUsage::heapBytes(termRows);
+    for (const BzRow& row : bzRows) {
+        bytes += MemoryUsage::heapBytes(row.bz) + MemoryUsage::heapBytes(row.terms) +
+                 MemoryUsage::heapBytes(row.firstTerm);
+    }
+    for (const TermRow& row : termRows) {
+        bytes += MemoryUsage::heapBytes(row.stem) + MemoryUsage::heapBytes(row.term) +
+                 MemoryUsage::heapBytes(row.bzs) + MemoryUsage::heapBytes(row.bzText);
+    }
+    for (const Diff* diff : {&bzDiff, &termDiff}) {
+        bytes += MemoryUsage::heapBytes(diff->deleted) + MemoryUsage::heapBytes(diff->inserted) +
+                 MemoryUsage::heapBytes(diff->changed);
+    }
+    return bytes;
+}
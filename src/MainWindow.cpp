@@ -1,11 +1,7 @@
 #include "MainWindow.h"
-#include "RegexPatterns.h"
-#include "GermanTextAnalyzer.h"
-#include "EnglishTextAnalyzer.h"
 #include "../img/check_16.xpm"
 #include "../img/warning_16.xpm"
 #include "ErrorNavigator.h"
-#include "TextScanner.h"
 #include "ErrorDetectorHelper.h"
 #include "UIBuilder.h"
 #include "utils.h"
@@ -13,24 +9,30 @@
 #include "wx/gdicmn.h"
 #include "wx/timer.h"
 #include "wx/wupdlock.h"
+#include "wx/filedlg.h"
+#include "wx/clipboard.h"
 #include <algorithm>
+#include <chrono>
 #include <locale>
+#include <sstream>
 #include <string>
 #include <wx/bitmap.h>
-#include "TimerHelper.h"
+#include "Trace.h"
+#include "Metrics.h"
+#include "ScanPipeline.h"
+#include "MemoryReport.h"
+#include "ReportExporter.h"
+#include "SessionFile.h"
+#include <filesystem>
 
 
 MainWindow::MainWindow()
     : wxFrame(nullptr, wxID_ANY,
               wxString::FromUTF8("Bezugszeichenprüfvorrichtung"),
               wxDefaultPosition, wxSize(1200, 800)),
-      // Initialize RE2 patterns using shared constants
-      m_singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN),
-      m_twoWordRegex(RegexPatterns::TWO_WORD_PATTERN),
-      m_wordRegex(RegexPatterns::WORD_PATTERN) {
-  
-  // Initialize default analyzer (German)
-  m_currentAnalyzer = std::make_unique<GermanTextAnalyzer>();
+      // German analyzer by default
+      m_pipeline(true),
+      m_ctx(m_pipeline.context()) {
 
 #ifdef _WIN32
   SetIcon(wxIcon("1", wxBITMAP_TYPE_ICO_RESOURCE));
@@ -38,19 +40,9 @@ MainWindow::MainWindow()
 #endif // SetIcon(wxIcon("APP_ICON", wxBITMAP_TYPE_ICO_RESOURCE"));
 
   // Verify RE2 patterns compiled successfully
-  if (!m_singleWordRegex.ok()) {
-    wxMessageBox("Failed to compile singleWordRegex: " +
-                 wxString::FromUTF8(m_singleWordRegex.error().c_str()),
-                 "Regex Error", wxOK | wxICON_ERROR);
-  }
-  if (!m_twoWordRegex.ok()) {
-    wxMessageBox("Failed to compile twoWordRegex: " +
-                 wxString::FromUTF8(m_twoWordRegex.error().c_str()),
-                 "Regex Error", wxOK | wxICON_ERROR);
-  }
-  if (!m_wordRegex.ok()) {
-    wxMessageBox("Failed to compile wordRegex: " +
-                 wxString::FromUTF8(m_wordRegex.error().c_str()),
+  const std::string patternError = m_pipeline.patternError();
+  if (!patternError.empty()) {
+    wxMessageBox("Failed to compile " + wxString::FromUTF8(patternError),
                  "Regex Error", wxOK | wxICON_ERROR);
   }
 
@@ -59,27 +51,77 @@ MainWindow::MainWindow()
   setupBindings();
 }
 
+void MainWindow::startSessionRecording(const std::string &path) {
+  m_sessionRecorder =
+      std::make_unique<EditSession::Recorder>(path, m_textBox->GetValue().ToStdWstring());
+  if (!m_sessionRecorder->isOpen()) {
+    wxLogError("Could not write edit session %s", path);
+    m_sessionRecorder.reset();
+  }
+}
+
 void MainWindow::debounceFunc(wxCommandEvent &event) {
+  // Appending loaded chunks is not an edit; finishLoad() starts the scan
+  if (m_loading) {
+    return;
+  }
+  BZ_TRACE_INSTANT("edit");
+  if (m_sessionRecorder) {
+    m_sessionRecorder->record(m_textBox->GetValue().ToStdWstring());
+  }
   m_debounceTimer.Start(500, true);
 }
 
+void MainWindow::onTextContentChanged(wxRichTextEvent &event) {
+  event.Skip();
+  // The text control does not tell paragraphs from line breaks, so the
+  // loaded paragraph table follows each edit instead of being rebuilt.
+  // The ranges are inclusive.
+  if (m_loading || m_paragraphStarts.empty()) {
+    return;
+  }
+  const wxRichTextRange range = event.GetRange();
+  const auto position = static_cast<size_t>(range.GetStart());
+  const auto length = static_cast<size_t>(range.GetLength());
+  if (event.GetEventType() == wxEVT_RICHTEXT_CONTENT_INSERTED) {
+    EditSession::shiftParagraphs(m_paragraphStarts, position, 0, length);
+  } else {
+    EditSession::shiftParagraphs(m_paragraphStarts, position, length, 0);
+  }
+}
+
 void MainWindow::scanText(wxTimerEvent &event) {
+  BZ_TRACE_SCOPE("MainWindow::scanText");
+
   // Cancel any running scan
   m_cancelScan = true;
 
   // Wait for previous thread to finish if it's still running
   if (m_scanThread.joinable()) {
+    static Metrics::Histogram& joinBlocked = Metrics::histogram(
+        "bz_ui_blocked_ms", "UI thread time spent on scans", Metrics::LATENCY_BUCKETS_MS,
+        "phase=\"join\"");
+    const auto waitStart = std::chrono::steady_clock::now();
     m_scanThread.join();
+    joinBlocked.observe(std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - waitStart).count());
   }
 
   // Reset cancellation flag
   m_cancelScan = false;
 
-  // Get the text to scan (on main thread, as required by wxWidgets)
+  // Get the text to scan (on main thread, as required by wxWidgets); the
+  // shown results keep referring to the previous text until the scan is published
+  if (m_fullTextShown) {
+    m_shownText = std::move(m_fullText);
+    m_fullTextShown = false;
+  }
   m_fullText = m_textBox->GetValue().ToStdWstring();
+  m_fullTextParagraphs = m_paragraphStarts;
 
   // Launch background thread for scanning
   m_scanThread = std::jthread([this](std::stop_token stoken) {
+    Trace::setThreadName("Scan");
     this->scanTextBackground();
   });
 }
@@ -89,72 +131,26 @@ void MainWindow::scanTextBackground() {
   // We lock the mutex for the entire operation to ensure data consistency
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
-  Timer t_total;
+  BZ_TRACE_SCOPE("MainWindow::scanTextBackground");
+  m_resultsValid = false;
 
   // Check for cancellation
   if (m_cancelScan) {
     return;
   }
 
-  Timer t_setup;
-  // Clear all results
-  m_ctx.clearResults();
-
-  m_allErrorsPositions.clear();
-  m_noNumberPositions.clear();
-  m_wrongTermBzPositions.clear();
-  m_wrongArticlePositions.clear();
-
-  std::cout << "Time for setup and clearing: " << t_setup.elapsed() << " milliseconds\n";
-
-  if (m_cancelScan) {
+  // Scan and detection, as in the command-line tools; the UI thread only
+  // applies the error lists
+  if (!m_pipeline.run(m_fullText, m_fullTextParagraphs, &m_cancelScan)) {
     return;
   }
 
-  // AUTO-DETECT ordinal patterns for multi-word terms BEFORE scanning
-  Timer t_ordinalDetect;
-  bool useGerman = (dynamic_cast<GermanTextAnalyzer*>(m_currentAnalyzer.get()) != nullptr);
-  std::unordered_set<std::wstring> newAutoDetected =
-      OrdinalDetector::detectOrdinalPatterns(m_fullText, m_twoWordRegex, useGerman, *m_currentAnalyzer);
-  std::cout << "Time for OrdinalDetector: " << t_ordinalDetect.elapsed() << " milliseconds\n";
-
-  // Rebuild combined multi-word set: manual + auto - disabled
-  m_ctx.multiWordBaseStems = m_ctx.manualMultiWordToggles;  // Start with manual enables
-  for (const auto& stem : newAutoDetected) {
-    if (m_ctx.manuallyDisabledMultiWord.count(stem) == 0) {
-      m_ctx.multiWordBaseStems.insert(stem);  // Add auto-detected if not manually disabled
-    }
+  // List rows for the UI, off the UI thread
+  {
+    BZ_TRACE_SCOPE("ListSnapshot::build");
+    m_listSnapshot = ListSnapshot::build(m_ctx, m_fullText, m_shownListSnapshot.get());
   }
-  m_ctx.autoDetectedMultiWordStems = newAutoDetected;  // Remember what was auto-detected
-
-  if (m_cancelScan) {
-    return;
-  }
-
-  // Scan text for patterns using TextScanner
-  Timer t_scan;
-  TextScanner::scanText(m_fullText, *m_currentAnalyzer, m_singleWordRegex, m_twoWordRegex, m_ctx);
-  std::cout << "Time for TextScanner::scanText: " << t_scan.elapsed() << " milliseconds\n";
-
-  // Cache first occurrence words for display
-  m_ctx.db.stemToFirstWord.clear();
-  for (const auto& [stem, positions] : m_ctx.db.stemToPositions) {
-    if (!positions.empty()) {
-      size_t firstStart = positions[0].first;
-      size_t firstLen = positions[0].second;
-      std::wstring fullMatch = m_fullText.substr(firstStart, firstLen);
-
-      // Extract word before BZ number
-      size_t bzStart = fullMatch.find_last_of(L' ');
-      if (bzStart != std::wstring::npos) {
-        m_ctx.db.stemToFirstWord[stem] = fullMatch.substr(0, bzStart);
-      } else {
-        m_ctx.db.stemToFirstWord[stem] = fullMatch;
-      }
-    }
-  }
-
-  std::cout << "Total background scan time: " << t_total.elapsed() << " milliseconds\n";
+  m_resultsValid = true;
 
   // Schedule UI update on main thread
   // Note: CallAfter is thread-safe in wxWidgets
@@ -163,6 +159,12 @@ void MainWindow::scanTextBackground() {
 
 void MainWindow::updateUIAfterScan() {
   // This function runs on the main thread
+  BZ_TRACE_SCOPE("MainWindow::updateUIAfterScan");
+  static Metrics::Histogram& updateBlocked = Metrics::histogram(
+      "bz_ui_blocked_ms", "UI thread time spent on scans", Metrics::LATENCY_BUCKETS_MS,
+      "phase=\"update\"");
+  const auto updateStart = std::chrono::steady_clock::now();
+
   // Lock mutex while accessing shared data
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
@@ -171,98 +173,91 @@ void MainWindow::updateUIAfterScan() {
     return;
   }
 
+  m_fullTextShown = true;
+  m_shownText = std::wstring();
+
+  // Decisions changed while the scan ran; rescan so the highlights follow them
+  if (!m_pendingDecisions.empty()) {
+    for (const auto &change : m_pendingDecisions) {
+      change();
+    }
+    m_pendingDecisions.clear();
+    m_debounceTimer.Start(1, true);
+  }
+
   // RAII-based window update locker prevents redraws during updates
   wxWindowUpdateLocker updateLocker(m_textBox);
   m_textBox->BeginSuppressUndo();
 
   // Clear UI elements
-  m_treeList->DeleteAllItems();
   m_bzCurrentOccurrence.clear();
   m_stemCurrentOccurrence.clear();
 
   // Reset text highlighting
-  m_textBox->SetStyle(0, m_textBox->GetValue().length(), m_neutralStyle);
+  {
+    BZ_TRACE_SCOPE("resetHighlighting");
+    static Metrics::Counter& setStyleCalls =
+        Metrics::counter("bz_set_style_calls_total", "wxRichTextCtrl::SetStyle calls for highlights");
+    m_textBox->SetStyle(0, m_textBox->GetValue().length(), m_neutralStyle);
+    setStyleCalls.add();
+  }
 
   // Update display
-  Timer t_fillListTree;
-  fillListTree();
-  std::cout << "Time for fillListTree: " << t_fillListTree.elapsed() << " milliseconds\n";
-
-  Timer t_findUnnumberedWords;
-  findUnnumberedWords();
-  std::cout << "Time for finding unnumbered words: " << t_findUnnumberedWords.elapsed() << " milliseconds\n";
-
-  Timer t_checkArticleUsage;
-  checkArticleUsage();
-  std::cout << "Time for checking articles: " << t_checkArticleUsage.elapsed() << " milliseconds\n";
-
-  // Sort the positions of all the errors and remove any duplicate entries
-  Timer t_sortErrors;
-  std::sort(m_allErrorsPositions.begin(), m_allErrorsPositions.end());
-  auto last = std::unique(m_allErrorsPositions.begin(), m_allErrorsPositions.end());
-  m_allErrorsPositions.erase(last, m_allErrorsPositions.end());
-  std::cout << "Time for error sort: " << t_sortErrors.elapsed() << " milliseconds\n";
+  {
+    BZ_TRACE_SCOPE("MainWindow::publishLists");
+    publishLists();
+  }
+  {
+    BZ_TRACE_SCOPE("MainWindow::highlightErrors");
+    highlightErrors();
+  }
 
   // Update navigation labels
+  const ErrorIndex &errorIndex = m_pipeline.errorIndex();
   m_allErrorsLabel->SetLabel(
-      L"0/" + std::to_wstring(m_allErrorsPositions.size()) + L"\t");
+      L"0/" + std::to_wstring(errorIndex.total()) + L"\t");
   m_noNumberLabel->SetLabel(
-      L"0/" + std::to_wstring(m_noNumberPositions.size()) + L"\t");
+      L"0/" + std::to_wstring(errorIndex.count(ErrorIndex::NoNumber)) + L"\t");
   m_wrongTermBzLabel->SetLabel(
-      L"0/" + std::to_wstring(m_wrongTermBzPositions.size()) + L"\t");
+      L"0/" + std::to_wstring(errorIndex.count(ErrorIndex::WrongTermBz)) + L"\t");
   m_wrongArticleLabel->SetLabel(
-      L"0/" + std::to_wstring(m_wrongArticlePositions.size()) + L"\t");
+      L"0/" + std::to_wstring(errorIndex.count(ErrorIndex::WrongArticle)) + L"\t");
 
   // Refresh layout to accommodate label size changes
   Layout();
 
-  Timer t_fillBzList;
-  fillBzList();
-  std::cout << "Time for fillBzList: " << t_fillBzList.elapsed() << " milliseconds\n";
-
-  Timer t_fillTermList;
-  fillTermList();
-  std::cout << "Time for fillTermList: " << t_fillTermList.elapsed() << " milliseconds\n\n";
+  BZ_TRACE_COUNTER("scanArenaBytes", m_ctx.arena.bytesInUse());
+  BZ_TRACE_COUNTER("scanArenaPeakBytes", m_ctx.arena.peakBytes());
 
   m_textBox->EndSuppressUndo();
   // wxWindowUpdateLocker automatically "thaws" the window when it goes out of scope
-}
 
-void MainWindow::fillListTree() {
-  for (const auto &[bz, stems] : m_ctx.db.bzToStems) {
-    wxTreeListItem item;
-
-    // Check if error has been cleared by user
-    bool isCleared = m_ctx.clearedErrors.count(bz) > 0;
+  updateBlocked.observe(std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - updateStart).count());
+}
 
-    if (isCleared || isUniquelyAssigned(bz)) {
-      // Use check icon (0) for cleared errors or no errors
-      item = m_treeList->AppendItem(m_treeList->GetRootItem(), bz, 0, 0);
+void MainWindow::publishLists() {
+  // The models read only the rows they paint and replay the snapshot's diff
+  // against m_shownListSnapshot, so a small edit touches only a few rows
+  static Metrics::Counter& rowUpdates =
+      Metrics::counter("bz_list_row_updates_total", "Rows inserted, deleted or changed in the list views");
+  static Metrics::Counter& resets =
+      Metrics::counter("bz_list_resets_total", "List views reset instead of updated row by row");
+  for (SnapshotListModel *model : {m_treeModel.get(), m_termModel.get(), m_bzModel.get()}) {
+    const size_t notifications = model->setSnapshot(m_listSnapshot);
+    if (notifications == SnapshotListModel::RESET) {
+      resets.add();
     } else {
-      // Use warning icon (1) for actual errors
-      item = m_treeList->AppendItem(m_treeList->GetRootItem(), bz, 1, 1);
+      rowUpdates.add(notifications);
     }
-
-    // Build display string from first occurrence of each stem
-    std::wstring displayText;
-    for (const auto& stem : stems) {
-      std::wstring firstWord = getFirstOccurrenceWord(stem);
-      if (!firstWord.empty()) {
-        if (!displayText.empty()) {
-          displayText += L"; ";
-        }
-        displayText += firstWord;
-      }
-    }
-
-    m_treeList->SetItemText(item, 1, displayText);
   }
+  m_shownListSnapshot = m_listSnapshot;
 }
 
-bool MainWindow::isUniquelyAssigned(const std::wstring &bz) {
-  return ErrorDetectorHelper::isUniquelyAssigned(
-      bz, m_ctx, m_textBox, m_conflictStyle,
-      m_wrongTermBzPositions, m_allErrorsPositions);
+void MainWindow::highlightErrors() {
+  ErrorDetectorHelper::highlight(m_textBox, m_pipeline.wrongTermBzErrors(), m_conflictStyle);
+  ErrorDetectorHelper::highlight(m_textBox, m_pipeline.noNumberErrors(), m_warningStyle);
+  ErrorDetectorHelper::highlight(m_textBox, m_pipeline.wrongArticleErrors(), m_articleWarningStyle);
 }
 
 void MainWindow::loadIcons() {
@@ -271,66 +266,99 @@ void MainWindow::loadIcons() {
   // SetIcon(icon);
 
   // rest of the code
-  m_imageList = std::make_shared<wxImageList>(16, 16, false, 0);
-  wxBitmap check(check_16_xpm);
-  wxBitmap warning(warning_16_xpm);
-
-  m_imageList->Add(check);
-  m_imageList->Add(warning);
-  m_treeList->SetImageList(m_imageList.get());
-  m_termList->SetImageList(m_imageList.get());
+  wxIcon check;
+  check.CopyFromBitmap(wxBitmap(check_16_xpm));
+  wxIcon warning;
+  warning.CopyFromBitmap(wxBitmap(warning_16_xpm));
+
+  // The list models hand out the icons with each visible row
+  m_treeModel = wxObjectDataPtr<SnapshotListModel>(
+      new SnapshotListModel(SnapshotListModel::View::BzToTerms, check, warning));
+  m_termModel = wxObjectDataPtr<SnapshotListModel>(
+      new SnapshotListModel(SnapshotListModel::View::TermToBzs, check, warning));
+  m_bzModel = wxObjectDataPtr<SnapshotListModel>(
+      new SnapshotListModel(SnapshotListModel::View::ReferenceSigns, check, warning));
+  m_treeList->AssociateModel(m_treeModel.get());
+  m_termList->AssociateModel(m_termModel.get());
+  m_bzList->AssociateModel(m_bzModel.get());
 }
 
-void MainWindow::findUnnumberedWords() {
-  ErrorDetectorHelper::findUnnumberedWords(
-      m_fullText, *m_currentAnalyzer, m_wordRegex, m_ctx, m_textBox, m_warningStyle,
-      m_noNumberPositions, m_allErrorsPositions);
-}
 
-void MainWindow::checkArticleUsage() {
-  ErrorDetectorHelper::checkArticleUsage(
-      m_fullText, *m_currentAnalyzer, m_ctx, m_textBox,
-      m_articleWarningStyle, m_wrongArticlePositions, m_allErrorsPositions);
+std::unique_lock<std::mutex> MainWindow::tryLockResults() {
+  // The navigators and the text context menu skip events during a scan
+  // rather than block the UI thread on it
+  return std::unique_lock<std::mutex>(m_dataMutex, std::try_to_lock);
 }
 
-
 void MainWindow::selectNextAllError(wxCommandEvent &event) {
-  ErrorNavigator::selectNext(m_allErrorsPositions, m_allErrorsSelected,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectNext(m_pipeline.allErrors(), m_allErrorsSelected,
                              m_textBox, m_allErrorsLabel.get());
 }
 
 void MainWindow::selectPreviousAllError(wxCommandEvent &event) {
-  ErrorNavigator::selectPrevious(m_allErrorsPositions, m_allErrorsSelected,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectPrevious(m_pipeline.allErrors(), m_allErrorsSelected,
                                  m_textBox, m_allErrorsLabel.get());
 }
 
 void MainWindow::selectNextNoNumber(wxCommandEvent &event) {
-  ErrorNavigator::selectNext(m_noNumberPositions, m_noNumberSelected, m_textBox,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectNext(m_pipeline.noNumberErrors(), m_noNumberSelected, m_textBox,
                              m_noNumberLabel.get());
 }
 
 void MainWindow::selectPreviousNoNumber(wxCommandEvent &event) {
-  ErrorNavigator::selectPrevious(m_noNumberPositions, m_noNumberSelected,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectPrevious(m_pipeline.noNumberErrors(), m_noNumberSelected,
                                  m_textBox, m_noNumberLabel.get());
 }
 
 void MainWindow::selectNextWrongTermBz(wxCommandEvent &event) {
-  ErrorNavigator::selectNext(m_wrongTermBzPositions, m_wrongTermBzSelected,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectNext(m_pipeline.wrongTermBzErrors(), m_wrongTermBzSelected,
                              m_textBox, m_wrongTermBzLabel.get());
 }
 
 void MainWindow::selectPreviousWrongTermBz(wxCommandEvent &event) {
-  ErrorNavigator::selectPrevious(m_wrongTermBzPositions, m_wrongTermBzSelected,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectPrevious(m_pipeline.wrongTermBzErrors(), m_wrongTermBzSelected,
                                  m_textBox, m_wrongTermBzLabel.get());
 }
 
 void MainWindow::selectNextWrongArticle(wxCommandEvent &event) {
-  ErrorNavigator::selectNext(m_wrongArticlePositions, m_wrongArticleSelected,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectNext(m_pipeline.wrongArticleErrors(), m_wrongArticleSelected,
                              m_textBox, m_wrongArticleLabel.get());
 }
 
 void MainWindow::selectPreviousWrongArticle(wxCommandEvent &event) {
-  ErrorNavigator::selectPrevious(m_wrongArticlePositions,
+  const auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    return;
+  }
+  ErrorNavigator::selectPrevious(m_pipeline.wrongArticleErrors(),
                                  m_wrongArticleSelected, m_textBox,
                                  m_wrongArticleLabel.get());
 }
@@ -377,6 +405,11 @@ void MainWindow::setupUi() {
       SetMenuBar(menuBar);
   }
 
+  // Status bar: file name and encoding, load progress in the second field
+  CreateStatusBar(2);
+  m_loadGauge = new wxGauge(GetStatusBar(), wxID_ANY, 1000);
+  m_loadGauge->Hide();
+
   // Help menu
   wxMenu* helpMenu = new wxMenu();
   helpMenu->Append(wxID_ABOUT, wxT("&About"));
@@ -386,8 +419,14 @@ void MainWindow::setupUi() {
 void MainWindow::setupBindings() {
   // Menu bar bindings
   Bind(wxEVT_MENU, &MainWindow::onAbout, this, wxID_ABOUT);
+  Bind(wxEVT_MENU, &MainWindow::onOpenFile, this, wxID_OPEN);
+  Bind(wxEVT_MENU, &MainWindow::onExportReport, this, wxID_HIGHEST + 25);
+  Bind(wxEVT_MENU, &MainWindow::onSaveSession, this, wxID_HIGHEST + 26);
+  Bind(wxEVT_CLOSE_WINDOW, &MainWindow::onClose, this);
 
   m_textBox->Bind(wxEVT_TEXT, &MainWindow::debounceFunc, this);
+  m_textBox->Bind(wxEVT_RICHTEXT_CONTENT_INSERTED, &MainWindow::onTextContentChanged, this);
+  m_textBox->Bind(wxEVT_RICHTEXT_CONTENT_DELETED, &MainWindow::onTextContentChanged, this);
   m_debounceTimer.Bind(wxEVT_TIMER, &MainWindow::scanText, this);
 
   m_buttonBackwardAllErrors->Bind(wxEVT_BUTTON,
@@ -407,16 +446,19 @@ void MainWindow::setupBindings() {
   m_buttonForwardWrongArticle->Bind(wxEVT_BUTTON,
                                     &MainWindow::selectNextWrongArticle, this);
 
-  m_treeList->Bind(wxEVT_TREELIST_ITEM_CONTEXT_MENU,
+  m_treeList->Bind(wxEVT_DATAVIEW_ITEM_CONTEXT_MENU,
                    &MainWindow::onTreeListContextMenu, this);
-  m_treeList->Bind(wxEVT_TREELIST_ITEM_ACTIVATED,
+  m_treeList->Bind(wxEVT_DATAVIEW_ITEM_ACTIVATED,
                    &MainWindow::onTreeListItemActivated, this);
 
-  m_termList->Bind(wxEVT_TREELIST_ITEM_CONTEXT_MENU,
+  m_termList->Bind(wxEVT_DATAVIEW_ITEM_CONTEXT_MENU,
                    &MainWindow::onTermListContextMenu, this);
-  m_termList->Bind(wxEVT_TREELIST_ITEM_ACTIVATED,
+  m_termList->Bind(wxEVT_DATAVIEW_ITEM_ACTIVATED,
                    &MainWindow::onTermListItemActivated, this);
 
+  m_bzList->Bind(wxEVT_DATAVIEW_ITEM_CONTEXT_MENU,
+                 &MainWindow::onBzListContextMenu, this);
+
   // Text right-click for clearing errors
   m_textBox->Bind(wxEVT_RIGHT_DOWN, &MainWindow::onTextRightClick, this);
   
@@ -424,162 +466,184 @@ void MainWindow::setupBindings() {
   Bind(wxEVT_MENU, &MainWindow::onRestoreAllErrors, this, wxID_HIGHEST + 20);
   Bind(wxEVT_MENU, &MainWindow::onRestoreTextboxErrors, this, wxID_HIGHEST + 21);
   Bind(wxEVT_MENU, &MainWindow::onRestoreOverviewErrors, this, wxID_HIGHEST + 22);
+  Bind(wxEVT_MENU, &MainWindow::onRestoreIgnoredWords, this, wxID_HIGHEST + 27);
+  Bind(wxEVT_MENU, &MainWindow::onShowStatistics, this, wxID_HIGHEST + 23);
+  Bind(wxEVT_MENU, &MainWindow::onShowMemoryReport, this, wxID_HIGHEST + 24);
   
   
   // Language selector
   m_languageSelector->Bind(wxEVT_RADIOBOX, &MainWindow::onLanguageChanged, this);
 }
 
-void MainWindow::fillBzList() {
-  m_bzList->SetValue("");
-
-  auto treeItem = m_treeList->GetFirstItem();
-  while (treeItem.IsOk()) {
-    std::wstring bz = m_treeList->GetItemText(treeItem, 0).ToStdWstring();
-
-    if (m_ctx.db.bzToPositions.count(bz) && m_ctx.db.bzToPositions[bz].size() >= 1) {
-      size_t start = m_ctx.db.bzToPositions[bz][0].first;
-      size_t len = m_ctx.db.bzToPositions[bz][0].second;
-
-      // Extract the term without the BZ number
-      size_t termLen = len > bz.size() + 1 ? len - bz.size() - 1 : 0;
-      std::wstring termText = m_fullText.substr(start, termLen);
+void MainWindow::onBzListContextMenu(wxDataViewEvent &event) {
+  const int ID_COPY = wxID_HIGHEST + 4;
+  wxMenu menu;
+  menu.Append(ID_COPY, m_bzList->HasSelection() ? "Copy selected" : "Copy list");
+  if (choosePopupItem(menu) != ID_COPY) {
+    return;
+  }
 
-      m_bzList->AppendText(bz + L"\t" + termText + L"\n");
+  // "bz<TAB>feature" lines, as the list used to be plain text
+  std::vector<unsigned int> rows;
+  wxDataViewItemArray selection;
+  if (m_bzList->GetSelections(selection) > 0) {
+    for (const wxDataViewItem &item : selection) {
+      rows.push_back(m_bzModel->GetRow(item));
+    }
+    std::sort(rows.begin(), rows.end());
+  } else {
+    for (unsigned int row = 0; row < m_bzModel->GetCount(); ++row) {
+      rows.push_back(row);
+    }
+  }
+  std::wstring text;
+  for (const unsigned int row : rows) {
+    if (const ListSnapshot::BzRow *bzRow = m_bzModel->bzRow(row)) {
+      text += bzRow->bz + L"\t" + bzRow->firstTerm + L"\n";
     }
-
-    treeItem = m_treeList->GetNextItem(treeItem);
+  }
+  if (wxTheClipboard->Open()) {
+    wxTheClipboard->SetData(new wxTextDataObject(text));
+    wxTheClipboard->Close();
   }
 }
 
-void MainWindow::onTreeListContextMenu(wxTreeListEvent &event) {
-  wxTreeListItem item = event.GetItem();
-  if (!item.IsOk()) {
+void MainWindow::onTreeListContextMenu(wxDataViewEvent &event) {
+  if (!event.GetItem().IsOk()) {
     return;
   }
+  const ListSnapshot::BzRow *row = m_treeModel->bzRow(m_treeModel->GetRow(event.GetItem()));
+  if (row == nullptr) {
+    return;
+  }
+  const std::wstring bz = row->bz;
+
+  // Read what the menu shows, then release the lock: the chosen action
+  // changes the decisions through changeDecisions(), which takes it again
+  std::wstring baseStem;
+  bool isMultiWord = false;
+  bool hasConflict = false;
+  bool isCleared = false;
+  std::wstring conflictInfo;
+  {
+    const auto lock = tryLockResults();
+    if (!lock.owns_lock()) {
+      return;
+    }
 
-  wxString bzText = m_treeList->GetItemText(item, 0);
-  std::wstring bz = bzText.ToStdWstring();
-
-  // Lock mutex to safely access shared data
-  std::lock_guard<std::mutex> lock(m_dataMutex);
-
-  // Get the stems for this BZ to determine the base word
-  if (m_ctx.db.bzToStems.count(bz) && !m_ctx.db.bzToStems[bz].empty()) {
+    // Get the stems for this BZ to determine the base word
+    auto stems = m_ctx.db.bzToStems.find(bz);
+    if (stems == m_ctx.db.bzToStems.end() || stems->second.empty()) {
+      return;
+    }
     // Get the first stem vector
-    const StemVector &firstStem = *m_ctx.db.bzToStems[bz].begin();
-
+    const StemVector &firstStem = *stems->second.begin();
     if (firstStem.empty()) {
       return;
     }
 
     // The base stem is the last element (for single-word: the only element,
     // for multi-word: the second word like "lager")
-    std::wstring baseStem = firstStem.back();
+    baseStem = firstStem.back();
+    isMultiWord = m_ctx.multiWordBaseStems.count(baseStem) > 0;
+
+    const OccurrenceTable &occurrences = m_ctx.db.occurrences;
+    const uint32_t bzId = occurrences.findBz(bz);
+    hasConflict = m_ctx.conflicts.bzConflicts(bzId);
+    if (hasConflict) {
+      isCleared = m_ctx.clearedErrors.count(bz) > 0;
+      // Everything tangled with this BZ, e.g. "Welle, Lager <-> 10, 12"
+      conflictInfo = m_ctx.conflicts.describe(m_ctx.conflicts.conflictOfBz(bzId), occurrences, m_fullText);
+    }
+  }
 
-    // Create context menu
-    wxMenu menu;
-    
-    // Use proper wxWidgets menu IDs (avoid conflicts with system IDs on Windows)
-    const int ID_MULTIWORD = wxID_HIGHEST + 1;
-    const int ID_CLEAR_ERROR = wxID_HIGHEST + 2;
-    
-    bool isMultiWord = m_ctx.multiWordBaseStems.count(baseStem) > 0;
-    menu.Append(ID_MULTIWORD, isMultiWord ? "Disable multi-word mode"
-                                          : "Enable multi-word mode");
+  // Create context menu
+  wxMenu menu;
 
-    // Check if this BZ actually has an error (ignoring cleared status)
-    const auto &stems = m_ctx.db.bzToStems[bz];
-    bool hasError = false;
+  // Use proper wxWidgets menu IDs (avoid conflicts with system IDs on Windows)
+  const int ID_MULTIWORD = wxID_HIGHEST + 1;
+  const int ID_CLEAR_ERROR = wxID_HIGHEST + 2;
+  const int ID_CONFLICT_INFO = wxID_HIGHEST + 3;
 
-    // Check if multiple different stems are assigned to this BZ
-    if (stems.size() > 1) {
-      hasError = true;
-    }
+  menu.Append(ID_MULTIWORD, isMultiWord ? "Disable multi-word mode"
+                                        : "Enable multi-word mode");
 
-    // Check if the stem is also used with other BZs
-    if (!hasError) {
-      for (const auto &stem : stems) {
-        if (m_ctx.db.stemToBz.at(stem).size() > 1) {
-          hasError = true;
-          break;
-        }
-      }
-    }
-
-    // Only show clear/restore error option if there's an actual error
-    if (hasError) {
-      bool isCleared = m_ctx.clearedErrors.count(bz) > 0;
-      menu.Append(ID_CLEAR_ERROR, isCleared ? "Restore error" : "Clear error");
-    }
+  // Only show clear/restore error option if there's an actual error (cleared or not)
+  if (hasConflict) {
+    menu.Append(ID_CLEAR_ERROR, isCleared ? "Restore error" : "Clear error");
+    menu.AppendSeparator();
+    menu.Append(ID_CONFLICT_INFO, conflictInfo);
+    menu.Enable(ID_CONFLICT_INFO, false);
+  }
 
-    int selection = GetPopupMenuSelectionFromUser(menu);
-    if (selection == ID_MULTIWORD) {
-      toggleMultiWordTerm(baseStem);
-    } else if (selection == ID_CLEAR_ERROR) {
-      clearError(bz);
-    }
+  int selection = choosePopupItem(menu);
+  if (selection == ID_MULTIWORD) {
+    toggleMultiWordTerm(baseStem);
+  } else if (selection == ID_CLEAR_ERROR) {
+    clearError(bz);
   }
 }
 
-void MainWindow::onTermListContextMenu(wxTreeListEvent &event) {
-  wxTreeListItem item = event.GetItem();
-  if (!item.IsOk()) {
+void MainWindow::onTermListContextMenu(wxDataViewEvent &event) {
+  if (!event.GetItem().IsOk()) {
     return;
   }
-
-  // Get BZs from the second column
-  wxString bzListText = m_termList->GetItemText(item, 1);
-  std::wstring bzListStr = bzListText.ToStdWstring();
-  
-  // Parse BZs
-  std::vector<std::wstring> bzs;
-  size_t start = 0;
-  size_t end = bzListStr.find(L", ");
-  while (end != std::wstring::npos) {
-    bzs.push_back(bzListStr.substr(start, end - start));
-    start = end + 2; // skip ", "
-    end = bzListStr.find(L", ", start);
+  const ListSnapshot::TermRow *row = m_termModel->termRow(m_termModel->GetRow(event.GetItem()));
+  if (row == nullptr) {
+    return;
   }
-  bzs.push_back(bzListStr.substr(start));
 
+  // BZs of the term, in the order of the second column
+  const std::vector<std::wstring> bzs = row->bzs;
   if (bzs.empty()) return;
+  const std::wstring term = row->term;
+  // Ignored words only stop single-word matches
+  const bool singleWord = row->stem.size() == 1;
 
   // Create menu
   wxMenu menu;
-  
-  // Lock mutex to safely access shared data
-  std::lock_guard<std::mutex> lock(m_dataMutex);
 
   int idCounter = 0;
   const int BASE_ID = wxID_HIGHEST + 100;
 
-  for (const auto& bz : bzs) {
-    if (bz.empty()) continue;
+  {
+    // Not held across the menu; clearError() takes it again
+    const auto lock = tryLockResults();
+    if (!lock.owns_lock()) {
+      return;
+    }
 
-    bool isCleared = m_ctx.clearedErrors.count(bz) > 0;
-    
-    // Check if there is an error associated with this BZ
-    bool hasError = false;
-    if (bzs.size() > 1) {
-        hasError = true;
-    } else {
-        if (!isUniquelyAssigned(bz)) {
-            hasError = true;
-        }
+    for (const auto& bz : bzs) {
+      if (bz.empty()) continue;
+
+      bool isCleared = m_ctx.clearedErrors.count(bz) > 0;
+
+      // Check if there is an error associated with this BZ
+      bool hasError = bzs.size() > 1 ||
+                      m_ctx.conflicts.bzConflicts(m_ctx.db.occurrences.findBz(bz));
+
+      if (hasError || isCleared) {
+          wxString label = isCleared ? wxString::Format("Restore error for '%s'", bz)
+                                     : wxString::Format("Clear error for '%s'", bz);
+          menu.Append(BASE_ID + idCounter, label);
+      }
+      idCounter++;
     }
-    
-    if (hasError || isCleared) {
-        wxString label = isCleared ? wxString::Format("Restore error for '%s'", bz) 
-                                   : wxString::Format("Clear error for '%s'", bz);
-        menu.Append(BASE_ID + idCounter, label);
+  }
+
+  const int ID_IGNORE_WORD = wxID_HIGHEST + 5;
+  if (singleWord) {
+    if (menu.GetMenuItemCount() > 0) {
+      menu.AppendSeparator();
     }
-    idCounter++;
+    menu.Append(ID_IGNORE_WORD, wxString::Format("Never treat '%s' as a term", term));
   }
 
   if (menu.GetMenuItemCount() > 0) {
-      int selection = GetPopupMenuSelectionFromUser(menu);
-      if (selection >= BASE_ID && selection < BASE_ID + idCounter) {
+      int selection = choosePopupItem(menu);
+      if (selection == ID_IGNORE_WORD) {
+          ignoreWord(term);
+      } else if (selection >= BASE_ID && selection < BASE_ID + idCounter) {
           int index = selection - BASE_ID;
           if (index >= 0 && index < static_cast<int>(bzs.size())) {
               clearError(bzs[index]);
@@ -588,54 +652,58 @@ void MainWindow::onTermListContextMenu(wxTreeListEvent &event) {
   }
 }
 
+void MainWindow::ignoreWord(const std::wstring &word) {
+  changeDecisions([this, word] { m_ctx.ignoredWords.insert(word); });
+}
+
 void MainWindow::toggleMultiWordTerm(const std::wstring &baseStem) {
-  bool currentlyActive = m_ctx.multiWordBaseStems.count(baseStem) > 0;
+  changeDecisions([this, baseStem] {
+    bool currentlyActive = m_ctx.multiWordBaseStems.count(baseStem) > 0;
 
-  if (currentlyActive) {
-    // User is DISABLING multi-word mode
-    m_ctx.manualMultiWordToggles.erase(baseStem);          // Remove from manual enables
-    m_ctx.manuallyDisabledMultiWord.insert(baseStem);      // Add to manual disables
+    if (currentlyActive) {
+      // User is DISABLING multi-word mode
+      m_ctx.manualMultiWordToggles.erase(baseStem);          // Remove from manual enables
+      m_ctx.manuallyDisabledMultiWord.insert(baseStem);      // Add to manual disables
 
-    // Also remove from auto-detected (so rebuild logic doesn't re-add it)
-    m_ctx.autoDetectedMultiWordStems.erase(baseStem);
-  } else {
-    // User is ENABLING multi-word mode
-    m_ctx.manuallyDisabledMultiWord.erase(baseStem);       // Remove from manual disables
-    m_ctx.manualMultiWordToggles.insert(baseStem);         // Add to manual enables
-  }
-
-  // Trigger rescan
-  m_debounceTimer.Start(1, true);
+      // Also remove from auto-detected (so rebuild logic doesn't re-add it)
+      m_ctx.autoDetectedMultiWordStems.erase(baseStem);
+    } else {
+      // User is ENABLING multi-word mode
+      m_ctx.manuallyDisabledMultiWord.erase(baseStem);       // Remove from manual disables
+      m_ctx.manualMultiWordToggles.insert(baseStem);         // Add to manual enables
+    }
+  });
 }
 
 void MainWindow::clearError(const std::wstring &bz) {
-  if (m_ctx.clearedErrors.count(bz)) {
-    // Restore error - remove from cleared set
-    m_ctx.clearedErrors.erase(bz);
-  } else {
-    // Clear error - add to cleared set
-    m_ctx.clearedErrors.insert(bz);
-  }
-
-  // Trigger rescan to update highlighting and icons
-  m_debounceTimer.Start(1, true);
+  // The scan thread builds the conflict graph from clearedErrors
+  changeDecisions([this, bz] {
+    if (m_ctx.clearedErrors.count(bz)) {
+      // Restore error - remove from cleared set
+      m_ctx.clearedErrors.erase(bz);
+    } else {
+      // Clear error - add to cleared set
+      m_ctx.clearedErrors.insert(bz);
+    }
+  });
 }
 
-void MainWindow::onTreeListItemActivated(wxTreeListEvent &event) {
-  wxTreeListItem item = event.GetItem();
-  if (!item.IsOk()) {
+void MainWindow::onTreeListItemActivated(wxDataViewEvent &event) {
+  if (!event.GetItem().IsOk()) {
     return;
   }
-
-  wxString bzText = m_treeList->GetItemText(item, 0);
-  std::wstring bz = bzText.ToStdWstring();
+  const ListSnapshot::BzRow *row = m_treeModel->bzRow(m_treeModel->GetRow(event.GetItem()));
+  if (row == nullptr) {
+    return;
+  }
+  const std::wstring bz = row->bz;
 
   // Lock mutex to safely access shared data
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
   // Check if this BZ has any positions
-  if (m_ctx.db.bzToPositions.count(bz) && !m_ctx.db.bzToPositions[bz].empty()) {
-    const auto &positions = m_ctx.db.bzToPositions[bz];
+  PositionRange positions = m_ctx.db.positionsOfBz(bz);
+  if (!positions.empty()) {
 
     // Get current occurrence index for this BZ (or initialize based on cursor
     // position)
@@ -684,37 +752,22 @@ void MainWindow::onTreeListItemActivated(wxTreeListEvent &event) {
   }
 }
 
-void MainWindow::onTermListItemActivated(wxTreeListEvent &event) {
-  wxTreeListItem item = event.GetItem();
-  if (!item.IsOk()) {
+void MainWindow::onTermListItemActivated(wxDataViewEvent &event) {
+  if (!event.GetItem().IsOk()) {
     return;
   }
-
-  wxString termText = m_termList->GetItemText(item, 0);
-  std::wstring termWord = termText.ToStdWstring();
+  const ListSnapshot::TermRow *row = m_termModel->termRow(m_termModel->GetRow(event.GetItem()));
+  if (row == nullptr) {
+    return;
+  }
+  const StemVector foundStem = row->stem;
 
   // Lock mutex to safely access shared data
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
-  // Find the stem for this term word
-  StemVector foundStem;
-  bool stemFound = false;
-
-  for (const auto& [stem, firstWord] : m_ctx.db.stemToFirstWord) {
-    if (firstWord == termWord) {
-      foundStem = stem;
-      stemFound = true;
-      break;
-    }
-  }
-
-  if (!stemFound) {
-    return;
-  }
-
   // Check if this stem has any positions
-  if (m_ctx.db.stemToPositions.count(foundStem) && !m_ctx.db.stemToPositions[foundStem].empty()) {
-    const auto &positions = m_ctx.db.stemToPositions[foundStem];
+  PositionRange positions = m_ctx.db.positionsOfStem(foundStem);
+  if (!positions.empty()) {
 
     // Get current occurrence index for this stem (or initialize based on cursor position)
     if (!m_stemCurrentOccurrence.count(foundStem)) {
@@ -775,33 +828,25 @@ void MainWindow::onTextRightClick(wxMouseEvent &event) {
   // Convert row/col to character position
   long clickPos = m_textBox->XYToPosition(col, row);
   
-  // Check if we're on a highlighted error
-  size_t errorStart = 0, errorEnd = 0;
-  bool foundError = false;
-  
-  // Check all error position vectors
-  auto checkPositions = [&](const std::vector<std::pair<int, int>>& positions) {
-    for (const auto& [start, end] : positions) {
-      if (clickPos >= start && clickPos < end) {
-        errorStart = start;
-        errorEnd = end;
-        return true;
-      }
-    }
-    return false;
-  };
-  
-  // all errors should be in m_allErrorsPositions so we don't need to check others separately
-  if (checkPositions(m_allErrorsPositions)) {
-    foundError = true;
+  // Check if we're on a highlighted error; every error is in the list of all errors
+  auto lock = tryLockResults();
+  if (!lock.owns_lock()) {
+    event.Skip();
+    return;
   }
-  
-  if (foundError) {
+  const ErrorPositions &allErrors = m_pipeline.allErrors();
+  const std::optional<size_t> error = m_pipeline.errorIndex().errorAt(allErrors, clickPos);
+
+  if (error) {
+    const size_t errorStart = allErrors[*error].first;
+    const size_t errorEnd = allErrors[*error].second;
+    // Not held across the menu; clearTextError() takes it again
+    lock.unlock();
     wxMenu menu;
     const int ID_CLEAR_TEXT_ERROR = wxID_HIGHEST + 10;
     menu.Append(ID_CLEAR_TEXT_ERROR, "Clear error");
     
-    int selection = GetPopupMenuSelectionFromUser(menu, event.GetPosition());
+    int selection = choosePopupItem(menu, event.GetPosition());
     if (selection == ID_CLEAR_TEXT_ERROR) {
       clearTextError(errorStart, errorEnd);
     }
@@ -811,50 +856,69 @@ void MainWindow::onTextRightClick(wxMouseEvent &event) {
 }
 
 void MainWindow::clearTextError(size_t start, size_t end) {
-  // Add to cleared positions
-  m_ctx.clearedTextPositions.insert({start, end});
-  
+  // Anchored now, to the text the highlight positions refer to
+  const std::wstring &text = shownText();
+  if (start >= end || end > text.size()) {
+    return;
+  }
+  const ClearedAnchors::Anchor anchor = ClearedAnchors::anchorAt(text, start, end);
+  changeDecisions([this, anchor] { m_ctx.clearedTextAnchors.addAnchor(anchor); });
+}
+
+int MainWindow::choosePopupItem(wxMenu &menu, const wxPoint &position) {
+  if (m_popupChoice) {
+    return m_popupChoice(menu);
+  }
+  return GetPopupMenuSelectionFromUser(menu, position);
+}
+
+void MainWindow::changeDecisions(std::function<void()> change) {
+  // Never wait for a running scan here; updateUIAfterScan() applies the change
+  std::unique_lock<std::mutex> lock(m_dataMutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    m_pendingDecisions.push_back(std::move(change));
+    return;
+  }
+  change();
+  lock.unlock();
+
   // Trigger rescan to update highlighting
   m_debounceTimer.Start(1, true);
 }
 
 bool MainWindow::isPositionCleared(size_t start, size_t end) const {
-  return ErrorDetectorHelper::isPositionCleared(m_ctx.clearedTextPositions, start, end);
+  return ErrorDetectorHelper::isPositionCleared(m_ctx.clearedTextAnchors, start, end);
 }
 
 void MainWindow::onRestoreTextboxErrors(wxCommandEvent &event) {
-  m_ctx.clearedTextPositions.clear();
-  m_debounceTimer.Start(1, true);
+  changeDecisions([this] { m_ctx.clearedTextAnchors.clear(); });
 }
 
 void MainWindow::onRestoreOverviewErrors(wxCommandEvent &event) {
-  m_ctx.clearedErrors.clear();
-  m_debounceTimer.Start(1, true);
+  changeDecisions([this] { m_ctx.clearedErrors.clear(); });
+}
+
+void MainWindow::onRestoreIgnoredWords(wxCommandEvent &event) {
+  changeDecisions([this] { m_ctx.ignoredWords.clear(); });
 }
 
 void MainWindow::onRestoreAllErrors(wxCommandEvent &event) {
-  m_ctx.clearedTextPositions.clear();
-  m_ctx.clearedErrors.clear();
-  m_debounceTimer.Start(1, true);
+  changeDecisions([this] {
+    m_ctx.clearedTextAnchors.clear();
+    m_ctx.clearedErrors.clear();
+  });
 }
 
 
 void MainWindow::onLanguageChanged(wxCommandEvent &event) {
-  // Update language selection
-  if (m_languageSelector->GetSelection() == 0) {
-      m_currentAnalyzer = std::make_unique<GermanTextAnalyzer>();
-  } else {
-      m_currentAnalyzer = std::make_unique<EnglishTextAnalyzer>();
-  }
-
-  // Clear auto-detected stems (language-specific)
-  m_ctx.autoDetectedMultiWordStems.clear();
-
-  // Rebuild combined set with just manual toggles
-  m_ctx.multiWordBaseStems = m_ctx.manualMultiWordToggles;
-
-  // Trigger rescan with new language
-  m_debounceTimer.Start(1, true);
+  // The running scan uses the analyzer, so the switch waits for it like a
+  // decision; changeDecisions() then rescans in the new language
+  const bool useGerman = m_languageSelector->GetSelection() == 0;
+  changeDecisions([this, useGerman] {
+    m_pipeline.setLanguage(useGerman);
+    // Results of the old language must not be saved as a session
+    m_resultsValid = false;
+  });
 }
 
 void MainWindow::onAbout(wxCommandEvent &event) {
@@ -883,103 +947,301 @@ void MainWindow::onAbout(wxCommandEvent &event) {
                wxOK | wxICON_INFORMATION);
 }
 
-std::wstring MainWindow::getFirstOccurrenceWord(const StemVector& stem) const {
-  if (!m_ctx.db.stemToPositions.count(stem) || m_ctx.db.stemToPositions.at(stem).empty()) {
-    return L"";
+void MainWindow::onOpenFile(wxCommandEvent &event) {
+  wxFileDialog dialog(this, wxT("Open document"), wxEmptyString, wxEmptyString,
+                      wxT("Documents (*.txt;*.docx)|*.txt;*.docx|Text files (*.txt)|*.txt|"
+                          "Word documents (*.docx)|*.docx|All files (*.*)|*.*"),
+                      wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+  if (dialog.ShowModal() == wxID_OK) {
+    openFile(dialog.GetPath().utf8_string());
+  }
+}
+
+void MainWindow::onExportReport(wxCommandEvent &event) {
+  wxFileDialog dialog(this, wxT("Export report"), wxEmptyString, wxT("report.json"),
+                      wxT("JSON (*.json)|*.json|CSV (*.csv)|*.csv|SARIF (*.sarif)|*.sarif"),
+                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+  if (dialog.ShowModal() != wxID_OK) {
+    return;
   }
+  static const ReportExporter::Format FORMATS[] = {ReportExporter::Format::JSON, ReportExporter::Format::CSV,
+                                                   ReportExporter::Format::SARIF};
+  exportReport(dialog.GetPath().utf8_string(), FORMATS[std::clamp(dialog.GetFilterIndex(), 0, 2)]);
+}
 
-  const auto& positions = m_ctx.db.stemToPositions.at(stem);
-  size_t firstStart = positions[0].first;
-  size_t firstLen = positions[0].second;
+bool MainWindow::exportReport(const std::string &path, ReportExporter::Format format) {
+  // Never wait for a running scan on the UI thread
+  const auto lock = tryLockResults();
+  // The results must be the published ones of m_fullText, with no rescan
+  // for edits or changed decisions still to come
+  if (!lock.owns_lock() || !m_resultsValid || !m_fullTextShown || !m_pendingDecisions.empty() ||
+      m_debounceTimer.IsRunning()) {
+    wxLogError("The document is still being scanned; export the report when the scan has finished");
+    return false;
+  }
+  const ReportExporter::Report report{m_documentPath, m_pipeline.german() ? "de" : "en",
+                                      m_fullText, m_ctx, m_pipeline.noNumberErrors(),
+                                      m_pipeline.wrongTermBzErrors(), m_pipeline.wrongArticleErrors(),
+                                      m_pipeline.allErrors()};
+  if (!ReportExporter::writeFile(path, format, report)) {
+    wxLogError("Could not write %s", wxString::FromUTF8(path));
+    return false;
+  }
+  return true;
+}
 
-  std::wstring fullMatch = m_fullText.substr(firstStart, firstLen);
+void MainWindow::openFile(const std::string &path) {
+  cancelLoad();
 
-  // Extract word before BZ number
-  size_t bzStart = fullMatch.find_last_of(L' ');
-  if (bzStart != std::wstring::npos) {
-    return fullMatch.substr(0, bzStart);
+  std::shared_ptr<MappedFile> file;
+  try {
+    file = std::make_shared<MappedFile>(path);
+  } catch (const std::exception &e) {
+    wxLogError("Could not open %s: %s", wxString::FromUTF8(path), e.what());
+    return;
   }
 
-  return fullMatch;
+  // The file replaces the text; appending chunks must not look like typing.
+  // A scan of the old text must not style the new one.
+  m_debounceTimer.Stop();
+  m_cancelScan = true;
+  m_loading = true;
+  m_loadScanStarted = false;
+  m_paragraphStarts.clear();
+  m_textBox->SetEditable(false);
+  m_textBox->BeginSuppressUndo();
+  m_textBox->Clear();
+
+  wxRect gaugeRect;
+  GetStatusBar()->GetFieldRect(1, gaugeRect);
+  m_loadGauge->SetSize(gaugeRect);
+  m_loadGauge->SetValue(0);
+  m_loadGauge->Show();
+  SetStatusText(wxString::FromUTF8(path), 0);
+
+  const uint64_t generation = ++m_loadGeneration;
+  m_loadThread = std::jthread([this, file, path, generation](std::stop_token stop) {
+    Trace::setThreadName("Load");
+    auto sink = [&](std::wstring &&chunk, size_t bytesDone, size_t bytesTotal) {
+      {
+        std::unique_lock<std::mutex> lock(m_loadMutex);
+        m_loadCondition.wait(lock, stop, [this] { return m_chunksInFlight < MAX_CHUNKS_IN_FLIGHT; });
+        if (stop.stop_requested()) {
+          return;
+        }
+        ++m_chunksInFlight;
+      }
+      CallAfter([this, generation, chunk = std::move(chunk), bytesDone, bytesTotal] {
+        appendLoadedChunk(generation, chunk, bytesDone, bytesTotal);
+      });
+    };
+    try {
+      DocumentLoader::Result result = DocumentLoader::load(*file, sink, stop);
+      if (result.completed) {
+        CallAfter([this, generation, path, result = std::move(result)] {
+          finishLoad(generation, path, result);
+        });
+      }
+    } catch (const std::exception &e) {
+      // A corrupt .docx; keep what was appended so far and report it
+      CallAfter([this, generation, path, message = std::string(e.what())] {
+        if (generation == m_loadGeneration) {
+          cancelLoad();
+          wxLogError("Could not read %s: %s", wxString::FromUTF8(path), wxString::FromUTF8(message));
+        }
+      });
+    }
+  });
 }
 
-void MainWindow::fillTermList() {
-  m_termList->DeleteAllItems();
+void MainWindow::appendLoadedChunk(uint64_t generation, const std::wstring &chunk,
+                                   size_t bytesDone, size_t bytesTotal) {
+  if (generation != m_loadGeneration) {
+    return;  // Chunk of a cancelled load; cancelLoad() reset the count
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    --m_chunksInFlight;
+  }
+  m_loadCondition.notify_all();
 
-  // Collect all stems sorted by first occurrence position
-  struct StemInfo {
-    StemVector stem;
-    size_t firstPosition;
-    std::wstring firstWord;
-    std::unordered_set<std::wstring> bzs;
-  };
+  BZ_TRACE_SCOPE("MainWindow::appendLoadedChunk");
+  m_textBox->AppendText(chunk);
+  m_loadGauge->SetValue(bytesTotal > 0 ? static_cast<int>(bytesDone * 1000 / bytesTotal) : 1000);
 
-  std::vector<StemInfo> stemInfos;
+  // Analyse the decoded prefix while the rest is still loading
+  if (!m_loadScanStarted) {
+    m_loadScanStarted = true;
+    wxTimerEvent timerEvent;
+    scanText(timerEvent);
+  }
+}
 
-  for (const auto& [stem, bzSet] : m_ctx.db.stemToBz) {
-    StemInfo info;
-    info.stem = stem;
-    info.bzs = bzSet;
+void MainWindow::finishLoad(uint64_t generation, const std::string &path,
+                            const DocumentLoader::Result &result) {
+  if (generation != m_loadGeneration) {
+    return;
+  }
+  m_loading = false;
+  m_textBox->EndSuppressUndo();
+  m_textBox->SetEditable(true);
+  m_textBox->SetInsertionPoint(0);
+  m_loadGauge->Hide();
+  m_documentPath = path;
+  const std::string format = result.format == DocumentLoader::Format::DOCX
+                                 ? std::string("Word document")
+                                 : TextDecoder::name(result.encoding);
+  SetStatusText(wxString::FromUTF8(path + "  (" + format + ", " + std::to_string(result.characters) +
+                                   " characters, " + std::to_string(result.paragraphs) +
+                                   " paragraphs)"), 0);
+
+  m_paragraphStarts = result.paragraphStarts;
+
+  if (m_sessionRecorder) {
+    m_sessionRecorder->record(m_textBox->GetValue().ToStdWstring());
+  }
+  if (restoreSession(path)) {
+    return;
+  }
+  wxTimerEvent timerEvent;
+  scanText(timerEvent);
+}
 
-    // Get first position and word
-    if (m_ctx.db.stemToPositions.count(stem) && !m_ctx.db.stemToPositions.at(stem).empty()) {
-      info.firstPosition = m_ctx.db.stemToPositions.at(stem)[0].first;
+bool MainWindow::restoreSession(const std::string &documentPath) {
+  const std::string sessionPath = SessionFile::pathFor(documentPath);
+  std::error_code error;
+  if (!std::filesystem::exists(sessionPath, error)) {
+    return false;
+  }
+  BZ_TRACE_SCOPE("MainWindow::restoreSession");
+  std::unique_ptr<SessionFile> session;
+  try {
+    session = std::make_unique<SessionFile>(sessionPath);
+  } catch (const std::exception &e) {
+    wxLogWarning("Ignoring session %s: %s", wxString::FromUTF8(sessionPath), e.what());
+    return false;
+  }
 
-      if (m_ctx.db.stemToFirstWord.count(stem)) {
-        info.firstWord = m_ctx.db.stemToFirstWord.at(stem);
-      }
-    } else {
-      info.firstPosition = SIZE_MAX;
+  // The scan of the loaded prefix is obsolete either way
+  m_cancelScan = true;
+  if (m_scanThread.joinable()) {
+    m_scanThread.join();
+  }
+  m_cancelScan = false;
+
+  const std::wstring text = m_textBox->GetValue().ToStdWstring();
+  {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    m_languageSelector->SetSelection(session->german() ? 0 : 1);
+    m_pipeline.setLanguage(session->german());
+    if (!session->matches(text)) {
+      // Edited since the session was saved, or saved by another analyzer
+      // version: keep the decisions, scan again
+      session->restoreDecisions(m_ctx);
+      return false;
     }
+    if (m_fullTextShown) {
+      m_shownText = std::move(m_fullText);
+      m_fullTextShown = false;
+    }
+    m_fullText = text;
+    try {
+      m_pipeline.restore(*session, m_fullText);
+      m_listSnapshot = ListSnapshot::build(m_ctx, m_fullText, m_shownListSnapshot.get());
+    } catch (const std::exception &e) {
+      wxLogWarning("Ignoring session %s: %s", wxString::FromUTF8(sessionPath), e.what());
+      return false;
+    }
+    m_resultsValid = true;
+  }
+  updateUIAfterScan();
+  return true;
+}
 
-    stemInfos.push_back(info);
+void MainWindow::onSaveSession(wxCommandEvent &event) {
+  if (m_documentPath.empty()) {
+    wxLogError("Open a document before saving its session");
+    return;
   }
+  saveSession();
+}
 
-  // Sort by first occurrence position
-  std::sort(stemInfos.begin(), stemInfos.end(),
-            [](const StemInfo& a, const StemInfo& b) {
-              return a.firstPosition < b.firstPosition;
-            });
+void MainWindow::saveSession() {
+  const std::string path = SessionFile::pathFor(m_documentPath);
+  std::lock_guard<std::mutex> lock(m_dataMutex);
+  if (!m_resultsValid) {
+    wxLogError("The document is still being scanned; save the session when the scan has finished");
+    return;
+  }
+  try {
+    m_pipeline.save(path, m_fullText);
+  } catch (const std::exception &e) {
+    wxLogError("Could not save session %s: %s", wxString::FromUTF8(path), e.what());
+  }
+}
 
-  // Populate tree control
-  for (const auto& info : stemInfos) {
-    // Sort BZs numerically
-    std::vector<std::wstring> sortedBzs(info.bzs.begin(), info.bzs.end());
-    std::sort(sortedBzs.begin(), sortedBzs.end(), BZComparatorForMap());
+void MainWindow::onClose(wxCloseEvent &event) {
+  // Keep an existing session up to date; new ones are only created on request
+  std::error_code error;
+  if (!m_documentPath.empty() && std::filesystem::exists(SessionFile::pathFor(m_documentPath), error)) {
+    saveSession();
+  }
+  event.Skip();
+}
 
-    std::wstring bzListStr;
-    for (size_t i = 0; i < sortedBzs.size(); ++i) {
-      if (i > 0) bzListStr += L", ";
-      bzListStr += sortedBzs[i];
-    }
+void MainWindow::cancelLoad() {
+  if (m_loadThread.joinable()) {
+    m_loadThread.request_stop();
+    m_loadCondition.notify_all();
+    m_loadThread.join();
+  }
+  // Chunks still queued belong to the old generation and are dropped
+  ++m_loadGeneration;
+  {
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    m_chunksInFlight = 0;
+  }
+  if (m_loading) {
+    m_loading = false;
+    m_textBox->EndSuppressUndo();
+    m_textBox->SetEditable(true);
+    m_loadGauge->Hide();
+  }
+}
 
-    // Check if there's a conflict:
-    // 1. Term maps to multiple BZs (info.bzs.size() > 1)
-    // 2. Any BZ this term is assigned to is also assigned to other terms
-    bool hasError = false;
-    if (info.bzs.size() > 1) {
-      hasError = true;  // One term -> multiple BZs
-    } else {
-      // Check if the single BZ is assigned to multiple terms
-      for (const auto& bz : info.bzs) {
-        if (!isUniquelyAssigned(bz)) {
-          hasError = true;
-          break;
-        }
-      }
-    }
+void MainWindow::onShowStatistics(wxCommandEvent &event) {
+  std::ostringstream text;
+  Metrics::writeText(text);
+  showTextDialog(wxT("Scan statistics"), text.str());
+}
 
-    // Create tree item with appropriate icon
-    wxTreeListItem item;
-    if (hasError) {
-      // Warning icon (1) for conflicts
-      item = m_termList->AppendItem(m_termList->GetRootItem(), info.firstWord, 1, 1);
-    } else {
-      // Check icon (0) for no conflicts
-      item = m_termList->AppendItem(m_termList->GetRootItem(), info.firstWord, 0, 0);
+void MainWindow::onShowMemoryReport(wxCommandEvent &event) {
+  MemoryReport report;
+  {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    m_pipeline.reportMemory(report, m_fullText);
+    if (m_listSnapshot) {
+      report.add("List rows", m_listSnapshot->memoryBytes());
     }
-
-    // Set the BZ list in the second column
-    m_termList->SetItemText(item, 1, bzListStr);
   }
+  // The control keeps its own copy of the text plus per-paragraph layout
+  report.add("wxRichTextCtrl text (estimate)", static_cast<size_t>(m_textBox->GetLastPosition()) * sizeof(wxChar));
+
+  std::ostringstream text;
+  report.write(text);
+  showTextDialog(wxT("Memory report"), text.str());
+}
+
+void MainWindow::showTextDialog(const wxString &title, const std::string &text) {
+  wxDialog dialog(this, wxID_ANY, title, wxDefaultPosition,
+                  wxSize(640, 480), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER);
+  auto* sizer = new wxBoxSizer(wxVERTICAL);
+  auto* view = new wxTextCtrl(&dialog, wxID_ANY, wxString::FromUTF8(text),
+                              wxDefaultPosition, wxDefaultSize,
+                              wxTE_MULTILINE | wxTE_READONLY | wxHSCROLL);
+  view->SetFont(wxFontInfo().Family(wxFONTFAMILY_TELETYPE));
+  sizer->Add(view, 1, wxEXPAND | wxALL, 8);
+  sizer->Add(dialog.CreateStdDialogButtonSizer(wxOK), 0, wxEXPAND | wxBOTTOM | wxLEFT | wxRIGHT, 8);
+  dialog.SetSizer(sizer);
+  dialog.ShowModal();
 }
@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    // Paths come from wxFileDialog as UTF-8
+    const int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length > 0 ? length - 1 : 0, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot read size of " + path);
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot map " + path);
+    }
+    m_mapping = mapping;
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("cannot map " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+
+    struct stat info {};
+    if (::fstat(m_fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(m_fd);
+        throw std::runtime_error("not a regular file: " + path);
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size == 0) {
+        return;
+    }
+
+    void* mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(m_fd);
+        throw std::runtime_error("cannot map " + path);
+    }
+    // Decoding reads front to back once
+    ::madvise(mapped, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(mapped);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+#endif
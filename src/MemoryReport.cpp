@@ -0,0 +1,93 @@
+#include "MemoryReport.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string formatBytes(double bytes) {
+    char buffer[32];
+    if (bytes >= 1024.0 * 1024.0) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    } else if (bytes >= 1024.0) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.0f B", bytes);
+    }
+    return buffer;
+}
+
+} // namespace
+
+void MemoryReport::add(std::string name, size_t bytes, bool transient) {
+    m_entries.push_back({std::move(name), bytes, transient});
+}
+
+size_t MemoryReport::totalBytes() const {
+    size_t total = 0;
+    for (const Entry& entry : m_entries) {
+        total += entry.bytes;
+    }
+    return total;
+}
+
+size_t MemoryReport::bytesOf(const std::string& name) const {
+    for (const Entry& entry : m_entries) {
+        if (entry.name == name) {
+            return entry.bytes;
+        }
+    }
+    return 0;
+}
+
+double MemoryReport::bytesPerMillionCharacters() const {
+    if (m_inputCharacters == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(totalBytes()) * 1e6 / static_cast<double>(m_inputCharacters);
+}
+
+void MemoryReport::write(std::ostream& out) const {
+    std::vector<Entry> sorted = m_entries;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Entry& a, const Entry& b) { return a.bytes > b.bytes; });
+
+    const double total = static_cast<double>(totalBytes());
+    char line[160];
+    for (const Entry& entry : sorted) {
+        std::snprintf(line, sizeof(line), "%-44s %12s %6.1f %%%s\n", entry.name.c_str(),
+                      formatBytes(static_cast<double>(entry.bytes)).c_str(),
+                      total > 0 ? 100.0 * static_cast<double>(entry.bytes) / total : 0.0,
+                      entry.transient ? "  (during scan)" : "");
+        out << line;
+    }
+
+    std::snprintf(line, sizeof(line), "%-44s %12s\n", "Total (estimated)", formatBytes(total).c_str());
+    out << line;
+    if (m_inputCharacters > 0) {
+        std::snprintf(line, sizeof(line), "%-44s %12s\n", "Per million input characters",
+                      formatBytes(bytesPerMillionCharacters()).c_str());
+        out << line;
+    }
+    if (const size_t resident = processResidentBytes()) {
+        std::snprintf(line, sizeof(line), "%-44s %12s\n", "Process resident set (measured)",
+                      formatBytes(static_cast<double>(resident)).c_str());
+        out << line;
+    }
+}
+
+size_t MemoryReport::processResidentBytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
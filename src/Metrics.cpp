@@ -0,0 +1,205 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+
+namespace Metrics {
+namespace {
+
+enum class Type { COUNTER, HISTOGRAM };
+
+// All series sharing a name; labels -> value
+struct Family {
+    std::string help;
+    Type type;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, Family> families;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+Family& family(Registry& reg, const std::string& name, const std::string& help, Type type) {
+    auto it = reg.families.find(name);
+    if (it == reg.families.end()) {
+        it = reg.families.emplace(name, Family{help, type, {}, {}}).first;
+    }
+    return it->second;
+}
+
+// Shortest round-trip-ish formatting for bucket bounds and sums
+std::string formatNumber(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+std::string withLabels(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return "";
+    }
+    if (labels.empty()) {
+        return "{" + extra + "}";
+    }
+    if (extra.empty()) {
+        return "{" + labels + "}";
+    }
+    return "{" + labels + "," + extra + "}";
+}
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> upperBounds)
+    : m_upperBounds(std::move(upperBounds)),
+      m_buckets(new std::atomic<uint64_t>[m_upperBounds.size() + 1]) {
+    std::sort(m_upperBounds.begin(), m_upperBounds.end());
+    for (size_t i = 0; i <= m_upperBounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) {
+    const size_t bucket = static_cast<size_t>(
+        std::lower_bound(m_upperBounds.begin(), m_upperBounds.end(), value) - m_upperBounds.begin());
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::bucketCounts() const {
+    std::vector<uint64_t> counts(m_upperBounds.size() + 1);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+double Histogram::quantileUpperBound(double q) const {
+    const std::vector<uint64_t> counts = bucketCounts();
+    uint64_t total = 0;
+    for (uint64_t c : counts) {
+        total += c;
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    const double rank = q * static_cast<double>(total);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < m_upperBounds.size(); ++i) {
+        cumulative += counts[i];
+        if (static_cast<double>(cumulative) >= rank) {
+            return m_upperBounds[i];
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+void Histogram::reset() {
+    for (size_t i = 0; i <= m_upperBounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0.0, std::memory_order_relaxed);
+}
+
+Counter& counter(const std::string& name, const std::string& help, const std::string& labels) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto& slot = family(reg, name, help, Type::COUNTER).counters[labels];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+Histogram& histogram(const std::string& name, const std::string& help,
+                     const std::vector<double>& upperBounds, const std::string& labels) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto& slot = family(reg, name, help, Type::HISTOGRAM).histograms[labels];
+    if (!slot) {
+        slot = std::make_unique<Histogram>(upperBounds);
+    }
+    return *slot;
+}
+
+std::string sizeLabel(size_t characters) {
+    if (characters < 10'000) return "size=\"10K\"";
+    if (characters < 100'000) return "size=\"100K\"";
+    if (characters < 1'000'000) return "size=\"1M\"";
+    if (characters < 10'000'000) return "size=\"10M\"";
+    return "size=\"10M+\"";
+}
+
+void resetAll() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& [name, fam] : reg.families) {
+        for (auto& [labels, c] : fam.counters) {
+            c->reset();
+        }
+        for (auto& [labels, h] : fam.histograms) {
+            h->reset();
+        }
+    }
+}
+
+void writeText(std::ostream& out) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    for (const auto& [name, fam] : reg.families) {
+        out << "# HELP " << name << ' ' << fam.help << '\n';
+        out << "# TYPE " << name << (fam.type == Type::COUNTER ? " counter\n" : " histogram\n");
+
+        for (const auto& [labels, c] : fam.counters) {
+            out << name << withLabels(labels) << ' ' << c->value() << '\n';
+        }
+
+        for (const auto& [labels, h] : fam.histograms) {
+            const std::vector<uint64_t> counts = h->bucketCounts();
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < h->upperBounds().size(); ++i) {
+                cumulative += counts[i];
+                out << name << "_bucket"
+                    << withLabels(labels, "le=\"" + formatNumber(h->upperBounds()[i]) + "\"") << ' '
+                    << cumulative << '\n';
+            }
+            cumulative += counts.back();
+            out << name << "_bucket" << withLabels(labels, "le=\"+Inf\"") << ' ' << cumulative << '\n';
+            out << name << "_sum" << withLabels(labels) << ' ' << formatNumber(h->sum()) << '\n';
+            out << name << "_count" << withLabels(labels) << ' ' << cumulative << '\n';
+        }
+    }
+}
+
+bool writeTextFile(const std::string& path) {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        if (!out) {
+            return false;
+        }
+        writeText(out);
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+} // namespace Metrics
@@ -0,0 +1,162 @@
+#include "OccurrenceTable.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+
+OccurrenceTable::OccurrenceTable(std::pmr::memory_resource* resource)
+    : m_resource(resource),
+      m_start(resource), m_length(resource), m_stemId(resource), m_bzId(resource), m_kind(resource),
+      m_runStarts(resource),
+      m_bzOffsets(resource), m_bzIndex(resource), m_stemOffsets(resource), m_stemIndex(resource),
+      m_bzNames(resource), m_bzIds(resource), m_stems(resource), m_stemIds(resource) {}
+
+uint32_t OccurrenceTable::internBz(const std::wstring& bz) {
+    auto [it, inserted] = m_bzIds.try_emplace(bz, static_cast<uint32_t>(m_bzNames.size()));
+    if (inserted) {
+        m_bzNames.push_back(bz);
+    }
+    return it->second;
+}
+
+uint32_t OccurrenceTable::internStem(const StemVector& stem) {
+    auto [it, inserted] = m_stemIds.try_emplace(stem, static_cast<uint32_t>(m_stems.size()));
+    if (inserted) {
+        m_stems.push_back(stem);
+    }
+    return it->second;
+}
+
+uint32_t OccurrenceTable::findBz(const std::wstring& bz) const {
+    auto it = m_bzIds.find(bz);
+    return it != m_bzIds.end() ? it->second : NO_ID;
+}
+
+uint32_t OccurrenceTable::findStem(const StemVector& stem) const {
+    auto it = m_stemIds.find(stem);
+    return it != m_stemIds.end() ? it->second : NO_ID;
+}
+
+void OccurrenceTable::add(uint32_t bzId, uint32_t stemId, size_t start, size_t length,
+                          OccurrenceKind kind) {
+    if (m_start.empty() || start < m_start.back()) {
+        m_runStarts.push_back(m_start.size());
+    }
+    m_start.push_back(static_cast<uint32_t>(start));
+    m_length.push_back(static_cast<uint32_t>(length));
+    m_stemId.push_back(stemId);
+    m_bzId.push_back(bzId);
+    m_kind.push_back(kind);
+    m_finalized = false;
+}
+
+void OccurrenceTable::finalize() {
+    const size_t count = m_start.size();
+
+    // Each scan pass appends an already sorted run; merge the runs into
+    // document order (no-op for a single run)
+    if (m_runStarts.size() > 1) {
+        std::pmr::vector<uint32_t> order(count, m_resource);
+        std::iota(order.begin(), order.end(), 0u);
+        auto byStart = [this](uint32_t a, uint32_t b) { return m_start[a] < m_start[b]; };
+
+        std::vector<size_t> bounds(m_runStarts.begin(), m_runStarts.end());
+        bounds.push_back(count);
+        while (bounds.size() > 2) {
+            std::vector<size_t> next;
+            size_t i = 0;
+            for (; i + 2 < bounds.size(); i += 2) {
+                std::inplace_merge(order.begin() + bounds[i], order.begin() + bounds[i + 1],
+                                   order.begin() + bounds[i + 2], byStart);
+                next.push_back(bounds[i]);
+            }
+            if (i + 1 < bounds.size()) {
+                next.push_back(bounds[i]);  // Odd run out, carried to the next round
+            }
+            next.push_back(count);
+            bounds = std::move(next);
+        }
+
+        auto permute = [&order](auto& column) {
+            std::remove_reference_t<decltype(column)> sorted(column.get_allocator());
+            sorted.reserve(column.size());
+            for (uint32_t row : order) {
+                sorted.push_back(column[row]);
+            }
+            column = std::move(sorted);
+        };
+        permute(m_start);
+        permute(m_length);
+        permute(m_stemId);
+        permute(m_bzId);
+        permute(m_kind);
+        m_runStarts.assign(1, 0);
+    }
+
+    // Counting pass: build CSR offsets, then scatter rows in document order
+    auto buildIndex = [this, count](const std::pmr::vector<uint32_t>& ids, size_t keyCount,
+                                    std::pmr::vector<uint32_t>& offsets,
+                                    std::pmr::vector<uint32_t>& index) {
+        offsets.assign(keyCount + 1, 0);
+        for (uint32_t id : ids) {
+            ++offsets[id + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        index.resize(count);
+        std::pmr::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1, m_resource);
+        for (uint32_t row = 0; row < count; ++row) {
+            index[cursor[ids[row]]++] = row;
+        }
+    };
+    buildIndex(m_bzId, m_bzNames.size(), m_bzOffsets, m_bzIndex);
+    buildIndex(m_stemId, m_stems.size(), m_stemOffsets, m_stemIndex);
+
+    m_finalized = true;
+}
+
+PositionRange OccurrenceTable::positionsOfBz(uint32_t bzId) const {
+    if (bzId == NO_ID || bzId + 1 >= m_bzOffsets.size()) {
+        return {};
+    }
+    return {m_bzIndex.data() + m_bzOffsets[bzId], m_bzIndex.data() + m_bzOffsets[bzId + 1], this};
+}
+
+PositionRange OccurrenceTable::positionsOfStem(uint32_t stemId) const {
+    if (stemId == NO_ID || stemId + 1 >= m_stemOffsets.size()) {
+        return {};
+    }
+    return {m_stemIndex.data() + m_stemOffsets[stemId],
+            m_stemIndex.data() + m_stemOffsets[stemId + 1], this};
+}
+
+std::wstring OccurrenceTable::firstSpelling(uint32_t stemId, const std::wstring& text) const {
+    const PositionRange positions = positionsOfStem(stemId);
+    if (positions.empty()) {
+        return {};
+    }
+    // Clamped: a report may pair a loaded session with another text
+    const auto [start, length] = positions.front();
+    const std::wstring_view match = std::wstring_view(text).substr(std::min(start, text.size()), length);
+    const size_t bzStart = match.find_last_of(L' ');
+    return std::wstring(bzStart == std::wstring_view::npos ? match : match.substr(0, bzStart));
+}
+
+bool OccurrenceTable::hasOccurrenceStartingAt(size_t pos) const {
+    return std::binary_search(m_start.begin(), m_start.end(), static_cast<uint32_t>(pos));
+}
+
+size_t OccurrenceTable::memoryBytes() const {
+    return MemoryUsage::heapBytes(m_start) + MemoryUsage::heapBytes(m_length) +
+           MemoryUsage::heapBytes(m_stemId) + MemoryUsage::heapBytes(m_bzId) +
+           MemoryUsage::heapBytes(m_kind) + MemoryUsage::heapBytes(m_runStarts) +
+           MemoryUsage::heapBytes(m_bzOffsets) + MemoryUsage::heapBytes(m_bzIndex) +
+           MemoryUsage::heapBytes(m_stemOffsets) + MemoryUsage::heapBytes(m_stemIndex) +
+           MemoryUsage::heapBytes(m_bzNames) + MemoryUsage::heapBytes(m_bzIds) +
+           MemoryUsage::heapBytes(m_stems) + MemoryUsage::heapBytes(m_stemIds);
+}
+
+void OccurrenceTable::clear() {
+    // Reassign rather than clear() so no array keeps a buffer in a released arena
+    *this = OccurrenceTable(m_resource);
+}
@@ -1,77 +1,48 @@
 #include "OrdinalDetector.h"
-#include <algorithm>
-#include <iostream>
-#include <cctype>
-
-// German ordinal sets (all common declensions)
-const std::unordered_set<std::wstring> OrdinalDetector::s_germanFirstOrdinals = {
-    L"erste", L"ersten", L"erstes", L"erster",   // Nominative, accusative, etc.
-};
-
-const std::unordered_set<std::wstring> OrdinalDetector::s_germanSecondOrdinals = {
-    L"zweite", L"zweiten", L"zweites", L"zweiter",
+#include "Lexicon.h"
+#include "Metrics.h"
+
+namespace {
+using Ordinal = OrdinalDetector::OrdinalType;
+
+// German ordinals (all common declensions), built at compile time
+constexpr Lexicon::Entry<Ordinal> GERMAN_ORDINAL_ENTRIES[] = {
+    {L"erste", Ordinal::FIRST},   {L"ersten", Ordinal::FIRST},
+    {L"erstes", Ordinal::FIRST},  {L"erster", Ordinal::FIRST},
+    {L"zweite", Ordinal::SECOND}, {L"zweiten", Ordinal::SECOND},
+    {L"zweites", Ordinal::SECOND}, {L"zweiter", Ordinal::SECOND},
+    {L"dritte", Ordinal::THIRD},  {L"dritten", Ordinal::THIRD},
+    {L"drittes", Ordinal::THIRD}, {L"dritter", Ordinal::THIRD},
 };
+constexpr Lexicon::StaticTable GERMAN_ORDINALS(GERMAN_ORDINAL_ENTRIES);
 
-const std::unordered_set<std::wstring> OrdinalDetector::s_germanThirdOrdinals = {
-    L"dritte", L"dritten", L"drittes", L"dritter",
+// English ordinals
+constexpr Lexicon::Entry<Ordinal> ENGLISH_ORDINAL_ENTRIES[] = {
+    {L"first", Ordinal::FIRST},
+    {L"second", Ordinal::SECOND},
+    {L"third", Ordinal::THIRD},
 };
-
-// English ordinal sets
-const std::unordered_set<std::wstring> OrdinalDetector::s_englishFirstOrdinals = {
-    L"first"
-};
-
-const std::unordered_set<std::wstring> OrdinalDetector::s_englishSecondOrdinals = {
-    L"second"
-};
-
-const std::unordered_set<std::wstring> OrdinalDetector::s_englishThirdOrdinals = {
-    L"third"
-};
-
-// Helper function to convert string to lowercase for comparison
-static std::wstring toLower(const std::wstring& str) {
-    std::wstring result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](wchar_t c) { return std::tolower(static_cast<unsigned char>(c)); });
-    return result;
+constexpr Lexicon::StaticTable ENGLISH_ORDINALS(ENGLISH_ORDINAL_ENTRIES);
 }
 
-bool OrdinalDetector::isGermanOrdinal(const std::wstring& word, OrdinalType& outType) {
-    std::wstring lowerWord = toLower(word);
+constinit const Lexicon::TableView<OrdinalDetector::OrdinalType> OrdinalDetector::s_germanOrdinals =
+    GERMAN_ORDINALS.view();
+constinit const Lexicon::TableView<OrdinalDetector::OrdinalType> OrdinalDetector::s_englishOrdinals =
+    ENGLISH_ORDINALS.view();
 
-    if (s_germanFirstOrdinals.count(lowerWord) > 0) {
-        outType = OrdinalType::FIRST;
-        return true;
-    }
-    if (s_germanSecondOrdinals.count(lowerWord) > 0) {
-        outType = OrdinalType::SECOND;
-        return true;
-    }
-    if (s_germanThirdOrdinals.count(lowerWord) > 0) {
-        outType = OrdinalType::THIRD;
+bool OrdinalDetector::isGermanOrdinal(std::wstring_view word, OrdinalType& outType) {
+    if (const OrdinalType* type = s_germanOrdinals.find(word)) {
+        outType = *type;
         return true;
     }
-
     return false;
 }
 
-bool OrdinalDetector::isEnglishOrdinal(const std::wstring& word, OrdinalType& outType) {
-    std::wstring lowerWord = toLower(word);
-
-    if (s_englishFirstOrdinals.count(lowerWord) > 0) {
-        outType = OrdinalType::FIRST;
+bool OrdinalDetector::isEnglishOrdinal(std::wstring_view word, OrdinalType& outType) {
+    if (const OrdinalType* type = s_englishOrdinals.find(word)) {
+        outType = *type;
         return true;
     }
-    if (s_englishSecondOrdinals.count(lowerWord) > 0) {
-        outType = OrdinalType::SECOND;
-        return true;
-    }
-    if (s_englishThirdOrdinals.count(lowerWord) > 0) {
-        outType = OrdinalType::THIRD;
-        return true;
-    }
-
     return false;
 }
 
@@ -89,9 +60,9 @@ std::unordered_set<std::wstring> OrdinalDetector::detectOrdinalPatterns(
 
     while (iter.hasNext()) {
         auto match = iter.next();
-        std::wstring word1 = match[1];  // Potential ordinal
-        std::wstring word2 = match[2];  // Potential base word
-        // std::wstring bz = match[3];     // Reference number (not used here)
+        std::wstring_view word1 = match[1];  // Potential ordinal
+        std::wstring_view word2 = match[2];  // Potential base word
+        // std::wstring_view bz = match[3];  // Reference number (not used here)
 
         // Check if word1 is an ordinal (language-specific)
         OrdinalType ordinalType;
@@ -105,7 +76,7 @@ std::unordered_set<std::wstring> OrdinalDetector::detectOrdinalPatterns(
 
         if (isOrdinal) {
             // Create stem vector for word2 (the base word)
-            StemVector word2StemVec = analyzer.createStemVector(word2);
+            StemVector word2StemVec = analyzer.createStemVector(std::wstring(word2));
 
             if (!word2StemVec.empty()) {
                 // Use the base stem (last element of StemVector is the base word)
@@ -115,6 +86,9 @@ std::unordered_set<std::wstring> OrdinalDetector::detectOrdinalPatterns(
         }
     }
 
+    static Metrics::Counter& detectedCounter = Metrics::counter(
+        "bz_ordinal_stems_detected_total", "Base stems auto-enabled for multi-word matching");
+
     // Find stems that have BOTH first AND second ordinals
     std::unordered_set<std::wstring> autoDetected;
 
@@ -124,9 +98,9 @@ std::unordered_set<std::wstring> OrdinalDetector::detectOrdinalPatterns(
 
         if (hasFirst && hasSecond) {
             autoDetected.insert(baseStem);
-            std::wcout << L"[OrdinalDetector] Auto-detected multi-word stem: " << baseStem << std::endl;
         }
     }
+    detectedCounter.add(autoDetected.size());
 
     return autoDetected;
 }
@@ -0,0 +1,239 @@
+#include "PatentXmlReader.h"
+#include "MappedFile.h"
+#include "TextDecoder.h"
+#include "Trace.h"
+#include "XmlReader.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+using SectionKind = PatentXmlReader::SectionKind;
+
+bool sectionKind(std::string_view local, SectionKind& kind) {
+    if (local == "description") {
+        kind = SectionKind::DESCRIPTION;
+    } else if (local == "claims") {
+        kind = SectionKind::CLAIMS;
+    } else if (local == "abstract") {
+        kind = SectionKind::ABSTRACT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Elements whose start and end break the line
+bool isLineElement(std::string_view local) {
+    return local == "p" || local == "heading" || local == "claim-text" || local == "claim" || local == "li" ||
+           local == "row" || local == "tr" || local == "br" || local == "title";
+}
+
+// Table cells; neighbouring cells must not run together
+bool isCellElement(std::string_view local) {
+    return local == "entry" || local == "td" || local == "th";
+}
+
+// Content that is not prose
+bool isIgnoredElement(std::string_view local) {
+    return local == "maths" || local == "math" || local == "chemistry" || local == "img" || local == "doc-page";
+}
+
+bool isXmlSpace(wchar_t c) {
+    return c == L' ' || c == L'\t' || c == L'\n' || c == L'\r';
+}
+
+std::string lowercase(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; });
+    return out;
+}
+
+std::string languageOf(const XmlReader::Attributes& attributes) {
+    const std::string* lang = XmlReader::attribute(attributes, "lang");
+    if (!lang) {
+        lang = XmlReader::attribute(attributes, "xml:lang");
+    }
+    return lang ? lowercase(*lang) : std::string();
+}
+
+class PatentHandler : public XmlReader::Handler {
+public:
+    PatentHandler(PatentXmlReader::Document& document, std::wstring& text)
+        : m_document(document), m_text(text) {}
+
+    void startElement(std::string_view name, const XmlReader::Attributes& attributes) override {
+        ++m_depth;
+        if (m_ignoreDepth > 0) {
+            return;
+        }
+        const std::string_view local = XmlReader::localName(name);
+
+        if (m_sectionDepth == 0) {
+            if (m_depth == 1 && m_document.language.empty()) {
+                m_document.language = languageOf(attributes);
+            }
+            SectionKind kind;
+            if (!sectionKind(local, kind)) {
+                return;
+            }
+            std::string language = languageOf(attributes);
+            if (m_document.language.empty()) {
+                m_document.language = language;
+            }
+            if (!language.empty() && language != m_document.language) {
+                ++m_document.skippedSections;
+                m_ignoreDepth = m_depth;
+                return;
+            }
+            lineBreak();
+            PatentXmlReader::Section& section = m_document.sections.emplace_back();
+            section.kind = kind;
+            section.language = std::move(language);
+            section.begin = m_text.size();
+            m_sectionDepth = m_depth;
+            return;
+        }
+
+        if (isIgnoredElement(local)) {
+            m_ignoreDepth = m_depth;
+        } else if (isLineElement(local)) {
+            lineBreak();
+        } else if (isCellElement(local)) {
+            m_pendingSpace = true;
+        }
+    }
+
+    void endElement(std::string_view name) override {
+        if (m_ignoreDepth > 0) {
+            if (m_depth == m_ignoreDepth) {
+                m_ignoreDepth = 0;
+            }
+        } else if (m_depth == m_sectionDepth) {
+            lineBreak();
+            m_document.sections.back().end = m_text.size();
+            m_sectionDepth = 0;
+        } else if (m_sectionDepth > 0) {
+            const std::string_view local = XmlReader::localName(name);
+            if (isLineElement(local)) {
+                lineBreak();
+            } else if (isCellElement(local)) {
+                m_pendingSpace = true;
+            }
+        }
+        m_depth = std::max(m_depth, 1) - 1;
+    }
+
+    void characters(std::string_view text) override {
+        if (m_sectionDepth == 0 || m_ignoreDepth > 0) {
+            return;
+        }
+        m_decoded.clear();
+        m_decoder.decode(text.data(), text.size(), false, m_decoded);
+        for (wchar_t c : m_decoded) {
+            if (isXmlSpace(c)) {
+                m_pendingSpace = true;
+                continue;
+            }
+            if (m_pendingSpace && !m_text.empty() && m_text.back() != L'\n') {
+                m_text += L' ';
+            }
+            m_pendingSpace = false;
+            m_text += c;
+        }
+    }
+
+    // False if the input ended with elements still open
+    bool complete() const { return m_depth == 0; }
+
+private:
+    void lineBreak() {
+        m_pendingSpace = false;
+        if (!m_text.empty() && m_text.back() != L'\n') {
+            m_text += L'\n';
+        }
+    }
+
+    PatentXmlReader::Document& m_document;
+    std::wstring& m_text;
+    TextDecoder m_decoder{TextDecoder::Encoding::UTF8};
+    std::wstring m_decoded;  // Reused per text run
+    int m_depth = 0;
+    int m_sectionDepth = 0;  // Depth of the open kept section, 0 = none
+    int m_ignoreDepth = 0;   // Depth of the element being skipped, 0 = none
+    bool m_pendingSpace = false;
+};
+
+} // namespace
+
+const PatentXmlReader::Section* PatentXmlReader::Document::sectionAt(size_t position) const {
+    auto it = std::upper_bound(sections.begin(), sections.end(), position,
+                               [](size_t pos, const Section& section) { return pos < section.begin; });
+    if (it == sections.begin()) {
+        return nullptr;
+    }
+    --it;
+    return position < it->end ? &*it : nullptr;
+}
+
+const char* PatentXmlReader::name(SectionKind kind) {
+    switch (kind) {
+    case SectionKind::ABSTRACT:
+        return "abstract";
+    case SectionKind::DESCRIPTION:
+        return "description";
+    case SectionKind::CLAIMS:
+        return "claims";
+    }
+    return "";
+}
+
+bool PatentXmlReader::looksLikeXml(const char* data, size_t size) {
+    size_t pos = size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+    while (pos < size && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n')) {
+        ++pos;
+    }
+    return pos < size && data[pos] == '<';
+}
+
+PatentXmlReader::Document PatentXmlReader::read(const char* data, size_t size, std::wstring& text,
+                                                std::string_view language) {
+    BZ_TRACE_SCOPE("PatentXmlReader::read");
+    text.clear();
+    Document document;
+    document.language = lowercase(language);
+
+    if (size >= 2 && (std::memcmp(data, "\xFF\xFE", 2) == 0 || std::memcmp(data, "\xFE\xFF", 2) == 0)) {
+        throw std::runtime_error("patent XML: UTF-16 is not supported");
+    }
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        data += 3;
+        size -= 3;
+    }
+
+    PatentHandler handler(document, text);
+    XmlReader reader(handler);
+
+    // The declaration comes first; check its encoding before parsing the rest
+    const char* declarationEnd = size > 0 ? static_cast<const char*>(std::memchr(data, '>', size)) : nullptr;
+    const size_t head = declarationEnd ? static_cast<size_t>(declarationEnd - data) + 1 : size;
+    reader.feed(data, head);
+    const std::string encoding = lowercase(reader.declaredEncoding());
+    if (!encoding.empty() && encoding != "utf-8" && encoding != "utf8" && encoding != "us-ascii") {
+        throw std::runtime_error("patent XML: unsupported encoding " + reader.declaredEncoding());
+    }
+    reader.feed(data + head, size - head);
+    reader.finish();
+    if (!handler.complete()) {
+        throw std::runtime_error("patent XML: unexpected end of document");
+    }
+    return document;
+}
+
+PatentXmlReader::Document PatentXmlReader::readFile(const std::string& path, std::wstring& text,
+                                                    std::string_view language) {
+    MappedFile file(path);
+    return read(file.data(), file.size(), text, language);
+}
@@ -0,0 +1,227 @@
+#include "PerfGate.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double median(std::vector<double> values) {
+    const auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+// Minimal reader for the baseline format: objects, strings and numbers
+class JsonReader {
+public:
+    explicit JsonReader(std::istream& in) : m_text(std::istreambuf_iterator<char>(in), {}) {}
+
+    void expect(char c) {
+        skipSpace();
+        if (m_pos >= m_text.size() || m_text[m_pos] != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++m_pos;
+    }
+
+    // Consumes c if it is the next non-space character
+    bool accept(char c) {
+        skipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    std::string string() {
+        expect('"');
+        std::string value;
+        while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+            if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size()) {
+                ++m_pos;
+            }
+            value += m_text[m_pos++];
+        }
+        expect('"');
+        return value;
+    }
+
+    double number() {
+        skipSpace();
+        size_t consumed = 0;
+        double value = 0;
+        try {
+            value = std::stod(m_text.substr(m_pos, 32), &consumed);
+        } catch (const std::logic_error&) {
+            fail("expected a number");
+        }
+        m_pos += consumed;
+        return value;
+    }
+
+    // Calls member(key) for each key of an object; member must consume the value
+    template <typename Member>
+    void object(Member&& member) {
+        expect('{');
+        if (accept('}')) {
+            return;
+        }
+        do {
+            const std::string key = string();
+            expect(':');
+            member(key);
+        } while (accept(','));
+        expect('}');
+    }
+
+    void end() {
+        skipSpace();
+        if (m_pos != m_text.size()) {
+            fail("trailing characters");
+        }
+    }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("baseline: " + what + " at offset " + std::to_string(m_pos));
+    }
+
+private:
+    void skipSpace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            ++m_pos;
+        }
+    }
+
+    std::string m_text;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+std::vector<PerfGate::Measurement> PerfGate::measure(const std::vector<Workload>& workloads,
+                                                     const Workload& reference, int repetitions) {
+    auto timed = [](const Workload& w) {
+        if (w.setup) {
+            w.setup();
+        }
+        const auto start = Clock::now();
+        w.run();
+        return secondsSince(start);
+    };
+
+    // Round-robin, so a slow spell costs every workload one repetition at most
+    std::vector<std::vector<double>> times(workloads.size());
+    std::vector<double> referenceTimes;
+    for (int i = 0; i < std::max(repetitions, 1); ++i) {
+        for (size_t w = 0; w < workloads.size(); ++w) {
+            referenceTimes.push_back(timed(reference));
+            times[w].push_back(timed(workloads[w]));
+        }
+    }
+
+    std::vector<Measurement> measurements;
+    if (workloads.empty()) {
+        return measurements;
+    }
+    const double referenceSeconds = median(referenceTimes);
+    for (size_t w = 0; w < workloads.size(); ++w) {
+        Measurement& measurement = measurements.emplace_back();
+        measurement.name = workloads[w].name;
+        measurement.seconds = median(times[w]);
+        measurement.referenceSeconds = referenceSeconds;
+        measurement.normalized = measurement.seconds / referenceSeconds;
+    }
+    return measurements;
+}
+
+PerfGate::Verdict PerfGate::judge(const Measurement& measurement, const std::optional<BaselineEntry>& baseline) {
+    Verdict verdict;
+    verdict.name = measurement.name;
+    verdict.baseline = baseline;
+    verdict.normalized = measurement.normalized;
+    if (baseline && measurement.normalized > 0) {
+        verdict.throughputRatio = baseline->normalized / measurement.normalized;
+        verdict.regressed = verdict.throughputRatio < 1.0 - baseline->tolerance;
+    }
+    return verdict;
+}
+
+PerfGate::Baseline PerfGate::loadBaseline(std::istream& in) {
+    JsonReader reader(in);
+    Baseline baseline;
+    bool sawVersion = false;
+    reader.object([&](const std::string& key) {
+        if (key == "version") {
+            const double version = reader.number();
+            if (version == 1) {
+                reader.fail("version 1 was normalized by the old calibration loop; re-record with --update");
+            }
+            if (version != BASELINE_VERSION) {
+                reader.fail("unsupported version");
+            }
+            sawVersion = true;
+        } else if (key == "workloads") {
+            reader.object([&](const std::string& name) {
+                BaselineEntry entry;
+                reader.object([&](const std::string& field) {
+                    if (field == "normalized") {
+                        entry.normalized = reader.number();
+                    } else if (field == "tolerance") {
+                        entry.tolerance = reader.number();
+                    } else {
+                        reader.fail("unknown field " + field);
+                    }
+                });
+                baseline[name] = entry;
+            });
+        } else {
+            reader.fail("unknown key " + key);
+        }
+    });
+    reader.end();
+    if (!sawVersion) {
+        reader.fail("missing version");
+    }
+    return baseline;
+}
+
+void PerfGate::saveBaseline(std::ostream& out, const Baseline& baseline) {
+    out << "{\n  \"version\": " << BASELINE_VERSION << ",\n  \"workloads\": {";
+    const char* separator = "\n";
+    for (const auto& [name, entry] : baseline) {
+        std::ostringstream line;
+        line << std::setprecision(6) << "    \"" << name << "\": {\"normalized\": " << entry.normalized
+             << ", \"tolerance\": " << entry.tolerance << "}";
+        out << separator << line.str();
+        separator = ",\n";
+    }
+    out << "\n  }\n}\n";
+}
+
+PerfGate::Baseline PerfGate::updated(const Baseline& baseline, const std::vector<Workload>& workloads,
+                                     const std::vector<Measurement>& measurements) {
+    Baseline result = baseline;
+    for (const Measurement& measurement : measurements) {
+        auto [it, inserted] = result.try_emplace(measurement.name);
+        if (inserted) {
+            auto workload = std::find_if(workloads.begin(), workloads.end(),
+                                         [&](const Workload& w) { return w.name == measurement.name; });
+            if (workload != workloads.end()) {
+                it->second.tolerance = workload->tolerance;
+            }
+        }
+        it->second.normalized = measurement.normalized;
+    }
+    return result;
+}
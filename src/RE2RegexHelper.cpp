@@ -1,21 +1,37 @@
 #include "RE2RegexHelper.h"
 #include <codecvt>
+#include <cstdint>
 #include <locale>
+#include <stdexcept>
+#include <string>
 
 // Thread-local cached converter to avoid repeated allocation
 static thread_local std::wstring_convert<std::codecvt_utf8<wchar_t>> t_converter;
 
+// wstring_convert sizes its result for the worst case (several times the
+// output on large documents), so give the slack back before returning
 std::string RE2RegexHelper::wstringToUtf8(const std::wstring& wstr) {
-    return t_converter.to_bytes(wstr);
+    std::string result = t_converter.to_bytes(wstr);
+    result.shrink_to_fit();
+    return result;
 }
 
 std::wstring RE2RegexHelper::utf8ToWstring(const std::string& str) {
-    return t_converter.from_bytes(str);
+    std::wstring result = t_converter.from_bytes(str);
+    result.shrink_to_fit();
+    return result;
 }
 
-RE2RegexHelper::MatchIterator::MatchIterator(const std::wstring& text, const RE2& pattern)
-    : m_pattern(pattern), m_currentPos(0), m_hasMore(true) {
-    m_utf8Text = wstringToUtf8(text);
+RE2RegexHelper::MatchIterator::MatchIterator(std::wstring_view text, const RE2& pattern)
+    : m_text(text), m_pattern(pattern), m_currentPos(0), m_hasMore(true) {
+    // MatchResult has room for MAX_GROUPS; further groups would be dropped silently
+    if (static_cast<size_t>(m_pattern.NumberOfCapturingGroups()) + 1 > MAX_GROUPS) {
+        throw std::invalid_argument("pattern has " + std::to_string(m_pattern.NumberOfCapturingGroups()) +
+                                    " capture groups, at most " + std::to_string(MAX_GROUPS - 1) +
+                                    " are supported");
+    }
+    m_utf8Text = t_converter.to_bytes(text.data(), text.data() + text.size());
+    m_utf8Text.shrink_to_fit();
     buildPositionMap(text);
 
     // Check if there's at least one match
@@ -25,7 +41,22 @@ RE2RegexHelper::MatchIterator::MatchIterator(const std::wstring& text, const RE2
     }
 }
 
-void RE2RegexHelper::MatchIterator::buildPositionMap(const std::wstring& text) {
+size_t RE2RegexHelper::MatchIterator::estimateUtf8Bytes(const std::wstring& text) {
+    // Byte counts of codecvt_utf8 per code unit
+    size_t bytes = 0;
+    for (const wchar_t c : text) {
+        const auto code = static_cast<uint32_t>(c);
+        bytes += code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+    }
+    return bytes;
+}
+
+size_t RE2RegexHelper::MatchIterator::estimatePositionMapBytes(const std::wstring& text) {
+    // One entry per UTF-8 byte plus the end position, as reserved by buildPositionMap
+    return (estimateUtf8Bytes(text) + 1) * sizeof(size_t);
+}
+
+void RE2RegexHelper::MatchIterator::buildPositionMap(std::wstring_view text) {
     // Build a map from UTF-8 byte position to wchar position
     // IMPORTANT: Must use actual UTF-8 conversion, not theoretical calculation
     m_wcharPositions.clear();
@@ -64,9 +95,9 @@ RE2RegexHelper::MatchResult RE2RegexHelper::MatchIterator::next() {
         return MatchResult();
     }
 
-    // Prepare capture groups (full match + numbered groups)
-    int numGroups = m_pattern.NumberOfCapturingGroups() + 1;
-    std::vector<re2::StringPiece> groups(numGroups);
+    // Prepare capture groups (full match + numbered groups; the constructor checked the count)
+    const int numGroups = m_pattern.NumberOfCapturingGroups() + 1;
+    re2::StringPiece groups[MAX_GROUPS];
 
     re2::StringPiece input(m_utf8Text);
     bool found = m_pattern.Match(
@@ -74,7 +105,7 @@ RE2RegexHelper::MatchResult RE2RegexHelper::MatchIterator::next() {
         m_currentPos,
         m_utf8Text.size(),
         RE2::UNANCHORED,
-        groups.data(),
+        groups,
         numGroups
     );
 
@@ -91,18 +122,14 @@ RE2RegexHelper::MatchResult RE2RegexHelper::MatchIterator::next() {
     result.position = utf8PosToWcharPos(matchStartUtf8);
     result.length = utf8PosToWcharPos(matchEndUtf8) - result.position;
 
-    // Convert captured groups to wstring
-    // Optimization: reserve capacity and convert directly from StringPiece
-    result.groups.reserve(numGroups);
+    // Map captured groups back onto the original text (no conversion needed)
+    result.groupCount = numGroups;
     for (int i = 0; i < numGroups; ++i) {
-        if (!groups[i].empty()) {
-            // Direct conversion from StringPiece to avoid temporary std::string
-            result.groups.push_back(t_converter.from_bytes(
-                groups[i].data(), 
-                groups[i].data() + groups[i].size()
-            ));
-        } else {
-            result.groups.emplace_back();  // Use emplace_back for empty strings
+        if (groups[i].data() != nullptr) {
+            size_t startUtf8 = groups[i].data() - m_utf8Text.data();
+            size_t start = utf8PosToWcharPos(startUtf8);
+            size_t end = utf8PosToWcharPos(startUtf8 + groups[i].size());
+            result.groups[i] = m_text.substr(start, end - start);
         }
     }
 
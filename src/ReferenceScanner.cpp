@@ -0,0 +1,476 @@
+#include "ReferenceScanner.h"
+#include "RegexPatterns.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+enum class Ordinal { FIRST, SECOND, THIRD };
+
+const std::map<std::wstring, Ordinal>& ordinalWords(bool useGerman) {
+    static const std::map<std::wstring, Ordinal> german = {
+        {L"erste", Ordinal::FIRST},   {L"ersten", Ordinal::FIRST},   {L"erstes", Ordinal::FIRST},
+        {L"erster", Ordinal::FIRST},  {L"zweite", Ordinal::SECOND},  {L"zweiten", Ordinal::SECOND},
+        {L"zweites", Ordinal::SECOND}, {L"zweiter", Ordinal::SECOND}, {L"dritte", Ordinal::THIRD},
+        {L"dritten", Ordinal::THIRD}, {L"drittes", Ordinal::THIRD},  {L"dritter", Ordinal::THIRD},
+    };
+    static const std::map<std::wstring, Ordinal> english = {
+        {L"first", Ordinal::FIRST},
+        {L"second", Ordinal::SECOND},
+        {L"third", Ordinal::THIRD},
+    };
+    return useGerman ? german : english;
+}
+
+const std::set<std::wstring>& definiteArticles(bool useGerman) {
+    static const std::set<std::wstring> german = {L"der", L"die", L"das", L"den", L"dem", L"des"};
+    static const std::set<std::wstring> english = {L"the"};
+    return useGerman ? german : english;
+}
+
+const std::set<std::wstring>& indefiniteArticles(bool useGerman) {
+    static const std::set<std::wstring> german = {L"ein", L"eine", L"eines", L"einen", L"einer", L"einem"};
+    static const std::set<std::wstring> english = {L"a", L"an"};
+    return useGerman ? german : english;
+}
+
+// Articles, figure references and conjunctions
+const std::set<std::wstring>& builtInIgnoredWords(bool useGerman) {
+    static const std::set<std::wstring> german = {
+        L"der", L"die", L"das", L"den", L"dem", L"des", L"ein", L"eine", L"eines", L"einen",
+        L"einer", L"einem", L"figur", L"figuren", L"und", L"oder", L"mit",
+    };
+    static const std::set<std::wstring> english = {
+        L"the", L"a", L"an", L"figure", L"figures", L"and", L"or", L"with",
+    };
+    return useGerman ? german : english;
+}
+
+// Latin Extended-A runs where every other code point, starting at first, is
+// an uppercase letter directly followed by its lowercase
+struct CasePairRun {
+    wchar_t first;
+    wchar_t last;
+};
+
+constexpr CasePairRun CASE_PAIR_RUNS[] = {
+    {0x0100, 0x012E},  // Ā ā .. Į į
+    {0x0132, 0x0136},  // Ĳ ĳ .. Ķ ķ
+    {0x0139, 0x0147},  // Ĺ ĺ .. Ň ň
+    {0x014A, 0x0176},  // Ŋ ŋ .. Ŷ ŷ
+    {0x0179, 0x017D},  // Ź ź .. Ž ž
+};
+
+// Lowercase of the uppercase letters in U+0000..U+017F; everything else is kept
+wchar_t lowercaseChar(wchar_t c) {
+    if ((c >= L'A' && c <= L'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7)) {
+        return static_cast<wchar_t>(c + 0x20);
+    }
+    if (c == 0x130) {
+        return L'i';
+    }
+    if (c == 0x178) {
+        return 0xFF;
+    }
+    for (const CasePairRun& run : CASE_PAIR_RUNS) {
+        if (c >= run.first && c <= run.last && (c - run.first) % 2 == 0) {
+            return static_cast<wchar_t>(c + 1);
+        }
+    }
+    return c;
+}
+
+std::wstring lowercase(std::wstring word) {
+    for (wchar_t& c : word) {
+        c = lowercaseChar(c);
+    }
+    return word;
+}
+
+// RE2's \d and \s
+bool isDigit(wchar_t c) {
+    return c >= L'0' && c <= L'9';
+}
+
+bool isSpace(wchar_t c) {
+    return c == L'\t' || c == L'\n' || c == 0x0C || c == L'\r' || c == L' ';
+}
+
+// UTF-8 as std::codecvt_utf8<wchar_t> writes it: one sequence per wchar_t
+// (surrogate halves included), std::range_error above U+10FFFF
+void appendUtf8(std::string& out, wchar_t ch) {
+    const auto code = static_cast<uint32_t>(ch);
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code <= 0x10FFFF) {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        throw std::range_error("character outside the Unicode range");
+    }
+}
+
+void addError(std::vector<ScanSnapshot::ErrorRange>& category, ScanSnapshot& snapshot, size_t start, size_t end) {
+    category.emplace_back(static_cast<int>(start), static_cast<int>(end));
+    snapshot.allErrors.emplace_back(static_cast<int>(start), static_cast<int>(end));
+}
+
+// Every category is reported as a set of ranges, like ErrorIndex::build leaves it
+void sortUnique(std::vector<ScanSnapshot::ErrorRange>& errors) {
+    std::sort(errors.begin(), errors.end());
+    errors.erase(std::unique(errors.begin(), errors.end()), errors.end());
+}
+
+} // namespace
+
+ReferenceScanner::ReferenceScanner(bool useGerman)
+    : m_useGerman(useGerman),
+      m_letterRegex("\\p{L}"),
+      m_singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN),
+      m_twoWordRegex(RegexPatterns::TWO_WORD_PATTERN),
+      m_wordRegex(RegexPatterns::WORD_PATTERN) {}
+
+std::wstring ReferenceScanner::stem(const std::wstring& word) {
+    std::wstring result = lowercase(word);
+    if (result.empty()) {
+        return result;
+    }
+    if (m_useGerman) {
+        m_germanStemmer(result);
+    } else {
+        m_englishStemmer(result);
+    }
+    return result;
+}
+
+bool ReferenceScanner::isIgnoredWord(const std::wstring& word) const {
+    if (word.size() < 3) {
+        return true;
+    }
+    const std::wstring lower = lowercase(word);
+    return builtInIgnoredWords(m_useGerman).count(lower) > 0 || m_ignoredWords.count(lower) > 0;
+}
+
+bool ReferenceScanner::isDefiniteArticle(const std::wstring& word) const {
+    return definiteArticles(m_useGerman).count(lowercase(word)) > 0;
+}
+
+bool ReferenceScanner::isIndefiniteArticle(const std::wstring& word) const {
+    return indefiniteArticles(m_useGerman).count(lowercase(word)) > 0;
+}
+
+// \p{L} as RE2 matches it; surrogate halves and values outside Unicode are no letters
+bool ReferenceScanner::isLetter(wchar_t c) {
+    auto known = m_letters.find(c);
+    if (known != m_letters.end()) {
+        return known->second;
+    }
+    const auto code = static_cast<uint32_t>(c);
+    bool letter = false;
+    if (code <= 0x10FFFF && (code < 0xD800 || code > 0xDFFF)) {
+        std::string utf8;
+        appendUtf8(utf8, c);
+        letter = RE2::FullMatch(utf8, m_letterRegex);
+    }
+    m_letters[c] = letter;
+    return letter;
+}
+
+// A range cleared in the text stays cleared wherever the same text has the
+// same 24 characters (ClearedAnchors::CONTEXT_CHARS) before and after it
+std::set<std::pair<size_t, size_t>> ReferenceScanner::clearedRanges(
+    const std::wstring& text, const std::set<std::pair<size_t, size_t>>& given) {
+    constexpr size_t CONTEXT = 24;
+    std::set<std::pair<size_t, size_t>> result;
+    for (const auto& [start, end] : given) {
+        if (start >= end || end > text.size()) {
+            continue;
+        }
+        const size_t length = end - start;
+        const std::wstring cleared = text.substr(start, length);
+        const std::wstring before = text.substr(start - std::min(start, CONTEXT), std::min(start, CONTEXT));
+        const std::wstring after = text.substr(end, CONTEXT);
+        for (size_t at = 0; at + length <= text.size(); ++at) {
+            if (text.compare(at, length, cleared) == 0 &&
+                text.compare(at - std::min(at, CONTEXT), std::min(at, CONTEXT), before) == 0 &&
+                text.compare(at + length, CONTEXT, after) == 0) {
+                result.emplace(at, at + length);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<ReferenceScanner::Match> ReferenceScanner::findAll(const std::wstring& text, const re2::RE2& pattern) {
+    // UTF-8 copy plus the character index of every byte (and of the end)
+    std::string utf8;
+    std::vector<size_t> charIndex;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const size_t before = utf8.size();
+        appendUtf8(utf8, text[i]);
+        charIndex.insert(charIndex.end(), utf8.size() - before, i);
+    }
+    charIndex.push_back(text.size());
+
+    const int groupCount = pattern.NumberOfCapturingGroups() + 1;
+    std::vector<re2::StringPiece> groups(groupCount);
+    std::vector<Match> matches;
+    size_t offset = 0;
+    while (offset <= utf8.size() &&
+           pattern.Match(utf8, offset, utf8.size(), RE2::UNANCHORED, groups.data(), groupCount)) {
+        Match match;
+        for (const re2::StringPiece& group : groups) {
+            if (group.data() == nullptr) {
+                match.groups.emplace_back();
+                continue;
+            }
+            const size_t begin = charIndex[group.data() - utf8.data()];
+            const size_t end = charIndex[group.data() - utf8.data() + group.size()];
+            match.groups.push_back(text.substr(begin, end - begin));
+        }
+        const size_t matchStart = groups[0].data() - utf8.data();
+        offset = matchStart + groups[0].size();
+        match.position = charIndex[matchStart];
+        match.length = charIndex[offset] - match.position;
+        matches.push_back(std::move(match));
+    }
+    return matches;
+}
+
+ScanSnapshot ReferenceScanner::run(const std::wstring& text, const ScanDecisions& decisions) {
+    m_bzToStems.clear();
+    m_stemToBz.clear();
+    m_bzToOriginalWords.clear();
+    m_occurrences.clear();
+    m_ignoredWords.clear();
+    for (const std::wstring& word : decisions.ignoredWords) {
+        m_ignoredWords.insert(lowercase(word));
+    }
+    m_cleared = clearedRanges(text, decisions.clearedRanges);
+
+    ScanSnapshot snapshot;
+    snapshot.multiWordBaseStems = detectOrdinalStems(text);
+    scanTerms(text, decisions.paragraphStarts, snapshot.multiWordBaseStems);
+
+    snapshot.bzToStems = m_bzToStems;
+    snapshot.bzToOriginalWords = m_bzToOriginalWords;
+    for (const Occurrence& occurrence : m_occurrences) {
+        snapshot.bzPositions[occurrence.bz].emplace_back(occurrence.start, occurrence.length);
+    }
+
+    detectConflicts(decisions.clearedBz, snapshot);
+    detectUnnumberedWords(text, snapshot.multiWordBaseStems, snapshot);
+    detectArticleErrors(text, snapshot);
+
+    sortUnique(snapshot.allErrors);
+    sortUnique(snapshot.noNumberErrors);
+    sortUnique(snapshot.wrongTermBzErrors);
+    sortUnique(snapshot.wrongArticleErrors);
+    return snapshot;
+}
+
+bool ReferenceScanner::isMultiWordBase(const std::wstring& word, const std::set<std::wstring>& multiWordStems) {
+    return multiWordStems.count(stem(word)) > 0;
+}
+
+// A base stem becomes multi-word when it appears after both a "first" and a "second" ordinal
+std::set<std::wstring> ReferenceScanner::detectOrdinalStems(const std::wstring& text) {
+    const std::map<std::wstring, Ordinal>& ordinals = ordinalWords(m_useGerman);
+    std::map<std::wstring, std::set<Ordinal>> ordinalsByStem;
+
+    for (const Match& match : findAll(text, m_twoWordRegex)) {
+        auto ordinal = ordinals.find(lowercase(match.groups[1]));
+        if (ordinal == ordinals.end()) {
+            continue;
+        }
+        ordinalsByStem[stem(match.groups[2])].insert(ordinal->second);
+    }
+
+    std::set<std::wstring> result;
+    for (const auto& [stem, used] : ordinalsByStem) {
+        if (used.count(Ordinal::FIRST) && used.count(Ordinal::SECOND)) {
+            result.insert(stem);
+        }
+    }
+    return result;
+}
+
+// Per paragraph: two-word terms first, then single words that do not overlap an earlier term
+void ReferenceScanner::scanTerms(const std::wstring& text, const std::vector<uint32_t>& paragraphStarts,
+                                 const std::set<std::wstring>& multiWordStems) {
+    std::vector<std::pair<size_t, size_t>> taken;
+    auto overlapsTaken = [&taken](size_t start, size_t end) {
+        for (const auto& [takenStart, takenEnd] : taken) {
+            if (start < takenEnd && end > takenStart) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto record = [this](const std::wstring& bz, const StemVector& stem, const std::wstring& original,
+                         size_t start, size_t length) {
+        m_bzToStems[bz].insert(stem);
+        m_stemToBz[stem].insert(bz);
+        m_bzToOriginalWords[bz].insert(original);
+        m_occurrences.push_back({start, length, bz, stem});
+    };
+
+    // Paragraph i runs from its start to the next one; the first one from the beginning of the text
+    std::vector<std::pair<size_t, size_t>> paragraphs;
+    if (paragraphStarts.empty()) {
+        paragraphs.emplace_back(0, text.size());
+    }
+    for (size_t i = 0; i < paragraphStarts.size(); ++i) {
+        const size_t start = i == 0 ? 0 : std::min<size_t>(paragraphStarts[i], text.size());
+        const size_t end = i + 1 < paragraphStarts.size() ? std::min<size_t>(paragraphStarts[i + 1], text.size())
+                                                          : text.size();
+        if (start < end) {
+            paragraphs.emplace_back(start, end);
+        }
+    }
+
+    for (const auto& [offset, end] : paragraphs) {
+        const std::wstring paragraph = text.substr(offset, end - offset);
+        taken.clear();
+
+        for (const Match& match : findAll(paragraph, m_twoWordRegex)) {
+            const size_t start = offset + match.position;
+            const std::wstring& word1 = match.groups[1];
+            const std::wstring& word2 = match.groups[2];
+            if (!isMultiWordBase(word2, multiWordStems) || overlapsTaken(start, start + match.length) ||
+                isCleared(start, start + match.length)) {
+                continue;
+            }
+            taken.emplace_back(start, start + match.length);
+            record(match.groups[3], stemVector(word1, word2), word1 + L" " + word2, start, match.length);
+        }
+
+        for (const Match& match : findAll(paragraph, m_singleWordRegex)) {
+            const size_t start = offset + match.position;
+            const std::wstring& word = match.groups[1];
+            if (isIgnoredWord(word) || overlapsTaken(start, start + match.length) ||
+                isCleared(start, start + match.length)) {
+                continue;
+            }
+            taken.emplace_back(start, start + match.length);
+            record(match.groups[2], stemVector(word), word, start, match.length);
+        }
+    }
+
+    std::sort(m_occurrences.begin(), m_occurrences.end(),
+              [](const Occurrence& a, const Occurrence& b) { return a.start < b.start; });
+}
+
+// A BZ conflicts if it names several terms, or if its only term also has another BZ;
+// the user can clear that per BZ
+void ReferenceScanner::detectConflicts(const std::set<std::wstring>& clearedBz, ScanSnapshot& snapshot) const {
+    auto highlight = [&](const Occurrence& occurrence) {
+        if (!isCleared(occurrence.start, occurrence.start + occurrence.length)) {
+            addError(snapshot.wrongTermBzErrors, snapshot, occurrence.start, occurrence.start + occurrence.length);
+        }
+    };
+
+    for (const auto& [bz, stems] : m_bzToStems) {
+        if (clearedBz.count(bz)) {
+            continue;
+        }
+        if (stems.size() > 1) {
+            for (const Occurrence& occurrence : m_occurrences) {
+                if (occurrence.bz == bz) {
+                    highlight(occurrence);
+                }
+            }
+            snapshot.conflictingBz.push_back(bz);
+            continue;
+        }
+
+        const StemVector& stem = *stems.begin();
+        if (m_stemToBz.at(stem).size() > 1) {
+            for (const Occurrence& occurrence : m_occurrences) {
+                if (occurrence.stem == stem) {
+                    highlight(occurrence);
+                }
+            }
+            snapshot.conflictingBz.push_back(bz);
+        }
+    }
+}
+
+// Known terms (single or multi-word) written without a number
+void ReferenceScanner::detectUnnumberedWords(const std::wstring& text,
+                                             const std::set<std::wstring>& multiWordStems,
+                                             ScanSnapshot& snapshot) {
+    std::set<size_t> occurrenceStarts;
+    for (const Occurrence& occurrence : m_occurrences) {
+        occurrenceStarts.insert(occurrence.start);
+    }
+    auto followedByNumber = [&text](size_t pos) {
+        while (pos < text.size() && isSpace(text[pos])) {
+            ++pos;
+        }
+        return pos < text.size() && isDigit(text[pos]);
+    };
+
+    std::vector<Match> words;
+    for (Match& match : findAll(text, m_wordRegex)) {
+        if (!occurrenceStarts.count(match.position) && !followedByNumber(match.position + match.length)) {
+            words.push_back(std::move(match));
+        }
+    }
+
+    // Adjacent pairs (at most 10 characters apart) forming a known multi-word term
+    for (size_t i = 0; i + 1 < words.size(); ++i) {
+        const Match& first = words[i];
+        const Match& second = words[i + 1];
+        if (second.position - (first.position + first.length) > 10 ||
+            !isMultiWordBase(second.groups[0], multiWordStems)) {
+            continue;
+        }
+        if (m_stemToBz.count(stemVector(first.groups[0], second.groups[0])) &&
+            !isCleared(first.position, second.position + second.length)) {
+            addError(snapshot.noNumberErrors, snapshot, first.position, second.position + second.length);
+        }
+    }
+
+    for (const Match& word : words) {
+        if (m_stemToBz.count(stemVector(word.groups[0])) && !isCleared(word.position, word.position + word.length)) {
+            addError(snapshot.noNumberErrors, snapshot, word.position, word.position + word.length);
+        }
+    }
+}
+
+// First mention must not use a definite article, later mentions not an indefinite one
+void ReferenceScanner::detectArticleErrors(const std::wstring& text, ScanSnapshot& snapshot) {
+    std::set<StemVector, StemVectorComparator> seen;
+    for (const Occurrence& occurrence : m_occurrences) {
+        const bool first = seen.insert(occurrence.stem).second;
+
+        // The word right before the term, skipping whitespace
+        size_t end = occurrence.start;
+        while (end > 0 && isSpace(text[end - 1])) {
+            --end;
+        }
+        size_t start = end;
+        while (start > 0 && isLetter(text[start - 1])) {
+            --start;
+        }
+        if (start == end) {
+            continue;
+        }
+
+        const std::wstring article = text.substr(start, end - start);
+        if ((first ? isDefiniteArticle(article) : isIndefiniteArticle(article)) && !isCleared(start, end)) {
+            addError(snapshot.wrongArticleErrors, snapshot, start, end);
+        }
+    }
+}
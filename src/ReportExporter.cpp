@@ -0,0 +1,497 @@
+#include "ReportExporter.h"
+#include "JsonEscape.h"
+#include "ScanPipeline.h"
+#include "Trace.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <ostream>
+#include <vector>
+
+namespace {
+
+constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+// Appends to a buffer that goes to the stream whenever it passes FLUSH_BYTES
+class Writer {
+public:
+    explicit Writer(std::ostream& out) : m_out(out) { m_buffer.reserve(FLUSH_BYTES + 256); }
+    ~Writer() { flush(); }
+
+    void raw(std::string_view s) {
+        m_buffer.append(s);
+        flushIfFull();
+    }
+
+    void number(size_t value) {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        raw(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+
+    // Escaped JSON string content, without the quotes
+    void jsonChars(std::wstring_view s) {
+        JsonEscape::append(m_buffer, s);
+        flushIfFull();
+    }
+
+    void jsonString(std::wstring_view s) {
+        m_buffer += '"';
+        jsonChars(s);
+        m_buffer += '"';
+    }
+
+    // UTF-8 input, copied byte for byte apart from escapes
+    void jsonString(std::string_view utf8) {
+        m_buffer += '"';
+        JsonEscape::append(m_buffer, utf8);
+        m_buffer += '"';
+        flushIfFull();
+    }
+
+    // RFC 4180: quoted only when needed, inner quotes doubled
+    void csvField(std::wstring_view s) {
+        const bool quote = s.find_first_of(L",\"\r\n") != std::wstring_view::npos;
+        if (quote) {
+            m_buffer += '"';
+        }
+        JsonEscape::forEachCodePoint(s, [this](char32_t c) {
+            if (c == U'"') {
+                m_buffer += '"';
+            }
+            JsonEscape::appendUtf8(m_buffer, c);
+        });
+        if (quote) {
+            m_buffer += '"';
+        }
+        flushIfFull();
+    }
+
+    void flush() {
+        m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+private:
+    void flushIfFull() {
+        if (m_buffer.size() >= FLUSH_BYTES) {
+            flush();
+        }
+    }
+
+    std::ostream& m_out;
+    std::string m_buffer;
+};
+
+// 1-based line and column of a text position
+class LineIndex {
+public:
+    explicit LineIndex(const std::wstring& text) {
+        m_starts.push_back(0);
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == L'\n') {
+                m_starts.push_back(i + 1);
+            }
+        }
+    }
+
+    std::pair<size_t, size_t> lineColumn(size_t position) const {
+        const auto it = std::upper_bound(m_starts.begin(), m_starts.end(), position) - 1;
+        return {static_cast<size_t>(it - m_starts.begin()) + 1, position - *it + 1};
+    }
+
+private:
+    std::vector<size_t> m_starts;
+};
+
+struct Rule {
+    const char* id;     // SARIF rule ID
+    const char* key;    // JSON/CSV error kind and summary key
+    const char* level;  // SARIF result level
+    const char* description;
+};
+
+constexpr Rule RULES[] = {
+    {"missing-number", "missing_number", "warning", "Term used without a reference number"},
+    {"wrong-term", "wrong_term", "error", "Reference number used for more than one term"},
+    {"wrong-article", "wrong_article", "warning",
+     "Definite article at the first mention or indefinite article after it"},
+};
+
+struct ErrorList {
+    size_t rule;  // Index into RULES
+    const ErrorPositions& positions;
+};
+
+std::wstring_view span(const std::wstring& text, size_t start, size_t end) {
+    start = std::min(start, text.size());
+    return std::wstring_view(text).substr(start, std::min(end, text.size()) - start);
+}
+
+// Display form of a stem, as in the term list: its first occurrence without the number
+std::wstring termOf(const ReferenceDatabase& db, const std::wstring& text, uint32_t stemId) {
+    const OccurrenceTable& occurrences = db.occurrences;
+    auto it = db.stemToFirstWord.find(occurrences.stem(stemId));
+    if (it != db.stemToFirstWord.end()) {
+        return it->second;
+    }
+    return occurrences.firstSpelling(stemId, text);
+}
+
+// Reference number of the occurrence starting at start, "" if none
+std::wstring_view bzAt(const OccurrenceTable& occurrences, size_t start) {
+    const auto& starts = occurrences.starts();
+    const auto it = std::lower_bound(starts.begin(), starts.end(), start);
+    if (it == starts.end() || *it != start) {
+        return {};
+    }
+    return occurrences.bzName(occurrences.bzId(static_cast<size_t>(it - starts.begin())));
+}
+
+// Same rule as the BZ list's warning icon: several terms, or a term shared
+// with another BZ, and not cleared
+bool isConflicting(const AnalysisContext& context, const std::wstring& bz) {
+    return context.conflicts.bzFlagged(context.db.occurrences.findBz(bz));
+}
+
+size_t countConflicting(const AnalysisContext& context) {
+    size_t count = 0;
+    for (const auto& entry : context.db.bzToStems) {
+        count += isConflicting(context, entry.first) ? 1 : 0;
+    }
+    return count;
+}
+
+// Stem IDs of a BZ's occurrences in order of first appearance
+void stemsInOrder(const OccurrenceTable& occurrences, const PositionRange& positions, std::vector<uint32_t>& out) {
+    out.clear();
+    for (auto it = positions.begin(); it != positions.end(); ++it) {
+        const uint32_t stemId = occurrences.stemId(it.occurrence());
+        if (std::find(out.begin(), out.end(), stemId) == out.end()) {
+            out.push_back(stemId);
+        }
+    }
+}
+
+void writeJson(Writer& w, const ReportExporter::Report& report, const ErrorList (&errors)[3]) {
+    const ReferenceDatabase& db = report.context.db;
+    const OccurrenceTable& occurrences = db.occurrences;
+    const LineIndex lines(report.text);
+
+    w.raw("{\n  \"format\": \"bz-report\",\n  \"version\": 1,\n  \"source\": ");
+    w.jsonString(std::string_view(report.source));
+    w.raw(",\n  \"language\": ");
+    w.jsonString(std::string_view(report.language));
+    w.raw(",\n  \"summary\": {\"characters\": ");
+    w.number(report.text.size());
+    w.raw(", \"reference_numbers\": ");
+    w.number(db.bzToStems.size());
+    w.raw(", \"conflicting\": ");
+    w.number(countConflicting(report.context));
+    for (const ErrorList& list : errors) {
+        w.raw(", \"");
+        w.raw(RULES[list.rule].key);
+        w.raw("\": ");
+        w.number(list.positions.size());
+    }
+    w.raw(", \"all_errors\": ");
+    w.number(report.allErrors.size());
+    w.raw("},\n  \"references\": [");
+
+    std::vector<uint32_t> stemIds;
+    std::vector<const std::wstring*> words;
+    bool first = true;
+    for (const auto& [bz, stems] : db.bzToStems) {
+        w.raw(first ? "\n    {\"bz\": " : ",\n    {\"bz\": ");
+        first = false;
+        w.jsonString(bz);
+        w.raw(", \"conflict\": ");
+        w.raw(isConflicting(report.context, bz) ? "true" : "false");
+        w.raw(", \"cleared\": ");
+        w.raw(report.context.clearedErrors.count(bz) > 0 ? "true" : "false");
+
+        // Original spellings, sorted for stable output
+        words.clear();
+        if (auto found = db.bzToOriginalWords.find(bz); found != db.bzToOriginalWords.end()) {
+            for (const auto& word : found->second) {
+                words.push_back(&word);
+            }
+        }
+        std::sort(words.begin(), words.end(), [](const auto* a, const auto* b) { return *a < *b; });
+        w.raw(", \"words\": [");
+        for (size_t i = 0; i < words.size(); ++i) {
+            w.raw(i > 0 ? ", " : "");
+            w.jsonString(*words[i]);
+        }
+
+        w.raw("], \"terms\": [");
+        const PositionRange positions = db.positionsOfBz(bz);
+        stemsInOrder(occurrences, positions, stemIds);
+        for (size_t s = 0; s < stemIds.size(); ++s) {
+            const StemVector& stem = occurrences.stem(stemIds[s]);
+            w.raw(s > 0 ? ", {\"term\": " : "{\"term\": ");
+            w.jsonString(termOf(db, report.text, stemIds[s]));
+            w.raw(", \"stem\": [");
+            for (size_t i = 0; i < stem.size(); ++i) {
+                w.raw(i > 0 ? ", " : "");
+                w.jsonString(stem[i]);
+            }
+            w.raw("], \"occurrences\": [");
+            bool firstOccurrence = true;
+            for (auto it = positions.begin(); it != positions.end(); ++it) {
+                if (occurrences.stemId(it.occurrence()) != stemIds[s]) {
+                    continue;
+                }
+                const auto [start, length] = *it;
+                w.raw(firstOccurrence ? "[" : ", [");
+                firstOccurrence = false;
+                w.number(start);
+                w.raw(", ");
+                w.number(start + length);
+                w.raw("]");
+            }
+            w.raw("]}");
+        }
+        w.raw("]}");
+    }
+    w.raw(first ? "],\n  \"errors\": [" : "\n  ],\n  \"errors\": [");
+
+    first = true;
+    for (const ErrorList& list : errors) {
+        for (const auto& [start, end] : list.positions) {
+            const auto [line, column] = lines.lineColumn(static_cast<size_t>(start));
+            w.raw(first ? "\n    {\"kind\": \"" : ",\n    {\"kind\": \"");
+            first = false;
+            w.raw(RULES[list.rule].key);
+            w.raw("\", \"start\": ");
+            w.number(static_cast<size_t>(start));
+            w.raw(", \"end\": ");
+            w.number(static_cast<size_t>(end));
+            w.raw(", \"line\": ");
+            w.number(line);
+            w.raw(", \"column\": ");
+            w.number(column);
+            if (&list.positions == &report.wrongTermBz) {
+                w.raw(", \"bz\": ");
+                w.jsonString(bzAt(occurrences, static_cast<size_t>(start)));
+            }
+            w.raw(", \"text\": ");
+            w.jsonString(span(report.text, static_cast<size_t>(start), static_cast<size_t>(end)));
+            w.raw("}");
+        }
+    }
+    w.raw(first ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+void writeCsv(Writer& w, const ReportExporter::Report& report, const ErrorList (&errors)[3]) {
+    const ReferenceDatabase& db = report.context.db;
+    const OccurrenceTable& occurrences = db.occurrences;
+    const LineIndex lines(report.text);
+
+    auto row = [&](std::string_view kind, std::wstring_view bz, std::wstring_view term, size_t start, size_t end) {
+        const auto [line, column] = lines.lineColumn(start);
+        w.raw(kind);
+        w.raw(",");
+        w.csvField(bz);
+        w.raw(",");
+        w.csvField(term);
+        w.raw(",");
+        w.number(start);
+        w.raw(",");
+        w.number(end);
+        w.raw(",");
+        w.number(line);
+        w.raw(",");
+        w.number(column);
+        w.raw(",");
+        w.csvField(span(report.text, start, end));
+        w.raw("\r\n");
+    };
+
+    w.raw("kind,bz,term,start,end,line,column,text\r\n");
+    std::vector<std::wstring> terms;  // By stem ID, filled on first use
+    for (const auto& [bz, stems] : db.bzToStems) {
+        const PositionRange positions = db.positionsOfBz(bz);
+        for (auto it = positions.begin(); it != positions.end(); ++it) {
+            const uint32_t stemId = occurrences.stemId(it.occurrence());
+            if (terms.size() <= stemId) {
+                terms.resize(occurrences.stemCount());
+            }
+            if (terms[stemId].empty()) {
+                terms[stemId] = termOf(db, report.text, stemId);
+            }
+            const auto [start, length] = *it;
+            row("reference", bz, terms[stemId], start, start + length);
+        }
+    }
+    for (const ErrorList& list : errors) {
+        const bool hasBz = &list.positions == &report.wrongTermBz;
+        for (const auto& [start, end] : list.positions) {
+            row(RULES[list.rule].key, hasBz ? bzAt(occurrences, static_cast<size_t>(start)) : std::wstring_view(),
+                {}, static_cast<size_t>(start), static_cast<size_t>(end));
+        }
+    }
+}
+
+// Relative URI reference for a path: '\' becomes '/', reserved bytes are percent-encoded
+std::string uriOf(const std::string& path) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string uri;
+    for (char c : path.empty() ? std::string("untitled.txt") : path) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '\\') {
+            uri += '/';
+        } else if ((byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || (byte >= '0' && byte <= '9') ||
+                   c == '-' || c == '.' || c == '_' || c == '~' || c == '/' || c == ':') {
+            uri += c;
+        } else {
+            uri += '%';
+            uri += HEX[byte >> 4];
+            uri += HEX[byte & 0xF];
+        }
+    }
+    return uri;
+}
+
+void writeSarif(Writer& w, const ReportExporter::Report& report, const ErrorList (&errors)[3]) {
+    const ReferenceDatabase& db = report.context.db;
+    const LineIndex lines(report.text);
+    const std::string uri = uriOf(report.source);
+
+    w.raw("{\n  \"$schema\": \"https://json.schemastore.org/sarif-2.1.0.json\",\n  \"version\": \"2.1.0\",\n"
+          "  \"runs\": [{\n    \"tool\": {\"driver\": {\"name\": \"Bezugszeichenvorrichtung\", \"rules\": [");
+    for (size_t i = 0; i < std::size(RULES); ++i) {
+        w.raw(i > 0 ? ",\n      {\"id\": \"" : "\n      {\"id\": \"");
+        w.raw(RULES[i].id);
+        w.raw("\", \"shortDescription\": {\"text\": ");
+        w.jsonString(std::string_view(RULES[i].description));
+        w.raw("}, \"defaultConfiguration\": {\"level\": \"");
+        w.raw(RULES[i].level);
+        w.raw("\"}}");
+    }
+    // Columns count wchar_t units: UTF-16 code units on Windows, code points elsewhere
+    w.raw("]}},\n    \"columnKind\": \"");
+    w.raw(sizeof(wchar_t) == 2 ? "utf16CodeUnits" : "unicodeCodePoints");
+    w.raw("\",\n    \"artifacts\": [{\"location\": {\"uri\": ");
+    w.jsonString(std::string_view(uri));
+    w.raw("}, \"sourceLanguage\": ");
+    w.jsonString(std::string_view(report.language));
+    w.raw("}],\n    \"properties\": {\"characters\": ");
+    w.number(report.text.size());
+    w.raw(", \"referenceNumbers\": ");
+    w.number(db.bzToStems.size());
+    w.raw(", \"conflictingNumbers\": ");
+    w.number(countConflicting(report.context));
+    w.raw("},\n    \"results\": [");
+
+    bool first = true;
+    for (const ErrorList& list : errors) {
+        const Rule& rule = RULES[list.rule];
+        for (const auto& [start, end] : list.positions) {
+            const std::wstring_view text = span(report.text, static_cast<size_t>(start), static_cast<size_t>(end));
+            const auto [startLine, startColumn] = lines.lineColumn(static_cast<size_t>(start));
+            const auto [endLine, endColumn] = lines.lineColumn(static_cast<size_t>(end));
+
+            w.raw(first ? "\n      {\"ruleId\": \"" : ",\n      {\"ruleId\": \"");
+            first = false;
+            w.raw(rule.id);
+            w.raw("\", \"ruleIndex\": ");
+            w.number(list.rule);
+            w.raw(", \"level\": \"");
+            w.raw(rule.level);
+            w.raw("\", \"message\": {\"text\": \"");
+            if (&list.positions == &report.noNumber) {
+                w.jsonChars(L"\"");
+                w.jsonChars(text);
+                w.jsonChars(L"\" has no reference number");
+            } else if (&list.positions == &report.wrongTermBz) {
+                w.jsonChars(L"Reference number ");
+                w.jsonChars(bzAt(db.occurrences, static_cast<size_t>(start)));
+                w.jsonChars(L" is used for more than one term");
+            } else {
+                w.jsonChars(L"Article \"");
+                w.jsonChars(text);
+                w.jsonChars(L"\" does not fit the mention of the term");
+            }
+            w.raw("\"}, \"locations\": [{\"physicalLocation\": {\"artifactLocation\": {\"uri\": ");
+            w.jsonString(std::string_view(uri));
+            w.raw(", \"index\": 0}, \"region\": {\"startLine\": ");
+            w.number(startLine);
+            w.raw(", \"startColumn\": ");
+            w.number(startColumn);
+            w.raw(", \"endLine\": ");
+            w.number(endLine);
+            w.raw(", \"endColumn\": ");
+            w.number(endColumn);
+            w.raw(", \"charOffset\": ");
+            w.number(static_cast<size_t>(start));
+            w.raw(", \"charLength\": ");
+            w.number(static_cast<size_t>(end - start));
+            w.raw(", \"snippet\": {\"text\": ");
+            w.jsonString(text);
+            w.raw("}}}}]}");
+        }
+    }
+    w.raw(first ? "]\n  }]\n}\n" : "\n    ]\n  }]\n}\n");
+}
+
+} // namespace
+
+ReportExporter::Report ReportExporter::fromPipeline(const ScanPipeline& pipeline, const std::wstring& text,
+                                                   std::string source, std::string language) {
+    return Report{std::move(source),           std::move(language),         text,
+                  pipeline.context(),          pipeline.noNumberErrors(),   pipeline.wrongTermBzErrors(),
+                  pipeline.wrongArticleErrors(), pipeline.allErrors()};
+}
+
+bool ReportExporter::parseFormat(std::string_view name, Format& format) {
+    if (name == "json") {
+        format = Format::JSON;
+    } else if (name == "csv") {
+        format = Format::CSV;
+    } else if (name == "sarif") {
+        format = Format::SARIF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* ReportExporter::extension(Format format) {
+    switch (format) {
+    case Format::JSON:
+        return ".json";
+    case Format::CSV:
+        return ".csv";
+    case Format::SARIF:
+        return ".sarif";
+    }
+    return "";
+}
+
+void ReportExporter::write(std::ostream& out, Format format, const Report& report) {
+    BZ_TRACE_SCOPE("ReportExporter::write");
+    const ErrorList errors[3] = {{0, report.noNumber}, {1, report.wrongTermBz}, {2, report.wrongArticle}};
+    Writer writer(out);
+    switch (format) {
+    case Format::JSON:
+        writeJson(writer, report, errors);
+        break;
+    case Format::CSV:
+        writeCsv(writer, report, errors);
+        break;
+    case Format::SARIF:
+        writeSarif(writer, report, errors);
+        break;
+    }
+}
+
+bool ReportExporter::writeFile(const std::string& path, Format format, const Report& report) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    write(out, format, report);
+    out.flush();
+    return static_cast<bool>(out);
+}
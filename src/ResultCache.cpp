@@ -0,0 +1,233 @@
+#include "ResultCache.h"
+#include "AnalysisContext.h"
+#include "Metrics.h"
+#include "ScanPipeline.h"
+#include "SessionFile.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr const char* EXTENSION = ".bzsession";
+
+inline uint64_t mix(uint64_t hash, uint64_t value) {
+    // splitmix64 finalizer over the running hash
+    hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBull;
+    return hash ^ (hash >> 31);
+}
+
+// Order-independent: unordered_set iteration order differs between runs
+uint64_t hashSet(const std::unordered_set<std::wstring>& set) {
+    uint64_t sum = 0;
+    for (const std::wstring& s : set) {
+        sum += mix(0, SessionFile::hashText(s));
+    }
+    return mix(set.size(), sum);
+}
+
+bool parseKey(const std::filesystem::path& path, uint64_t& key) {
+    const std::string stem = path.stem().string();
+    if (path.extension() != EXTENSION || stem.size() != 16 ||
+        stem.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        return false;
+    }
+    key = std::stoull(stem, nullptr, 16);
+    return true;
+}
+
+Metrics::Counter& hits() {
+    static Metrics::Counter& counter =
+        Metrics::counter("bz_result_cache_hits_total", "Analyses answered from the result cache");
+    return counter;
+}
+
+Metrics::Counter& misses() {
+    static Metrics::Counter& counter =
+        Metrics::counter("bz_result_cache_misses_total", "Result cache lookups that needed a scan");
+    return counter;
+}
+
+} // namespace
+
+ResultCache::ResultCache(const std::filesystem::path& directory, uint64_t maxBytes)
+    : m_directory(directory), m_maxBytes(maxBytes) {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error || !std::filesystem::is_directory(m_directory)) {
+        throw std::runtime_error("result cache: cannot create " + m_directory.string());
+    }
+
+    // Rebuild the LRU order from the modification times left by touch()
+    struct Found {
+        std::filesystem::file_time_type time;
+        uint64_t key;
+        uint64_t bytes;
+    };
+    std::vector<Found> found;
+    for (const auto& file : std::filesystem::directory_iterator(m_directory, error)) {
+        uint64_t key;
+        if (file.is_regular_file(error) && parseKey(file.path(), key)) {
+            found.push_back({file.last_write_time(error), key, file.file_size(error)});
+        }
+    }
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time < b.time; });
+    for (const Found& f : found) {
+        m_entries[f.key] = {f.bytes, ++m_clock};
+        m_totalBytes += f.bytes;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    evictLocked();
+}
+
+uint64_t ResultCache::key(const std::wstring& text, bool german, const AnalysisContext& ctx,
+                          std::span<const uint32_t> paragraphStarts) {
+    uint64_t hash = mix(SessionFile::hashText(text), text.size());
+    if (!paragraphStarts.empty()) {
+        // A match never spans paragraphs, so the table changes the results
+        uint64_t paragraphs = paragraphStarts.size();
+        for (const uint32_t start : paragraphStarts) {
+            paragraphs = mix(paragraphs, start);
+        }
+        hash = mix(hash, paragraphs);
+    }
+    hash = mix(hash, german ? 1 : 2);
+    hash = mix(hash, SessionFile::ANALYZER_VERSION);
+    hash = mix(hash, SessionFile::VERSION);
+    hash = mix(hash, hashSet(ctx.manualMultiWordToggles));
+    hash = mix(hash, hashSet(ctx.manuallyDisabledMultiWord));
+    hash = mix(hash, hashSet(ctx.clearedErrors));
+    hash = mix(hash, hashSet(ctx.ignoredWords));
+    uint64_t anchors = 0;
+    for (const ClearedAnchors::Anchor& anchor : ctx.clearedTextAnchors.anchors()) {
+        anchors += mix(mix(mix(mix(mix(anchor.text, anchor.firstWord), anchor.before), anchor.after), anchor.length),
+                       static_cast<uint32_t>(anchor.offset));
+    }
+    return mix(hash, mix(ctx.clearedTextAnchors.size(), anchors));
+}
+
+bool ResultCache::lookup(ScanPipeline& pipeline, const std::wstring& text,
+                         std::span<const uint32_t> paragraphStarts) {
+    BZ_TRACE_SCOPE("ResultCache::lookup");
+    const uint64_t k = key(text, pipeline.german(), pipeline.context(), paragraphStarts);
+    const std::filesystem::path path = pathFor(k);
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        forget(k);
+        misses().add();
+        return false;
+    }
+    try {
+        const SessionFile session(path.string());
+        // Also rejects the (unlikely) key collision with other text or language
+        if (pipeline.restore(session, text)) {
+            touch(k, path);
+            hits().add();
+            return true;
+        }
+    } catch (const std::exception&) {
+        // Damaged or from another version: drop it, the scan will store a new one
+        std::filesystem::remove(path, error);
+        forget(k);
+    }
+    misses().add();
+    return false;
+}
+
+void ResultCache::store(const ScanPipeline& pipeline, const std::wstring& text,
+                        std::span<const uint32_t> paragraphStarts) {
+    BZ_TRACE_SCOPE("ResultCache::store");
+    const uint64_t k = key(text, pipeline.german(), pipeline.context(), paragraphStarts);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.count(k) > 0 || !m_writing.insert(k).second) {
+            return;
+        }
+    }
+    const std::filesystem::path path = pathFor(k);
+    try {
+        pipeline.save(path.string(), text);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writing.erase(k);
+        throw;
+    }
+    std::error_code error;
+    const uint64_t bytes = std::filesystem::file_size(path, error);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_writing.erase(k);
+    if (error) {
+        return;  // Already evicted by another process
+    }
+    m_entries[k] = {bytes, ++m_clock};
+    m_totalBytes += bytes;
+    evictLocked();
+}
+
+size_t ResultCache::entryCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+uint64_t ResultCache::sizeBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totalBytes;
+}
+
+std::filesystem::path ResultCache::pathFor(uint64_t key) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return m_directory / (std::string(name) + EXTENSION);
+}
+
+void ResultCache::touch(uint64_t key, const std::filesystem::path& path) {
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    const uint64_t bytes = std::filesystem::file_size(path, error);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [entry, added] = m_entries.try_emplace(key);
+    if (added && !error) {
+        // Written by another process since we indexed the directory
+        entry->second.bytes = bytes;
+        m_totalBytes += bytes;
+    }
+    entry->second.lastUse = ++m_clock;
+}
+
+void ResultCache::forget(uint64_t key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto entry = m_entries.find(key);
+    if (entry != m_entries.end()) {
+        m_totalBytes -= entry->second.bytes;
+        m_entries.erase(entry);
+    }
+}
+
+void ResultCache::evictLocked() {
+    if (m_totalBytes <= m_maxBytes) {
+        return;
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> byUse;  // (last use, key)
+    byUse.reserve(m_entries.size());
+    for (const auto& [key, entry] : m_entries) {
+        byUse.emplace_back(entry.lastUse, key);
+    }
+    std::sort(byUse.begin(), byUse.end());
+    for (const auto& [lastUse, key] : byUse) {
+        if (m_totalBytes <= m_maxBytes) {
+            break;
+        }
+        std::error_code error;
+        std::filesystem::remove(pathFor(key), error);
+        m_totalBytes -= m_entries[key].bytes;
+        m_entries.erase(key);
+    }
+}
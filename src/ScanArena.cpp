@@ -0,0 +1,45 @@
+#include "ScanArena.h"
+#include <algorithm>
+#include <bit>
+
+ScanArena::ScanArena(size_t initialSize)
+    : m_bufferSize(std::max<size_t>(initialSize, 1024)) {
+    createResource();
+}
+
+void ScanArena::createResource() {
+    m_monotonic.reset();
+    m_buffer = std::make_unique<std::byte[]>(m_bufferSize);
+    m_monotonic.emplace(m_buffer.get(), m_bufferSize, std::pmr::new_delete_resource());
+    m_counter.upstream = &*m_monotonic;
+}
+
+void ScanArena::reset() {
+    const size_t used = m_counter.bytesInUse;
+    m_lastScanBytes = used;
+    m_peakBytes = std::max(m_peakBytes, used);
+    m_counter.bytesInUse = 0;
+
+    // Alignment padding and block headers are not counted, so leave headroom
+    const size_t wanted = used + used / 4;
+    if (wanted > m_bufferSize) {
+        m_bufferSize = std::bit_ceil(wanted);
+        createResource();
+    } else {
+        m_monotonic->release();
+    }
+}
+
+void* ScanArena::CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    bytesInUse += bytes;
+    return upstream->allocate(bytes, alignment);
+}
+
+void ScanArena::CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    // Monotonic: memory is only reclaimed by ScanArena::reset()
+    upstream->deallocate(p, bytes, alignment);
+}
+
+bool ScanArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,236 @@
+#include "ScanPipeline.h"
+#include "GermanTextAnalyzer.h"
+#include "EnglishTextAnalyzer.h"
+#include "OrdinalDetector.h"
+#include "TextScanner.h"
+#include "ErrorDetectorHelper.h"
+#include "ErrorIndex.h"
+#include "RegexPatterns.h"
+#include "RE2RegexHelper.h"
+#include "Metrics.h"
+#include "SessionFile.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+
+ScanPipeline::ScanPipeline(bool useGerman)
+    : m_singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN),
+      m_twoWordRegex(RegexPatterns::TWO_WORD_PATTERN),
+      m_wordRegex(RegexPatterns::WORD_PATTERN),
+      m_allErrorsPositions(m_ctx.arena.resource()),
+      m_noNumberPositions(m_ctx.arena.resource()),
+      m_wrongTermBzPositions(m_ctx.arena.resource()),
+      m_wrongArticlePositions(m_ctx.arena.resource()) {
+    if (useGerman) {
+        m_analyzer = std::make_unique<GermanTextAnalyzer>();
+    } else {
+        m_analyzer = std::make_unique<EnglishTextAnalyzer>();
+    }
+}
+
+bool ScanPipeline::run(const std::wstring& text, std::span<const uint32_t> paragraphStarts,
+                       const std::atomic<bool>* cancel) {
+    BZ_TRACE_SCOPE("ScanPipeline::run");
+    using Clock = std::chrono::steady_clock;
+    auto millisecondsSince = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+    auto cancelled = [cancel] { return cancel && cancel->load(); };
+    const auto started = Clock::now();
+
+    {
+        BZ_TRACE_SCOPE("clearResults");
+        // The error lists live in the scan arena, so they are replaced by
+        // empty ones before the arena is released
+        resetErrors();
+        m_ctx.clearResults();
+    }
+    if (cancelled()) {
+        return false;
+    }
+
+    applyIgnoredWords();
+    detectMultiWordStems(text, m_twoWordRegex, german(), *m_analyzer, m_ctx);
+    m_timings.ordinalMs = millisecondsSince(started);
+    if (cancelled()) {
+        return false;
+    }
+
+    const auto scanStarted = Clock::now();
+    {
+        BZ_TRACE_SCOPE("TextScanner::scanText");
+        TextScanner::scanText(text, *m_analyzer, m_singleWordRegex, m_twoWordRegex, m_ctx, paragraphStarts);
+    }
+    collectFirstSpellings(text);
+    m_timings.scanMs = millisecondsSince(scanStarted);
+    if (cancelled()) {
+        return false;
+    }
+
+    detect(text);
+    recordScanMetrics(text.size(), millisecondsSince(started));
+    return true;
+}
+
+void ScanPipeline::collectFirstSpellings(const std::wstring& text) {
+    BZ_TRACE_SCOPE("stemToFirstWord");
+    const OccurrenceTable& occurrences = m_ctx.db.occurrences;
+    for (uint32_t stemId = 0; stemId < occurrences.stemCount(); ++stemId) {
+        if (!occurrences.positionsOfStem(stemId).empty()) {
+            m_ctx.db.stemToFirstWord[occurrences.stem(stemId)] = occurrences.firstSpelling(stemId, text);
+        }
+    }
+}
+
+void ScanPipeline::detectMultiWordStems(const std::wstring& text, const re2::RE2& twoWordRegex, bool german,
+                                        TextAnalyzer& analyzer, AnalysisContext& ctx) {
+    BZ_TRACE_SCOPE("OrdinalDetector::detectOrdinalPatterns");
+    std::unordered_set<std::wstring> autoDetected =
+        OrdinalDetector::detectOrdinalPatterns(text, twoWordRegex, german, analyzer);
+    ctx.multiWordBaseStems = ctx.manualMultiWordToggles;
+    for (const auto& stem : autoDetected) {
+        if (ctx.manuallyDisabledMultiWord.count(stem) == 0) {
+            ctx.multiWordBaseStems.insert(stem);
+        }
+    }
+    ctx.autoDetectedMultiWordStems = std::move(autoDetected);
+}
+
+bool ScanPipeline::restore(const SessionFile& session, const std::wstring& text) {
+    BZ_TRACE_SCOPE("ScanPipeline::restore");
+    if (session.german() != german() || !session.matches(text)) {
+        return false;
+    }
+    resetErrors();
+    session.restore(m_ctx);
+    m_ctx.clearedTextAnchors.resolve(text);
+    m_timings.ordinalMs = 0;
+    m_timings.scanMs = 0;
+    if (!session.hasDetection()) {
+        detect(text);
+        return true;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    session.restoreDetection(m_noNumberPositions, m_wrongTermBzPositions, m_wrongArticlePositions, m_conflictingBz);
+    m_ctx.buildConflicts();
+    m_errorIndex.build({&m_noNumberPositions, &m_wrongTermBzPositions, &m_wrongArticlePositions},
+                       m_allErrorsPositions);
+    m_timings.detectMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+void ScanPipeline::save(const std::string& path, const std::wstring& text) const {
+    const SessionFile::Detection detection{&m_noNumberPositions, &m_wrongTermBzPositions, &m_wrongArticlePositions,
+                                           &m_conflictingBz};
+    SessionFile::save(path, text, german(), m_ctx, &detection);
+}
+
+bool ScanPipeline::german() const {
+    return dynamic_cast<const GermanTextAnalyzer*>(m_analyzer.get()) != nullptr;
+}
+
+void ScanPipeline::setLanguage(bool useGerman) {
+    if (useGerman == german()) {
+        return;
+    }
+    if (useGerman) {
+        m_analyzer = std::make_unique<GermanTextAnalyzer>();
+    } else {
+        m_analyzer = std::make_unique<EnglishTextAnalyzer>();
+    }
+    m_analyzerIgnoredWords.clear();
+    m_ctx.autoDetectedMultiWordStems.clear();
+    m_ctx.multiWordBaseStems = m_ctx.manualMultiWordToggles;
+}
+
+void ScanPipeline::applyIgnoredWords() {
+    if (m_analyzerIgnoredWords == m_ctx.ignoredWords) {
+        return;
+    }
+    // Words cannot be taken out of an analyzer, so removing one starts over
+    for (const auto& word : m_analyzerIgnoredWords) {
+        if (m_ctx.ignoredWords.count(word) == 0) {
+            if (german()) {
+                m_analyzer = std::make_unique<GermanTextAnalyzer>();
+            } else {
+                m_analyzer = std::make_unique<EnglishTextAnalyzer>();
+            }
+            m_analyzerIgnoredWords.clear();
+            break;
+        }
+    }
+    for (const auto& word : m_ctx.ignoredWords) {
+        if (m_analyzerIgnoredWords.insert(word).second) {
+            m_analyzer->addIgnoredWord(word);
+        }
+    }
+}
+
+std::string ScanPipeline::patternError() const {
+    for (const re2::RE2* regex : {&m_singleWordRegex, &m_twoWordRegex, &m_wordRegex}) {
+        if (!regex->ok()) {
+            return regex->pattern() + ": " + regex->error();
+        }
+    }
+    return {};
+}
+
+void ScanPipeline::resetErrors() {
+    m_allErrorsPositions = ErrorPositions(m_ctx.arena.resource());
+    m_noNumberPositions = ErrorPositions(m_ctx.arena.resource());
+    m_wrongTermBzPositions = ErrorPositions(m_ctx.arena.resource());
+    m_wrongArticlePositions = ErrorPositions(m_ctx.arena.resource());
+    m_conflictingBz.clear();
+    m_errorIndex.clear();
+}
+
+void ScanPipeline::detect(const std::wstring& text) {
+    using Clock = std::chrono::steady_clock;
+    const auto detectStarted = Clock::now();
+
+    // Headless: styles are never applied
+    const wxTextAttr noStyle;
+    m_ctx.buildConflicts();
+    const OccurrenceTable& occurrences = m_ctx.db.occurrences;
+    for (const auto& [bz, stems] : m_ctx.db.bzToStems) {
+        if (m_ctx.conflicts.bzFlagged(occurrences.findBz(bz))) {
+            m_conflictingBz.push_back(bz);
+        }
+    }
+    ErrorDetectorHelper::highlightConflicts(m_ctx, nullptr, noStyle, m_wrongTermBzPositions);
+    ErrorDetectorHelper::findUnnumberedWords(text, *m_analyzer, m_wordRegex, m_ctx, nullptr, noStyle,
+                                             m_noNumberPositions);
+    ErrorDetectorHelper::checkArticleUsage(text, *m_analyzer, m_ctx, nullptr, noStyle, m_wrongArticlePositions);
+
+    m_errorIndex.build({&m_noNumberPositions, &m_wrongTermBzPositions, &m_wrongArticlePositions},
+                       m_allErrorsPositions);
+    m_timings.detectMs = std::chrono::duration<double, std::milli>(Clock::now() - detectStarted).count();
+}
+
+void ScanPipeline::reportMemory(MemoryReport& report, const std::wstring& text) const {
+    report.setInputCharacters(text.size());
+    report.add("Document text (wchar_t)", text.capacity() * sizeof(wchar_t));
+    report.add("Match iterator: UTF-8 copy", RE2RegexHelper::MatchIterator::estimateUtf8Bytes(text), true);
+    report.add("Match iterator: position map", RE2RegexHelper::MatchIterator::estimatePositionMapBytes(text), true);
+
+    m_ctx.reportMemory(report);
+    report.add("Stem cache", m_analyzer->getCacheMemoryBytes());
+    size_t errorBytes = 0;
+    for (const ErrorPositions* positions :
+         {&m_allErrorsPositions, &m_noNumberPositions, &m_wrongTermBzPositions, &m_wrongArticlePositions}) {
+        errorBytes += MemoryUsage::heapBytes(*positions);
+    }
+    report.add("Error positions", errorBytes);
+    report.add("Conflicting BZ list", MemoryUsage::heapBytes(m_conflictingBz));
+}
+
+void ScanPipeline::recordScanMetrics(size_t characters, double milliseconds) {
+    static Metrics::Counter& scans = Metrics::counter("bz_scans_total", "Completed scans");
+    scans.add();
+    Metrics::histogram("bz_scan_duration_ms", "Scan latency by document size in characters",
+                       Metrics::LATENCY_BUCKETS_MS, Metrics::sizeLabel(characters))
+        .observe(milliseconds);
+}
@@ -0,0 +1,152 @@
+#include "ScanSnapshot.h"
+#include "ScanPipeline.h"
+#include "RE2RegexHelper.h"
+#include <algorithm>
+
+namespace {
+
+std::string toUtf8(const std::wstring& text) {
+    return RE2RegexHelper::wstringToUtf8(text);
+}
+
+std::string describe(uint32_t value) { return std::to_string(value); }
+std::string describe(const std::wstring& value) { return "'" + toUtf8(value) + "'"; }
+std::string describe(const StemVector& stems) { return "{" + toUtf8(stemVectorToString(stems)) + "}"; }
+
+template <typename A, typename B>
+std::string describe(const std::pair<A, B>& range) {
+    return "(" + std::to_string(range.first) + ", " + std::to_string(range.second) + ")";
+}
+
+template <typename Container>
+std::string describeAll(const Container& values) {
+    std::string result = "[";
+    for (const auto& value : values) {
+        if (result.size() > 1) {
+            result += ", ";
+        }
+        result += describe(value);
+    }
+    return result + "]";
+}
+
+// First position where two sequences differ, described as name[i]
+template <typename Sequence>
+std::optional<std::string> firstSequenceDifference(const std::string& name, const Sequence& expected,
+                                                   const Sequence& actual) {
+    auto e = expected.begin();
+    auto a = actual.begin();
+    for (size_t i = 0;; ++i, ++e, ++a) {
+        const bool expectedEnd = e == expected.end();
+        const bool actualEnd = a == actual.end();
+        if (expectedEnd && actualEnd) {
+            return std::nullopt;
+        }
+        const std::string where = name + "[" + std::to_string(i) + "]: ";
+        if (actualEnd) {
+            return where + "expected " + describe(*e) + ", missing";
+        }
+        if (expectedEnd) {
+            return where + "unexpected " + describe(*a);
+        }
+        if (!(*e == *a)) {
+            return where + "expected " + describe(*e) + ", got " + describe(*a);
+        }
+    }
+}
+
+// First key present in only one map, then the first key whose values differ
+template <typename Map>
+std::optional<std::string> firstMapDifference(const std::string& name, const Map& expected, const Map& actual) {
+    for (const auto& [key, value] : expected) {
+        auto it = actual.find(key);
+        if (it == actual.end()) {
+            return name + ": BZ " + describe(key) + " missing, expected " + describeAll(value);
+        }
+        if (!(it->second == value)) {
+            return name + "[" + toUtf8(key) + "]: expected " + describeAll(value) + ", got " +
+                   describeAll(it->second);
+        }
+    }
+    for (const auto& [key, value] : actual) {
+        if (expected.find(key) == expected.end()) {
+            return name + ": unexpected BZ " + describe(key) + " with " + describeAll(value);
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename Range>
+std::vector<ScanSnapshot::ErrorRange> sortedErrors(const Range& positions) {
+    std::vector<ScanSnapshot::ErrorRange> result(positions.begin(), positions.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+ScanSnapshot ScanSnapshot::capture(const ScanPipeline& pipeline) {
+    const AnalysisContext& ctx = pipeline.context();
+    ScanSnapshot snapshot;
+
+    for (const auto& [bz, stems] : ctx.db.bzToStems) {
+        snapshot.bzToStems[bz].insert(stems.begin(), stems.end());
+
+        std::vector<Range>& positions = snapshot.bzPositions[bz];
+        for (const auto position : ctx.db.positionsOfBz(bz)) {
+            positions.push_back(position);
+        }
+    }
+    for (const auto& [bz, words] : ctx.db.bzToOriginalWords) {
+        snapshot.bzToOriginalWords[bz].insert(words.begin(), words.end());
+    }
+    snapshot.multiWordBaseStems.insert(ctx.multiWordBaseStems.begin(), ctx.multiWordBaseStems.end());
+
+    snapshot.conflictingBz = pipeline.conflictingBz();
+    snapshot.allErrors = sortedErrors(pipeline.allErrors());
+    snapshot.noNumberErrors = sortedErrors(pipeline.noNumberErrors());
+    snapshot.wrongTermBzErrors = sortedErrors(pipeline.wrongTermBzErrors());
+    snapshot.wrongArticleErrors = sortedErrors(pipeline.wrongArticleErrors());
+    return snapshot;
+}
+
+std::optional<std::string> ScanSnapshot::firstDivergence(const ScanSnapshot& expected,
+                                                         const ScanSnapshot& actual) {
+    if (expected.exception != actual.exception) {
+        return "exception: expected " + expected.exception.value_or("none") + ", got " +
+               actual.exception.value_or("none");
+    }
+
+    std::optional<std::string> difference;
+    if ((difference = firstSequenceDifference("multiWordBaseStems", expected.multiWordBaseStems,
+                                              actual.multiWordBaseStems)) ||
+        (difference = firstMapDifference("bzToStems", expected.bzToStems, actual.bzToStems)) ||
+        (difference = firstMapDifference("bzToOriginalWords", expected.bzToOriginalWords,
+                                         actual.bzToOriginalWords)) ||
+        (difference = firstMapDifference("bzPositions", expected.bzPositions, actual.bzPositions)) ||
+        (difference = firstSequenceDifference("conflictingBz", expected.conflictingBz, actual.conflictingBz)) ||
+        (difference = firstSequenceDifference("allErrors", expected.allErrors, actual.allErrors)) ||
+        (difference = firstSequenceDifference("noNumberErrors", expected.noNumberErrors,
+                                              actual.noNumberErrors)) ||
+        (difference = firstSequenceDifference("wrongTermBzErrors", expected.wrongTermBzErrors,
+                                              actual.wrongTermBzErrors)) ||
+        (difference = firstSequenceDifference("wrongArticleErrors", expected.wrongArticleErrors,
+                                              actual.wrongArticleErrors))) {
+        return difference;
+    }
+    return std::nullopt;
+}
+
+std::string ScanDecisions::describe() const {
+    std::string result;
+    auto line = [&result](const char* name, const auto& values) {
+        if (!values.empty()) {
+            result += std::string(name) + ": " + describeAll(values) + "\n";
+        }
+    };
+    line("paragraphStarts", paragraphStarts);
+    line("clearedBz", clearedBz);
+    line("clearedRanges", clearedRanges);
+    line("ignoredWords", ignoredWords);
+    return result;
+}
@@ -0,0 +1,482 @@
+#include "SessionFile.h"
+#include "Trace.h"
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little, "session files are little-endian");
+
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'Z', 'S', 'E', 'S', 'S', 'N', '\0'};
+constexpr uint32_t NO_STRING = UINT32_MAX;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint8_t wcharSize;
+    uint8_t language;  // 0 German, 1 English
+    uint16_t reserved;
+    uint64_t textHash;
+    uint64_t textLength;
+    uint32_t sectionCount;
+    uint32_t analyzerVersion;  // 0 in files written before it was recorded
+};
+static_assert(sizeof(Header) == 40);
+
+struct DirectoryEntry {
+    uint32_t id;
+    uint32_t count;
+    uint64_t offset;
+    uint64_t bytes;
+};
+static_assert(sizeof(DirectoryEntry) == 24);
+
+template <typename T>
+T load(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void append(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+[[noreturn]] void corrupt(const std::string& what) {
+    throw std::runtime_error("session: " + what);
+}
+
+} // namespace
+
+std::string SessionFile::pathFor(const std::string& documentPath) {
+    return documentPath + ".bzsession";
+}
+
+uint64_t SessionFile::hashText(const std::wstring& text) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (wchar_t c : text) {
+        hash = (hash ^ static_cast<uint32_t>(c)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+void SessionFile::save(const std::string& path, const std::wstring& text, bool german,
+                       const AnalysisContext& ctx, const Detection* detection) {
+    BZ_TRACE_SCOPE("SessionFile::save");
+    struct Section {
+        std::string bytes;
+        uint32_t count = 0;
+        bool written = true;
+    };
+    Section sections[SECTION_COUNT];
+    std::wstring pool;
+
+    auto reference = [&](Section& section, const std::wstring& s) {
+        if (pool.size() + s.size() >= NO_STRING) {
+            throw std::runtime_error("session: too much text for one session file");
+        }
+        append<uint32_t>(section.bytes, static_cast<uint32_t>(pool.size()));
+        append<uint32_t>(section.bytes, static_cast<uint32_t>(s.size()));
+        pool += s;
+    };
+    auto stringSet = [&](SectionId id, const std::unordered_set<std::wstring>& set) {
+        for (const auto& s : set) {
+            reference(sections[id], s);
+        }
+        sections[id].count = static_cast<uint32_t>(set.size());
+    };
+
+    const OccurrenceTable& occurrences = ctx.db.occurrences;
+    for (uint32_t id = 0; id < occurrences.bzCount(); ++id) {
+        reference(sections[BZ_NAMES], occurrences.bzName(id));
+    }
+    sections[BZ_NAMES].count = static_cast<uint32_t>(occurrences.bzCount());
+
+    for (uint32_t id = 0; id < occurrences.stemCount(); ++id) {
+        const StemVector& stem = occurrences.stem(id);
+        append<uint32_t>(sections[STEMS].bytes, sections[STEM_PARTS].count);
+        append<uint32_t>(sections[STEMS].bytes, static_cast<uint32_t>(stem.size()));
+        for (const auto& part : stem) {
+            reference(sections[STEM_PARTS], part);
+            ++sections[STEM_PARTS].count;
+        }
+    }
+    sections[STEMS].count = static_cast<uint32_t>(occurrences.stemCount());
+
+    // Columns in document order, so restoring them is a single sorted run
+    std::string& rows = sections[OCCURRENCES].bytes;
+    const size_t count = occurrences.size();
+    rows.reserve(count * 17);
+    for (size_t i = 0; i < count; ++i) {
+        append<uint32_t>(rows, static_cast<uint32_t>(occurrences.start(i)));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        append<uint32_t>(rows, static_cast<uint32_t>(occurrences.length(i)));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        append<uint32_t>(rows, occurrences.stemId(i));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        append<uint32_t>(rows, occurrences.bzId(i));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        append<uint8_t>(rows, static_cast<uint8_t>(occurrences.kind(i)));
+    }
+    sections[OCCURRENCES].count = static_cast<uint32_t>(count);
+
+    for (const auto& [bz, words] : ctx.db.bzToOriginalWords) {
+        const uint32_t bzId = occurrences.findBz(bz);
+        if (bzId == OccurrenceTable::NO_ID) {
+            continue;
+        }
+        for (const auto& word : words) {
+            append<uint32_t>(sections[ORIGINAL_WORDS].bytes, bzId);
+            reference(sections[ORIGINAL_WORDS], word);
+            ++sections[ORIGINAL_WORDS].count;
+        }
+    }
+    for (const auto& [stem, word] : ctx.db.stemToFirstWord) {
+        const uint32_t stemId = occurrences.findStem(stem);
+        if (stemId == OccurrenceTable::NO_ID) {
+            continue;
+        }
+        append<uint32_t>(sections[FIRST_WORDS].bytes, stemId);
+        reference(sections[FIRST_WORDS], word);
+        ++sections[FIRST_WORDS].count;
+    }
+
+    stringSet(MULTI_WORD_STEMS, ctx.multiWordBaseStems);
+    stringSet(AUTO_DETECTED_STEMS, ctx.autoDetectedMultiWordStems);
+    stringSet(MANUAL_TOGGLES, ctx.manualMultiWordToggles);
+    stringSet(MANUALLY_DISABLED, ctx.manuallyDisabledMultiWord);
+    stringSet(CLEARED_ERRORS, ctx.clearedErrors);
+    stringSet(IGNORED_WORDS, ctx.ignoredWords);
+    // Anchors the last scan did not find in the text are dropped
+    const ClearedAnchors& anchors = ctx.clearedTextAnchors;
+    for (size_t i = 0; i < anchors.size(); ++i) {
+        if (!anchors.resolved(i)) {
+            continue;
+        }
+        const ClearedAnchors::Anchor& anchor = anchors.anchors()[i];
+        std::string& out = sections[CLEARED_ANCHORS].bytes;
+        append<uint64_t>(out, anchor.text);
+        append<uint64_t>(out, anchor.firstWord);
+        append<uint64_t>(out, anchor.before);
+        append<uint64_t>(out, anchor.after);
+        append<uint32_t>(out, anchor.length);
+        append<int32_t>(out, anchor.offset);
+        ++sections[CLEARED_ANCHORS].count;
+    }
+
+    auto errorList = [&](SectionId id, const ErrorPositions* errors) {
+        for (const auto& [start, end] : *errors) {
+            append<uint32_t>(sections[id].bytes, static_cast<uint32_t>(start));
+            append<uint32_t>(sections[id].bytes, static_cast<uint32_t>(end));
+        }
+        sections[id].count = static_cast<uint32_t>(errors->size());
+    };
+    if (detection) {
+        errorList(NO_NUMBER_ERRORS, detection->noNumber);
+        errorList(WRONG_TERM_BZ_ERRORS, detection->wrongTermBz);
+        errorList(WRONG_ARTICLE_ERRORS, detection->wrongArticle);
+        for (const auto& bz : *detection->conflictingBz) {
+            append<uint32_t>(sections[CONFLICTING_BZ].bytes, occurrences.findBz(bz));
+        }
+        sections[CONFLICTING_BZ].count = static_cast<uint32_t>(detection->conflictingBz->size());
+    } else {
+        // Absent rather than empty, so restoring runs detection
+        for (SectionId id : {NO_NUMBER_ERRORS, WRONG_TERM_BZ_ERRORS, WRONG_ARTICLE_ERRORS, CONFLICTING_BZ}) {
+            sections[id].written = false;
+        }
+    }
+
+    sections[STRINGS].bytes.assign(reinterpret_cast<const char*>(pool.data()), pool.size() * sizeof(wchar_t));
+    sections[STRINGS].count = static_cast<uint32_t>(pool.size());
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.wcharSize = sizeof(wchar_t);
+    header.language = german ? 0 : 1;
+    header.textHash = hashText(text);
+    header.textLength = text.size();
+    header.sectionCount = 0;
+    header.analyzerVersion = ANALYZER_VERSION;
+    for (uint32_t id = STRINGS; id < SECTION_COUNT; ++id) {
+        header.sectionCount += sections[id].written;
+    }
+
+    std::string head(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t offset = sizeof(Header) + header.sectionCount * sizeof(DirectoryEntry);
+    for (uint32_t id = STRINGS; id < SECTION_COUNT; ++id) {
+        if (!sections[id].written) {
+            continue;
+        }
+        offset = (offset + 7) & ~uint64_t(7);
+        const DirectoryEntry entry{id, sections[id].count, offset, sections[id].bytes.size()};
+        head.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        offset += sections[id].bytes.size();
+    }
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(head.data(), static_cast<std::streamsize>(head.size()));
+        size_t written = head.size();
+        for (uint32_t id = STRINGS; id < SECTION_COUNT; ++id) {
+            if (!sections[id].written) {
+                continue;
+            }
+            static const char PADDING[8] = {};
+            out.write(PADDING, static_cast<std::streamsize>(((written + 7) & ~size_t(7)) - written));
+            written = (written + 7) & ~size_t(7);
+            out.write(sections[id].bytes.data(), static_cast<std::streamsize>(sections[id].bytes.size()));
+            written += sections[id].bytes.size();
+        }
+        if (!out.flush()) {
+            throw std::runtime_error("session: cannot write " + temporary);
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        throw std::runtime_error("session: cannot replace " + path);
+    }
+}
+
+SessionFile::SessionFile(const std::string& path) : m_file(path) {
+    const char* data = m_file.data();
+    const size_t size = m_file.size();
+    if (size < sizeof(Header)) {
+        corrupt("file too small");
+    }
+    const Header header = load<Header>(data);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        corrupt("not a session file");
+    }
+    if (header.version != VERSION) {
+        corrupt("unsupported version " + std::to_string(header.version));
+    }
+    if (header.wcharSize != sizeof(wchar_t)) {
+        corrupt("saved on a platform with a different wchar_t");
+    }
+    if (header.sectionCount > (size - sizeof(Header)) / sizeof(DirectoryEntry)) {
+        corrupt("section directory out of range");
+    }
+    m_textHash = header.textHash;
+    m_textLength = static_cast<size_t>(header.textLength);
+    m_german = header.language == 0;
+    m_analyzerVersion = header.analyzerVersion;
+
+    // Bytes per element of each known section
+    static constexpr size_t STRIDE[SECTION_COUNT] = {
+        0, sizeof(wchar_t), 8, 8, 8, 17, 12, 12, 8, 8, 8, 8, 8, 40, 8, 8, 8, 4, 8};
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const auto entry = load<DirectoryEntry>(data + sizeof(Header) + i * sizeof(DirectoryEntry));
+        if (entry.offset > size || entry.bytes > size - entry.offset) {
+            corrupt("section " + std::to_string(entry.id) + " out of range");
+        }
+        if (entry.id == 0 || entry.id >= SECTION_COUNT) {
+            continue;  // Added by a later writer
+        }
+        if (entry.offset % 8 != 0 || entry.bytes != uint64_t(entry.count) * STRIDE[entry.id]) {
+            corrupt("section " + std::to_string(entry.id) + " has the wrong size");
+        }
+        m_sections[entry.id] = Span{data + entry.offset, entry.count};
+    }
+
+    m_pool = reinterpret_cast<const wchar_t*>(m_sections[STRINGS].data);
+    m_poolSize = m_sections[STRINGS].count;
+    validateStrings(m_sections[BZ_NAMES], 8, 0);
+    validateStrings(m_sections[STEM_PARTS], 8, 0);
+    validateStrings(m_sections[ORIGINAL_WORDS], 12, 4);
+    validateStrings(m_sections[FIRST_WORDS], 12, 4);
+    for (SectionId id : {MULTI_WORD_STEMS, AUTO_DETECTED_STEMS, MANUAL_TOGGLES, MANUALLY_DISABLED, CLEARED_ERRORS,
+                         IGNORED_WORDS}) {
+        validateStrings(m_sections[id], 8, 0);
+    }
+
+    const uint32_t bzCount = m_sections[BZ_NAMES].count;
+    const uint32_t stemCount = m_sections[STEMS].count;
+    for (uint32_t i = 0; i < stemCount; ++i) {
+        const auto first = load<uint32_t>(m_sections[STEMS].data + i * 8);
+        const auto parts = load<uint32_t>(m_sections[STEMS].data + i * 8 + 4);
+        if (first > m_sections[STEM_PARTS].count || parts > m_sections[STEM_PARTS].count - first) {
+            corrupt("stem parts out of range");
+        }
+    }
+
+    const Span rows = m_sections[OCCURRENCES];
+    const size_t n = rows.count;
+    for (size_t i = 0; i < n; ++i) {
+        const auto start = load<uint32_t>(rows.data + i * 4);
+        const auto length = load<uint32_t>(rows.data + (n + i) * 4);
+        if (start > m_textLength || length > m_textLength - start || (i > 0 && start < load<uint32_t>(rows.data + (i - 1) * 4)) ||
+            load<uint32_t>(rows.data + (2 * n + i) * 4) >= stemCount ||
+            load<uint32_t>(rows.data + (3 * n + i) * 4) >= bzCount || load<uint8_t>(rows.data + 16 * n + i) > 1) {
+            corrupt("occurrence " + std::to_string(i) + " out of range");
+        }
+    }
+    for (uint32_t i = 0; i < m_sections[ORIGINAL_WORDS].count; ++i) {
+        if (load<uint32_t>(m_sections[ORIGINAL_WORDS].data + i * 12) >= bzCount) {
+            corrupt("original word of an unknown number");
+        }
+    }
+    for (uint32_t i = 0; i < m_sections[FIRST_WORDS].count; ++i) {
+        if (load<uint32_t>(m_sections[FIRST_WORDS].data + i * 12) >= stemCount) {
+            corrupt("first word of an unknown stem");
+        }
+    }
+    for (SectionId id : {NO_NUMBER_ERRORS, WRONG_TERM_BZ_ERRORS, WRONG_ARTICLE_ERRORS}) {
+        for (uint32_t i = 0; i < m_sections[id].count; ++i) {
+            const auto start = load<uint32_t>(m_sections[id].data + i * 8);
+            const auto end = load<uint32_t>(m_sections[id].data + i * 8 + 4);
+            if (start > end || end > m_textLength) {
+                corrupt("error range out of range");
+            }
+        }
+    }
+    for (uint32_t i = 0; i < m_sections[CONFLICTING_BZ].count; ++i) {
+        if (load<uint32_t>(m_sections[CONFLICTING_BZ].data + i * 4) >= bzCount) {
+            corrupt("conflict on an unknown number");
+        }
+    }
+}
+
+void SessionFile::validateStrings(const Span& span, size_t stride, size_t referenceOffset) const {
+    for (uint32_t i = 0; i < span.count; ++i) {
+        const char* reference = span.data + i * stride + referenceOffset;
+        const auto offset = load<uint32_t>(reference);
+        const auto length = load<uint32_t>(reference + 4);
+        if (offset > m_poolSize || length > m_poolSize - offset) {
+            corrupt("string out of range");
+        }
+    }
+}
+
+std::wstring SessionFile::string(const char* reference) const {
+    return std::wstring(m_pool + load<uint32_t>(reference), load<uint32_t>(reference + 4));
+}
+
+bool SessionFile::matches(const std::wstring& text) const {
+    return m_analyzerVersion == ANALYZER_VERSION && text.size() == m_textLength && hashText(text) == m_textHash;
+}
+
+void SessionFile::restoreSet(SectionId id, std::unordered_set<std::wstring>& set) const {
+    set.clear();
+    for (uint32_t i = 0; i < m_sections[id].count; ++i) {
+        set.insert(string(m_sections[id].data + i * 8));
+    }
+}
+
+void SessionFile::restoreDecisions(AnalysisContext& ctx) const {
+    restoreSet(MANUAL_TOGGLES, ctx.manualMultiWordToggles);
+    restoreSet(MANUALLY_DISABLED, ctx.manuallyDisabledMultiWord);
+    restoreSet(CLEARED_ERRORS, ctx.clearedErrors);
+    restoreSet(IGNORED_WORDS, ctx.ignoredWords);
+    ctx.clearedTextAnchors.clear();
+    for (uint32_t i = 0; i < m_sections[CLEARED_ANCHORS].count; ++i) {
+        const char* row = m_sections[CLEARED_ANCHORS].data + i * 40;
+        ClearedAnchors::Anchor anchor;
+        anchor.text = load<uint64_t>(row);
+        anchor.firstWord = load<uint64_t>(row + 8);
+        anchor.before = load<uint64_t>(row + 16);
+        anchor.after = load<uint64_t>(row + 24);
+        anchor.length = load<uint32_t>(row + 32);
+        anchor.offset = load<int32_t>(row + 36);
+        ctx.clearedTextAnchors.addAnchor(anchor);
+    }
+}
+
+void SessionFile::restoreErrors(SectionId id, ErrorPositions& errors) const {
+    errors.clear();
+    errors.reserve(m_sections[id].count);
+    for (uint32_t i = 0; i < m_sections[id].count; ++i) {
+        const char* row = m_sections[id].data + i * 8;
+        errors.emplace_back(static_cast<int>(load<uint32_t>(row)), static_cast<int>(load<uint32_t>(row + 4)));
+    }
+}
+
+bool SessionFile::hasDetection() const {
+    // Present sections point into the mapping even when empty
+    for (SectionId id : {NO_NUMBER_ERRORS, WRONG_TERM_BZ_ERRORS, WRONG_ARTICLE_ERRORS, CONFLICTING_BZ}) {
+        if (m_sections[id].data == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SessionFile::restoreDetection(ErrorPositions& noNumber, ErrorPositions& wrongTermBz,
+                                   ErrorPositions& wrongArticle, std::vector<std::wstring>& conflictingBz) const {
+    restoreErrors(NO_NUMBER_ERRORS, noNumber);
+    restoreErrors(WRONG_TERM_BZ_ERRORS, wrongTermBz);
+    restoreErrors(WRONG_ARTICLE_ERRORS, wrongArticle);
+    conflictingBz.clear();
+    for (uint32_t i = 0; i < m_sections[CONFLICTING_BZ].count; ++i) {
+        const uint32_t bzId = load<uint32_t>(m_sections[CONFLICTING_BZ].data + i * 4);
+        conflictingBz.push_back(string(m_sections[BZ_NAMES].data + bzId * 8));
+    }
+}
+
+void SessionFile::restore(AnalysisContext& ctx) const {
+    BZ_TRACE_SCOPE("SessionFile::restore");
+    ctx.clearResults();
+    restoreDecisions(ctx);
+    restoreSet(MULTI_WORD_STEMS, ctx.multiWordBaseStems);
+    restoreSet(AUTO_DETECTED_STEMS, ctx.autoDetectedMultiWordStems);
+
+    ReferenceDatabase& db = ctx.db;
+    OccurrenceTable& occurrences = db.occurrences;
+    std::vector<std::wstring> bzNames;
+    bzNames.reserve(m_sections[BZ_NAMES].count);
+    for (uint32_t i = 0; i < m_sections[BZ_NAMES].count; ++i) {
+        bzNames.push_back(string(m_sections[BZ_NAMES].data + i * 8));
+        if (occurrences.internBz(bzNames.back()) != i) {
+            corrupt("duplicate reference number");
+        }
+    }
+    std::vector<StemVector> stems(m_sections[STEMS].count);
+    for (uint32_t i = 0; i < stems.size(); ++i) {
+        const auto first = load<uint32_t>(m_sections[STEMS].data + i * 8);
+        const auto parts = load<uint32_t>(m_sections[STEMS].data + i * 8 + 4);
+        for (uint32_t part = first; part < first + parts; ++part) {
+            stems[i].push_back(string(m_sections[STEM_PARTS].data + part * 8));
+        }
+        if (occurrences.internStem(stems[i]) != i) {
+            corrupt("duplicate stem");
+        }
+    }
+
+    // bzToStems and stemToBz hold exactly the (BZ, stem) pairs of the occurrences
+    const Span rows = m_sections[OCCURRENCES];
+    const size_t n = rows.count;
+    std::unordered_set<uint64_t> pairs;
+    for (size_t i = 0; i < n; ++i) {
+        const auto stemId = load<uint32_t>(rows.data + (2 * n + i) * 4);
+        const auto bzId = load<uint32_t>(rows.data + (3 * n + i) * 4);
+        occurrences.add(bzId, stemId, load<uint32_t>(rows.data + i * 4), load<uint32_t>(rows.data + (n + i) * 4),
+                        static_cast<OccurrenceKind>(load<uint8_t>(rows.data + 16 * n + i)));
+        if (pairs.insert((uint64_t(bzId) << 32) | stemId).second) {
+            db.bzToStems[bzNames[bzId]].insert(stems[stemId]);
+            db.stemToBz[stems[stemId]].insert(bzNames[bzId]);
+        }
+    }
+    db.finalize();
+
+    for (uint32_t i = 0; i < m_sections[ORIGINAL_WORDS].count; ++i) {
+        const char* row = m_sections[ORIGINAL_WORDS].data + i * 12;
+        db.bzToOriginalWords[bzNames[load<uint32_t>(row)]].insert(string(row + 4));
+    }
+    for (uint32_t i = 0; i < m_sections[FIRST_WORDS].count; ++i) {
+        const char* row = m_sections[FIRST_WORDS].data + i * 12;
+        db.stemToFirstWord[stems[load<uint32_t>(row)]] = string(row + 4);
+    }
+}
@@ -0,0 +1,124 @@
+#include "SnapshotListModel.h"
+#include <algorithm>
+
+SnapshotListModel::SnapshotListModel(View view, const wxIcon& check, const wxIcon& warning)
+    : wxDataViewVirtualListModel(0), m_view(view), m_check(check), m_warning(warning) {}
+
+size_t SnapshotListModel::setSnapshot(std::shared_ptr<const ListSnapshot> snapshot) {
+    // Shown already (a stale or repeated publish); its diff is against an older base
+    if (snapshot == m_snapshot) {
+        return 0;
+    }
+    const std::shared_ptr<const ListSnapshot> base = std::move(m_snapshot);
+    m_snapshot = std::move(snapshot);
+
+    // A diff from another base, or one touching most rows, is not worth replaying
+    const ListSnapshot::Diff* rows = diff();
+    if (!base || !rows || rows->baseGeneration != base->generation ||
+        rows->operations() > std::max<size_t>(MIN_RESET_OPERATIONS, rowCount() / 2)) {
+        // Only the row count; the control fetches visible cells on its next paint
+        Reset(rowCount());
+        return RESET;
+    }
+
+    size_t notifications = 0;
+    if (!rows->deleted.empty()) {
+        wxArrayInt deleted;
+        deleted.reserve(rows->deleted.size());
+        for (const unsigned int row : rows->deleted) {
+            deleted.push_back(static_cast<int>(row));
+        }
+        RowsDeleted(deleted);
+        notifications += rows->deleted.size();
+    }
+    for (const unsigned int row : rows->inserted) {
+        RowInserted(row);
+        ++notifications;
+    }
+    // Per cell, so a new icon or BZ list is redrawn in place
+    for (const auto& [baseRow, row] : rows->changed) {
+        for (unsigned int col = 0; col < GetColumnCount(); ++col) {
+            if (cellDiffers(*base, baseRow, row, col)) {
+                RowValueChanged(row, col);
+                ++notifications;
+            }
+        }
+    }
+    return notifications;
+}
+
+const ListSnapshot::Diff* SnapshotListModel::diff() const {
+    if (!m_snapshot) {
+        return nullptr;
+    }
+    return m_view == View::TermToBzs ? &m_snapshot->termDiff : &m_snapshot->bzDiff;
+}
+
+bool SnapshotListModel::cellDiffers(const ListSnapshot& base, unsigned int baseRow, unsigned int row,
+                                    unsigned int col) const {
+    if (m_view == View::TermToBzs) {
+        const ListSnapshot::TermRow& before = base.termRows[baseRow];
+        const ListSnapshot::TermRow& after = m_snapshot->termRows[row];
+        return col == 0 ? before.term != after.term || before.flagged != after.flagged
+                        : before.bzText != after.bzText;
+    }
+    const ListSnapshot::BzRow& before = base.bzRows[baseRow];
+    const ListSnapshot::BzRow& after = m_snapshot->bzRows[row];
+    if (m_view == View::ReferenceSigns) {
+        return col == 0 ? before.bz != after.bz : before.firstTerm != after.firstTerm;
+    }
+    return col == 0 ? before.bz != after.bz || before.flagged != after.flagged : before.terms != after.terms;
+}
+
+unsigned int SnapshotListModel::rowCount() const {
+    if (!m_snapshot) {
+        return 0;
+    }
+    return static_cast<unsigned int>(m_view == View::TermToBzs ? m_snapshot->termRows.size()
+                                                               : m_snapshot->bzRows.size());
+}
+
+const ListSnapshot::BzRow* SnapshotListModel::bzRow(unsigned int row) const {
+    if (!m_snapshot || m_view == View::TermToBzs || row >= m_snapshot->bzRows.size()) {
+        return nullptr;
+    }
+    return &m_snapshot->bzRows[row];
+}
+
+const ListSnapshot::TermRow* SnapshotListModel::termRow(unsigned int row) const {
+    if (!m_snapshot || m_view != View::TermToBzs || row >= m_snapshot->termRows.size()) {
+        return nullptr;
+    }
+    return &m_snapshot->termRows[row];
+}
+
+wxString SnapshotListModel::GetColumnType(unsigned int col) const {
+    return col == 0 && m_view != View::ReferenceSigns ? "wxDataViewIconText" : "string";
+}
+
+void SnapshotListModel::GetValueByRow(wxVariant& variant, unsigned int row, unsigned int col) const {
+    if (const ListSnapshot::BzRow* bz = bzRow(row)) {
+        if (m_view == View::ReferenceSigns) {
+            variant = col == 0 ? wxString(bz->bz) : wxString(bz->firstTerm);
+        } else if (col == 0) {
+            variant << wxDataViewIconText(bz->bz, bz->flagged ? m_warning : m_check);
+        } else {
+            variant = wxString(bz->terms);
+        }
+    } else if (const ListSnapshot::TermRow* term = termRow(row)) {
+        if (col == 0) {
+            variant << wxDataViewIconText(term->term, term->flagged ? m_warning : m_check);
+        } else {
+            variant = wxString(term->bzText);
+        }
+    } else if (GetColumnType(col) == "wxDataViewIconText") {
+        variant << wxDataViewIconText();
+    } else {
+        variant = wxString();
+    }
+}
+
+bool SnapshotListModel::SetValueByRow(const wxVariant&, unsigned int, unsigned int) {
+    // Read-only: the lists change only with a new scan
+    return false;
+}
@@ -1,14 +1,14 @@
 #include "TextAnalyzer.h"
-#include <cwctype>
+#include "CharClass.h"
 
-std::pair<std::wstring, size_t> TextAnalyzer::findPrecedingWord(const std::wstring& text, size_t pos) const {
+std::pair<std::wstring_view, size_t> TextAnalyzer::findPrecedingWord(const std::wstring& text, size_t pos) const {
     if (pos == 0) {
         return {L"", 0};
     }
 
     // Skip whitespace backwards
     size_t end = pos;
-    while (end > 0 && std::iswspace(text[end - 1])) {
+    while (end > 0 && CharClass::isSpace(text[end - 1])) {
         --end;
     }
 
@@ -18,7 +18,7 @@ std::pair<std::wstring, size_t> TextAnalyzer::findPrecedingWord(const std::wstri
 
     // Find the start of the word
     size_t start = end;
-    while (start > 0 && std::iswalpha(text[start - 1])) {
+    while (start > 0 && CharClass::isLetter(text[start - 1])) {
         --start;
     }
 
@@ -26,5 +26,5 @@ std::pair<std::wstring, size_t> TextAnalyzer::findPrecedingWord(const std::wstri
         return {L"", 0};
     }
 
-    return {text.substr(start, end - start), start};
+    return {std::wstring_view(text).substr(start, end - start), start};
 }
@@ -0,0 +1,255 @@
+#include "TextDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t REPLACEMENT = 0xFFFD;
+constexpr int INCOMPLETE = -1;
+
+/**
+ * Decode one UTF-8 sequence at p. Returns the bytes consumed (invalid input
+ * consumes one byte and yields U+FFFD) or INCOMPLETE if the available bytes
+ * are a valid prefix of a longer sequence.
+ */
+int decodeUtf8Sequence(const uint8_t* p, size_t available, uint32_t& code) {
+    const uint8_t lead = p[0];
+    if (lead < 0x80) {
+        code = lead;
+        return 1;
+    }
+
+    int length = 0;
+    uint32_t minimum = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        minimum = 0x80;
+        code = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        minimum = 0x800;
+        code = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        minimum = 0x10000;
+        code = lead & 0x07;
+    } else {
+        code = REPLACEMENT;
+        return 1;
+    }
+
+    for (int i = 1; i < length; ++i) {
+        if (static_cast<size_t>(i) >= available) {
+            return INCOMPLETE;
+        }
+        if ((p[i] & 0xC0) != 0x80) {
+            code = REPLACEMENT;
+            return 1;
+        }
+        code = (code << 6) | (p[i] & 0x3F);
+    }
+
+    // Overlong forms, surrogates and values outside Unicode
+    if (code < minimum || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+        code = REPLACEMENT;
+        return 1;
+    }
+    return length;
+}
+
+void append(uint32_t code, std::wstring& out) {
+    if constexpr (sizeof(wchar_t) == 2) {
+        if (code > 0xFFFF) {
+            code -= 0x10000;
+            out += static_cast<wchar_t>(0xD800 + (code >> 10));
+            out += static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+            return;
+        }
+    }
+    out += static_cast<wchar_t>(code);
+}
+
+} // namespace
+
+TextDecoder::Detection TextDecoder::detect(const char* data, size_t size) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    if (size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        return {Encoding::UTF8, 3};
+    }
+    if (size >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE) {
+        return {Encoding::UTF16LE, 2};
+    }
+    if (size >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF) {
+        return {Encoding::UTF16BE, 2};
+    }
+
+    // UTF-16 without BOM: Latin text has a NUL in (nearly) every code unit
+    const size_t sample = std::min<size_t>(size, 4096) & ~size_t(1);
+    if (sample >= 2) {
+        size_t evenZeros = 0;
+        size_t oddZeros = 0;
+        for (size_t i = 0; i < sample; i += 2) {
+            evenZeros += bytes[i] == 0;
+            oddZeros += bytes[i + 1] == 0;
+        }
+        const size_t units = sample / 2;
+        if (oddZeros * 10 >= units * 4 && evenZeros * 20 < units) {
+            return {Encoding::UTF16LE, 0};
+        }
+        if (evenZeros * 10 >= units * 4 && oddZeros * 20 < units) {
+            return {Encoding::UTF16BE, 0};
+        }
+    }
+
+    for (size_t i = 0; i < size;) {
+        uint32_t code = 0;
+        const int consumed = decodeUtf8Sequence(bytes + i, size - i, code);
+        if (consumed == INCOMPLETE) {
+            break;  // Truncated last character; the rest was valid
+        }
+        if (code == REPLACEMENT && consumed == 1 && bytes[i] >= 0x80) {
+            return {Encoding::LATIN1, 0};
+        }
+        i += static_cast<size_t>(consumed);
+    }
+    return {Encoding::UTF8, 0};
+}
+
+const char* TextDecoder::name(Encoding encoding) {
+    switch (encoding) {
+    case Encoding::UTF8:
+        return "UTF-8";
+    case Encoding::UTF16LE:
+        return "UTF-16LE";
+    case Encoding::UTF16BE:
+        return "UTF-16BE";
+    case Encoding::LATIN1:
+        return "Latin-1";
+    }
+    return "?";
+}
+
+void TextDecoder::decode(const char* data, size_t size, bool last, std::wstring& out) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    switch (m_encoding) {
+    case Encoding::UTF8:
+        decodeUtf8(bytes, size, last, out);
+        break;
+    case Encoding::UTF16LE:
+    case Encoding::UTF16BE:
+        decodeUtf16(bytes, size, last, out);
+        break;
+    case Encoding::LATIN1:
+        for (size_t i = 0; i < size; ++i) {
+            out += static_cast<wchar_t>(bytes[i]);
+        }
+        break;
+    }
+}
+
+void TextDecoder::decodeUtf8(const uint8_t* data, size_t size, bool last, std::wstring& out) {
+    size_t i = 0;
+
+    // Finish the sequence split off the previous chunk
+    while (m_pendingSize > 0) {
+        uint8_t buffer[4];
+        std::memcpy(buffer, m_pending, m_pendingSize);
+        const size_t taken = std::min(sizeof(buffer) - m_pendingSize, size - i);
+        std::memcpy(buffer + m_pendingSize, data + i, taken);
+
+        uint32_t code = 0;
+        const int consumed = decodeUtf8Sequence(buffer, m_pendingSize + taken, code);
+        if (consumed == INCOMPLETE) {
+            if (!last) {
+                std::memcpy(m_pending + m_pendingSize, data + i, taken);
+                m_pendingSize += taken;
+                return;
+            }
+            out += static_cast<wchar_t>(REPLACEMENT);
+            m_pendingSize = 0;
+            i += taken;
+            break;
+        }
+
+        append(code, out);
+        if (static_cast<size_t>(consumed) >= m_pendingSize) {
+            i += static_cast<size_t>(consumed) - m_pendingSize;
+            m_pendingSize = 0;
+        } else {
+            // Invalid lead byte: retry with the remaining pending bytes
+            m_pendingSize -= static_cast<size_t>(consumed);
+            std::memmove(m_pending, m_pending + consumed, m_pendingSize);
+        }
+    }
+
+    while (i < size) {
+        if (data[i] < 0x80) {
+            out += static_cast<wchar_t>(data[i++]);
+            continue;
+        }
+        uint32_t code = 0;
+        const int consumed = decodeUtf8Sequence(data + i, size - i, code);
+        if (consumed == INCOMPLETE) {
+            if (last) {
+                out += static_cast<wchar_t>(REPLACEMENT);
+            } else {
+                m_pendingSize = size - i;
+                std::memcpy(m_pending, data + i, m_pendingSize);
+            }
+            return;
+        }
+        append(code, out);
+        i += static_cast<size_t>(consumed);
+    }
+}
+
+void TextDecoder::decodeUtf16(const uint8_t* data, size_t size, bool last, std::wstring& out) {
+    const bool littleEndian = m_encoding == Encoding::UTF16LE;
+
+    auto handleUnit = [&](uint32_t unit) {
+        if (m_highSurrogate != 0) {
+            if (unit >= 0xDC00 && unit <= 0xDFFF) {
+                append(0x10000 + ((m_highSurrogate - 0xD800) << 10) + (unit - 0xDC00), out);
+                m_highSurrogate = 0;
+                return;
+            }
+            out += static_cast<wchar_t>(REPLACEMENT);
+            m_highSurrogate = 0;
+        }
+        if (unit >= 0xD800 && unit <= 0xDBFF) {
+            m_highSurrogate = unit;
+        } else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+            out += static_cast<wchar_t>(REPLACEMENT);
+        } else {
+            out += static_cast<wchar_t>(unit);
+        }
+    };
+    auto unitAt = [&](uint8_t first, uint8_t second) -> uint32_t {
+        return littleEndian ? (first | (second << 8)) : ((first << 8) | second);
+    };
+
+    size_t i = 0;
+    if (m_pendingSize == 1 && size > 0) {
+        handleUnit(unitAt(m_pending[0], data[0]));
+        m_pendingSize = 0;
+        i = 1;
+    }
+    for (; i + 1 < size; i += 2) {
+        handleUnit(unitAt(data[i], data[i + 1]));
+    }
+    if (i < size) {
+        m_pending[0] = data[i];
+        m_pendingSize = 1;
+    }
+
+    if (last) {
+        if (m_highSurrogate != 0) {
+            out += static_cast<wchar_t>(REPLACEMENT);
+        }
+        if (m_pendingSize > 0) {
+            out += static_cast<wchar_t>(REPLACEMENT);
+        }
+        m_pendingSize = 0;
+        m_highSurrogate = 0;
+    }
+}
@@ -2,54 +2,105 @@
 #include "GermanTextAnalyzer.h"
 #include "EnglishTextAnalyzer.h"
 #include "MainWindow.h"
-#include "TimerHelper.h"
-#include <iostream>
+#include "Trace.h"
+#include "Metrics.h"
+#include <algorithm>
 
 void TextScanner::scanText(
     const std::wstring& fullText,
     TextAnalyzer& analyzer,
     const re2::RE2& singleWordRegex,
     const re2::RE2& twoWordRegex,
-    AnalysisContext& ctx
+    AnalysisContext& ctx,
+    std::span<const uint32_t> paragraphStarts
 ) {
+    static Metrics::Counter& twoWordMatches = Metrics::counter(
+        "bz_regex_matches_total", "Regex matches seen per scan pattern", "pattern=\"two_word\"");
+    static Metrics::Counter& twoWordTerms = Metrics::counter(
+        "bz_terms_recorded_total", "Matches recorded as term occurrences per scan pattern",
+        "pattern=\"two_word\"");
+    static Metrics::Counter& singleWordMatches = Metrics::counter(
+        "bz_regex_matches_total", "Regex matches seen per scan pattern", "pattern=\"single_word\"");
+    static Metrics::Counter& singleWordTerms = Metrics::counter(
+        "bz_terms_recorded_total", "Matches recorded as term occurrences per scan pattern",
+        "pattern=\"single_word\"");
+    static Metrics::Counter& overlapCounter = Metrics::counter(
+        "bz_overlap_rejections_total", "Matches dropped because they overlap an earlier match");
+    static Metrics::Counter& ignoredCounter = Metrics::counter(
+        "bz_ignored_word_skips_total", "Single-word matches skipped as articles or stop words");
+
+    // Cleared errors follow the text they were cleared on, wherever it moved
+    ctx.clearedTextAnchors.resolve(fullText);
+
     // Track matched positions to avoid duplicate processing
-    std::vector<std::pair<size_t, size_t>> matchedRanges;
+    std::pmr::vector<std::pair<size_t, size_t>> matchedRanges(ctx.arena.resource());
+
+    // Counted locally and published once, keeping atomics out of the loops
+    PassCounts twoWord;
+    PassCounts singleWord;
+
+    // Both passes per paragraph; the first paragraph also takes any text before it
+    BZ_TRACE_SCOPE("TextScanner::scanParagraphs");
+    const std::wstring_view text(fullText);
+    const size_t paragraphs = std::max<size_t>(paragraphStarts.size(), 1);
+    for (size_t i = 0; i < paragraphs; ++i) {
+        const size_t start = i == 0 ? 0 : std::min<size_t>(paragraphStarts[i], text.size());
+        const size_t end = i + 1 < paragraphs ? std::min<size_t>(paragraphStarts[i + 1], text.size()) : text.size();
+        if (end <= start) {
+            continue;
+        }
+        const std::wstring_view paragraph = text.substr(start, end - start);
+        matchedRanges.clear();
+
+        // First pass: scan for two-word patterns
+        scanTwoWordPatterns(paragraph, start, analyzer, twoWordRegex, ctx, matchedRanges, twoWord);
+
+        // Second pass: scan for single-word patterns
+        scanSingleWordPatterns(paragraph, start, analyzer, singleWordRegex, ctx, matchedRanges, singleWord);
+    }
 
-    // First pass: scan for two-word patterns
-    Timer t_twoWordScan;
-    scanTwoWordPatterns(fullText, analyzer, twoWordRegex, ctx, matchedRanges);
-    std::cout << "Time for two word scan: " << t_twoWordScan.elapsed() << " milliseconds\n";
+    twoWordMatches.add(twoWord.matches);
+    twoWordTerms.add(twoWord.recorded);
+    singleWordMatches.add(singleWord.matches);
+    singleWordTerms.add(singleWord.recorded);
+    overlapCounter.add(twoWord.overlaps + singleWord.overlaps);
+    ignoredCounter.add(singleWord.ignored);
 
-    // Second pass: scan for single-word patterns
-    Timer t_oneWordScan;
-    scanSingleWordPatterns(fullText, analyzer, singleWordRegex, ctx, matchedRanges);
-    std::cout << "Time for one word scan: " << t_oneWordScan.elapsed() << " milliseconds\n";
+    // Merge both passes into document order and build the per-BZ/per-stem indexes
+    BZ_TRACE_SCOPE("ReferenceDatabase::finalize");
+    ctx.db.finalize();
 }
 
 void TextScanner::scanTwoWordPatterns(
-    const std::wstring& fullText,
+    std::wstring_view paragraph,
+    size_t offset,
     TextAnalyzer& analyzer,
     const re2::RE2& twoWordRegex,
     AnalysisContext& ctx,
-    std::vector<std::pair<size_t, size_t>>& matchedRanges
+    std::pmr::vector<std::pair<size_t, size_t>>& matchedRanges,
+    PassCounts& counts
 ) {
-    RE2RegexHelper::MatchIterator iter(fullText, twoWordRegex);
+    RE2RegexHelper::MatchIterator iter(paragraph, twoWordRegex);
 
     while (iter.hasNext()) {
         auto match = iter.next();
-        size_t pos = match.position;
+        ++counts.matches;
+        size_t pos = offset + match.position;
         size_t len = match.length;
         size_t endPos = pos + len;
 
-        std::wstring word1 = match[1];
-        std::wstring word2 = match[2];
-        std::wstring bz = match[3];
-
-        // Check if word2's stem is marked for multi-word matching
-        if (analyzer.isMultiWordBase(word2, ctx.multiWordBaseStems)) {
-            if (!overlapsExisting(matchedRanges, pos, endPos) &&
-                !ctx.clearedTextPositions.count({pos, endPos})) {
+        // Check if word2's stem is marked for multi-word matching; most
+        // matches are not, so the other strings are only built on a hit
+        if (analyzer.isMultiWordBase(std::wstring(match[2]), ctx.multiWordBaseStems)) {
+            if (overlapsExisting(matchedRanges, pos, endPos)) {
+                ++counts.overlaps;
+            } else if (!ctx.clearedTextAnchors.contains(pos, endPos)) {
                 matchedRanges.emplace_back(pos, endPos);
+                ++counts.recorded;
+
+                std::wstring word1(match[1]);
+                std::wstring word2(match[2]);
+                std::wstring bz(match[3]);
 
                 // Build original phrase first (before moving words)
                 std::wstring originalPhrase;
@@ -66,38 +117,43 @@ void TextScanner::scanTwoWordPatterns(
                 ctx.db.bzToOriginalWords[bz].insert(originalPhrase);
 
                 // Track positions
-                ctx.db.bzToPositions[bz].push_back({pos, len});
-                ctx.db.stemToPositions[stemVec].push_back({pos, len});
+                ctx.db.addOccurrence(bz, stemVec, pos, len, OccurrenceKind::MULTI_WORD);
             }
         }
     }
 }
 
 void TextScanner::scanSingleWordPatterns(
-    const std::wstring& fullText,
+    std::wstring_view paragraph,
+    size_t offset,
     TextAnalyzer& analyzer,
     const re2::RE2& singleWordRegex,
     AnalysisContext& ctx,
-    std::vector<std::pair<size_t, size_t>>& matchedRanges
+    std::pmr::vector<std::pair<size_t, size_t>>& matchedRanges,
+    PassCounts& counts
 ) {
-    RE2RegexHelper::MatchIterator iter(fullText, singleWordRegex);
+    RE2RegexHelper::MatchIterator iter(paragraph, singleWordRegex);
 
     while (iter.hasNext()) {
         auto match = iter.next();
+        ++counts.matches;
         if (analyzer.isIgnoredWord(match[1])) {
+            ++counts.ignored;
             continue; // Skip ignored words
         }
-        size_t pos = match.position;
+        size_t pos = offset + match.position;
         size_t len = match.length;
         size_t endPos = pos + len;
 
-        if (!overlapsExisting(matchedRanges, pos, endPos) &&
-            !ctx.clearedTextPositions.count({pos, endPos})) {
+        if (overlapsExisting(matchedRanges, pos, endPos)) {
+            ++counts.overlaps;
+        } else if (!ctx.clearedTextAnchors.contains(pos, endPos)) {
             matchedRanges.emplace_back(pos, endPos);
+            ++counts.recorded;
 
-            std::wstring word = match[1];
+            std::wstring word(match[1]);
             std::wstring originalWord = word;  // Keep copy for storage
-            std::wstring bz = match[2];
+            std::wstring bz(match[2]);
 
             // Create single-element stem vector
             StemVector stemVec = analyzer.createStemVector(std::move(word));
@@ -108,14 +164,13 @@ void TextScanner::scanSingleWordPatterns(
             ctx.db.bzToOriginalWords[bz].insert(std::move(originalWord));
 
             // Track positions
-            ctx.db.bzToPositions[bz].push_back({pos, len});
-            ctx.db.stemToPositions[stemVec].push_back({pos, len});
+            ctx.db.addOccurrence(bz, stemVec, pos, len, OccurrenceKind::SINGLE_WORD);
         }
     }
 }
 
 bool TextScanner::overlapsExisting(
-    const std::vector<std::pair<size_t, size_t>>& matchedRanges,
+    const std::pmr::vector<std::pair<size_t, size_t>>& matchedRanges,
     size_t start,
     size_t end
 ) {
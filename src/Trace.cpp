@@ -0,0 +1,252 @@
+#include "Trace.h"
+#include "JsonEscape.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace Trace {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point g_epoch = Clock::now();
+std::atomic<bool> g_enabled{false};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_epoch).count();
+}
+
+// Fields are atomics so snapshot() may read while the owner thread writes
+struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint8_t> phase{0};
+    std::atomic<int64_t> startNs{0};
+    std::atomic<int64_t> value{0};
+};
+
+/**
+ * Single-producer ring: only the owning thread advances head. Readers copy
+ * slots and then re-read head to discard anything overwritten meanwhile.
+ */
+struct ThreadBuffer {
+    uint32_t id = 0;
+    std::string name;  // Guarded by Registry::mutex
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> clearedUpTo{0};
+    std::unique_ptr<Slot[]> slots{new Slot[RING_CAPACITY]};
+
+    void push(const char* eventName, Phase eventPhase, int64_t start, int64_t eventValue) {
+        const uint64_t index = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[index % RING_CAPACITY];
+        // Pairs with the acquire fence in collect(): a reader that sees any of
+        // these stores also sees head == index, and so drops the lapped slot
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(eventName, std::memory_order_relaxed);
+        slot.phase.store(static_cast<uint8_t>(eventPhase), std::memory_order_relaxed);
+        slot.startNs.store(start, std::memory_order_relaxed);
+        slot.value.store(eventValue, std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    void collect(std::vector<Event>& out) const {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t begin = std::max(clearedUpTo.load(std::memory_order_relaxed),
+                                  end > RING_CAPACITY ? end - RING_CAPACITY : 0);
+
+        std::vector<Event> copied;
+        copied.reserve(end - begin);
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot& slot = slots[i % RING_CAPACITY];
+            copied.push_back({slot.name.load(std::memory_order_relaxed), id,
+                              static_cast<Phase>(slot.phase.load(std::memory_order_relaxed)),
+                              slot.startNs.load(std::memory_order_relaxed),
+                              slot.value.load(std::memory_order_relaxed)});
+        }
+
+        // The writer may have lapped us; slots below (head - capacity) are torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = head.load(std::memory_order_relaxed);
+        const uint64_t firstValid = after > RING_CAPACITY ? after - RING_CAPACITY + 1 : 0;
+        for (uint64_t i = std::max(begin, firstValid); i < end; ++i) {
+            out.push_back(copied[i - begin]);
+        }
+    }
+};
+
+// Buffers outlive their threads; a finished thread's buffer (and ID) is
+// handed to the next new thread, so per-scan worker threads share one lane
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> retired;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadHolder {
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadHolder() {
+        if (buffer) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.retired.push_back(buffer);
+        }
+    }
+
+    ThreadBuffer& get() {
+        if (!buffer) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.retired.empty()) {
+                buffer = reg.retired.back();
+                reg.retired.pop_back();
+            } else {
+                auto created = std::make_shared<ThreadBuffer>();
+                created->id = static_cast<uint32_t>(reg.buffers.size() + 1);
+                buffer = created.get();
+                reg.buffers.push_back(std::move(created));
+            }
+        }
+        return *buffer;
+    }
+};
+
+thread_local ThreadHolder t_holder;
+
+} // namespace
+
+void setEnabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void setThreadName(const char* name) {
+    ThreadBuffer& buffer = t_holder.get();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+uint32_t currentThreadId() {
+    return t_holder.get().id;
+}
+
+void counter(const char* name, int64_t value) {
+    if (isEnabled()) {
+        t_holder.get().push(name, Phase::COUNTER, nowNs(), value);
+    }
+}
+
+void instant(const char* name) {
+    if (isEnabled()) {
+        t_holder.get().push(name, Phase::INSTANT, nowNs(), 0);
+    }
+}
+
+Span::Span(const char* name) : m_name(nullptr), m_startNs(0) {
+    if (isEnabled()) {
+        m_name = name;
+        m_startNs = nowNs();
+    }
+}
+
+Span::~Span() {
+    if (m_name) {
+        const int64_t end = nowNs();
+        t_holder.get().push(m_name, Phase::SPAN, m_startNs, end - m_startNs);
+    }
+}
+
+std::vector<Event> snapshot() {
+    std::vector<Event> events;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& buffer : reg.buffers) {
+            buffer->collect(events);
+        }
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.startNs < b.startNs; });
+    return events;
+}
+
+void clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        buffer->clearedUpTo.store(buffer->head.load(std::memory_order_acquire),
+                                  std::memory_order_relaxed);
+    }
+}
+
+void writeChromeJson(std::ostream& out) {
+    const std::vector<Event> events = snapshot();
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& buffer : reg.buffers) {
+            if (buffer->name.empty()) {
+                continue;
+            }
+            separator();
+            out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->id
+                << ", \"args\": {\"name\": ";
+            JsonEscape::write(out, std::string_view(buffer->name));
+            out << "}}";
+        }
+    }
+
+    // trace_event timestamps are microseconds
+    char timestamp[32];
+    for (const Event& event : events) {
+        separator();
+        std::snprintf(timestamp, sizeof(timestamp), "%.3f", event.startNs / 1000.0);
+        out << "{\"name\": ";
+        JsonEscape::write(out, std::string_view(event.name));
+        out << ", \"cat\": \"bz\", \"pid\": 1, \"tid\": " << event.threadId << ", \"ts\": " << timestamp;
+
+        switch (event.phase) {
+        case Phase::SPAN:
+            std::snprintf(timestamp, sizeof(timestamp), "%.3f", event.value / 1000.0);
+            out << ", \"ph\": \"X\", \"dur\": " << timestamp << "}";
+            break;
+        case Phase::COUNTER:
+            out << ", \"ph\": \"C\", \"args\": {\"value\": " << event.value << "}}";
+            break;
+        case Phase::INSTANT:
+            out << ", \"ph\": \"i\", \"s\": \"t\"}";
+            break;
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool writeChromeJson(const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    writeChromeJson(out);
+    return static_cast<bool>(out);
+}
+
+} // namespace Trace
@@ -24,15 +24,19 @@ UIBuilder::UIComponents UIBuilder::buildUI(wxFrame* parent) {
 
     // Main text editor
     components.textBox = new wxRichTextCtrl(panel);
-    components.bzList = std::make_shared<wxRichTextCtrl>(
-        components.notebookList, wxID_ANY, wxEmptyString,
-        wxDefaultPosition, wxSize(350, -1));
 
-    // Tree list for term -> BZ inverse mapping
-    components.termList = std::make_shared<wxTreeListCtrl>(
+    // Reference sign list: BZ and its first spelling
+    components.bzList = std::make_shared<wxDataViewCtrl>(
+        components.notebookList, wxID_ANY, wxDefaultPosition, wxSize(350, -1),
+        wxDV_MULTIPLE | wxDV_ROW_LINES);
+    components.bzList->AppendTextColumn("reference sign", 0);
+    components.bzList->AppendTextColumn("feature", 1);
+
+    // Term -> BZ inverse mapping
+    components.termList = std::make_shared<wxDataViewCtrl>(
         components.notebookList, wxID_ANY, wxDefaultPosition, wxDefaultSize);
-    components.termList->AppendColumn("feature");
-    components.termList->AppendColumn("reference signs");
+    components.termList->AppendIconTextColumn("feature", 0);
+    components.termList->AppendTextColumn("reference signs", 1);
 
     wxBoxSizer *mainSizer = new wxBoxSizer(wxVERTICAL);
     mainSizer->Add(viewSizer, 1, wxEXPAND);
@@ -41,11 +45,11 @@ UIBuilder::UIComponents UIBuilder::buildUI(wxFrame* parent) {
     viewSizer->Add(components.textBox, 2, wxEXPAND | wxALL, 10);
     viewSizer->Add(outputSizer, 1, wxEXPAND, 10);
 
-    // Tree list for displaying BZ-term mappings
-    components.treeList = std::make_shared<wxTreeListCtrl>(
+    // BZ -> term mappings
+    components.treeList = std::make_shared<wxDataViewCtrl>(
         components.notebookList, wxID_ANY, wxDefaultPosition, wxDefaultSize);
-    components.treeList->AppendColumn("reference sign");
-    components.treeList->AppendColumn("features");
+    components.treeList->AppendIconTextColumn("reference sign", 0);
+    components.treeList->AppendTextColumn("features", 1);
 
     outputSizer->Add(components.notebookList, 3, wxEXPAND | wxALL, 10);
     components.notebookList->AddPage(components.treeList.get(), "BZ -> feature");
@@ -96,11 +100,24 @@ UIBuilder::UIComponents UIBuilder::buildUI(wxFrame* parent) {
 
 void UIBuilder::createMenuBar(wxFrame* parent) {
     wxMenuBar *menuBar = new wxMenuBar();
+
+    wxMenu *fileMenu = new wxMenu();
+    fileMenu->Append(wxID_OPEN, "&Open...\tCtrl+O", "Load a UTF-8, UTF-16 or Latin-1 text file");
+    fileMenu->Append(wxID_HIGHEST + 25, "&Export report...\tCtrl+E",
+                     "Save reference numbers and errors as JSON, CSV or SARIF");
+    fileMenu->Append(wxID_HIGHEST + 26, "Save &session\tCtrl+S",
+                     "Keep the results and cleared errors next to the document for the next time it is opened");
+    menuBar->Append(fileMenu, "&File");
+
     wxMenu *toolsMenu = new wxMenu();
 
     toolsMenu->Append(wxID_HIGHEST + 20, "Restore all errors");
     toolsMenu->Append(wxID_HIGHEST + 21, "Restore cleared textbox errors");
     toolsMenu->Append(wxID_HIGHEST + 22, "Restore cleared overview errors");
+    toolsMenu->Append(wxID_HIGHEST + 27, "Restore ignored words");
+    toolsMenu->AppendSeparator();
+    toolsMenu->Append(wxID_HIGHEST + 23, "Scan statistics...");
+    toolsMenu->Append(wxID_HIGHEST + 24, "Memory report...");
 
     menuBar->Append(toolsMenu, "Tools");
     parent->SetMenuBar(menuBar);
@@ -0,0 +1,349 @@
+#include "XmlReader.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+// Smallest piece of new input appended to an unfinished token at a time
+constexpr size_t COMPLETION_PIECE = 4096;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && isSpace(s.front())) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && isSpace(s.back())) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+void appendUtf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Position of the '>' closing a DOCTYPE, skipping the internal subset and quotes
+size_t findDoctypeEnd(std::string_view s) {
+    int depth = 0;
+    char quote = 0;
+    for (size_t i = 2; i < s.size(); ++i) {
+        const char c = s[i];
+        if (quote) {
+            quote = c == quote ? 0 : quote;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']') {
+            --depth;
+        } else if (c == '>' && depth <= 0) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Position of the '>' closing a start tag, skipping quoted attribute values
+size_t findTagEnd(std::string_view s) {
+    char quote = 0;
+    for (size_t i = 1; i < s.size(); ++i) {
+        const char c = s[i];
+        if (quote) {
+            quote = c == quote ? 0 : quote;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+[[noreturn]] void malformed(const char* what) {
+    throw std::runtime_error(std::string("XML: ") + what);
+}
+
+} // namespace
+
+void XmlReader::feed(const char* data, size_t size) {
+    // Complete the token left over from the last call, appending only about as much as it
+    // needs; pieces grow with the token so a long CDATA section is not rescanned quadratically
+    size_t offset = 0;
+    while (!m_pending.empty() && offset < size) {
+        const size_t before = m_pending.size();
+        const size_t piece = std::min(std::max(COMPLETION_PIECE, before), size - offset);
+        m_pending.append(data + offset, piece);
+        offset += piece;
+        const size_t used = parse(m_pending, false);
+        if (used >= before) {
+            offset -= m_pending.size() - used;  // Continue on the caller's buffer
+            m_pending.clear();
+        } else {
+            m_pending.erase(0, used);
+        }
+    }
+
+    if (offset < size) {
+        const std::string_view input(data + offset, size - offset);
+        const size_t used = parse(input, false);
+        m_pending.assign(input.substr(used));
+    }
+}
+
+void XmlReader::finish() {
+    const size_t used = parse(m_pending, true);
+    m_pending.erase(0, used);
+    if (!m_pending.empty()) {
+        malformed("unexpected end of document");
+    }
+}
+
+std::string_view XmlReader::localName(std::string_view name) {
+    const size_t colon = name.find(':');
+    return colon == std::string_view::npos ? name : name.substr(colon + 1);
+}
+
+const std::string* XmlReader::attribute(const Attributes& attributes, std::string_view name) {
+    for (const Attribute& attribute : attributes) {
+        if (attribute.name == name) {
+            return &attribute.value;
+        }
+    }
+    return nullptr;
+}
+
+size_t XmlReader::parse(std::string_view input, bool final) {
+    size_t pos = 0;
+    while (pos < input.size()) {
+        if (input[pos] != '<') {
+            const size_t open = input.find('<', pos);
+            size_t end = open == std::string_view::npos ? input.size() : open;
+            if (open == std::string_view::npos && !final) {
+                // Keep an entity reference that may continue in the next piece
+                const size_t amp = input.rfind('&');
+                if (amp != std::string_view::npos && amp >= pos &&
+                    input.find(';', amp) == std::string_view::npos) {
+                    end = amp;
+                }
+            }
+            if (end > pos) {
+                text(input.substr(pos, end - pos));
+            }
+            pos = end;
+            if (open == std::string_view::npos) {
+                break;
+            }
+            continue;
+        }
+
+        const size_t length = markup(input.substr(pos), final);
+        if (length == 0) {
+            break;
+        }
+        pos += length;
+    }
+    return pos;
+}
+
+size_t XmlReader::markup(std::string_view s, bool final) {
+    // Every kind of markup ends in '>'; shorter than "<![CDATA[" without one cannot be classified yet
+    if (s.size() < 9 && s.find('>') == std::string_view::npos) {
+        if (final) {
+            malformed("unexpected end of document");
+        }
+        return 0;
+    }
+
+    size_t end = std::string_view::npos;
+    size_t length = 0;
+    if (s.starts_with("<!--")) {
+        end = s.find("-->", 4);
+        length = end + 3;
+    } else if (s.starts_with("<![CDATA[")) {
+        end = s.find("]]>", 9);
+        if (end != std::string_view::npos) {
+            m_handler.characters(s.substr(9, end - 9));
+        }
+        length = end + 3;
+    } else if (s.starts_with("<?")) {
+        end = s.find("?>", 2);
+        if (end != std::string_view::npos && s.starts_with("<?xml") && isSpace(s[5])) {
+            const size_t key = s.find("encoding", 5);
+            if (key != std::string_view::npos && key < end) {
+                const size_t quote = s.find_first_of("\"'", key);
+                if (quote < end) {
+                    const size_t close = s.find(s[quote], quote + 1);
+                    if (close < end) {
+                        m_declaredEncoding.assign(s.substr(quote + 1, close - quote - 1));
+                    }
+                }
+            }
+        }
+        length = end + 2;
+    } else if (s.starts_with("<!")) {
+        end = findDoctypeEnd(s);
+        length = end + 1;
+    } else if (s.starts_with("</")) {
+        end = s.find('>', 2);
+        if (end != std::string_view::npos) {
+            m_handler.endElement(trim(s.substr(2, end - 2)));
+        }
+        length = end + 1;
+    } else {
+        end = findTagEnd(s);
+        if (end != std::string_view::npos) {
+            startTag(s.substr(1, end - 1));
+        }
+        length = end + 1;
+    }
+
+    if (end == std::string_view::npos) {
+        if (final) {
+            malformed("unexpected end of document");
+        }
+        return 0;
+    }
+    return length;
+}
+
+void XmlReader::startTag(std::string_view tag) {
+    const bool empty = !tag.empty() && tag.back() == '/';
+    if (empty) {
+        tag.remove_suffix(1);
+    }
+
+    size_t pos = 0;
+    while (pos < tag.size() && !isSpace(tag[pos])) {
+        ++pos;
+    }
+    const std::string_view name = tag.substr(0, pos);
+    if (name.empty()) {
+        malformed("element without a name");
+    }
+
+    m_attributes.clear();
+    while (pos < tag.size()) {
+        while (pos < tag.size() && isSpace(tag[pos])) {
+            ++pos;
+        }
+        const size_t nameStart = pos;
+        while (pos < tag.size() && tag[pos] != '=' && !isSpace(tag[pos])) {
+            ++pos;
+        }
+        if (pos == nameStart) {
+            break;
+        }
+        const std::string_view attributeName = tag.substr(nameStart, pos - nameStart);
+        while (pos < tag.size() && isSpace(tag[pos])) {
+            ++pos;
+        }
+        if (pos == tag.size() || tag[pos] != '=') {
+            malformed("attribute without a value");
+        }
+        ++pos;
+        while (pos < tag.size() && isSpace(tag[pos])) {
+            ++pos;
+        }
+        if (pos == tag.size() || (tag[pos] != '"' && tag[pos] != '\'')) {
+            malformed("unquoted attribute value");
+        }
+        const size_t close = tag.find(tag[pos], pos + 1);
+        if (close == std::string_view::npos) {
+            malformed("unterminated attribute value");
+        }
+        Attribute& attribute = m_attributes.emplace_back();
+        attribute.name = attributeName;
+        decodeEntities(tag.substr(pos + 1, close - pos - 1), attribute.value);
+        pos = close + 1;
+    }
+
+    m_handler.startElement(name, m_attributes);
+    if (empty) {
+        m_handler.endElement(name);
+    }
+}
+
+void XmlReader::text(std::string_view raw) {
+    if (raw.find('&') == std::string_view::npos) {
+        m_handler.characters(raw);
+        return;
+    }
+    m_decoded.clear();
+    decodeEntities(raw, m_decoded);
+    m_handler.characters(m_decoded);
+}
+
+void XmlReader::decodeEntities(std::string_view raw, std::string& out) {
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        const size_t amp = raw.find('&', pos);
+        if (amp == std::string_view::npos) {
+            out.append(raw.substr(pos));
+            return;
+        }
+        out.append(raw.substr(pos, amp - pos));
+        const size_t semicolon = raw.find(';', amp);
+        if (semicolon == std::string_view::npos) {
+            out.append(raw.substr(amp));
+            return;
+        }
+
+        const std::string_view entity = raw.substr(amp + 1, semicolon - amp - 1);
+        if (entity == "lt") {
+            out += '<';
+        } else if (entity == "gt") {
+            out += '>';
+        } else if (entity == "amp") {
+            out += '&';
+        } else if (entity == "quot") {
+            out += '"';
+        } else if (entity == "apos") {
+            out += '\'';
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            const bool hex = entity[1] == 'x' || entity[1] == 'X';
+            uint32_t cp = 0;
+            bool valid = entity.size() > (hex ? 2u : 1u);
+            for (size_t i = hex ? 2 : 1; valid && i < entity.size(); ++i) {
+                const char c = entity[i];
+                uint32_t digit = 0;
+                if (c >= '0' && c <= '9') {
+                    digit = c - '0';
+                } else if (hex && c >= 'a' && c <= 'f') {
+                    digit = c - 'a' + 10;
+                } else if (hex && c >= 'A' && c <= 'F') {
+                    digit = c - 'A' + 10;
+                } else {
+                    valid = false;
+                }
+                cp = cp * (hex ? 16 : 10) + digit;
+                valid = valid && cp <= 0x10FFFF;
+            }
+            if (valid && !(cp >= 0xD800 && cp <= 0xDFFF) && cp != 0) {
+                appendUtf8(cp, out);
+            } else {
+                out.append(raw.substr(amp, semicolon - amp + 1));
+            }
+        } else {
+            out.append(raw.substr(amp, semicolon - amp + 1));  // e.g. DTD-defined &deg;
+        }
+        pos = semicolon + 1;
+    }
+}
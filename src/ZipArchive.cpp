@@ -0,0 +1,200 @@
+#include "ZipArchive.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr uint32_t END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr size_t LOCAL_HEADER_SIZE = 30;
+constexpr size_t CENTRAL_HEADER_SIZE = 46;
+constexpr size_t END_OF_DIRECTORY_SIZE = 22;
+constexpr size_t STORED_PIECE = 64 * 1024;
+
+// Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> makeCrcTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (size_t k = 1; k < 8; ++k) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto CRC_TABLES = makeCrcTables();
+
+uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t size) {
+    const auto& t = CRC_TABLES;
+    crc = ~crc;
+    for (; size >= 8; data += 8, size -= 8) {
+        const uint32_t low = crc ^ (static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+                                    (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24));
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; size > 0; ++data, --size) {
+        crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint16_t read16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+[[noreturn]] void corrupt(const std::string& what) {
+    throw std::runtime_error("zip: " + what);
+}
+
+} // namespace
+
+ZipArchive::ZipArchive(const MappedFile& file, size_t maxEntryBytes)
+    : m_file(file), m_maxEntryBytes(maxEntryBytes) {
+    const auto* data = reinterpret_cast<const uint8_t*>(file.data());
+    const size_t size = file.size();
+    if (size < END_OF_DIRECTORY_SIZE) {
+        corrupt("file too small");
+    }
+
+    // The end-of-central-directory record sits before a comment of up to 64 KB
+    size_t end = size - END_OF_DIRECTORY_SIZE;
+    const size_t lowest = size > END_OF_DIRECTORY_SIZE + 0xFFFF ? size - END_OF_DIRECTORY_SIZE - 0xFFFF : 0;
+    while (read32(data + end) != END_OF_DIRECTORY_SIGNATURE) {
+        if (end == lowest) {
+            corrupt("end of central directory not found");
+        }
+        --end;
+    }
+
+    const uint16_t entryCount = read16(data + end + 10);
+    const uint32_t directorySize = read32(data + end + 12);
+    const uint32_t directoryOffset = read32(data + end + 16);
+    if (entryCount == 0xFFFF || directoryOffset == 0xFFFFFFFF) {
+        corrupt("ZIP64 archives are not supported");
+    }
+    if (read16(data + end + 4) != 0 || read16(data + end + 6) != 0) {
+        corrupt("multi-disk archives are not supported");
+    }
+    if (static_cast<size_t>(directoryOffset) + directorySize > end) {
+        corrupt("central directory out of range");
+    }
+
+    m_entries.reserve(entryCount);
+    size_t offset = directoryOffset;
+    for (uint16_t i = 0; i < entryCount; ++i) {
+        if (offset + CENTRAL_HEADER_SIZE > end || read32(data + offset) != CENTRAL_HEADER_SIGNATURE) {
+            corrupt("bad central directory header");
+        }
+        const uint8_t* header = data + offset;
+        const size_t nameLength = read16(header + 28);
+        const size_t extraLength = read16(header + 30);
+        const size_t commentLength = read16(header + 32);
+        if (offset + CENTRAL_HEADER_SIZE + nameLength > end) {
+            corrupt("central directory out of range");
+        }
+
+        Entry entry;
+        entry.name.assign(reinterpret_cast<const char*>(header + CENTRAL_HEADER_SIZE), nameLength);
+        entry.method = read16(header + 10);
+        entry.crc = read32(header + 16);
+        entry.compressedSize = read32(header + 20);
+        entry.uncompressedSize = read32(header + 24);
+        entry.localHeaderOffset = read32(header + 42);
+        if (entry.compressedSize == 0xFFFFFFFF || entry.uncompressedSize == 0xFFFFFFFF ||
+            entry.localHeaderOffset == 0xFFFFFFFF) {
+            corrupt("ZIP64 archives are not supported");
+        }
+        if (read16(header + 8) & 1) {
+            entry.method = 0xFFFF;  // Encrypted; extract() refuses it
+        }
+        m_entries.push_back(std::move(entry));
+        offset += CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+    }
+}
+
+bool ZipArchive::isZip(const char* data, size_t size) {
+    return size >= 4 && read32(reinterpret_cast<const uint8_t*>(data)) == LOCAL_HEADER_SIGNATURE;
+}
+
+const ZipArchive::Entry* ZipArchive::find(std::string_view name) const {
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&](const Entry& entry) { return entry.name == name; });
+    return it == m_entries.end() ? nullptr : &*it;
+}
+
+size_t ZipArchive::extract(const Entry& entry, const Inflater::Sink& sink, std::stop_token stop) {
+    const auto* data = reinterpret_cast<const uint8_t*>(m_file.data());
+    const size_t size = m_file.size();
+    const size_t local = entry.localHeaderOffset;
+    if (local + LOCAL_HEADER_SIZE > size || read32(data + local) != LOCAL_HEADER_SIGNATURE) {
+        corrupt("bad local header for " + entry.name);
+    }
+    // The local name and extra field lengths may differ from the central ones
+    m_dataOffset = local + LOCAL_HEADER_SIZE + read16(data + local + 26) + read16(data + local + 28);
+    if (m_dataOffset > size || entry.compressedSize > size - m_dataOffset) {
+        corrupt("entry data out of range for " + entry.name);
+    }
+    if (entry.uncompressedSize > m_maxEntryBytes) {
+        corrupt(entry.name + " is too large (" + std::to_string(entry.uncompressedSize) + " bytes)");
+    }
+    const uint8_t* compressed = data + m_dataOffset;
+
+    uint32_t crc = 0;
+    size_t produced = 0;
+    auto checked = [&](const uint8_t* out, size_t length) {
+        // Before the sink sees it: the declared size bounds what a crafted stream can inflate to
+        if (length > entry.uncompressedSize - produced) {
+            corrupt("more data than declared in " + entry.name);
+        }
+        crc = updateCrc(crc, out, length);
+        produced += length;
+        sink(out, length);
+    };
+
+    m_storedRead = 0;
+    if (entry.method == 0) {
+        m_deflating = false;
+        while (m_storedRead < entry.compressedSize) {
+            if (stop.stop_requested()) {
+                return produced;
+            }
+            const size_t length = std::min(STORED_PIECE, entry.compressedSize - m_storedRead);
+            checked(compressed + m_storedRead, length);
+            m_storedRead += length;
+        }
+    } else if (entry.method == 8) {
+        m_deflating = true;
+        m_inflater.inflate(compressed, entry.compressedSize, checked, stop);
+        m_deflating = false;
+        m_storedRead = entry.compressedSize;
+        if (stop.stop_requested()) {
+            return produced;
+        }
+    } else {
+        corrupt("unsupported compression method or encryption in " + entry.name);
+    }
+
+    if (produced != entry.uncompressedSize || crc != entry.crc) {
+        corrupt("checksum mismatch in " + entry.name);
+    }
+    return produced;
+}
+
+size_t ZipArchive::bytesRead() const {
+    return m_dataOffset + (m_deflating ? m_inflater.inputConsumed() : m_storedRead);
+}
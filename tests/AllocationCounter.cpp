@@ -0,0 +1,70 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Plain integers need no dynamic initialization, so operator new may touch
+// them at any point of thread start-up
+thread_local uint64_t t_allocations = 0;
+thread_local uint64_t t_deallocations = 0;
+thread_local uint64_t t_bytes = 0;
+
+void* countedAllocate(std::size_t size) noexcept {
+    ++t_allocations;
+    t_bytes += size;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void countedFree(void* p) noexcept {
+    if (p != nullptr) {
+        ++t_deallocations;
+        std::free(p);
+    }
+}
+
+} // namespace
+
+namespace AllocationCounter {
+
+uint64_t allocations() { return t_allocations; }
+uint64_t deallocations() { return t_deallocations; }
+uint64_t bytesAllocated() { return t_bytes; }
+
+Scope::Scope()
+    : m_allocations(t_allocations), m_deallocations(t_deallocations), m_bytes(t_bytes) {}
+
+uint64_t Scope::allocations() const { return t_allocations - m_allocations; }
+uint64_t Scope::deallocations() const { return t_deallocations - m_deallocations; }
+uint64_t Scope::bytesAllocated() const { return t_bytes - m_bytes; }
+
+} // namespace AllocationCounter
+
+void* operator new(std::size_t size) {
+    if (void* p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
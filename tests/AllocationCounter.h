@@ -0,0 +1,56 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Test-only heap allocation counting
+ *
+ * AllocationCounter.cpp replaces the global operator new/delete of the
+ * unit_tests binary and counts calls per thread, so allocations made by
+ * other threads (gtest, ScanPipeline workers) never leak into a measurement.
+ * Over-aligned new is not replaced and goes uncounted.
+ *
+ * Use EXPECT_MAX_ALLOCATIONS around a statement, or a Scope when the bound is
+ * per item (e.g. the difference between two document sizes per added match).
+ */
+namespace AllocationCounter {
+    // Totals for the calling thread since it started
+    uint64_t allocations();
+    uint64_t deallocations();
+    uint64_t bytesAllocated();
+
+    // Counts on the calling thread since construction
+    class Scope {
+    public:
+        Scope();
+
+        uint64_t allocations() const;
+        uint64_t deallocations() const;
+        uint64_t bytesAllocated() const;
+
+    private:
+        uint64_t m_allocations;
+        uint64_t m_deallocations;
+        uint64_t m_bytes;
+    };
+}
+
+// Fails the test if statement performs more than maxAllocations heap
+// allocations on the current thread
+#define EXPECT_MAX_ALLOCATIONS(maxAllocations, statement)                                  \
+    do {                                                                                   \
+        const ::AllocationCounter::Scope bzAllocationScope_;                               \
+        statement;                                                                         \
+        const uint64_t bzAllocations_ = bzAllocationScope_.allocations();                  \
+        EXPECT_LE(bzAllocations_, static_cast<uint64_t>(maxAllocations)) << "in: " #statement; \
+    } while (false)
+
+#define ASSERT_MAX_ALLOCATIONS(maxAllocations, statement)                                  \
+    do {                                                                                   \
+        const ::AllocationCounter::Scope bzAllocationScope_;                               \
+        statement;                                                                         \
+        const uint64_t bzAllocations_ = bzAllocationScope_.allocations();                  \
+        ASSERT_LE(bzAllocations_, static_cast<uint64_t>(maxAllocations)) << "in: " #statement; \
+    } while (false)
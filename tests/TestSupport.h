@@ -0,0 +1,90 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Fixtures shared by the test suites that save, cache or export a scan
+ *
+ * TEXT is a small German document with a conflict (Welle and Getriebe both
+ * 10) and two ordinal terms (erste/zweite Lager). TempPath hands out a fresh
+ * path under the gtest temp directory and removes whatever ends up there, a
+ * file or a directory tree. The name carries the process id and the running
+ * test, since ctest -j runs every test in its own process at the same time.
+ */
+namespace TestSupport {
+    inline const std::wstring TEXT =
+        L"Die Welle 10 ist im Lager 12 gelagert.\n"
+        L"Das Getriebe 10 dreht, die Welle 10 auch. Das erste Lager 14 und das zweite Lager 16.\n";
+
+    class TempPath {
+    public:
+        // Nothing is created at the path
+        explicit TempPath(const std::string& suffix = "") {
+            static int counter = 0;
+            m_path = ::testing::TempDir() + "bz_test_" + std::to_string(processId()) + "_" + testName() + "_" +
+                     std::to_string(counter++) + suffix;
+            std::error_code error;
+            std::filesystem::remove_all(m_path, error);
+        }
+
+        // A file holding content
+        TempPath(const std::string& suffix, const std::string& content) : TempPath(suffix) {
+            write(content);
+        }
+
+        ~TempPath() {
+            std::error_code error;
+            std::filesystem::remove_all(m_path, error);
+        }
+
+        TempPath(const TempPath&) = delete;
+        TempPath& operator=(const TempPath&) = delete;
+
+        const std::string& path() const { return m_path; }
+
+        std::string read() const {
+            std::ifstream in(m_path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(in), {});
+        }
+
+        void write(const std::string& bytes) const {
+            std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+            out << bytes;
+        }
+
+    private:
+        static long processId() {
+#ifdef _WIN32
+            return _getpid();
+#else
+            return static_cast<long>(getpid());
+#endif
+        }
+
+        // Suite and test name, with the '/' of parameterized tests replaced
+        static std::string testName() {
+            const ::testing::TestInfo* info = ::testing::UnitTest::GetInstance()->current_test_info();
+            if (!info) {
+                return "global";
+            }
+            std::string name = std::string(info->test_suite_name()) + "." + info->name();
+            for (char& c : name) {
+                if (c == '/') {
+                    c = '_';
+                }
+            }
+            return name;
+        }
+
+        std::string m_path;
+    };
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include "AllocationCounter.h"
+#include "RE2RegexHelper.h"
+#include "TextScanner.h"
+#include "ErrorDetectorHelper.h"
+#include "GermanTextAnalyzer.h"
+#include "EnglishTextAnalyzer.h"
+#include "RegexPatterns.h"
+#include "AnalysisContext.h"
+#include <re2/re2.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * Test suite locking in allocation bounds of the scan hot loops
+ * Bounds are per item (match, word, occurrence), measured as the difference
+ * between a document and the same document repeated, so fixed per-scan
+ * costs (UTF-8 copy, position map, first-time cache and map entries) cancel.
+ */
+
+namespace {
+
+// Keeps the optimizer from removing a new/delete pair
+void* volatile g_sink = nullptr;
+
+std::wstring repeat(const std::wstring& text, size_t times) {
+  std::wstring result;
+  result.reserve(text.size() * times);
+  for (size_t i = 0; i < times; ++i) {
+    result += text;
+  }
+  return result;
+}
+
+} // namespace
+
+// Counter
+
+TEST(AllocationCounterTest, CountsAllocationsOnThisThread) {
+  AllocationCounter::Scope scope;
+  g_sink = new int(42);
+  delete static_cast<int*>(g_sink);
+
+  EXPECT_EQ(scope.allocations(), 1u);
+  EXPECT_EQ(scope.deallocations(), 1u);
+  EXPECT_GE(scope.bytesAllocated(), sizeof(int));
+}
+
+TEST(AllocationCounterTest, IgnoresOtherThreads) {
+  std::thread worker;
+  AllocationCounter::Scope scope;
+  {
+    worker = std::thread([] {
+      for (int i = 0; i < 100; ++i) {
+        g_sink = new int(i);
+        delete static_cast<int*>(g_sink);
+      }
+    });
+  }
+  const uint64_t beforeJoin = scope.allocations();
+  worker.join();
+
+  // Starting the thread allocates its state here, the loop runs over there
+  EXPECT_EQ(scope.allocations(), beforeJoin);
+  EXPECT_LT(beforeJoin, 100u);
+}
+
+TEST(AllocationCounterTest, MacroPassesWithinBound) {
+  EXPECT_MAX_ALLOCATIONS(0, g_sink = nullptr);
+  EXPECT_MAX_ALLOCATIONS(1, std::wstring longText(100, L'x'); g_sink = longText.data());
+}
+
+// Regex matching
+
+class MatchAllocationTest : public ::testing::Test {
+protected:
+  // The searches next() performs, without building MatchResults
+  static void searchAll(const std::wstring& text, const re2::RE2& pattern) {
+    const std::string utf8 = RE2RegexHelper::wstringToUtf8(text);
+    const re2::StringPiece input(utf8);
+    re2::StringPiece groups[RE2RegexHelper::MAX_GROUPS];
+    const int groupCount = pattern.NumberOfCapturingGroups() + 1;
+    size_t pos = 0;
+    while (pattern.Match(input, pos, utf8.size(), RE2::UNANCHORED, groups, groupCount)) {
+      pos = groups[0].data() - utf8.data() + groups[0].size();
+      pattern.Match(input, pos, utf8.size(), RE2::UNANCHORED, nullptr, 0);
+    }
+  }
+
+  re2::RE2 singleWordRegex{RegexPatterns::SINGLE_WORD_PATTERN};
+  re2::RE2 twoWordRegex{RegexPatterns::TWO_WORD_PATTERN};
+};
+
+// RE2 allocates search scratch space itself; next() must add nothing to it
+TEST_F(MatchAllocationTest, NextAllocatesNothingBeyondRE2) {
+  const std::wstring text = repeat(L"Die Vorrichtung 10 hat ein Gehäuse 12 und eine Welle 14. ", 50);
+
+  for (const re2::RE2* pattern : {&singleWordRegex, &twoWordRegex}) {
+    searchAll(text, *pattern);  // Warm the DFA cache
+
+    AllocationCounter::Scope searchScope;
+    searchAll(text, *pattern);
+    const uint64_t searchAllocations = searchScope.allocations();
+
+    RE2RegexHelper::MatchIterator iter(text, *pattern);
+    size_t matches = 0;
+    AllocationCounter::Scope iterScope;
+    while (iter.hasNext()) {
+      iter.next();
+      ++matches;
+    }
+
+    EXPECT_GT(matches, 100u);
+    EXPECT_LE(iterScope.allocations(), searchAllocations) << pattern->pattern();
+  }
+}
+
+TEST_F(MatchAllocationTest, ConstructionDoesNotAllocatePerCharacter) {
+  const std::wstring sentence = L"Die Vorrichtung 10 hat ein Gehäuse 12 – Maß 14. ";
+  const std::wstring small = repeat(sentence, 10);
+  const std::wstring large = repeat(sentence, 1000);
+
+  AllocationCounter::Scope smallScope;
+  { RE2RegexHelper::MatchIterator iter(small, singleWordRegex); }
+  const uint64_t smallAllocations = smallScope.allocations();
+
+  AllocationCounter::Scope largeScope;
+  { RE2RegexHelper::MatchIterator iter(large, singleWordRegex); }
+
+  // UTF-8 copy and position map are a handful of buffers whatever the size;
+  // per-character conversion must stay within the small-string buffer
+  EXPECT_LE(largeScope.allocations(), smallAllocations + 4);
+}
+
+// Stemming
+
+TEST(StemAllocationTest, GermanWarmCacheDoesNotAllocate) {
+  GermanTextAnalyzer analyzer;
+  const std::wstring words[] = {L"Vorrichtungen", L"Gehäuses", L"Befestigungselement", L"Lager"};
+  for (const std::wstring& word : words) {
+    std::wstring copy = word;
+    analyzer.stemWord(copy);
+  }
+
+  for (const std::wstring& word : words) {
+    std::wstring copy = word;
+    EXPECT_MAX_ALLOCATIONS(0, analyzer.stemWord(copy));
+  }
+}
+
+TEST(StemAllocationTest, EnglishWarmCacheDoesNotAllocate) {
+  EnglishTextAnalyzer analyzer;
+  const std::wstring words[] = {L"bearings", L"fastening", L"housings", L"shaft"};
+  for (const std::wstring& word : words) {
+    std::wstring copy = word;
+    analyzer.stemWord(copy);
+  }
+
+  for (const std::wstring& word : words) {
+    std::wstring copy = word;
+    EXPECT_MAX_ALLOCATIONS(0, analyzer.stemWord(copy));
+  }
+}
+
+// Scan passes
+
+class ScanAllocationTest : public ::testing::Test {
+protected:
+  static constexpr size_t BASE_REPEATS = 20;
+  static constexpr size_t EXTRA_REPEATS = 200;
+
+  // Allocations of scanning sentence * repeats, less the regex passes, and the
+  // number of recorded occurrences
+  std::pair<uint64_t, size_t> scanAllocations(const std::wstring& sentence, size_t repeats) {
+    const std::wstring text = repeat(sentence, repeats);
+    ctx = std::make_unique<AnalysisContext>();
+    ctx->multiWordBaseStems = multiWordBaseStems;
+
+    AllocationCounter::Scope scope;
+    TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, *ctx);
+    const uint64_t scanAllocations = scope.allocations();
+
+    // Leave out RE2's own search allocations (see MatchAllocationTest)
+    AllocationCounter::Scope matchScope;
+    matchAll(text, twoWordRegex);
+    matchAll(text, singleWordRegex);
+    return {scanAllocations - matchScope.allocations(), ctx->db.occurrences.size()};
+  }
+
+  // Allocations per occurrence added by the extra repeats
+  double allocationsPerOccurrence(const std::wstring& sentence) {
+    scanAllocations(sentence, BASE_REPEATS);  // Warm the stem cache and the arena size
+    const auto [baseAllocations, baseOccurrences] = scanAllocations(sentence, BASE_REPEATS);
+    const auto [allocations, occurrences] = scanAllocations(sentence, BASE_REPEATS + EXTRA_REPEATS);
+    EXPECT_GT(occurrences, baseOccurrences);
+    return static_cast<double>(allocations - baseAllocations) /
+           static_cast<double>(occurrences - baseOccurrences);
+  }
+
+  static void matchAll(const std::wstring& text, const re2::RE2& pattern) {
+    RE2RegexHelper::MatchIterator iter(text, pattern);
+    while (iter.hasNext()) {
+      iter.next();
+    }
+  }
+
+  GermanTextAnalyzer analyzer;
+  re2::RE2 singleWordRegex{RegexPatterns::SINGLE_WORD_PATTERN};
+  re2::RE2 twoWordRegex{RegexPatterns::TWO_WORD_PATTERN};
+  std::unordered_set<std::wstring> multiWordBaseStems;
+  std::unique_ptr<AnalysisContext> ctx;
+};
+
+// Measured 5: word, original word and StemVector per occurrence plus the
+// word2 copy of each two-word candidate. A per-match group copy in
+// MatchResult would add at least two more.
+TEST_F(ScanAllocationTest, SingleWordMatchesStayWithinBound) {
+  const double perOccurrence =
+      allocationsPerOccurrence(L"Die Vorrichtung 10 hat ein Gehäuse 12, das Gehäuse 12 trägt eine Welle 14. ");
+  EXPECT_LE(perOccurrence, 6.0);
+}
+
+TEST_F(ScanAllocationTest, MultiWordMatchesStayWithinBound) {
+  std::wstring base = L"lager";
+  analyzer.stemWord(base);
+  multiWordBaseStems.insert(base);
+
+  const double perOccurrence =
+      allocationsPerOccurrence(L"Ein erstes Lager 10 und ein zweites Lager 12 halten die Welle 14. ");
+  EXPECT_LE(perOccurrence, 8.0);  // Measured 7
+}
+
+// The preceding word is a view into the text; only the error vectors grow
+TEST_F(ScanAllocationTest, CheckArticleUsageDoesNotAllocatePerOccurrence) {
+  const std::wstring sentence = L"Eine Vorrichtung 10 hat ein Gehäuse 12. Die Vorrichtung 10 und das Gehäuse 12. ";
+  const std::wstring text = repeat(sentence, BASE_REPEATS + EXTRA_REPEATS);
+  scanAllocations(sentence, BASE_REPEATS + EXTRA_REPEATS);
+  const size_t occurrences = ctx->db.occurrences.size();
+  ASSERT_GT(occurrences, EXTRA_REPEATS);
+
+  ErrorPositions wrongArticlePositions;
+  AllocationCounter::Scope scope;
+  ErrorDetectorHelper::checkArticleUsage(text, analyzer, *ctx, nullptr, wxTextAttr(),
+                                         wrongArticlePositions);
+
+  EXPECT_FALSE(wrongArticlePositions.empty());
+  EXPECT_LT(static_cast<double>(scope.allocations()) / static_cast<double>(occurrences), 0.05);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "CaseFolding.h"
+#include "OrdinalDetector.h"
+#include "RegexPatterns.h"
+#include "GermanTextAnalyzer.h"
+#include <re2/re2.h>
+
+// Test single character folding
+TEST(CaseFoldingTest, FoldChar_Ascii) {
+  EXPECT_EQ(CaseFolding::foldChar(L'A'), L'a');
+  EXPECT_EQ(CaseFolding::foldChar(L'Z'), L'z');
+  EXPECT_EQ(CaseFolding::foldChar(L'a'), L'a');
+  EXPECT_EQ(CaseFolding::foldChar(L'0'), L'0');
+  EXPECT_EQ(CaseFolding::foldChar(L'@'), L'@');
+  EXPECT_EQ(CaseFolding::foldChar(L'['), L'[');
+}
+
+TEST(CaseFoldingTest, FoldChar_GermanUmlauts) {
+  EXPECT_EQ(CaseFolding::foldChar(L'Ä'), L'ä');
+  EXPECT_EQ(CaseFolding::foldChar(L'Ö'), L'ö');
+  EXPECT_EQ(CaseFolding::foldChar(L'Ü'), L'ü');
+  EXPECT_EQ(CaseFolding::foldChar(L'ä'), L'ä');
+  // ß is already lowercase and must not be expanded or changed
+  EXPECT_EQ(CaseFolding::foldChar(L'ß'), L'ß');
+}
+
+TEST(CaseFoldingTest, FoldChar_Latin1AndExtendedA) {
+  EXPECT_EQ(CaseFolding::foldChar(L'É'), L'é');
+  EXPECT_EQ(CaseFolding::foldChar(L'Ø'), L'ø');
+  EXPECT_EQ(CaseFolding::foldChar(L'×'), L'×');  // Multiplication sign is not a letter
+  EXPECT_EQ(CaseFolding::foldChar(L'Ł'), L'ł');
+  EXPECT_EQ(CaseFolding::foldChar(L'Ž'), L'ž');
+  EXPECT_EQ(CaseFolding::foldChar(L'Ÿ'), L'ÿ');
+  EXPECT_EQ(CaseFolding::foldChar(L'İ'), L'i');
+  EXPECT_EQ(CaseFolding::foldChar(L'ı'), L'ı');
+}
+
+TEST(CaseFoldingTest, FoldChar_OutsideTableUnchanged) {
+  EXPECT_EQ(CaseFolding::foldChar(L'Ω'), L'Ω');
+  EXPECT_EQ(CaseFolding::foldChar(L'€'), L'€');
+}
+
+TEST(CaseFoldingTest, UpperChar_InvertsFolding) {
+  EXPECT_EQ(CaseFolding::upperChar(L'd'), L'D');
+  EXPECT_EQ(CaseFolding::upperChar(L'ä'), L'Ä');
+  EXPECT_EQ(CaseFolding::upperChar(L'ÿ'), L'Ÿ');
+  EXPECT_EQ(CaseFolding::upperChar(L'i'), L'I');
+  EXPECT_EQ(CaseFolding::upperChar(L'ß'), L'ß');
+  EXPECT_EQ(CaseFolding::upperChar(L'A'), L'A');
+  EXPECT_EQ(CaseFolding::upperChar(L'ω'), L'ω');
+  static_assert(CaseFolding::upperChar(L'ü') == L'Ü');
+}
+
+TEST(CaseFoldingTest, FoldChar_IsConstexpr) {
+  static_assert(CaseFolding::foldChar(L'Ü') == L'ü');
+  static_assert(CaseFolding::equalsFolded(L"ERSTE", L"erste"));
+  SUCCEED();
+}
+
+// Test whole-string folding (exercises both SIMD blocks and the scalar tail)
+TEST(CaseFoldingTest, FoldInPlace_LongAsciiRun) {
+  std::wstring text = L"THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 1234567890";
+  CaseFolding::foldInPlace(text);
+  EXPECT_EQ(text, L"the quick brown fox jumps over the lazy dog 1234567890");
+}
+
+TEST(CaseFoldingTest, FoldInPlace_MixedUmlautsInsideAsciiBlocks) {
+  std::wstring text = L"PLANETENRADSÄTZE UND ZAHNRÄDER MIT GROßEN ÖFFNUNGEN";
+  CaseFolding::foldInPlace(text);
+  EXPECT_EQ(text, L"planetenradsätze und zahnräder mit großen öffnungen");
+}
+
+TEST(CaseFoldingTest, FoldInPlace_MatchesScalarFolding) {
+  std::wstring text;
+  for (wchar_t c = 0; c < 0x200; ++c) {
+    text.push_back(c == 0 ? L' ' : c);
+  }
+  std::wstring expected = text;
+  for (auto& c : expected) {
+    c = CaseFolding::foldChar(c);
+  }
+  CaseFolding::foldInPlace(text);
+  EXPECT_EQ(text, expected);
+}
+
+TEST(CaseFoldingTest, FoldInPlace_Empty) {
+  std::wstring text;
+  CaseFolding::foldInPlace(text);
+  EXPECT_TRUE(text.empty());
+}
+
+TEST(CaseFoldingTest, EqualsFolded) {
+  EXPECT_TRUE(CaseFolding::equalsFolded(L"ÜBER", L"über"));
+  EXPECT_FALSE(CaseFolding::equalsFolded(L"über", L"uber"));
+  EXPECT_FALSE(CaseFolding::equalsFolded(L"der", L"dera"));
+}
+
+// Analyzer paths must not depend on the process locale
+TEST(CaseFoldingTest, GermanStemWord_UppercaseUmlaut) {
+  GermanTextAnalyzer analyzer;
+  std::wstring upper = L"ÄNDERUNG";
+  std::wstring lower = L"änderung";
+  analyzer.stemWord(upper);
+  analyzer.stemWord(lower);
+  EXPECT_EQ(upper, lower);
+}
+
+TEST(CaseFoldingTest, OrdinalDetector_UppercaseOrdinals) {
+  re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+  GermanTextAnalyzer analyzer;
+  std::wstring text = L"ERSTE Lager 10 ZWEITE Lager 20";
+  auto detected = OrdinalDetector::detectOrdinalPatterns(text, twoWordRegex, true, analyzer);
+  EXPECT_EQ(detected.size(), 1);
+}
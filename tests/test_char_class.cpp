@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "CharClass.h"
+#include "GermanTextAnalyzer.h"
+#include "RegexPatterns.h"
+#include "RE2RegexHelper.h"
+#include <re2/re2.h>
+
+// Test letter classification (\p{L})
+TEST(CharClassTest, IsLetter_AsciiAndUmlauts) {
+  EXPECT_TRUE(CharClass::isLetter(L'a'));
+  EXPECT_TRUE(CharClass::isLetter(L'Z'));
+  EXPECT_TRUE(CharClass::isLetter(L'ä'));
+  EXPECT_TRUE(CharClass::isLetter(L'Ü'));
+  EXPECT_TRUE(CharClass::isLetter(L'ß'));
+  EXPECT_FALSE(CharClass::isLetter(L'1'));
+  EXPECT_FALSE(CharClass::isLetter(L' '));
+  EXPECT_FALSE(CharClass::isLetter(L'-'));
+  EXPECT_FALSE(CharClass::isLetter(L'×'));
+}
+
+TEST(CharClassTest, IsLetter_OtherScripts) {
+  EXPECT_TRUE(CharClass::isLetter(L'Ω'));
+  EXPECT_TRUE(CharClass::isLetter(L'ж'));
+  EXPECT_TRUE(CharClass::isLetter(L'中'));
+  EXPECT_FALSE(CharClass::isLetter(L'€'));
+  EXPECT_FALSE(CharClass::isLetter(static_cast<wchar_t>(0xD800)));  // Surrogate half
+}
+
+// Test digit classification (\d is ASCII-only in RE2)
+TEST(CharClassTest, IsDigit_AsciiOnly) {
+  for (wchar_t c = L'0'; c <= L'9'; ++c) {
+    EXPECT_TRUE(CharClass::isDigit(c));
+  }
+  EXPECT_FALSE(CharClass::isDigit(L'a'));
+  EXPECT_FALSE(CharClass::isDigit(static_cast<wchar_t>(0x0663)));  // Arabic-Indic three
+  EXPECT_FALSE(CharClass::isDigit(static_cast<wchar_t>(0xFF11)));  // Fullwidth one
+}
+
+// Test whitespace classification (\s in RE2)
+TEST(CharClassTest, IsSpace_MatchesRegex) {
+  EXPECT_TRUE(CharClass::isSpace(L' '));
+  EXPECT_TRUE(CharClass::isSpace(L'\t'));
+  EXPECT_TRUE(CharClass::isSpace(L'\n'));
+  EXPECT_TRUE(CharClass::isSpace(L'\r'));
+  EXPECT_TRUE(CharClass::isSpace(L'\f'));
+  EXPECT_FALSE(CharClass::isSpace(L'a'));
+  EXPECT_FALSE(CharClass::isSpace(static_cast<wchar_t>(0x00A0)));  // No-break space
+}
+
+TEST(CharClassTest, Classification_IsConstexpr) {
+  static_assert(CharClass::isLetter(L'ö'));
+  static_assert(CharClass::isDigit(L'7'));
+  static_assert(!CharClass::isSpace(L'x'));
+  SUCCEED();
+}
+
+// The table must agree with the RE2 classes used in RegexPatterns
+TEST(CharClassTest, AgreesWithRe2Classes) {
+  re2::RE2 letter(R"(\p{L})");
+  re2::RE2 digit(R"(\d)");
+  re2::RE2 space(R"(\s)");
+  for (wchar_t c = 1; c < 0x3000; ++c) {
+    if (c >= 0xD800 && c <= 0xDFFF) {
+      continue;
+    }
+    std::string utf8 = RE2RegexHelper::wstringToUtf8(std::wstring(1, c));
+    EXPECT_EQ(CharClass::isLetter(c), re2::RE2::FullMatch(utf8, letter)) << "U+" << std::hex << int(c);
+    EXPECT_EQ(CharClass::isDigit(c), re2::RE2::FullMatch(utf8, digit)) << "U+" << std::hex << int(c);
+    EXPECT_EQ(CharClass::isSpace(c), re2::RE2::FullMatch(utf8, space)) << "U+" << std::hex << int(c);
+  }
+}
+
+// findPrecedingWord must treat umlauts as letters regardless of locale
+TEST(CharClassTest, FindPrecedingWord_Umlaut) {
+  GermanTextAnalyzer analyzer;
+  std::wstring text = L"für Lager 10";
+  auto [word, pos] = analyzer.findPrecedingWord(text, 4);
+  EXPECT_EQ(word, L"für");
+  EXPECT_EQ(pos, 0);
+}
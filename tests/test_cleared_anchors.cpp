@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "ClearedAnchors.h"
+#include "ScanPipeline.h"
+#include "CorpusGenerator.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <string>
+
+/**
+ * Test suite for ClearedAnchors
+ * Cleared errors must follow their text through edits and never jump to other text.
+ */
+namespace {
+
+using TestSupport::TEXT;
+
+bool hasError(const ErrorPositions& errors, size_t start, size_t end) {
+  return std::find(errors.begin(), errors.end(), std::make_pair(static_cast<int>(start), static_cast<int>(end))) !=
+         errors.end();
+}
+
+} // namespace
+
+TEST(ClearedAnchorsTest, ClearedRightAway) {
+  ClearedAnchors cleared;
+  cleared.add(TEXT, 4, 12);
+  EXPECT_TRUE(cleared.contains(4, 12));
+  EXPECT_FALSE(cleared.contains(4, 11));
+  EXPECT_EQ(cleared.size(), 1u);
+
+  cleared.add(TEXT, 4, 12);
+  EXPECT_EQ(cleared.size(), 1u);
+  cleared.add(TEXT, 5, 5);  // Empty ranges are ignored
+  cleared.add(TEXT, 0, TEXT.size() + 1);
+  EXPECT_EQ(cleared.size(), 1u);
+}
+
+TEST(ClearedAnchorsTest, FollowsInsertionsAbove) {
+  ClearedAnchors cleared;
+  const size_t second = TEXT.find(L"Welle 10 auch");
+  cleared.add(TEXT, second, second + 8);
+
+  const std::wstring edited = L"Ein neuer erster Satz. " + TEXT;
+  cleared.resolve(edited);
+  EXPECT_TRUE(cleared.contains(second + 23, second + 31));
+  // The identical "Welle 10" of the first line stays an error
+  EXPECT_FALSE(cleared.contains(4 + 23, 12 + 23));
+  EXPECT_EQ(cleared.resolvedCount(), 1u);
+}
+
+TEST(ClearedAnchorsTest, SurvivesAnEditOnOneSide) {
+  ClearedAnchors cleared;
+  const size_t start = TEXT.find(L"Lager 14");
+  cleared.add(TEXT, start, start + 8);
+
+  std::wstring edited = TEXT;
+  edited.replace(edited.find(L"und das zweite"), 14, L"sowie ein weiteres");
+  cleared.resolve(edited);
+  EXPECT_TRUE(cleared.contains(start, start + 8));
+}
+
+TEST(ClearedAnchorsTest, UniqueTextSurvivesContextChanges) {
+  ClearedAnchors cleared;
+  const size_t start = TEXT.find(L"Getriebe 10");
+  cleared.add(TEXT, start, start + 11);
+
+  const std::wstring edited = L"Ganz anderer Text vorne. Das Getriebe 10 bleibt.";
+  cleared.resolve(edited);
+  EXPECT_TRUE(cleared.contains(29, 40));
+}
+
+TEST(ClearedAnchorsTest, DropsDecisionsWhoseTextIsGone) {
+  ClearedAnchors cleared;
+  cleared.add(TEXT, 4, 12);
+  cleared.resolve(L"Der Text handelt jetzt von einer Achse 10.");
+  EXPECT_EQ(cleared.resolvedCount(), 0u);
+  EXPECT_EQ(cleared.size(), 1u);  // Kept in case the text comes back
+
+  cleared.resolve(TEXT);
+  EXPECT_TRUE(cleared.contains(4, 12));
+}
+
+TEST(ClearedAnchorsTest, RangesNotStartingAtAWordFollowEdits) {
+  ClearedAnchors cleared;
+  const size_t dot = TEXT.find(L". Das");    // Word inside the range
+  const size_t mid = TEXT.find(L"lle 10 a");  // Starts inside a word
+  const size_t comma = TEXT.find(L", ");      // No word at all
+  cleared.add(TEXT, dot, dot + 6);
+  cleared.add(TEXT, mid, mid + 6);
+  cleared.add(TEXT, comma, comma + 2);
+
+  const std::wstring edited = L"Vorab. " + TEXT;
+  cleared.resolve(edited);
+  EXPECT_TRUE(cleared.contains(dot + 7, dot + 13));
+  EXPECT_TRUE(cleared.contains(mid + 7, mid + 13));
+  EXPECT_TRUE(cleared.contains(comma + 7, comma + 9));
+  EXPECT_EQ(cleared.resolvedCount(), 3u);
+}
+
+TEST(ClearedAnchorsTest, ReportsAnchorsThatWereNotFound) {
+  ClearedAnchors cleared;
+  cleared.add(TEXT, 4, 12);
+  cleared.add(TEXT, TEXT.find(L"Getriebe"), TEXT.find(L"Getriebe") + 8);
+  EXPECT_TRUE(cleared.resolved(0));
+  EXPECT_TRUE(cleared.resolved(1));
+
+  cleared.resolve(L"Die Achse 10 bleibt, das Getriebe entfällt.");
+  EXPECT_FALSE(cleared.resolved(0));
+  EXPECT_TRUE(cleared.resolved(1));  // Unique, so found without context
+}
+
+TEST(ClearedAnchorsTest, AmbiguousTextWithoutContextStaysAnError) {
+  ClearedAnchors cleared;
+  cleared.add(TEXT, 4, 12);
+  // "Welle 10" twice, neither with the old surroundings
+  cleared.resolve(L"Eine Welle 10 hier; noch eine Welle 10 dort.");
+  EXPECT_EQ(cleared.resolvedCount(), 0u);
+}
+
+TEST(ClearedAnchorsTest, PipelineKeepsClearedErrorAfterEdit) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  // Definite articles before first occurrences: "Die" Welle and "Das" Getriebe
+  const size_t das = TEXT.find(L"Das Getriebe");
+  ASSERT_TRUE(hasError(pipeline.wrongArticleErrors(), 0, 3));
+  ASSERT_TRUE(hasError(pipeline.wrongArticleErrors(), das, das + 3));
+
+  pipeline.context().clearedTextAnchors.add(TEXT, 0, 3);
+  pipeline.run(TEXT);
+  EXPECT_FALSE(hasError(pipeline.wrongArticleErrors(), 0, 3));
+
+  const std::wstring edited = L"Kurze Einleitung. " + TEXT;
+  pipeline.run(edited);
+  EXPECT_FALSE(hasError(pipeline.wrongArticleErrors(), 18, 21));
+  EXPECT_TRUE(hasError(pipeline.wrongArticleErrors(), das + 18, das + 21));
+}
+
+TEST(ClearedAnchorsTest, ResolvesManyAnchorsOnLargeCorpus) {
+  CorpusGenerator::Options options;
+  options.targetChars = 300000;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ScanPipeline pipeline(true);
+  pipeline.run(corpus.text);
+  ASSERT_FALSE(pipeline.allErrors().empty());
+
+  ClearedAnchors cleared;
+  for (const auto& [start, end] : pipeline.allErrors()) {
+    cleared.add(corpus.text, start, end);
+  }
+  const std::wstring edited = L"Vorwort. " + corpus.text;
+  cleared.resolve(edited);
+  size_t found = 0;
+  for (const auto& [start, end] : pipeline.allErrors()) {
+    found += cleared.contains(start + 9, end + 9);
+  }
+  EXPECT_EQ(found, pipeline.allErrors().size());
+}
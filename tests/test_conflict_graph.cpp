@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "ConflictGraph.h"
+#include "ErrorDetectorHelper.h"
+#include "ScanPipeline.h"
+#include "CorpusGenerator.h"
+#include <algorithm>
+#include <set>
+#include <string>
+
+/**
+ * Test suite for ConflictGraph
+ * Components must group tangled numbers and terms; the flags must match the per-BZ
+ * check isUniquelyAssigned() below.
+ */
+namespace {
+
+// Welle/Lager share 10 and Lager also has 12: one tangle. Getriebe 14 is fine.
+const std::wstring TEXT =
+    L"Die Welle 10 sitzt im Lager 10. Das Lager 12 ist neu. Das Getriebe 14 dreht die Welle 10.\n";
+
+std::set<std::pair<int, int>> sorted(const ErrorPositions& positions) {
+  return {positions.begin(), positions.end()};
+}
+
+// Oracle: the per-BZ check highlighting ran before the conflict graph. A BZ
+// conflicts if it names several terms or its only term has another BZ;
+// cleared BZs count as unique. Adds the positions a conflict highlights.
+bool isUniquelyAssigned(const std::wstring& bz, const AnalysisContext& ctx,
+                        std::set<std::pair<int, int>>& wrongTermBz) {
+  if (ctx.clearedErrors.count(bz) > 0) {
+    return true;
+  }
+  const auto addUncleared = [&](PositionRange positions) {
+    for (const auto [start, length] : positions) {
+      if (!ErrorDetectorHelper::isPositionCleared(ctx.clearedTextAnchors, start, start + length)) {
+        wrongTermBz.emplace(static_cast<int>(start), static_cast<int>(start + length));
+      }
+    }
+  };
+  const auto& stems = ctx.db.bzToStems.at(bz);
+  if (stems.size() > 1) {
+    addUncleared(ctx.db.positionsOfBz(bz));
+    return false;
+  }
+  for (const auto& stem : stems) {
+    if (ctx.db.stemToBz.at(stem).size() > 1) {
+      addUncleared(ctx.db.positionsOfStem(stem));
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(ConflictGraphTest, TangledTermsAndNumbersFormOneConflict) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  const AnalysisContext& ctx = pipeline.context();
+  const OccurrenceTable& occurrences = ctx.db.occurrences;
+  const ConflictGraph& graph = ctx.conflicts;
+
+  ASSERT_EQ(graph.size(), 1u);
+  const ConflictGraph::Conflict conflict = graph.conflict(0);
+  EXPECT_EQ(conflict.bzIds.size(), 2u);
+  EXPECT_EQ(conflict.stemIds.size(), 2u);
+  EXPECT_EQ(conflict.occurrences.size(), 4u);
+  EXPECT_TRUE(std::is_sorted(conflict.occurrences.begin(), conflict.occurrences.end()));
+  EXPECT_EQ(graph.describe(0, occurrences, TEXT), L"Welle, Lager <-> 10, 12");
+
+  EXPECT_EQ(graph.conflictOfBz(occurrences.findBz(L"10")), 0u);
+  EXPECT_EQ(graph.conflictOfBz(occurrences.findBz(L"14")), ConflictGraph::NO_CONFLICT);
+  EXPECT_TRUE(graph.bzFlagged(occurrences.findBz(L"12")));
+  EXPECT_FALSE(graph.bzFlagged(occurrences.findBz(L"14")));
+  EXPECT_FALSE(graph.bzFlagged(OccurrenceTable::NO_ID));
+  EXPECT_EQ(pipeline.conflictingBz(), (std::vector<std::wstring>{L"10", L"12"}));
+
+  // Every tangled occurrence once, in document order
+  EXPECT_EQ(graph.flaggedOccurrences().size(), 4u);
+  EXPECT_EQ(pipeline.wrongTermBzErrors().size(), 4u);
+}
+
+TEST(ConflictGraphTest, ClearedNumberKeepsTheConflictButIsNotFlagged) {
+  ScanPipeline pipeline(true);
+  pipeline.context().clearedErrors.insert(L"12");
+  pipeline.run(TEXT);
+  const OccurrenceTable& occurrences = pipeline.context().db.occurrences;
+  const ConflictGraph& graph = pipeline.context().conflicts;
+
+  const uint32_t bz12 = occurrences.findBz(L"12");
+  EXPECT_TRUE(graph.bzConflicts(bz12));
+  EXPECT_FALSE(graph.bzFlagged(bz12));
+  EXPECT_TRUE(graph.bzFlagged(occurrences.findBz(L"10")));
+  // Lager still has two numbers
+  EXPECT_TRUE(graph.stemFlagged(occurrences.stemId(occurrences.positionsOfBz(bz12).begin().occurrence())));
+  EXPECT_EQ(pipeline.conflictingBz(), (std::vector<std::wstring>{L"10"}));
+  EXPECT_EQ(graph.size(), 1u);
+}
+
+TEST(ConflictGraphTest, NoConflictsInCleanText) {
+  ScanPipeline pipeline(true);
+  pipeline.run(L"Die Welle 10 sitzt im Lager 12. Die Welle 10 dreht im Lager 12.");
+  EXPECT_TRUE(pipeline.context().conflicts.empty());
+  EXPECT_TRUE(pipeline.context().conflicts.flaggedOccurrences().empty());
+  EXPECT_TRUE(pipeline.wrongTermBzErrors().empty());
+}
+
+TEST(ConflictGraphTest, MatchesIsUniquelyAssignedOnCorpus) {
+  CorpusGenerator::Options options;
+  options.targetChars = 200000;
+  options.missingNumberPercent = 5;
+  options.conflictPercent = 5;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ASSERT_FALSE(corpus.truth.conflictingBz.empty());
+  ScanPipeline pipeline(true);
+  pipeline.context().clearedErrors.insert(*corpus.truth.conflictingBz.begin());
+  pipeline.run(corpus.text);
+
+  const AnalysisContext& ctx = pipeline.context();
+  std::set<std::pair<int, int>> perBz;
+  size_t conflicting = 0;
+  for (const auto& [bz, stems] : ctx.db.bzToStems) {
+    const bool flagged = ctx.clearedErrors.count(bz) == 0 && !isUniquelyAssigned(bz, ctx, perBz);
+    EXPECT_EQ(ctx.conflicts.bzFlagged(ctx.db.occurrences.findBz(bz)), flagged) << bz;
+    conflicting += flagged;
+  }
+  EXPECT_GT(conflicting, 0u);
+  EXPECT_EQ(pipeline.conflictingBz().size(), conflicting);
+  EXPECT_EQ(sorted(pipeline.wrongTermBzErrors()), perBz);
+}
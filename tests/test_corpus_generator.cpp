@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include "CorpusGenerator.h"
+#include "AnalysisContext.h"
+#include "TextScanner.h"
+#include "ErrorDetectorHelper.h"
+#include "OrdinalDetector.h"
+#include "GermanTextAnalyzer.h"
+#include "EnglishTextAnalyzer.h"
+#include "RegexPatterns.h"
+#include <re2/re2.h>
+#include <set>
+#include <sstream>
+
+/**
+ * Test suite for CorpusGenerator
+ * The generated ground truth must match what the scanner and the error
+ * detectors actually report for the generated text.
+ */
+class CorpusGeneratorTest : public ::testing::Test {
+protected:
+  re2::RE2 singleWordRegex{RegexPatterns::SINGLE_WORD_PATTERN};
+  re2::RE2 twoWordRegex{RegexPatterns::TWO_WORD_PATTERN};
+  re2::RE2 wordRegex{RegexPatterns::WORD_PATTERN};
+  GermanTextAnalyzer germanAnalyzer;
+  EnglishTextAnalyzer englishAnalyzer;
+  AnalysisContext ctx;
+
+  using Ranges = std::set<std::pair<size_t, size_t>>;
+
+  struct ScanResult {
+    Ranges noNumber;
+    Ranges wrongArticle;
+    Ranges wrongTermBz;
+    std::set<std::wstring, BZComparatorForMap> conflictingBz;
+  };
+
+  TextAnalyzer& analyzerFor(const CorpusGenerator::Options& options) {
+    if (options.language == CorpusGenerator::Language::GERMAN) {
+      return germanAnalyzer;
+    }
+    return englishAnalyzer;
+  }
+
+  // Scan headless the way MainWindow does, with the ground truth's multi-word bases
+  ScanResult scan(const CorpusGenerator::Corpus& corpus, TextAnalyzer& analyzer) {
+    ctx.multiWordBaseStems.clear();
+    ctx.multiWordBaseStems.insert(corpus.truth.multiWordBaseStems.begin(),
+                                  corpus.truth.multiWordBaseStems.end());
+    TextScanner::scanText(corpus.text, analyzer, singleWordRegex, twoWordRegex, ctx);
+
+    wxTextAttr style;
+    ErrorPositions noNumber(ctx.arena.resource());
+    ErrorPositions wrongArticle(ctx.arena.resource());
+    ErrorPositions wrongTermBz(ctx.arena.resource());
+
+    ErrorDetectorHelper::findUnnumberedWords(corpus.text, analyzer, wordRegex, ctx, nullptr,
+                                            style, noNumber);
+    ErrorDetectorHelper::checkArticleUsage(corpus.text, analyzer, ctx, nullptr, style,
+                                          wrongArticle);
+
+    ctx.buildConflicts();
+    ErrorDetectorHelper::highlightConflicts(ctx, nullptr, style, wrongTermBz);
+
+    ScanResult result;
+    for (const auto& [bz, stems] : ctx.db.bzToStems) {
+      if (ctx.conflicts.bzFlagged(ctx.db.occurrences.findBz(bz))) {
+        result.conflictingBz.insert(bz);
+      }
+    }
+    result.noNumber.insert(noNumber.begin(), noNumber.end());
+    result.wrongArticle.insert(wrongArticle.begin(), wrongArticle.end());
+    result.wrongTermBz.insert(wrongTermBz.begin(), wrongTermBz.end());
+    return result;
+  }
+
+  static Ranges plantedRanges(const CorpusGenerator::GroundTruth& truth,
+                              CorpusGenerator::ErrorKind kind) {
+    Ranges ranges;
+    for (const auto& error : truth.errors) {
+      if (error.kind == kind) {
+        ranges.emplace(error.start, error.end);
+      }
+    }
+    return ranges;
+  }
+
+  void expectDatabaseMatches(const CorpusGenerator::GroundTruth& truth) {
+    ASSERT_EQ(ctx.db.bzToOriginalWords.size(), truth.bzToOriginalWords.size());
+    for (const auto& [bz, words] : truth.bzToOriginalWords) {
+      ASSERT_TRUE(ctx.db.bzToOriginalWords.count(bz)) << "BZ not found by the scanner";
+      const auto& scanned = ctx.db.bzToOriginalWords.at(bz);
+      EXPECT_EQ(std::set<std::wstring>(scanned.begin(), scanned.end()), words);
+    }
+  }
+
+  void expectMatchesTruth(const CorpusGenerator::Options& options) {
+    CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+    ScanResult result = scan(corpus, analyzerFor(options));
+    const auto& truth = corpus.truth;
+
+    expectDatabaseMatches(truth);
+    EXPECT_EQ(result.noNumber, plantedRanges(truth, CorpusGenerator::ErrorKind::MISSING_NUMBER));
+    EXPECT_EQ(result.wrongArticle, plantedRanges(truth, CorpusGenerator::ErrorKind::WRONG_ARTICLE));
+    EXPECT_EQ(result.conflictingBz, truth.conflictingBz);
+    for (const auto& range : plantedRanges(truth, CorpusGenerator::ErrorKind::CONFLICT)) {
+      EXPECT_TRUE(result.wrongTermBz.count(range));
+    }
+  }
+};
+
+// Determinism and size
+TEST_F(CorpusGeneratorTest, SameSeedSameText) {
+  CorpusGenerator::Options options;
+  options.targetChars = 5000;
+  options.missingNumberPercent = 5;
+
+  EXPECT_EQ(CorpusGenerator::generate(options).text, CorpusGenerator::generate(options).text);
+
+  CorpusGenerator::Options other = options;
+  other.seed = 7;
+  EXPECT_NE(CorpusGenerator::generate(options).text, CorpusGenerator::generate(other).text);
+}
+
+TEST_F(CorpusGeneratorTest, ReachesTargetSizeAndVocabulary) {
+  CorpusGenerator::Options options;
+  options.targetChars = 200000;
+  options.vocabularySize = 120;
+
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  EXPECT_GE(corpus.text.size(), options.targetChars);
+  EXPECT_LT(corpus.text.size(), options.targetChars + 256);
+  EXPECT_EQ(corpus.truth.bzToOriginalWords.size(), 120u);
+}
+
+// Clean corpora scan without any findings
+TEST_F(CorpusGeneratorTest, German_CleanCorpusMatchesTruth) {
+  CorpusGenerator::Options options;
+  options.targetChars = 50000;
+  options.vocabularySize = 200;
+  options.ordinalPairs = 3;
+  options.multiWordPairs = 3;
+
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  EXPECT_TRUE(corpus.truth.errors.empty());
+  EXPECT_TRUE(corpus.truth.conflictingBz.empty());
+  EXPECT_EQ(corpus.truth.multiWordBaseStems.size(), 6u);
+  expectMatchesTruth(options);
+}
+
+TEST_F(CorpusGeneratorTest, English_CleanCorpusMatchesTruth) {
+  CorpusGenerator::Options options;
+  options.language = CorpusGenerator::Language::ENGLISH;
+  options.targetChars = 50000;
+  options.vocabularySize = 200;
+  options.ordinalPairs = 3;
+  options.multiWordPairs = 3;
+  expectMatchesTruth(options);
+}
+
+// Planted errors are found exactly where the ground truth says
+TEST_F(CorpusGeneratorTest, German_PlantedErrorsMatchTruth) {
+  CorpusGenerator::Options options;
+  options.targetChars = 50000;
+  options.vocabularySize = 80;
+  options.missingNumberPercent = 4;
+  options.conflictPercent = 2;
+  options.wrongArticlePercent = 4;
+
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  EXPECT_GT(corpus.truth.count(CorpusGenerator::ErrorKind::MISSING_NUMBER), 0u);
+  EXPECT_GT(corpus.truth.count(CorpusGenerator::ErrorKind::WRONG_ARTICLE), 0u);
+  EXPECT_GT(corpus.truth.count(CorpusGenerator::ErrorKind::CONFLICT), 0u);
+  expectMatchesTruth(options);
+}
+
+TEST_F(CorpusGeneratorTest, English_PlantedErrorsMatchTruth) {
+  CorpusGenerator::Options options;
+  options.language = CorpusGenerator::Language::ENGLISH;
+  options.targetChars = 50000;
+  options.vocabularySize = 80;
+  options.missingNumberPercent = 4;
+  options.conflictPercent = 2;
+  options.wrongArticlePercent = 4;
+  expectMatchesTruth(options);
+}
+
+// Ordinal pairs are what OrdinalDetector reports
+TEST_F(CorpusGeneratorTest, OrdinalPairsAreDetected) {
+  CorpusGenerator::Options options;
+  options.targetChars = 50000;
+  options.ordinalPairs = 2;
+  options.multiWordPairs = 2;
+
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ASSERT_EQ(corpus.truth.ordinalBaseStems.size(), 2u);
+  auto detected = OrdinalDetector::detectOrdinalPatterns(corpus.text, twoWordRegex, true, germanAnalyzer);
+  EXPECT_EQ(std::set<std::wstring>(detected.begin(), detected.end()), corpus.truth.ordinalBaseStems);
+}
+
+TEST_F(CorpusGeneratorTest, WithoutUmlauts_TextIsAscii) {
+  CorpusGenerator::Options options;
+  options.targetChars = 20000;
+  options.vocabularySize = 300;
+  options.umlauts = false;
+
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  for (wchar_t c : corpus.text) {
+    ASSERT_LT(static_cast<unsigned>(c), 0x80u);
+  }
+  expectMatchesTruth(options);
+}
+
+TEST_F(CorpusGeneratorTest, GroundTruthJson) {
+  CorpusGenerator::Options options;
+  options.targetChars = 2000;
+  options.wrongArticlePercent = 10;
+
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  std::ostringstream out;
+  CorpusGenerator::writeGroundTruth(out, options, corpus.truth);
+  const std::string json = out.str();
+
+  EXPECT_NE(json.find("\"language\": \"de\""), std::string::npos);
+  EXPECT_NE(json.find("\"bzToOriginalWords\": {"), std::string::npos);
+  EXPECT_NE(json.find("\"type\": \"wrong_article\""), std::string::npos);
+  EXPECT_EQ(json.back(), '\n');
+}
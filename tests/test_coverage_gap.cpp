@@ -142,7 +142,7 @@ protected:
 
 // ErrorNavigator Tests
 TEST_F(CoverageGuiTest, ErrorNavigator_SelectNext) {
-    std::vector<std::pair<int, int>> positions = {{0, 5}, {10, 15}, {20, 25}};
+    ErrorPositions positions = {{0, 5}, {10, 15}, {20, 25}};
     int currentIndex = -1; // Initially none selected
 
     // 1. Select next (first)
@@ -174,7 +174,7 @@ TEST_F(CoverageGuiTest, ErrorNavigator_SelectNext) {
 }
 
 TEST_F(CoverageGuiTest, ErrorNavigator_SelectPrevious) {
-    std::vector<std::pair<int, int>> positions = {{0, 5}, {10, 15}};
+    ErrorPositions positions = {{0, 5}, {10, 15}};
     int currentIndex = -1;
 
     // 1. Select previous (wrap around to last)
@@ -189,19 +189,16 @@ TEST_F(CoverageGuiTest, ErrorNavigator_SelectPrevious) {
 }
 
 TEST_F(CoverageGuiTest, ErrorNavigator_EmptyList) {
-    std::vector<std::pair<int, int>> positions;
+    ErrorPositions positions;
     int currentIndex = -1;
     
     ErrorNavigator::selectNext(positions, currentIndex, textBox, label);
-    // Behavior: resets to 0 even if empty
-    EXPECT_EQ(currentIndex, 0);
+    // Nothing to select: the index is left as it was
+    EXPECT_EQ(currentIndex, -1);
     
-    currentIndex = -1;
+    currentIndex = 2;
     ErrorNavigator::selectPrevious(positions, currentIndex, textBox, label);
-    // Behavior: resets to 0 (size - 1 = -1 cast to int? no, size is 0)
-    // Code: if (current >= size || current < 0) current = size - 1;
-    // size=0 -> current = -1.
-    EXPECT_EQ(currentIndex, -1);
+    EXPECT_EQ(currentIndex, 2);
 }
 
 // UIBuilder Tests
@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include "DifferentialHarness.h"
+#include "RE2RegexHelper.h"
+#include "ReferenceScanner.h"
+#include "ScanPipeline.h"
+
+/**
+ * Test suite for the differential harness
+ * ScanPipeline must agree with the frozen ReferenceScanner on the synthetic
+ * corpora and on random mutations of them, with random decisions; the harness
+ * itself is checked with hand-made snapshots and predicates.
+ */
+using Language = CorpusGenerator::Language;
+
+static DifferentialHarness::Options campaign(Language language, size_t mutations) {
+  DifferentialHarness::Options options;
+  options.corpus.language = language;
+  options.corpus.targetChars = 6000;
+  options.corpus.missingNumberPercent = 5;
+  options.corpus.conflictPercent = 5;
+  options.corpus.wrongArticlePercent = 5;
+  options.mutations = mutations;
+  return options;
+}
+
+static void expectAgreement(Language language, size_t mutations) {
+  const bool german = language == Language::GERMAN;
+  auto result = DifferentialHarness::run(campaign(language, mutations),
+                                         DifferentialHarness::referenceEngine(german),
+                                         DifferentialHarness::pipelineEngine(german));
+  if (result) {
+    ADD_FAILURE() << "Engines diverge at input " << result->iteration << ": " << result->description
+                  << "\nMinimized input: " << RE2RegexHelper::wstringToUtf8(result->minimized.text) << "\n"
+                  << result->minimized.decisions.describe();
+  }
+}
+
+TEST(DifferentialTest, EnginesAgreeOnGermanCorpusAndMutations) {
+  expectAgreement(Language::GERMAN, 60);
+}
+
+TEST(DifferentialTest, EnginesAgreeOnEnglishCorpusAndMutations) {
+  expectAgreement(Language::ENGLISH, 60);
+}
+
+TEST(DifferentialTest, EnginesAgreeOnHandWrittenText) {
+  const std::wstring texts[] = {
+      L"Die erste Welle 10 und die zweite Welle 12 tragen ein Lager 14. Das Lager 14 ist "
+      L"fest. Die Welle ist lang. Ein Lager 14 und das Gehäuse 14.",
+      L"der Welle 10a, die Welle 10' und 10 Wellen 20 bis 30",
+      L"",
+      L"10 12 14",
+  };
+  auto reference = DifferentialHarness::referenceEngine(true);
+  auto pipeline = DifferentialHarness::pipelineEngine(true);
+  for (const auto& text : texts) {
+    EXPECT_EQ(DifferentialHarness::compare(text, reference, pipeline), std::nullopt)
+        << RE2RegexHelper::wstringToUtf8(text);
+  }
+}
+
+TEST(DifferentialTest, EnginesAgreeOnDecisions) {
+  const std::wstring text = L"Die Welle 10 trägt das Lager 12.\nDas Lager 10 ist fest. Die Welle\n10 dreht.";
+  ScanDecisions paragraphs;
+  paragraphs.paragraphStarts = {0, 33, 62};
+  ScanDecisions clearedBz;
+  clearedBz.clearedBz = {L"10"};
+  ScanDecisions clearedRange;
+  clearedRange.clearedRanges = {{4, 12}, {33, 36}};
+  ScanDecisions ignored;
+  ignored.ignoredWords = {L"LAGER"};
+
+  auto reference = DifferentialHarness::referenceEngine(true);
+  auto pipeline = DifferentialHarness::pipelineEngine(true);
+  for (const auto& decisions : {ScanDecisions{}, paragraphs, clearedBz, clearedRange, ignored}) {
+    EXPECT_EQ(DifferentialHarness::compare({text, decisions}, reference, pipeline), std::nullopt)
+        << decisions.describe();
+  }
+}
+
+TEST(DifferentialTest, ReferenceFollowsDecisions) {
+  const std::wstring text = L"Das Lager 10 und die Welle 10.";
+  ReferenceScanner scanner(true);
+  const ScanSnapshot plain = scanner.run(text);
+  EXPECT_EQ(plain.conflictingBz, (std::vector<std::wstring>{L"10"}));
+  EXPECT_EQ(plain.wrongArticleErrors, (std::vector<ScanSnapshot::ErrorRange>{{0, 3}, {17, 20}}));
+
+  ScanDecisions decisions;
+  decisions.clearedBz = {L"10"};
+  decisions.clearedRanges = {{0, 3}};
+  const ScanSnapshot cleared = scanner.run(text, decisions);
+  EXPECT_TRUE(cleared.conflictingBz.empty());
+  EXPECT_TRUE(cleared.wrongTermBzErrors.empty());
+  EXPECT_EQ(cleared.wrongArticleErrors, (std::vector<ScanSnapshot::ErrorRange>{{17, 20}}));
+
+  // "Welle" and its number in different paragraphs are no reference
+  decisions = {};
+  decisions.paragraphStarts = {0, 26};
+  EXPECT_EQ(scanner.run(text, decisions).bzToOriginalWords.count(L"10"), 1u);
+  EXPECT_EQ(scanner.run(text, decisions).bzToOriginalWords.at(L"10"), (std::set<std::wstring>{L"Lager"}));
+
+  decisions = {};
+  decisions.ignoredWords = {L"welle"};
+  EXPECT_EQ(scanner.run(text, decisions).bzToOriginalWords.at(L"10"), (std::set<std::wstring>{L"Lager"}));
+}
+
+TEST(DifferentialTest, SnapshotMatchesPipelineResults) {
+  ScanPipeline pipeline(true);
+  pipeline.run(L"Ein Lager 10 und eine Welle 12. Das Lager 12 ist fest.");
+  ScanSnapshot snapshot = ScanSnapshot::capture(pipeline);
+
+  EXPECT_EQ(snapshot.bzToOriginalWords.size(), 2u);
+  ASSERT_EQ(snapshot.bzPositions.count(L"12"), 1u);
+  EXPECT_EQ(snapshot.bzPositions[L"12"].size(), 2u);
+  // "Lager" has two BZs and BZ 12 two terms
+  EXPECT_EQ(snapshot.conflictingBz, (std::vector<std::wstring>{L"10", L"12"}));
+  EXPECT_FALSE(snapshot.exception.has_value());
+}
+
+TEST(DifferentialTest, FirstDivergenceNamesTheField) {
+  ScanPipeline pipeline(true);
+  pipeline.run(L"Ein Lager 10 und eine Welle 12.");
+  const ScanSnapshot expected = ScanSnapshot::capture(pipeline);
+
+  EXPECT_EQ(ScanSnapshot::firstDivergence(expected, expected), std::nullopt);
+
+  ScanSnapshot moved = expected;
+  moved.bzPositions[L"12"][0].first += 1;
+  auto description = ScanSnapshot::firstDivergence(expected, moved);
+  ASSERT_TRUE(description.has_value());
+  EXPECT_NE(description->find("bzPositions"), std::string::npos) << *description;
+
+  ScanSnapshot extraError = expected;
+  extraError.noNumberErrors.emplace_back(0, 3);
+  description = ScanSnapshot::firstDivergence(expected, extraError);
+  ASSERT_TRUE(description.has_value());
+  EXPECT_NE(description->find("noNumberErrors"), std::string::npos) << *description;
+
+  ScanSnapshot failed;
+  failed.exception = "std::out_of_range";
+  description = ScanSnapshot::firstDivergence(expected, failed);
+  ASSERT_TRUE(description.has_value());
+  EXPECT_NE(description->find("std::out_of_range"), std::string::npos) << *description;
+}
+
+TEST(DifferentialTest, CandidateDivergenceIsReportedAndMinimized) {
+  // A candidate that loses every BZ "14" must be caught and shrunk to a short text
+  auto reference = DifferentialHarness::referenceEngine(true);
+  DifferentialHarness::Engine broken = [reference](const DifferentialHarness::Input& input) {
+    ScanSnapshot snapshot = reference(input);
+    snapshot.bzPositions.erase(L"14");
+    return snapshot;
+  };
+
+  DifferentialHarness::Options options = campaign(Language::GERMAN, 0);
+  options.corpus.targetChars = 1500;
+  auto result = DifferentialHarness::run(options, reference, broken);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->iteration, 0u);
+  EXPECT_NE(result->minimized.text.find(L"14"), std::wstring::npos);
+  EXPECT_LT(result->minimized.text.size(), 20u) << RE2RegexHelper::wstringToUtf8(result->minimized.text);
+  EXPECT_TRUE(result->minimized.decisions.empty()) << result->minimized.decisions.describe();
+  EXPECT_NE(result->description.find("bzPositions"), std::string::npos);
+}
+
+TEST(DifferentialTest, MinimizeKeepsOnlyWhatThePredicateNeeds) {
+  auto stillFails = [](const DifferentialHarness::Input& input) {
+    return input.text.find(L'x') != std::wstring::npos && input.text.find(L'y') != std::wstring::npos;
+  };
+  EXPECT_EQ(DifferentialHarness::minimize(std::wstring(L"aaaaxbbbbbbbbbbyccc"), stillFails).text, L"xy");
+}
+
+TEST(DifferentialTest, MinimizeMovesAndDropsDecisions) {
+  // Needs the cleared range on "x" and the cleared BZ 10, nothing else
+  auto stillFails = [](const DifferentialHarness::Input& input) {
+    const size_t x = input.text.find(L'x');
+    return x != std::wstring::npos && input.decisions.clearedRanges.count({x, x + 1}) &&
+           input.decisions.clearedBz.count(L"10");
+  };
+  DifferentialHarness::Input input(L"aaaa\nbbbbxcccc\ndddd");
+  input.decisions.paragraphStarts = {0, 5, 15};
+  input.decisions.clearedBz = {L"10", L"12"};
+  input.decisions.clearedRanges = {{9, 10}, {16, 18}};
+  input.decisions.ignoredWords = {L"Welle"};
+
+  const DifferentialHarness::Input minimized = DifferentialHarness::minimize(input, stillFails);
+  EXPECT_EQ(minimized.text, L"x");
+  EXPECT_EQ(minimized.decisions.clearedRanges, (std::set<std::pair<size_t, size_t>>{{0, 1}}));
+  EXPECT_EQ(minimized.decisions.clearedBz, (std::set<std::wstring>{L"10"}));
+  EXPECT_TRUE(minimized.decisions.paragraphStarts.empty());
+  EXPECT_TRUE(minimized.decisions.ignoredWords.empty());
+}
+
+TEST(DifferentialTest, MutationIsDeterministicPerSeed) {
+  const auto input = DifferentialHarness::corpusInput(L"Die Welle 10 trägt\ndas Lager 12.");
+  EXPECT_EQ(input.decisions.paragraphStarts, (std::vector<uint32_t>{0, 19}));
+  std::mt19937 first(7);
+  std::mt19937 second(7);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_TRUE(DifferentialHarness::mutate(input, first, 4) == DifferentialHarness::mutate(input, second, 4));
+  }
+  std::mt19937 rng(1);
+  EXPECT_NO_THROW(DifferentialHarness::mutate(std::wstring(), rng, 4));
+}
+
+TEST(DifferentialTest, MutationMovesDecisionsWithTheText) {
+  DifferentialHarness::Input input(L"Das Lager 10.\nDie Welle 12.");
+  input.decisions.paragraphStarts = {0, 14};
+  input.decisions.clearedRanges = {{18, 26}};
+  std::mt19937 rng(3);
+  for (int i = 0; i < 200; ++i) {
+    const DifferentialHarness::Input mutated = DifferentialHarness::mutate(input, rng, 4);
+    for (const uint32_t start : mutated.decisions.paragraphStarts) {
+      EXPECT_LE(start, mutated.text.size());
+    }
+    // A cleared range that survives still covers the text it was cleared on
+    for (const auto& [start, end] : mutated.decisions.clearedRanges) {
+      EXPECT_EQ(mutated.text.substr(start, end - start), L"Welle 12");
+    }
+  }
+}
+
+TEST(DifferentialTest, FuzzInputDecodesInvalidUtf8AsReplacement) {
+  const uint8_t valid[] = {'W', 0xC3, 0xA4, 'l'};  // "Wäl"
+  EXPECT_EQ(DifferentialHarness::decodeFuzzInput(valid, sizeof(valid)), L"Wäl");
+
+  const uint8_t truncated[] = {'a', 0xC3};
+  EXPECT_EQ(DifferentialHarness::decodeFuzzInput(truncated, sizeof(truncated)), L"a�");
+
+  const uint8_t overlong[] = {0xC0, 0xAF};
+  EXPECT_EQ(DifferentialHarness::decodeFuzzInput(overlong, sizeof(overlong)), L"��");
+
+  const uint8_t surrogate[] = {0xED, 0xA0, 0x80};
+  EXPECT_EQ(DifferentialHarness::decodeFuzzInput(surrogate, sizeof(surrogate)), L"���");
+}
+
+TEST(DifferentialTest, EngineExceptionsAreComparedByType) {
+  // A BZ too large for std::stoi throws in both engines
+  const std::wstring text = L"Die Welle 99999999999999999999 und die Welle 10.";
+  auto reference = DifferentialHarness::referenceEngine(true);
+  auto pipeline = DifferentialHarness::pipelineEngine(true);
+  ASSERT_TRUE(reference(text).exception.has_value());
+  EXPECT_EQ(reference(text).exception, pipeline(text).exception);
+  EXPECT_EQ(DifferentialHarness::compare(text, reference, pipeline), std::nullopt);
+}
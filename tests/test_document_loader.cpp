@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "DocumentLoader.h"
+#include "MappedFile.h"
+#include "TextDecoder.h"
+#include "TestSupport.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Test suite for TextDecoder, MappedFile and DocumentLoader
+ * Decoding must not depend on where the input is split into chunks.
+ */
+using Encoding = TextDecoder::Encoding;
+
+static std::wstring decodeInChunks(Encoding encoding, const std::string& bytes, size_t chunk) {
+  TextDecoder decoder(encoding);
+  std::wstring out;
+  for (size_t offset = 0; offset < bytes.size(); offset += chunk) {
+    const size_t length = std::min(chunk, bytes.size() - offset);
+    decoder.decode(bytes.data() + offset, length, offset + length == bytes.size(), out);
+  }
+  if (bytes.empty()) {
+    decoder.decode(nullptr, 0, true, out);
+  }
+  return out;
+}
+
+static std::string utf16(const std::u16string& text, bool littleEndian) {
+  std::string bytes;
+  for (char16_t unit : text) {
+    const char low = static_cast<char>(unit & 0xFF);
+    const char high = static_cast<char>(unit >> 8);
+    bytes += littleEndian ? low : high;
+    bytes += littleEndian ? high : low;
+  }
+  return bytes;
+}
+
+TEST(TextDecoderTest, DetectsByteOrderMarks) {
+  EXPECT_EQ(TextDecoder::detect("\xEF\xBB\xBF" "abc", 6).encoding, Encoding::UTF8);
+  EXPECT_EQ(TextDecoder::detect("\xEF\xBB\xBF" "abc", 6).bomBytes, 3u);
+  EXPECT_EQ(TextDecoder::detect("\xFF\xFE" "a\0", 4).encoding, Encoding::UTF16LE);
+  EXPECT_EQ(TextDecoder::detect("\xFE\xFF\0a", 4).encoding, Encoding::UTF16BE);
+  EXPECT_EQ(TextDecoder::detect("\xFE\xFF\0a", 4).bomBytes, 2u);
+}
+
+TEST(TextDecoderTest, DetectsUtf16WithoutBom) {
+  const std::string le = utf16(u"Die Welle 10", true);
+  const std::string be = utf16(u"Die Welle 10", false);
+  EXPECT_EQ(TextDecoder::detect(le.data(), le.size()).encoding, Encoding::UTF16LE);
+  EXPECT_EQ(TextDecoder::detect(be.data(), be.size()).encoding, Encoding::UTF16BE);
+}
+
+TEST(TextDecoderTest, FallsBackToLatin1ForInvalidUtf8) {
+  const std::string utf8 = "Geh\xC3\xA4use 10";
+  const std::string latin1 = "Geh\xE4use 10";
+  EXPECT_EQ(TextDecoder::detect(utf8.data(), utf8.size()).encoding, Encoding::UTF8);
+  EXPECT_EQ(TextDecoder::detect(latin1.data(), latin1.size()).encoding, Encoding::LATIN1);
+  EXPECT_EQ(decodeInChunks(Encoding::LATIN1, latin1, 64), L"Gehäuse 10");
+  EXPECT_EQ(TextDecoder::detect("", 0).encoding, Encoding::UTF8);
+}
+
+TEST(TextDecoderTest, Utf8IsIndependentOfChunkBoundaries) {
+  // 1-, 2-, 3- and 4-byte sequences
+  const std::string bytes = "a\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80z \xC3\x9F";
+  const std::wstring expected = decodeInChunks(Encoding::UTF8, bytes, bytes.size());
+  ASSERT_EQ(expected.substr(0, 3), L"aä€");
+  for (size_t chunk = 1; chunk <= bytes.size(); ++chunk) {
+    EXPECT_EQ(decodeInChunks(Encoding::UTF8, bytes, chunk), expected) << "chunk " << chunk;
+  }
+}
+
+TEST(TextDecoderTest, InvalidUtf8BecomesReplacement) {
+  EXPECT_EQ(decodeInChunks(Encoding::UTF8, "a\xC3", 1), L"a�");
+  EXPECT_EQ(decodeInChunks(Encoding::UTF8, "\xC0\xAF", 1), L"��");
+  EXPECT_EQ(decodeInChunks(Encoding::UTF8, "\xED\xA0\x80", 2), L"���");
+  // Truncated sequence followed by ASCII, split inside the sequence
+  EXPECT_EQ(decodeInChunks(Encoding::UTF8, "\xE2\x82" "x", 1), L"��x");
+}
+
+TEST(TextDecoderTest, Utf16SurrogatePairsAcrossChunks) {
+  const std::u16string text = u"Welle \U0001F600 10";
+  for (bool littleEndian : {true, false}) {
+    const std::string bytes = utf16(text, littleEndian);
+    const Encoding encoding = littleEndian ? Encoding::UTF16LE : Encoding::UTF16BE;
+    const std::wstring expected = decodeInChunks(encoding, bytes, bytes.size());
+    EXPECT_EQ(expected.substr(0, 6), L"Welle ");
+    for (size_t chunk = 1; chunk <= bytes.size(); ++chunk) {
+      EXPECT_EQ(decodeInChunks(encoding, bytes, chunk), expected) << "chunk " << chunk;
+    }
+  }
+  // Lone surrogates and a dangling odd byte
+  EXPECT_EQ(decodeInChunks(Encoding::UTF16LE, utf16(u"\xDC00" "a", true), 4), L"�a");
+  EXPECT_EQ(decodeInChunks(Encoding::UTF16LE, std::string("a\0b", 3), 4), L"a�");
+}
+
+TEST(MappedFileTest, MapsContentAndEmptyFiles) {
+  const TestSupport::TempPath file(".txt", "Die Welle 10");
+  MappedFile mapped(file.path());
+  EXPECT_EQ(std::string(mapped.data(), mapped.size()), "Die Welle 10");
+
+  const TestSupport::TempPath empty(".txt", "");
+  MappedFile mappedEmpty(empty.path());
+  EXPECT_EQ(mappedEmpty.size(), 0u);
+
+  EXPECT_THROW(MappedFile(file.path() + ".missing"), std::runtime_error);
+}
+
+TEST(DocumentLoaderTest, ChunksConcatenateToTheWholeText) {
+  std::string content;
+  std::wstring expected;
+  for (int i = 0; i < 2000; ++i) {
+    content += "Die Welle " + std::to_string(i) + " tr\xC3\xA4gt das Lager.\r\n";
+    expected += L"Die Welle " + std::to_wstring(i) + L" trägt das Lager.\n";
+  }
+  const TestSupport::TempPath file(".txt", "\xEF\xBB\xBF" + content);
+  MappedFile mapped(file.path());
+
+  for (size_t chunkBytes : {1u, 7u, 4096u, 1u << 20}) {
+    std::wstring text;
+    size_t chunks = 0;
+    size_t lastDone = 0;
+    auto result = DocumentLoader::load(mapped, [&](std::wstring&& chunk, size_t done, size_t total) {
+      EXPECT_GE(done, lastDone);
+      EXPECT_EQ(total, mapped.size());
+      lastDone = done;
+      text += chunk;
+      ++chunks;
+    }, {}, chunkBytes);
+
+    EXPECT_TRUE(result.completed);
+    EXPECT_EQ(result.encoding, Encoding::UTF8);
+    EXPECT_EQ(result.characters, expected.size());
+    EXPECT_EQ(lastDone, mapped.size());
+    EXPECT_EQ(text, expected) << "chunk bytes " << chunkBytes;
+    if (chunkBytes == 4096) {
+      EXPECT_GT(chunks, 10u);
+    }
+  }
+}
+
+TEST(DocumentLoaderTest, NormalizesLoneCarriageReturns) {
+  const TestSupport::TempPath file(".txt", "a\rb\r\rc\r");
+  EXPECT_EQ(DocumentLoader::loadAll(file.path()), L"a\nb\n\nc\n");
+}
+
+TEST(DocumentLoaderTest, StopsWhenRequested) {
+  const TestSupport::TempPath file(".txt", std::string(100000, 'x'));
+  MappedFile mapped(file.path());
+  std::stop_source stop;
+  size_t received = 0;
+  auto result = DocumentLoader::load(mapped, [&](std::wstring&& chunk, size_t, size_t) {
+    received += chunk.size();
+    stop.request_stop();
+  }, stop.get_token(), 1000);
+
+  EXPECT_FALSE(result.completed);
+  EXPECT_EQ(received, 1000u);
+}
+
+TEST(DocumentLoaderTest, LoadAllReportsEncoding) {
+  const TestSupport::TempPath file(".txt", "\xFF\xFE" + utf16(u"Gehäuse 10", true));
+  Encoding encoding = Encoding::UTF8;
+  EXPECT_EQ(DocumentLoader::loadAll(file.path(), &encoding), L"Gehäuse 10");
+  EXPECT_EQ(encoding, Encoding::UTF16LE);
+
+  const TestSupport::TempPath empty(".txt", "");
+  EXPECT_EQ(DocumentLoader::loadAll(empty.path()), L"");
+}
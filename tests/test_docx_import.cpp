@@ -0,0 +1,510 @@
+#include <gtest/gtest.h>
+#include "DocumentLoader.h"
+#include "DocxImporter.h"
+#include "Inflater.h"
+#include "MappedFile.h"
+#include "ScanPipeline.h"
+#include "XmlReader.h"
+#include "ZipArchive.h"
+#include "TestSupport.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Test suite for Inflater, ZipArchive, XmlReader and DocxImporter
+ * Deflate streams come from zlib (raw, windowBits -15) or the fixed-Huffman
+ * writer below; ZIP containers are assembled in the test.
+ */
+namespace {
+
+// zlib level 0 of "Gehause 14": one final stored block
+const std::vector<uint8_t> STORED_STREAM = {
+    0x01, 0x0a, 0x00, 0xf5, 0xff, 0x47, 0x65, 0x68, 0x61, 0x75, 0x73, 0x65, 0x20, 0x31, 0x34,
+};
+
+// zlib Z_FIXED of "Die Welle 10 lagert im Lager 12."
+const std::vector<uint8_t> FIXED_STREAM = {
+    0x73, 0xc9, 0x4c, 0x55, 0x08, 0x4f, 0xcd, 0xc9, 0x49, 0x55, 0x30, 0x34, 0x50, 0xc8, 0x49, 0x4c,
+    0x4f, 0x2d, 0x2a, 0x51, 0xc8, 0xcc, 0x55, 0xf0, 0x01, 0xb1, 0x14, 0x0c, 0x8d, 0xf4, 0x00,
+};
+
+// zlib level 9 of dynamicText(): one dynamic Huffman block
+const std::vector<uint8_t> DYNAMIC_STREAM = {
+    0x85, 0xd3, 0x3d, 0x0a, 0x02, 0x41, 0x0c, 0x86, 0xe1, 0xde, 0x53, 0xcc,
+    0x09, 0x64, 0x92, 0xcc, 0x6f, 0xbf, 0xa5, 0xbd, 0xf5, 0x82, 0xc3, 0x22,
+    0x6c, 0xb5, 0xee, 0x91, 0xbc, 0x89, 0x17, 0xb3, 0x93, 0xc0, 0x08, 0x6f,
+    0xfd, 0x56, 0x0f, 0xf9, 0xb2, 0x3c, 0x47, 0xb8, 0x8f, 0x7d, 0x1f, 0x21,
+    0x86, 0xf3, 0xf8, 0xbc, 0xb7, 0x33, 0x3c, 0xd6, 0x57, 0xb8, 0xad, 0xdb,
+    0x38, 0x42, 0xbc, 0x5e, 0x96, 0x5f, 0x97, 0xb9, 0x8b, 0xef, 0x3a, 0x77,
+    0xf5, 0xdd, 0xe6, 0x6e, 0xbe, 0xa7, 0xb9, 0x27, 0xdf, 0xf3, 0xdc, 0xb3,
+    0xef, 0x65, 0xee, 0xc5, 0xf7, 0x0a, 0xbe, 0x06, 0xbe, 0x0e, 0x3e, 0x89,
+    0x00, 0x14, 0x01, 0xa1, 0x28, 0x10, 0xc5, 0xc0, 0x28, 0x89, 0x8e, 0x98,
+    0x41, 0x29, 0x85, 0x98, 0x95, 0x98, 0x8d, 0x98, 0x1d, 0x98, 0x1a, 0x81,
+    0xa9, 0x02, 0x4c, 0x55, 0x1a, 0xab, 0x01, 0x53, 0x13, 0x30, 0x35, 0x03,
+    0x53, 0x0b, 0x31, 0x2b, 0x31, 0x1b, 0x31, 0x3b, 0x30, 0x2d, 0xd2, 0x53,
+    0x0a, 0x30, 0x4d, 0x81, 0x69, 0x06, 0x4c, 0x4b, 0xc0, 0xb4, 0x0c, 0x4c,
+    0x2b, 0xc4, 0xac, 0xc4, 0x6c, 0xc4, 0xec, 0x7f, 0x99, 0x5f,
+};
+
+std::string dynamicText() {
+  std::string text;
+  for (int i = 0; i < 40; ++i) {
+    text += "Die Welle " + std::to_string(i) + " tr\xC3\xA4gt das Lager " + std::to_string(i % 7) + ".\n";
+  }
+  return text;
+}
+
+std::string inflate(const std::vector<uint8_t>& stream) {
+  Inflater inflater;
+  std::string out;
+  inflater.inflate(stream.data(), stream.size(),
+                   [&](const uint8_t* data, size_t size) { out.append(reinterpret_cast<const char*>(data), size); });
+  return out;
+}
+
+// Writes a final fixed-Huffman block: literals and (length, distance) matches
+class FixedBlockWriter {
+public:
+  FixedBlockWriter() {
+    bits(1, 1);
+    bits(1, 2);
+  }
+
+  void literal(uint8_t byte) {
+    if (byte < 144) {
+      code(0x30 + byte, 8);
+    } else {
+      code(0x190 + byte - 144, 9);
+    }
+  }
+
+  // Only length 258 (symbol 285) is needed here
+  void match258(uint32_t distance) {
+    code(0xC0 + 285 - 280, 8);
+    static const uint32_t base[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                    6145, 8193, 12289, 16385, 24577};
+    int symbol = 29;
+    while (base[symbol] > distance) {
+      --symbol;
+    }
+    code(symbol, 5);
+    bits(distance - base[symbol], symbol < 4 ? 0 : symbol / 2 - 1);
+  }
+
+  std::vector<uint8_t> finish() {
+    code(0, 7);  // End of block
+    if (m_count > 0) {
+      m_out.push_back(static_cast<uint8_t>(m_buffer));
+    }
+    return m_out;
+  }
+
+private:
+  void bits(uint32_t value, int count) {
+    for (int i = 0; i < count; ++i) {
+      m_buffer |= ((value >> i) & 1) << m_count;
+      if (++m_count == 8) {
+        m_out.push_back(static_cast<uint8_t>(m_buffer));
+        m_buffer = 0;
+        m_count = 0;
+      }
+    }
+  }
+
+  // Huffman codes go most significant bit first
+  void code(uint32_t value, int length) {
+    for (int i = length - 1; i >= 0; --i) {
+      bits((value >> i) & 1, 1);
+    }
+  }
+
+  std::vector<uint8_t> m_out;
+  uint32_t m_buffer = 0;
+  int m_count = 0;
+};
+
+uint32_t crc32(const std::string& data) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (unsigned char c : data) {
+    crc ^= c;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+  }
+  return ~crc;
+}
+
+struct ZipItem {
+  std::string name;
+  std::string content;     // Uncompressed
+  std::string compressed;  // Raw deflate; empty = stored
+};
+
+void put16(std::string& out, uint32_t value) {
+  out += static_cast<char>(value & 0xFF);
+  out += static_cast<char>((value >> 8) & 0xFF);
+}
+
+void put32(std::string& out, uint32_t value) {
+  put16(out, value & 0xFFFF);
+  put16(out, value >> 16);
+}
+
+std::string buildZip(const std::vector<ZipItem>& items) {
+  std::string zip;
+  std::string directory;
+  for (const ZipItem& item : items) {
+    const bool deflated = !item.compressed.empty();
+    const std::string& payload = deflated ? item.compressed : item.content;
+    const uint32_t offset = static_cast<uint32_t>(zip.size());
+    const uint32_t crc = crc32(item.content);
+
+    put32(zip, 0x04034b50);
+    put16(zip, 20);
+    put16(zip, 0);
+    put16(zip, deflated ? 8 : 0);
+    put32(zip, 0);  // Time, date
+    put32(zip, crc);
+    put32(zip, static_cast<uint32_t>(payload.size()));
+    put32(zip, static_cast<uint32_t>(item.content.size()));
+    put16(zip, static_cast<uint32_t>(item.name.size()));
+    put16(zip, 0);
+    zip += item.name + payload;
+
+    put32(directory, 0x02014b50);
+    put16(directory, 20);
+    put16(directory, 20);
+    put16(directory, 0);
+    put16(directory, deflated ? 8 : 0);
+    put32(directory, 0);
+    put32(directory, crc);
+    put32(directory, static_cast<uint32_t>(payload.size()));
+    put32(directory, static_cast<uint32_t>(item.content.size()));
+    put16(directory, static_cast<uint32_t>(item.name.size()));
+    put32(directory, 0);  // Extra and comment length
+    put32(directory, 0);  // Disk, internal attributes
+    put32(directory, 0);  // External attributes
+    put32(directory, offset);
+    directory += item.name;
+  }
+
+  const uint32_t directoryOffset = static_cast<uint32_t>(zip.size());
+  zip += directory;
+  put32(zip, 0x06054b50);
+  put32(zip, 0);
+  put16(zip, static_cast<uint32_t>(items.size()));
+  put16(zip, static_cast<uint32_t>(items.size()));
+  put32(zip, static_cast<uint32_t>(directory.size()));
+  put32(zip, directoryOffset);
+  put16(zip, 0);
+  return zip;
+}
+
+std::string wordDocument(const std::string& body) {
+  return "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\r\n"
+         "<w:document xmlns:w=\"http://schemas.openxmlformats.org/wordprocessingml/2006/main\" "
+         "xmlns:mc=\"http://schemas.openxmlformats.org/markup-compatibility/2006\">"
+         "<w:body>" + body + "<w:sectPr/></w:body></w:document>";
+}
+
+std::string paragraph(const std::string& text) {
+  return "<w:p><w:pPr><w:pStyle w:val=\"Standard\"/></w:pPr><w:r><w:t xml:space=\"preserve\">" + text +
+         "</w:t></w:r></w:p>";
+}
+
+// Logs every event; adjacent text is merged so splitting does not show
+class RecordingHandler : public XmlReader::Handler {
+public:
+  void startElement(std::string_view name, const XmlReader::Attributes& attributes) override {
+    log += "<" + std::string(name);
+    for (const auto& attribute : attributes) {
+      log += " " + std::string(attribute.name) + "=" + attribute.value;
+    }
+    log += ">";
+  }
+  void endElement(std::string_view name) override { log += "</" + std::string(name) + ">"; }
+  void characters(std::string_view text) override { log += text; }
+
+  std::string log;
+};
+
+std::string parseInPieces(const std::string& xml, size_t piece) {
+  RecordingHandler handler;
+  XmlReader reader(handler);
+  for (size_t offset = 0; offset < xml.size(); offset += piece) {
+    reader.feed(xml.data() + offset, std::min(piece, xml.size() - offset));
+  }
+  reader.finish();
+  return handler.log;
+}
+
+} // namespace
+
+TEST(InflaterTest, DecodesStoredFixedAndDynamicBlocks) {
+  EXPECT_EQ(inflate(STORED_STREAM), "Gehause 14");
+  EXPECT_EQ(inflate(FIXED_STREAM), "Die Welle 10 lagert im Lager 12.");
+  EXPECT_EQ(inflate(DYNAMIC_STREAM), dynamicText());
+}
+
+TEST(InflaterTest, BackReferencesAcrossWindowFlushes) {
+  // 32 KB of noise, then 400 maximal matches reaching back the full window
+  std::string expected;
+  FixedBlockWriter writer;
+  uint32_t x = 12345;
+  for (int i = 0; i < 32768; ++i) {
+    x = x * 1103515245u + 12345u;
+    const uint8_t byte = static_cast<uint8_t>(x >> 16);
+    writer.literal(byte);
+    expected += static_cast<char>(byte);
+  }
+  for (int i = 0; i < 400; ++i) {
+    writer.match258(32768);
+    for (int j = 0; j < 258; ++j) {
+      expected += expected[expected.size() - 32768];
+    }
+  }
+  const std::vector<uint8_t> stream = writer.finish();
+
+  Inflater inflater;
+  std::string out;
+  size_t largestPiece = 0;
+  const size_t total = inflater.inflate(stream.data(), stream.size(), [&](const uint8_t* data, size_t size) {
+    out.append(reinterpret_cast<const char*>(data), size);
+    largestPiece = std::max(largestPiece, size);
+  });
+  EXPECT_EQ(total, expected.size());
+  EXPECT_TRUE(out == expected);
+  EXPECT_LE(largestPiece, 64u * 1024);
+  EXPECT_EQ(inflater.inputConsumed(), stream.size());
+}
+
+TEST(InflaterTest, RejectsCorruptInput) {
+  std::vector<uint8_t> truncated(DYNAMIC_STREAM.begin(), DYNAMIC_STREAM.begin() + 100);
+  EXPECT_THROW(inflate(truncated), std::runtime_error);
+  EXPECT_THROW(inflate({0x07}), std::runtime_error);  // Block type 3
+  EXPECT_THROW(inflate({0x01, 0x0a, 0x00, 0xf4, 0xff}), std::runtime_error);  // LEN != ~NLEN
+
+  FixedBlockWriter writer;
+  writer.literal('a');
+  writer.match258(2);  // Before the start of the output
+  EXPECT_THROW(inflate(writer.finish()), std::runtime_error);
+}
+
+TEST(InflaterTest, ChecksStopBeforeEachBlock) {
+  // Two stored blocks, the first not final
+  const std::vector<uint8_t> stream = {0x00, 0x02, 0x00, 0xfd, 0xff, 'a', 'b',
+                                       0x01, 0x02, 0x00, 0xfd, 0xff, 'c', 'd'};
+  EXPECT_EQ(inflate(stream), "abcd");
+
+  std::stop_source stop;
+  stop.request_stop();
+  Inflater inflater;
+  bool called = false;
+  EXPECT_EQ(inflater.inflate(stream.data(), stream.size(), [&](const uint8_t*, size_t) { called = true; },
+                             stop.get_token()),
+            0u);
+  EXPECT_FALSE(called);
+}
+
+TEST(ZipArchiveTest, ExtractsStoredAndDeflatedEntries) {
+  const std::string zipped = buildZip({
+      {"[Content_Types].xml", "<Types/>", ""},
+      {"word/document.txt", dynamicText(), std::string(DYNAMIC_STREAM.begin(), DYNAMIC_STREAM.end())},
+  });
+  const TestSupport::TempPath file(".docx", zipped);
+  MappedFile mapped(file.path());
+  EXPECT_TRUE(ZipArchive::isZip(mapped.data(), mapped.size()));
+
+  ZipArchive archive(mapped);
+  ASSERT_EQ(archive.entries().size(), 2u);
+  EXPECT_EQ(archive.find("word/missing.xml"), nullptr);
+
+  for (const auto& [name, expected] : {std::pair<std::string, std::string>{"[Content_Types].xml", "<Types/>"},
+                                       {"word/document.txt", dynamicText()}}) {
+    const ZipArchive::Entry* entry = archive.find(name);
+    ASSERT_NE(entry, nullptr);
+    std::string out;
+    const size_t size = archive.extract(*entry, [&](const uint8_t* data, size_t length) {
+      out.append(reinterpret_cast<const char*>(data), length);
+    });
+    EXPECT_EQ(size, expected.size());
+    EXPECT_EQ(out, expected);
+  }
+  EXPECT_EQ(archive.bytesRead(), zipped.find("PK\x01\x02"));
+}
+
+TEST(ZipArchiveTest, RejectsDamagedArchives) {
+  std::string zipped = buildZip({{"a.txt", "Die Welle 10", ""}});
+  zipped[zipped.find("Welle")] = 'w';  // Content no longer matches the CRC
+  const TestSupport::TempPath damaged(".docx", zipped);
+  MappedFile mapped(damaged.path());
+  ZipArchive archive(mapped);
+  EXPECT_THROW(archive.extract(archive.entries()[0], [](const uint8_t*, size_t) {}), std::runtime_error);
+
+  const TestSupport::TempPath text(".docx", "Die Welle 10 ist kein Archiv, auch wenn sie lang genug ist.");
+  MappedFile mappedText(text.path());
+  EXPECT_FALSE(ZipArchive::isZip(mappedText.data(), mappedText.size()));
+  EXPECT_THROW(ZipArchive{mappedText}, std::runtime_error);
+}
+
+TEST(ZipArchiveTest, StopsInflatingAtTheDeclaredSize) {
+  // 1 byte declared, 258 KB of deflate output
+  FixedBlockWriter writer;
+  writer.literal('a');
+  for (int i = 0; i < 1000; ++i) {
+    writer.match258(1);
+  }
+  const std::vector<uint8_t> bomb = writer.finish();
+  const TestSupport::TempPath file(".docx",
+                                   buildZip({{"word/document.xml", "a", std::string(bomb.begin(), bomb.end())}}));
+  MappedFile mapped(file.path());
+  ZipArchive archive(mapped);
+
+  size_t received = 0;
+  EXPECT_THROW(archive.extract(archive.entries()[0], [&](const uint8_t*, size_t length) { received += length; }),
+               std::runtime_error);
+  EXPECT_LE(received, 1u);
+}
+
+TEST(ZipArchiveTest, RejectsEntriesAboveTheSizeLimit) {
+  const TestSupport::TempPath file(".docx", buildZip({{"word/document.xml", dynamicText(), ""}}));
+  MappedFile mapped(file.path());
+  ZipArchive archive(mapped, 1024);
+
+  bool called = false;
+  EXPECT_THROW(archive.extract(archive.entries()[0], [&](const uint8_t*, size_t) { called = true; }),
+               std::runtime_error);
+  EXPECT_FALSE(called);
+}
+
+TEST(XmlReaderTest, ReportsElementsAttributesAndDecodedText) {
+  const std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<!DOCTYPE doc [ <!ENTITY deg \"&#176;\"> ]>"
+      "<doc lang='de' n=\"a&amp;b\"><!-- Kommentar <x> -->"
+      "<p>Welle &lt;10&gt; &#x2013; &#223;&deg;</p><br/><![CDATA[<roh> & ]]></doc>";
+  const std::string expected =
+      "\n<doc lang=de n=a&b><p>Welle <10> \xE2\x80\x93 \xC3\x9F&deg;</p><br></br><roh> & </doc>";
+
+  for (size_t piece = 1; piece <= xml.size(); ++piece) {
+    EXPECT_EQ(parseInPieces(xml, piece), expected) << "piece " << piece;
+  }
+
+  RecordingHandler handler;
+  XmlReader reader(handler);
+  reader.feed(xml.data(), xml.size());
+  reader.finish();
+  EXPECT_EQ(reader.declaredEncoding(), "UTF-8");
+  EXPECT_EQ(XmlReader::localName("w:p"), "p");
+  EXPECT_EQ(XmlReader::localName("p"), "p");
+}
+
+TEST(XmlReaderTest, ThrowsOnUnterminatedMarkup) {
+  EXPECT_THROW(parseInPieces("<doc><p", 4), std::runtime_error);
+  EXPECT_THROW(parseInPieces("<doc><!-- Kommentar", 4), std::runtime_error);
+  EXPECT_THROW(parseInPieces("<doc a=b>", 4), std::runtime_error);
+  EXPECT_NO_THROW(parseInPieces("<doc>Welle 10", 4));  // Nesting is not validated
+}
+
+TEST(DocxImporterTest, ExtractsParagraphText) {
+  const std::string body =
+      paragraph("Die Welle 10 tr\xC3\xA4gt") +
+      "<w:p><w:pPr><w:tabs><w:tab w:val=\"left\" w:pos=\"720\"/></w:tabs></w:pPr>"
+      "<w:r><w:t>Lager</w:t></w:r><w:r><w:tab/><w:t>12</w:t><w:br/><w:t>A</w:t><w:noBreakHyphen/>"
+      "<w:t>B &amp; C</w:t><w:softHyphen/></w:r>"
+      "<w:del><w:r><w:delText>entfernt</w:delText></w:r></w:del>"
+      "<w:r><w:fldChar w:fldCharType=\"begin\"/></w:r><w:r><w:instrText> PAGE </w:instrText></w:r>"
+      "<w:r><mc:AlternateContent><mc:Choice Requires=\"wps\"><w:t>neu</w:t></mc:Choice>"
+      "<mc:Fallback><w:t>alt</w:t></mc:Fallback></mc:AlternateContent></w:r></w:p>"
+      "<w:p/>" + paragraph("Ende");
+  const TestSupport::TempPath file(".docx", buildZip({{"word/document.xml", wordDocument(body), ""}}));
+  MappedFile mapped(file.path());
+
+  std::wstring text;
+  const DocumentLoader::Result result =
+      DocumentLoader::load(mapped, [&](std::wstring&& chunk, size_t, size_t) { text += chunk; });
+
+  EXPECT_TRUE(result.completed);
+  EXPECT_EQ(result.format, DocumentLoader::Format::DOCX);
+  EXPECT_EQ(text, L"Die Welle 10 trägt\nLager\t12\nA-B & Cneu\n\nEnde\n");
+  EXPECT_EQ(result.characters, text.size());
+  EXPECT_EQ(result.paragraphs, 4u);
+  EXPECT_EQ(result.paragraphStarts, (std::vector<uint32_t>{0, 19, 39, 40}));
+}
+
+TEST(DocxImporterTest, ChunksMatchTheWholeDocument) {
+  std::string body;
+  std::wstring expected;
+  std::vector<uint32_t> starts;
+  for (int i = 0; i < 3000; ++i) {
+    starts.push_back(static_cast<uint32_t>(expected.size()));
+    body += paragraph("Die Welle " + std::to_string(i) + " lagert im Geh\xC3\xA4use.");
+    expected += L"Die Welle " + std::to_wstring(i) + L" lagert im Gehäuse.\n";
+  }
+  const std::string xml = wordDocument(body);
+  const std::string zipped = buildZip({{"docProps/app.xml", "<Properties/>", ""}, {"word/document.xml", xml, ""}});
+  const TestSupport::TempPath file(".docx", zipped);
+  MappedFile mapped(file.path());
+
+  std::wstring text;
+  size_t chunks = 0;
+  size_t lastDone = 0;
+  const DocumentLoader::Result result = DocxImporter::load(mapped, [&](std::wstring&& chunk, size_t done, size_t total) {
+    EXPECT_GE(done, lastDone);
+    EXPECT_EQ(total, mapped.size());
+    lastDone = done;
+    text += chunk;
+    ++chunks;
+  }, {}, 4096);
+
+  EXPECT_TRUE(result.completed);
+  EXPECT_TRUE(text == expected);
+  EXPECT_EQ(result.paragraphs, 3000u);
+  EXPECT_EQ(result.paragraphStarts, starts);
+  EXPECT_EQ(lastDone, mapped.size());
+  EXPECT_GT(chunks, 3u);  // Stored entries arrive 64 KB at a time
+}
+
+TEST(DocxImporterTest, RejectsZipWithoutDocument) {
+  const TestSupport::TempPath file(".docx", buildZip({{"content.xml", "<office:document/>", ""}}));
+  MappedFile mapped(file.path());
+  EXPECT_THROW(DocumentLoader::load(mapped, [](std::wstring&&, size_t, size_t) {}), std::runtime_error);
+}
+
+TEST(DocxImporterTest, TextFilesCountLines) {
+  const TestSupport::TempPath file(".txt", "Welle 10\r\n\r\nLager 12\rEnde");
+  MappedFile mapped(file.path());
+  for (size_t chunkBytes : {1u, 3u, 1024u}) {
+    const DocumentLoader::Result result = DocumentLoader::load(mapped, [](std::wstring&&, size_t, size_t) {},
+                                                               {}, chunkBytes);
+    EXPECT_EQ(result.format, DocumentLoader::Format::TEXT);
+    EXPECT_EQ(result.paragraphs, 4u) << "chunk bytes " << chunkBytes;
+    EXPECT_TRUE(result.paragraphStarts.empty());
+  }
+}
+
+TEST(DocxImporterTest, ParagraphsBoundTheScan) {
+  // A term ending one paragraph and a number starting the next are no reference
+  // sign; a line break (w:br) inside a paragraph does not separate them
+  const std::string body = paragraph("Die Welle") + paragraph("10 dreht sich.") +
+                           "<w:p><w:r><w:t>Das Lager</w:t><w:br/><w:t>12 steht.</w:t></w:r></w:p>";
+  const TestSupport::TempPath file(".docx", buildZip({{"word/document.xml", wordDocument(body), ""}}));
+  MappedFile mapped(file.path());
+  std::wstring text;
+  const DocumentLoader::Result result =
+      DocumentLoader::load(mapped, [&](std::wstring&& chunk, size_t, size_t) { text += chunk; });
+  ASSERT_EQ(text, L"Die Welle\n10 dreht sich.\nDas Lager\n12 steht.\n");
+
+  ScanPipeline pipeline(true);
+  pipeline.run(text);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"10"), 1u);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"12"), 1u);
+
+  pipeline.run(text, result.paragraphStarts);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"10"), 0u);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"12"), 1u);
+  // Positions stay offsets into the whole text
+  EXPECT_EQ(pipeline.context().db.positionsOfBz(L"12").front(), (std::pair<size_t, size_t>{29, 8}));
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "EditSession.h"
+#include "ScanPipeline.h"
+#include <sstream>
+
+/**
+ * Test suite for EditSession
+ * Covers applying and diffing edits, shifting paragraph tables, the session
+ * file format and synthesis.
+ */
+using Edit = EditSession::Edit;
+
+static Edit insertAt(int64_t timeMs, size_t position, const std::wstring& text) {
+  Edit edit;
+  edit.timeMs = timeMs;
+  edit.kind = Edit::Kind::INSERT;
+  edit.position = position;
+  edit.text = text;
+  return edit;
+}
+
+static Edit eraseAt(int64_t timeMs, size_t position, size_t length) {
+  Edit edit;
+  edit.timeMs = timeMs;
+  edit.kind = Edit::Kind::ERASE;
+  edit.position = position;
+  edit.length = length;
+  return edit;
+}
+
+// Applying edits
+TEST(EditSessionTest, ApplyInsertAndErase) {
+  std::wstring text = L"Die Welle 12";
+  EditSession::apply(text, insertAt(0, 4, L"lange "));
+  EXPECT_EQ(text, L"Die lange Welle 12");
+  EditSession::apply(text, eraseAt(0, 0, 4));
+  EXPECT_EQ(text, L"lange Welle 12");
+}
+
+TEST(EditSessionTest, ApplyClampsOutOfRangeEdits) {
+  std::wstring text = L"abc";
+  EditSession::apply(text, eraseAt(0, 2, 10));
+  EXPECT_EQ(text, L"ab");
+  EditSession::apply(text, insertAt(0, 99, L"z"));
+  EXPECT_EQ(text, L"abz");
+}
+
+// Diffing
+TEST(EditSessionTest, DiffFindsSingleInsertion) {
+  auto edits = EditSession::diff(L"Die Welle 12", L"Die Welle 12 und", 250);
+  ASSERT_EQ(edits.size(), 1u);
+  EXPECT_EQ(edits[0].kind, Edit::Kind::INSERT);
+  EXPECT_EQ(edits[0].position, 12u);
+  EXPECT_EQ(edits[0].text, L" und");
+  EXPECT_EQ(edits[0].timeMs, 250);
+}
+
+TEST(EditSessionTest, DiffReportsReplacementAsEraseThenInsert) {
+  const std::wstring before = L"Das Lager 14 hält";
+  const std::wstring after = L"Das Gehäuse 14 hält";
+  auto edits = EditSession::diff(before, after, 0);
+  ASSERT_EQ(edits.size(), 2u);
+  EXPECT_EQ(edits[0].kind, Edit::Kind::ERASE);
+  EXPECT_EQ(edits[1].kind, Edit::Kind::INSERT);
+
+  std::wstring text = before;
+  for (const auto& edit : edits) {
+    EditSession::apply(text, edit);
+  }
+  EXPECT_EQ(text, after);
+  EXPECT_TRUE(EditSession::diff(after, after, 0).empty());
+}
+
+// Paragraph tables
+TEST(EditSessionTest, ShiftParagraphsMovesLaterStarts) {
+  std::vector<uint32_t> starts{0, 10, 25};
+  EditSession::shiftParagraphs(starts, insertAt(0, 10, L"ab"));
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 10, 27}));
+  EditSession::shiftParagraphs(starts, eraseAt(0, 2, 3));
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 7, 24}));
+  // Erasing the break before a paragraph merges it into the previous one
+  EditSession::shiftParagraphs(starts, eraseAt(0, 6, 1));
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 23}));
+}
+
+TEST(EditSessionTest, ShiftParagraphsByReplacement) {
+  std::vector<uint32_t> starts{0, 10, 25};
+  // "abc" at 8..10 replaced by "x": the break before paragraph 10 is gone
+  EditSession::shiftParagraphs(starts, 8, 3, 1);
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 23}));
+  EditSession::shiftParagraphs(starts, 23, 0, 4);
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 23}));
+  EditSession::shiftParagraphs(starts, 22, 0, 4);
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 27}));
+}
+
+TEST(EditSessionTest, EditOutsideParagraphKeepsItsMatches) {
+  // "Welle" ends a paragraph and "10" starts the next; an edit in front of
+  // them must not turn the pair into a reference sign
+  const std::wstring before = L"Die Welle\n10 dreht sich.\nDas Lager 12 steht.\n";
+  std::vector<uint32_t> starts{0, 10, 25};
+  ScanPipeline pipeline(true);
+  pipeline.run(before, starts);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"10"), 0u);
+  EXPECT_EQ(pipeline.context().db.positionsOfBz(L"12").front(), (std::pair<size_t, size_t>{29, 8}));
+
+  const std::wstring after = L"Die große Welle\n10 dreht sich.\nDas Lager 12 steht.\n";
+  for (const Edit& edit : EditSession::diff(before, after, 0)) {
+    EditSession::shiftParagraphs(starts, edit);
+  }
+  EXPECT_EQ(starts, (std::vector<uint32_t>{0, 16, 31}));
+  pipeline.run(after, starts);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"10"), 0u);
+  EXPECT_EQ(pipeline.context().db.positionsOfBz(L"12").front(), (std::pair<size_t, size_t>{35, 8}));
+}
+
+// File format
+TEST(EditSessionTest, SaveLoadRoundTrip) {
+  EditSession session;
+  session.initialText = L"Zeile 1\nÄußere Welle 12\tund \\ Rest";
+  session.edits.push_back(insertAt(100, 3, L" neu\n"));
+  session.edits.push_back(eraseAt(250, 0, 2));
+  session.edits.push_back(insertAt(300, 0, L""));
+
+  std::stringstream file;
+  session.save(file);
+  EditSession loaded = EditSession::load(file);
+
+  EXPECT_EQ(loaded.initialText, session.initialText);
+  ASSERT_EQ(loaded.edits.size(), 3u);
+  EXPECT_EQ(loaded.edits[0].text, L" neu\n");
+  EXPECT_EQ(loaded.edits[0].timeMs, 100);
+  EXPECT_EQ(loaded.edits[1].kind, Edit::Kind::ERASE);
+  EXPECT_EQ(loaded.edits[1].length, 2u);
+  EXPECT_EQ(loaded.edits[2].text, L"");
+  EXPECT_EQ(loaded.finalText(), session.finalText());
+}
+
+TEST(EditSessionTest, LoadRejectsMalformedInput) {
+  std::istringstream noHeader("text abc\n");
+  EXPECT_THROW(EditSession::load(noHeader), std::runtime_error);
+
+  std::istringstream badEdit("bz-edit-session 1\ntext abc\n100 * 3 x\n");
+  EXPECT_THROW(EditSession::load(badEdit), std::runtime_error);
+}
+
+// Synthesis
+TEST(EditSessionTest, SynthesizedSessionTypesDocumentTerms) {
+  const std::wstring text = L"Die Vorrichtung 10 hat eine Welle 12. Die Welle 12 ist gelagert.";
+  EditSession::SynthesisOptions options;
+  options.bursts = 5;
+  options.backspacePercent = 20;
+  EditSession session = EditSession::synthesize(text, options);
+
+  ASSERT_FALSE(session.edits.empty());
+  for (size_t i = 1; i < session.edits.size(); ++i) {
+    EXPECT_GE(session.edits[i].timeMs, session.edits[i - 1].timeMs);
+  }
+  const std::wstring finalText = session.finalText();
+  EXPECT_GT(finalText.size(), text.size());
+  EXPECT_EQ(finalText.find(L'x'), std::wstring::npos);  // Every typo was corrected
+
+  // Deterministic for a given seed
+  EXPECT_EQ(EditSession::synthesize(text, options).finalText(), finalText);
+}
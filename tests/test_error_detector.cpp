@@ -70,12 +70,11 @@ protected:
     void clearDataStructures() {
         ctx.clearResults();
         ctx.multiWordBaseStems.clear();
-        ctx.clearedTextPositions.clear();
+        ctx.clearedTextAnchors.clear();
         ctx.clearedErrors.clear();
         noNumberPositions.clear();
         wrongTermBzPositions.clear();
         wrongArticlePositions.clear();
-        allErrorsPositions.clear();
     }
 
     // Helper to scan text and populate data structures
@@ -84,6 +83,16 @@ protected:
         TextScanner::scanText(text, analyzer, *singleWordRegex, *twoWordRegex, ctx);
     }
 
+    // Build the conflict graph and highlight its conflicts, as MainWindow does after a scan
+    void detectConflicts(wxRichTextCtrl* target) {
+        ctx.buildConflicts();
+        ErrorDetectorHelper::highlightConflicts(ctx, target, conflictStyle, wrongTermBzPositions);
+    }
+
+    bool bzFlagged(const std::wstring& bz) const {
+        return ctx.conflicts.bzFlagged(ctx.db.occurrences.findBz(bz));
+    }
+
     // Analyzer
     GermanTextAnalyzer analyzer;
 
@@ -103,10 +112,9 @@ protected:
     AnalysisContext ctx;
 
     // Error position vectors
-    std::vector<std::pair<int, int>> noNumberPositions;
-    std::vector<std::pair<int, int>> wrongTermBzPositions;
-    std::vector<std::pair<int, int>> wrongArticlePositions;
-    std::vector<std::pair<int, int>> allErrorsPositions;
+    ErrorPositions noNumberPositions;
+    ErrorPositions wrongTermBzPositions;
+    ErrorPositions wrongArticlePositions;
 };
 
 // Test 9: FindUnnumberedWords_Basic
@@ -118,8 +126,7 @@ TEST_F(ErrorDetectorTest, FindUnnumberedWords_Basic) {
 
     // Find unnumbered words
     ErrorDetectorHelper::findUnnumberedWords(text, analyzer, *wordRegex, ctx,
-                                            textBox, warningStyle, noNumberPositions,
-                                            allErrorsPositions);
+                                            textBox, warningStyle, noNumberPositions);
 
     // Should detect the second "Lager" without a number
     EXPECT_FALSE(noNumberPositions.empty());
@@ -141,8 +148,7 @@ TEST_F(ErrorDetectorTest, FindUnnumberedWords_MultiWord) {
 
     // Find unnumbered words
     ErrorDetectorHelper::findUnnumberedWords(text, analyzer, *wordRegex, ctx,
-                                            textBox, warningStyle, noNumberPositions,
-                                            allErrorsPositions);
+                                            textBox, warningStyle, noNumberPositions);
 
     // Should detect "erstes Lager" without number in the second occurrence
     EXPECT_FALSE(noNumberPositions.empty());
@@ -154,12 +160,7 @@ TEST_F(ErrorDetectorTest, DetectConflictingAssignments) {
 
     scanText(text);
 
-    // Check each BZ for unique assignment
-    for (const auto& [bz, stems] : ctx.db.bzToStems) {
-        ErrorDetectorHelper::isUniquelyAssigned(bz, ctx,
-                                               textBox, conflictStyle, wrongTermBzPositions,
-                                               allErrorsPositions);
-    }
+    detectConflicts(textBox);
 
     // Should detect conflicting assignment: same stem "lag" with different BZs
     EXPECT_FALSE(wrongTermBzPositions.empty());
@@ -174,15 +175,13 @@ TEST_F(ErrorDetectorTest, DetectSplitAssignments) {
 
     scanText(text);
 
-    // Check BZ "10" for unique assignment
-    bool isUnique = ErrorDetectorHelper::isUniquelyAssigned(
-        L"10", ctx, textBox, conflictStyle,
-        wrongTermBzPositions, allErrorsPositions);
+    detectConflicts(textBox);
 
     // Should detect split assignment: same BZ "10" for different terms
-    EXPECT_FALSE(isUnique);
+    EXPECT_TRUE(bzFlagged(L"10"));
 
     // Should highlight as wrong term/BZ (conflict)
+    EXPECT_EQ(wrongTermBzPositions.size(), 2);
     EXPECT_FALSE(wrongTermBzPositions.empty());
 }
 
@@ -196,8 +195,7 @@ TEST_F(ErrorDetectorTest, ArticleValidation_DefiniteVsIndefinite) {
 
     // Check article usage
     ErrorDetectorHelper::checkArticleUsage(text, analyzer, ctx,
-                                          textBox, articleWarningStyle, wrongArticlePositions,
-                                          allErrorsPositions);
+                                          textBox, articleWarningStyle, wrongArticlePositions);
 
     // BOTH occurrences should be flagged:
     // 1. First "der" is definite (should be indefinite for first occurrence)
@@ -236,8 +234,7 @@ TEST_F(ErrorDetectorTest, ArticleValidation_FirstOccurrenceBaseline) {
 
     // Check article usage
     ErrorDetectorHelper::checkArticleUsage(text, analyzer, ctx,
-                                          textBox, articleWarningStyle, wrongArticlePositions,
-                                          allErrorsPositions);
+                                          textBox, articleWarningStyle, wrongArticlePositions);
 
     // First "ein" is indefinite (correct for first occurrence)
     // Second "der" is definite (correct for subsequent occurrence)
@@ -254,8 +251,7 @@ TEST_F(ErrorDetectorTest, ArticleValidation_NoArticle) {
 
     // Check article usage
     ErrorDetectorHelper::checkArticleUsage(text, analyzer, ctx,
-                                          textBox, articleWarningStyle, wrongArticlePositions,
-                                          allErrorsPositions);
+                                          textBox, articleWarningStyle, wrongArticlePositions);
 
     // No error should be flagged because the subsequent article "der" is definite (correct)
     // The first occurrence having no article doesn't affect validation
@@ -271,13 +267,10 @@ TEST_F(ErrorDetectorTest, RespectClearedBZNumbers) {
     // Clear the error for BZ "10"
     ctx.clearedErrors.insert(L"10");
 
-    // Check BZ "10" for unique assignment
-    bool isUnique = ErrorDetectorHelper::isUniquelyAssigned(
-        L"10", ctx, textBox, conflictStyle,
-        wrongTermBzPositions, allErrorsPositions);
+    detectConflicts(textBox);
 
     // Should treat as unique (no error) because it was cleared
-    EXPECT_TRUE(isUnique);
+    EXPECT_FALSE(bzFlagged(L"10"));
 
     // No positions should be added
     EXPECT_TRUE(wrongTermBzPositions.empty());
@@ -295,12 +288,11 @@ TEST_F(ErrorDetectorTest, RespectClearedTextPositions) {
     size_t unnumberedEnd = unnumberedPos + 5;           // Length of "Lager"
 
     // Clear this specific position
-    ctx.clearedTextPositions.insert({unnumberedPos, unnumberedEnd});
+    ctx.clearedTextAnchors.add(text, unnumberedPos, unnumberedEnd);
 
     // Find unnumbered words
     ErrorDetectorHelper::findUnnumberedWords(text, analyzer, *wordRegex, ctx,
-                                            textBox, warningStyle, noNumberPositions,
-                                            allErrorsPositions);
+                                            textBox, warningStyle, noNumberPositions);
 
     // The cleared position should not be re-detected
     bool foundClearedPosition = false;
@@ -327,8 +319,7 @@ TEST_F(ErrorDetectorTest, ErrorPositionVectorGeneration) {
 
     // Find unnumbered words
     ErrorDetectorHelper::findUnnumberedWords(text, analyzer, *wordRegex, ctx,
-                                            textBox, warningStyle, noNumberPositions,
-                                            allErrorsPositions);
+                                            textBox, warningStyle, noNumberPositions);
 
     // Should have multiple errors (3 unnumbered "Lager" instances)
     EXPECT_GE(noNumberPositions.size(), 3);
@@ -338,16 +329,14 @@ TEST_F(ErrorDetectorTest, ErrorPositionVectorGeneration) {
         EXPECT_LT(start, end); // Start should be before end
         EXPECT_GE(start, 0);   // Should be non-negative
     }
-
-    // Verify allErrorsPositions also contains these
-    EXPECT_GE(allErrorsPositions.size(), noNumberPositions.size());
 }
 
 // Additional test: Verify isPositionCleared helper function
 TEST_F(ErrorDetectorTest, IsPositionClearedHelper) {
-    std::set<std::pair<size_t, size_t>> cleared;
-    cleared.insert({10, 20});
-    cleared.insert({30, 40});
+    const std::wstring text = L"Das Gehäuse 10 hat eine Welle 12, und eine Kupplung 14 hat es auch.";
+    ClearedAnchors cleared;
+    cleared.add(text, 10, 20);
+    cleared.add(text, 30, 40);
 
     // Test exact match
     EXPECT_TRUE(ErrorDetectorHelper::isPositionCleared(cleared, 10, 20));
@@ -359,7 +348,7 @@ TEST_F(ErrorDetectorTest, IsPositionClearedHelper) {
     EXPECT_FALSE(ErrorDetectorHelper::isPositionCleared(cleared, 10, 21)); // Slightly different end
 
     // Test empty set
-    std::set<std::pair<size_t, size_t>> emptyCleared;
+    ClearedAnchors emptyCleared;
     EXPECT_FALSE(ErrorDetectorHelper::isPositionCleared(emptyCleared, 10, 20));
 }
 
@@ -372,8 +361,7 @@ TEST_F(ErrorDetectorTest, ArticleValidation_MultipleTerms) {
 
     // Check article usage
     ErrorDetectorHelper::checkArticleUsage(text, analyzer, ctx,
-                                          textBox, articleWarningStyle, wrongArticlePositions,
-                                          allErrorsPositions);
+                                          textBox, articleWarningStyle, wrongArticlePositions);
 
     // All articles are correct:
     // - "Lager" first: indefinite (ein) ✓, second: definite (der) ✓
@@ -388,11 +376,7 @@ TEST_F(ErrorDetectorTest, ConflictingAssignments_AfterClearing) {
     scanText(text);
 
     // Initially, all should be flagged as conflicts
-    for (const auto& [bz, stems] : ctx.db.bzToStems) {
-        ErrorDetectorHelper::isUniquelyAssigned(bz, ctx,
-                                               textBox, conflictStyle, wrongTermBzPositions,
-                                               allErrorsPositions);
-    }
+    detectConflicts(textBox);
 
     size_t initialErrorCount = wrongTermBzPositions.size();
     EXPECT_GT(initialErrorCount, 0);
@@ -407,15 +391,28 @@ TEST_F(ErrorDetectorTest, ConflictingAssignments_AfterClearing) {
     ctx.clearedErrors.insert(L"30");
 
     // Check again
+    detectConflicts(textBox);
     for (const auto& [bz, stems] : ctx.db.bzToStems) {
-        bool isUnique = ErrorDetectorHelper::isUniquelyAssigned(
-            bz, ctx, textBox, conflictStyle,
-            wrongTermBzPositions, allErrorsPositions);
-
         // All should be treated as unique now
-        EXPECT_TRUE(isUnique);
+        EXPECT_FALSE(bzFlagged(bz));
     }
 
     // No new errors should be added
     EXPECT_TRUE(wrongTermBzPositions.empty());
 }
+
+// Detection runs headless (benchmarks) when no text control is given
+TEST_F(ErrorDetectorTest, HeadlessDetection_NullTextBox) {
+    std::wstring text = L"Das Lager 10 und ein Lager ohne Nummer. Ein Lager 12 ist gut.";
+    scanText(text);
+
+    ErrorDetectorHelper::findUnnumberedWords(text, analyzer, *wordRegex, ctx,
+                                            nullptr, warningStyle, noNumberPositions);
+    ErrorDetectorHelper::checkArticleUsage(text, analyzer, ctx, nullptr, articleWarningStyle,
+                                          wrongArticlePositions);
+    detectConflicts(nullptr);
+
+    EXPECT_FALSE(noNumberPositions.empty());
+    EXPECT_FALSE(wrongArticlePositions.empty());
+    EXPECT_FALSE(wrongTermBzPositions.empty());
+}
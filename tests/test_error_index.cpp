@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "ErrorIndex.h"
+#include "ScanPipeline.h"
+#include "CorpusGenerator.h"
+#include <algorithm>
+#include <random>
+
+/**
+ * Test suite for ErrorIndex
+ * The merge must equal sorting the concatenation; lookups must agree with a linear scan.
+ */
+namespace {
+
+ErrorPositions positions(std::initializer_list<std::pair<int, int>> ranges) {
+  return ErrorPositions(ranges.begin(), ranges.end());
+}
+
+} // namespace
+
+TEST(ErrorIndexTest, MergeSortsAndDeduplicates) {
+  ErrorPositions noNumber = positions({{40, 45}, {10, 15}, {10, 15}});
+  ErrorPositions wrongTermBz = positions({{20, 28}, {0, 8}});
+  ErrorPositions wrongArticle = positions({{16, 19}, {40, 45}});
+  ErrorPositions all = positions({{99, 100}});
+
+  ErrorIndex index;
+  index.build({&noNumber, &wrongTermBz, &wrongArticle}, all);
+  EXPECT_EQ(noNumber, positions({{10, 15}, {40, 45}}));
+  EXPECT_EQ(wrongTermBz, positions({{0, 8}, {20, 28}}));
+  EXPECT_EQ(all, positions({{0, 8}, {10, 15}, {16, 19}, {20, 28}, {40, 45}}));
+  EXPECT_EQ(index.count(ErrorIndex::NoNumber), 2u);
+  EXPECT_EQ(index.count(ErrorIndex::WrongTermBz), 2u);
+  EXPECT_EQ(index.count(ErrorIndex::WrongArticle), 2u);
+  EXPECT_EQ(index.total(), 5u);
+
+  index.clear();
+  EXPECT_EQ(index.total(), 0u);
+  EXPECT_EQ(index.count(ErrorIndex::NoNumber), 0u);
+}
+
+TEST(ErrorIndexTest, NextAndPreviousFromTheCursor) {
+  const ErrorPositions all = positions({{0, 8}, {10, 15}, {10, 20}, {30, 35}});
+
+  // Caret before, inside and after errors
+  EXPECT_EQ(ErrorIndex::nextAfter(all, 9, 9), 1u);
+  EXPECT_EQ(ErrorIndex::nextAfter(all, 10, 10), 1u);
+  EXPECT_EQ(ErrorIndex::nextAfter(all, 12, 12), 3u);
+  EXPECT_EQ(ErrorIndex::nextAfter(all, 36, 36), 0u);  // Wraps
+  EXPECT_EQ(ErrorIndex::previousBefore(all, 12, 12), 2u);
+  EXPECT_EQ(ErrorIndex::previousBefore(all, 0, 0), 3u);  // Wraps
+
+  // From a selected error, also between errors with the same start
+  EXPECT_EQ(ErrorIndex::nextAfter(all, 10, 15), 2u);
+  EXPECT_EQ(ErrorIndex::previousBefore(all, 10, 20), 1u);
+  EXPECT_EQ(ErrorIndex::previousBefore(all, 10, 15), 0u);
+
+  const ErrorPositions none;
+  EXPECT_EQ(ErrorIndex::nextAfter(none, 0, 0), std::nullopt);
+  EXPECT_EQ(ErrorIndex::previousBefore(none, 0, 0), std::nullopt);
+}
+
+TEST(ErrorIndexTest, ErrorAtPosition) {
+  ErrorPositions noNumber = positions({{10, 30}, {12, 15}});
+  ErrorPositions wrongTermBz = positions({{40, 48}});
+  ErrorPositions wrongArticle = positions({{0, 3}});
+  ErrorPositions all;
+  ErrorIndex index;
+  index.build({&noNumber, &wrongTermBz, &wrongArticle}, all);
+
+  EXPECT_EQ(index.errorAt(all, 0), 0u);
+  EXPECT_EQ(index.errorAt(all, 3), std::nullopt);  // End is exclusive
+  EXPECT_EQ(index.errorAt(all, 13), 2u);           // The inner of two overlapping errors
+  EXPECT_EQ(index.errorAt(all, 20), 1u);           // Only the outer one contains it
+  EXPECT_EQ(index.errorAt(all, 35), std::nullopt);
+  EXPECT_EQ(index.errorAt(all, 47), 3u);
+  EXPECT_EQ(index.errorAt(all, 1000), std::nullopt);
+}
+
+TEST(ErrorIndexTest, AgreesWithLinearScanOnManyErrors) {
+  std::mt19937 random(46);
+  std::array<ErrorPositions, ErrorIndex::CategoryCount> categories;
+  for (int i = 0; i < 100000; ++i) {
+    const int start = static_cast<int>(random() % 1000000);
+    categories[random() % ErrorIndex::CategoryCount].emplace_back(start, start + 1 + static_cast<int>(random() % 30));
+  }
+  ErrorPositions expected;
+  for (const ErrorPositions& category : categories) {
+    expected.insert(expected.end(), category.begin(), category.end());
+  }
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+  ErrorPositions all;
+  ErrorIndex index;
+  index.build({&categories[0], &categories[1], &categories[2]}, all);
+  ASSERT_EQ(all, expected);
+  EXPECT_EQ(index.total(), expected.size());
+
+  for (int probe = 0; probe < 500; ++probe) {
+    const long position = static_cast<long>(random() % 1000050);
+    std::optional<size_t> linear;
+    for (size_t i = 0; i < all.size(); ++i) {
+      if (all[i].first <= position && position < all[i].second) {
+        linear = i;  // Last containing error wins, like errorAt()
+      }
+    }
+    ASSERT_EQ(index.errorAt(all, position), linear) << position;
+
+    const auto next = std::find_if(all.begin(), all.end(), [&](const auto& e) { return e.first >= position; });
+    EXPECT_EQ(ErrorIndex::nextAfter(all, position, position),
+              next == all.end() ? 0 : static_cast<size_t>(next - all.begin()));
+  }
+}
+
+TEST(ErrorIndexTest, PipelineListsAreSortedAndMerged) {
+  CorpusGenerator::Options options;
+  options.targetChars = 100000;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ScanPipeline pipeline(true);
+  pipeline.run(corpus.text);
+
+  const ErrorIndex& index = pipeline.errorIndex();
+  EXPECT_TRUE(std::is_sorted(pipeline.noNumberErrors().begin(), pipeline.noNumberErrors().end()));
+  EXPECT_TRUE(std::is_sorted(pipeline.wrongTermBzErrors().begin(), pipeline.wrongTermBzErrors().end()));
+  EXPECT_TRUE(std::is_sorted(pipeline.allErrors().begin(), pipeline.allErrors().end()));
+  EXPECT_EQ(index.count(ErrorIndex::NoNumber), pipeline.noNumberErrors().size());
+  EXPECT_EQ(index.count(ErrorIndex::WrongTermBz), pipeline.wrongTermBzErrors().size());
+  EXPECT_EQ(index.count(ErrorIndex::WrongArticle), pipeline.wrongArticleErrors().size());
+  EXPECT_EQ(index.total(), pipeline.allErrors().size());
+  for (const auto& [start, end] : pipeline.allErrors()) {
+    const std::optional<size_t> hit = index.errorAt(pipeline.allErrors(), start);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_LE(pipeline.allErrors()[*hit].first, start);
+  }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "LatencyReplay.h"
+
+/**
+ * Test suite for LatencyReplay
+ * Scan durations are measured, so tests check the scheduling structure and
+ * lower bounds rather than exact latencies.
+ */
+using Edit = EditSession::Edit;
+
+static EditSession typingSession(const std::vector<int64_t>& keyTimesMs) {
+  EditSession session;
+  session.initialText = L"Die Vorrichtung 10 hat eine Welle 12. ";
+  size_t position = session.initialText.size();
+  for (int64_t timeMs : keyTimesMs) {
+    Edit edit;
+    edit.timeMs = timeMs;
+    edit.position = position++;
+    edit.text = L"a";
+    session.edits.push_back(edit);
+  }
+  return session;
+}
+
+TEST(LatencyReplayTest, SingleEditWaitsForDebounce) {
+  LatencyReplay::Options options;
+  options.debounceMs = 200;
+  auto report = LatencyReplay::replay(typingSession({1000}), options);
+
+  ASSERT_EQ(report.editLatencyMs.size(), 1u);
+  EXPECT_GE(report.editLatencyMs[0], 200.0);
+  EXPECT_EQ(report.scansStarted, 1u);
+  EXPECT_EQ(report.uiUpdates, 1u);
+  EXPECT_EQ(report.inputDelayMs[0], 0.0);
+}
+
+TEST(LatencyReplayTest, BurstWithinDebounceScansOnce) {
+  LatencyReplay::Options options;
+  options.debounceMs = 500;
+  auto report = LatencyReplay::replay(typingSession({0, 100, 200, 300}), options);
+
+  EXPECT_EQ(report.scansStarted, 1u);
+  ASSERT_EQ(report.editLatencyMs.size(), 4u);
+  // All four edits appear in the same update; the first waited longest
+  EXPECT_GE(report.editLatencyMs[0], 800.0);
+  EXPECT_NEAR(report.editLatencyMs[0] - report.editLatencyMs[3], 300.0, 1e-6);
+}
+
+TEST(LatencyReplayTest, SpacedEditsEachGetAScan) {
+  LatencyReplay::Options options;
+  options.debounceMs = 50;
+  auto report = LatencyReplay::replay(typingSession({0, 5000, 10000}), options);
+
+  EXPECT_EQ(report.scansStarted, 3u);
+  EXPECT_EQ(report.uiUpdates, 3u);
+  for (double latency : report.editLatencyMs) {
+    EXPECT_GE(latency, 50.0);
+    EXPECT_LT(latency, 5000.0);
+  }
+}
+
+TEST(LatencyReplayTest, StyleCostAddsToUiStall) {
+  LatencyReplay::Options cheap;
+  cheap.debounceMs = 10;
+  LatencyReplay::Options expensive = cheap;
+  expensive.styleCostPerErrorUs = 1'000'000;  // 1 s per highlighted error
+
+  EditSession session = typingSession({0});
+  session.initialText += L"Der Motor ist schnell. Der Motor 14 dreht.";  // One unnumbered "Motor"
+  auto report = LatencyReplay::replay(session, expensive);
+
+  ASSERT_EQ(report.uiStallMs.size(), 1u);
+  EXPECT_GE(report.uiStallMs[0], 1000.0);
+  EXPECT_GE(report.editLatencyMs[0], 1010.0);
+  EXPECT_LT(LatencyReplay::replay(session, cheap).uiStallMs[0], 1000.0);
+}
+
+TEST(LatencyReplayTest, Percentiles) {
+  using Report = LatencyReplay::Report;
+  std::vector<double> values = {5, 1, 4, 2, 3, 6, 7, 8, 9, 10};
+  EXPECT_DOUBLE_EQ(Report::percentile(values, 0.5), 5.0);
+  EXPECT_DOUBLE_EQ(Report::percentile(values, 0.95), 10.0);
+  EXPECT_DOUBLE_EQ(Report::percentile(values, 0.1), 1.0);
+  EXPECT_DOUBLE_EQ(Report::percentile({}, 0.5), 0.0);
+  EXPECT_DOUBLE_EQ(Report::total(values), 55.0);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "Lexicon.h"
+#include "GermanTextAnalyzer.h"
+#include "EnglishTextAnalyzer.h"
+#include "ScanPipeline.h"
+
+namespace {
+constexpr auto TEST_WORDS = Lexicon::makeWordSet({L"der", L"die", L"das", L"über", L"figuren"});
+}
+
+// Compile-time tables
+TEST(LexiconTest, StaticTable_FindsAllEntries) {
+  constexpr auto view = TEST_WORDS.view();
+  EXPECT_TRUE(view.contains(L"der"));
+  EXPECT_TRUE(view.contains(L"die"));
+  EXPECT_TRUE(view.contains(L"das"));
+  EXPECT_TRUE(view.contains(L"über"));
+  EXPECT_TRUE(view.contains(L"figuren"));
+}
+
+TEST(LexiconTest, StaticTable_CaseInsensitive) {
+  constexpr auto view = TEST_WORDS.view();
+  EXPECT_TRUE(view.contains(L"DER"));
+  EXPECT_TRUE(view.contains(L"Über"));
+  EXPECT_TRUE(view.contains(L"ÜBER"));
+}
+
+TEST(LexiconTest, StaticTable_RejectsOtherWords) {
+  constexpr auto view = TEST_WORDS.view();
+  EXPECT_FALSE(view.contains(L""));
+  EXPECT_FALSE(view.contains(L"dem"));
+  EXPECT_FALSE(view.contains(L"uber"));
+  EXPECT_FALSE(view.contains(L"figurenx"));
+}
+
+TEST(LexiconTest, StaticTable_UsableInConstantExpressions) {
+  static_assert(TEST_WORDS.view().contains(L"Das"));
+  static_assert(!TEST_WORDS.view().contains(L"Dass"));
+  SUCCEED();
+}
+
+TEST(LexiconTest, StaticTable_ReturnsValues) {
+  constexpr Lexicon::Entry<int> entries[] = {{L"erste", 1}, {L"zweite", 2}};
+  constexpr Lexicon::StaticTable table(entries);
+  const int* value = table.view().find(L"Zweite");
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 2);
+  EXPECT_EQ(table.view().find(L"dritte"), nullptr);
+}
+
+// Runtime additions on top of a compile-time table
+TEST(LexiconTest, WordTable_AddedWordsAreFound) {
+  Lexicon::WordTable<bool> table(TEST_WORDS.view());
+  EXPECT_FALSE(table.contains(L"Vorrichtung"));
+  table.add(L"Vorrichtung", true);
+  EXPECT_TRUE(table.contains(L"vorrichtung"));
+  EXPECT_TRUE(table.contains(L"VORRICHTUNG"));
+  EXPECT_TRUE(table.contains(L"der"));  // Built-in entries still present
+  EXPECT_EQ(table.addedCount(), 1);
+}
+
+TEST(LexiconTest, WordTable_DuplicateAddIsIgnored) {
+  Lexicon::WordTable<bool> table(TEST_WORDS.view());
+  table.add(L"Welle", true);
+  table.add(L"WELLE", true);
+  EXPECT_EQ(table.addedCount(), 1);
+}
+
+TEST(LexiconTest, WordTable_GrowsBeyondInitialCapacity) {
+  Lexicon::WordTable<bool> table(TEST_WORDS.view());
+  for (int i = 0; i < 200; ++i) {
+    table.add(L"wort" + std::to_wstring(i), true);
+  }
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_TRUE(table.contains(L"WORT" + std::to_wstring(i)));
+  }
+  EXPECT_FALSE(table.contains(L"wort200"));
+  table.clearAdded();
+  EXPECT_FALSE(table.contains(L"wort1"));
+  EXPECT_TRUE(table.contains(L"die"));
+}
+
+// Analyzer integration
+TEST(LexiconTest, GermanAnalyzer_UserIgnoredWord) {
+  GermanTextAnalyzer analyzer;
+  EXPECT_FALSE(analyzer.isIgnoredWord(L"Ausführungsform"));
+  analyzer.addIgnoredWord(L"Ausführungsform");
+  EXPECT_TRUE(analyzer.isIgnoredWord(L"AUSFÜHRUNGSFORM"));
+  EXPECT_TRUE(analyzer.isIgnoredWord(L"Figur"));
+}
+
+TEST(LexiconTest, PipelineFollowsContextIgnoredWords) {
+  const std::wstring text = L"Die Welle 10 und das Getriebe 12.";
+  ScanPipeline pipeline(true);
+  pipeline.context().ignoredWords.insert(L"Getriebe");
+  pipeline.run(text);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"12"), 0u);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"10"), 1u);
+
+  // Kept across a language switch, dropped again when removed
+  pipeline.setLanguage(false);
+  pipeline.setLanguage(true);
+  pipeline.run(text);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"12"), 0u);
+  pipeline.context().ignoredWords.clear();
+  pipeline.run(text);
+  EXPECT_EQ(pipeline.context().db.bzToStems.count(L"12"), 1u);
+  EXPECT_FALSE(pipeline.analyzer().isIgnoredWord(L"Getriebe"));
+}
+
+TEST(LexiconTest, EnglishAnalyzer_UserIgnoredWord) {
+  EnglishTextAnalyzer analyzer;
+  EXPECT_FALSE(analyzer.isIgnoredWord(L"embodiment"));
+  analyzer.addIgnoredWord(L"embodiment");
+  EXPECT_TRUE(analyzer.isIgnoredWord(L"Embodiment"));
+  EXPECT_TRUE(analyzer.isIgnoredWord(L"with"));
+}
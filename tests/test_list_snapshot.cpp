@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "ListSnapshot.h"
+#include "SnapshotListModel.h"
+#include "ScanPipeline.h"
+#include "CorpusGenerator.h"
+
+/**
+ * Test suite for ListSnapshot and SnapshotListModel
+ * Rows must match the database and conflict flags; the models only index into them
+ * and replay a diff only onto the snapshot it was computed from.
+ */
+namespace {
+
+// Welle/Lager share 10 and Lager also has 12; Getriebe 14 is fine
+const std::wstring TEXT =
+    L"Die Welle 10 sitzt im Lager 10. Das Lager 12 ist neu. Das Getriebe 14 dreht die Welle 10.\n";
+
+wxString cell(const SnapshotListModel& model, unsigned int row, unsigned int col) {
+  wxVariant variant;
+  model.GetValueByRow(variant, row, col);
+  if (model.GetColumnType(col) == "wxDataViewIconText") {
+    wxDataViewIconText iconText;
+    iconText << variant;
+    return iconText.GetText();
+  }
+  return variant.GetString();
+}
+
+} // namespace
+
+TEST(ListSnapshotTest, RowsFollowTheDatabase) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  const auto snapshot = ListSnapshot::build(pipeline.context(), TEXT);
+
+  ASSERT_EQ(snapshot->bzRows.size(), 3u);
+  EXPECT_EQ(snapshot->bzRows[0].bz, L"10");
+  EXPECT_EQ(snapshot->bzRows[0].terms, L"Welle; Lager");  // Document order
+  EXPECT_EQ(snapshot->bzRows[0].firstTerm, L"Welle");
+  EXPECT_TRUE(snapshot->bzRows[0].flagged);
+  EXPECT_EQ(snapshot->bzRows[1].bz, L"12");
+  EXPECT_EQ(snapshot->bzRows[1].firstTerm, L"Lager");
+  EXPECT_TRUE(snapshot->bzRows[1].flagged);
+  EXPECT_EQ(snapshot->bzRows[2].bz, L"14");
+  EXPECT_EQ(snapshot->bzRows[2].terms, L"Getriebe");
+  EXPECT_FALSE(snapshot->bzRows[2].flagged);
+
+  ASSERT_EQ(snapshot->termRows.size(), 3u);
+  EXPECT_EQ(snapshot->termRows[0].term, L"Welle");
+  EXPECT_EQ(snapshot->termRows[1].term, L"Lager");
+  EXPECT_EQ(snapshot->termRows[1].bzs, (std::vector<std::wstring>{L"10", L"12"}));
+  EXPECT_EQ(snapshot->termRows[1].bzText, L"10, 12");
+  EXPECT_TRUE(snapshot->termRows[1].flagged);
+  EXPECT_EQ(snapshot->termRows[2].term, L"Getriebe");
+  EXPECT_FALSE(snapshot->termRows[2].flagged);
+  EXPECT_GT(snapshot->memoryBytes(), 0u);
+}
+
+TEST(ListSnapshotTest, ClearedNumberIsNotFlagged) {
+  ScanPipeline pipeline(true);
+  pipeline.context().clearedErrors.insert(L"12");
+  pipeline.run(TEXT);
+  const auto snapshot = ListSnapshot::build(pipeline.context(), TEXT);
+
+  ASSERT_EQ(snapshot->bzRows.size(), 3u);
+  EXPECT_TRUE(snapshot->bzRows[0].flagged);
+  EXPECT_FALSE(snapshot->bzRows[1].flagged);
+}
+
+TEST(ListSnapshotTest, ModelsReadRowsFromTheSnapshot) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  const auto snapshot = ListSnapshot::build(pipeline.context(), TEXT);
+
+  SnapshotListModel bzModel(SnapshotListModel::View::BzToTerms, wxIcon(), wxIcon());
+  SnapshotListModel termModel(SnapshotListModel::View::TermToBzs, wxIcon(), wxIcon());
+  SnapshotListModel signModel(SnapshotListModel::View::ReferenceSigns, wxIcon(), wxIcon());
+  EXPECT_EQ(bzModel.GetCount(), 0u);
+  bzModel.setSnapshot(snapshot);
+  termModel.setSnapshot(snapshot);
+  signModel.setSnapshot(snapshot);
+
+  EXPECT_EQ(bzModel.GetCount(), 3u);
+  EXPECT_EQ(cell(bzModel, 0, 0), "10");
+  EXPECT_EQ(cell(bzModel, 0, 1), "Welle; Lager");
+  EXPECT_EQ(termModel.GetCount(), 3u);
+  EXPECT_EQ(cell(termModel, 1, 0), "Lager");
+  EXPECT_EQ(cell(termModel, 1, 1), "10, 12");
+  EXPECT_EQ(cell(signModel, 2, 0), "14");
+  EXPECT_EQ(cell(signModel, 2, 1), "Getriebe");
+
+  // Rows of the other kind or past the end are not there
+  EXPECT_EQ(termModel.bzRow(0), nullptr);
+  EXPECT_EQ(bzModel.termRow(0), nullptr);
+  EXPECT_EQ(bzModel.bzRow(3), nullptr);
+
+  bzModel.setSnapshot(nullptr);
+  EXPECT_EQ(bzModel.GetCount(), 0u);
+}
+
+TEST(ListSnapshotTest, OneRowPerBzAndTermOnCorpus) {
+  CorpusGenerator::Options options;
+  options.targetChars = 100000;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ScanPipeline pipeline(true);
+  pipeline.run(corpus.text);
+  const AnalysisContext& ctx = pipeline.context();
+  const auto snapshot = ListSnapshot::build(ctx, corpus.text);
+
+  ASSERT_EQ(snapshot->bzRows.size(), ctx.db.bzToStems.size());
+  EXPECT_EQ(snapshot->termRows.size(), ctx.db.stemToBz.size());
+  size_t flagged = 0;
+  for (const ListSnapshot::BzRow& row : snapshot->bzRows) {
+    flagged += row.flagged;
+  }
+  EXPECT_EQ(flagged, pipeline.conflictingBz().size());
+}
+
+TEST(ListSnapshotTest, DiffMatchesRowsByBzAndStem) {
+  ScanPipeline pipeline(true);
+  const std::wstring first = L"Die Welle 10 und das Lager 12. Das Getriebe 14 und der Motor 16.";
+  pipeline.run(first);
+  const auto before = ListSnapshot::build(pipeline.context(), first);
+  // One edit: the bearing takes the shaft's number, a wheel is added
+  const std::wstring text = L"Die Welle 10 und das Lager 10. Das Getriebe 14 und der Motor 16, das Rad 18.";
+  pipeline.run(text);
+  const auto after = ListSnapshot::build(pipeline.context(), text, before.get());
+
+  EXPECT_GT(after->generation, before->generation);
+  EXPECT_EQ(after->bzDiff.baseGeneration, before->generation);
+  EXPECT_EQ(after->bzDiff.deleted, (std::vector<unsigned int>{1}));   // 12
+  EXPECT_EQ(after->bzDiff.inserted, (std::vector<unsigned int>{3}));  // 18
+  ASSERT_EQ(after->bzDiff.changed.size(), 1u);                       // 10 now names two terms
+  EXPECT_EQ(after->bzDiff.changed[0], std::make_pair(0u, 0u));
+  EXPECT_TRUE(after->termDiff.deleted.empty());
+  EXPECT_EQ(after->termDiff.inserted, (std::vector<unsigned int>{4}));  // Rad
+  EXPECT_EQ(after->termDiff.changed.size(), 2u);                       // Welle and Lager
+}
+
+TEST(ListSnapshotTest, MovedTermIsDeletedAndInserted) {
+  ScanPipeline pipeline(true);
+  const std::wstring first = L"Die Welle 10 und das Lager 12. Der Motor 16.";
+  pipeline.run(first);
+  const auto before = ListSnapshot::build(pipeline.context(), first);
+  const std::wstring second = L"Der Motor 16. Die Welle 10 und das Lager 12.";
+  pipeline.run(second);
+  const auto after = ListSnapshot::build(pipeline.context(), second, before.get());
+
+  EXPECT_EQ(after->bzDiff.operations(), 0u);
+  EXPECT_EQ(after->termDiff.deleted, (std::vector<unsigned int>{2}));
+  EXPECT_EQ(after->termDiff.inserted, (std::vector<unsigned int>{0}));
+  EXPECT_TRUE(after->termDiff.changed.empty());
+}
+
+TEST(ListSnapshotTest, ModelReplaysSmallDiffsOnly) {
+  CorpusGenerator::Options options;
+  options.targetChars = 100000;
+  CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ScanPipeline pipeline(true);
+  pipeline.run(corpus.text);
+  const auto before = ListSnapshot::build(pipeline.context(), corpus.text);
+  SnapshotListModel bzModel(SnapshotListModel::View::BzToTerms, wxIcon(), wxIcon());
+  SnapshotListModel termModel(SnapshotListModel::View::TermToBzs, wxIcon(), wxIcon());
+  EXPECT_EQ(bzModel.setSnapshot(before), SnapshotListModel::RESET);
+  termModel.setSnapshot(before);
+
+  // Rescanning unchanged text sends nothing
+  pipeline.run(corpus.text);
+  const auto same = ListSnapshot::build(pipeline.context(), corpus.text, before.get());
+  EXPECT_EQ(bzModel.setSnapshot(same), 0u);
+  EXPECT_EQ(termModel.setSnapshot(same), 0u);
+
+  // A new reference sign at the end is one inserted row in each list
+  const std::wstring edited = corpus.text + L" Der Zusatzhebel 9999 ist neu.";
+  pipeline.run(edited);
+  const auto after = ListSnapshot::build(pipeline.context(), edited, same.get());
+  EXPECT_EQ(bzModel.setSnapshot(after), 1u);
+  EXPECT_EQ(termModel.setSnapshot(after), 1u);
+  EXPECT_EQ(bzModel.GetCount(), after->bzRows.size());
+  EXPECT_EQ(termModel.GetCount(), after->termRows.size());
+
+  // Publishing the shown snapshot again keeps the rows (and the selection)
+  EXPECT_EQ(bzModel.setSnapshot(after), 0u);
+
+  // A snapshot diffed against another base resets
+  const auto unrelated = ListSnapshot::build(pipeline.context(), edited, before.get());
+  EXPECT_EQ(bzModel.setSnapshot(unrelated), SnapshotListModel::RESET);
+}
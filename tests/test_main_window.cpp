@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "MainWindow.h"
+#include "TestSupport.h"
+#include <functional>
+#include <future>
+#include <optional>
+#include <thread>
 #include <wx/wx.h>
 
 class TestApp : public wxApp {
@@ -7,6 +12,28 @@ public:
     virtual bool OnInit() override { return true; }
 };
 
+// Holds a mutex on another thread, as the scan thread holds the results lock, until destroyed
+class RunningScan {
+public:
+    explicit RunningScan(std::mutex& mutex) : m_thread([this, &mutex] {
+        std::lock_guard<std::mutex> lock(mutex);
+        m_locked.set_value();
+        m_finished.get_future().wait();
+    }) {
+        m_locked.get_future().wait();
+    }
+
+    ~RunningScan() {
+        m_finished.set_value();
+        m_thread.join();
+    }
+
+private:
+    std::promise<void> m_locked;
+    std::promise<void> m_finished;
+    std::thread m_thread;
+};
+
 class MainWindowTestBase : public ::testing::Test {
 protected:
     static void SetUpTestSuite() {
@@ -48,6 +75,61 @@ protected:
         if (window->m_scanThread.joinable()) {
             window->m_scanThread.join();
         }
+
+        // Publish the results (updateUIAfterScan via CallAfter)
+        wxTheApp->ProcessPendingEvents();
+    }
+
+    // Right-click row of the BZ tree (or the term list) and choose the menu item labelled
+    // choice, after running whileShown; false if no menu was shown
+    bool contextMenu(bool termList, unsigned int row, const wxString& choice,
+                     const std::function<void()>& whileShown = {}) {
+        bool shown = false;
+        window->setPopupChoice([&](wxMenu& menu) {
+            shown = true;
+            if (whileShown) {
+                whileShown();
+            }
+            return menu.FindItem(choice);
+        });
+        wxDataViewEvent event;
+        if (termList) {
+            event.SetItem(window->getTermModel()->GetItem(row));
+            window->onTermListContextMenu(event);
+        } else {
+            event.SetItem(window->getTreeModel()->GetItem(row));
+            window->onTreeListContextMenu(event);
+        }
+        window->setPopupChoice(nullptr);
+        return shown;
+    }
+
+    bool exportReport(const std::string& path) {
+        return window->exportReport(path, ReportExporter::Format::JSON);
+    }
+
+    // The lock a running scan holds
+    std::mutex& dataMutex() {
+        return window->m_dataMutex;
+    }
+
+    size_t pendingDecisions() {
+        return window->m_pendingDecisions.size();
+    }
+
+    // Row of bz in the BZ tree
+    unsigned int treeRow(const std::wstring& bz) {
+        for (unsigned int row = 0; window->getTreeModel()->bzRow(row) != nullptr; ++row) {
+            if (window->getTreeModel()->bzRow(row)->bz == bz) {
+                return row;
+            }
+        }
+        ADD_FAILURE() << "no tree row for BZ";
+        return 0;
+    }
+
+    std::vector<uint32_t>& paragraphStarts() {
+        return window->m_paragraphStarts;
     }
 
     size_t getTermCount() {
@@ -120,6 +202,38 @@ TEST_F(ScanWorkflowTest, UnnumberedTermsDetected) {
     EXPECT_TRUE(has10);
 }
 
+TEST_F(ScanWorkflowTest, ResultsMatchHeadlessPipeline) {
+    const std::wstring text = L"Die Welle 10 dreht im Lager 12. Das Getriebe 10 und die Welle. Ein Lager 12.";
+    setText(text);
+    scanAndWait();
+
+    ScanPipeline pipeline;
+    pipeline.run(text);
+    EXPECT_EQ(window->getWrongTermBzPositions(), pipeline.wrongTermBzErrors());
+    EXPECT_EQ(window->getNoNumberPositions(), pipeline.noNumberErrors());
+    EXPECT_FALSE(pipeline.wrongTermBzErrors().empty());
+    EXPECT_FALSE(pipeline.noNumberErrors().empty());
+}
+
+TEST_F(ScanWorkflowTest, ParagraphTableFollowsEdits) {
+    // "Welle" ends a paragraph and "10" starts the next, as loaded from a Word document
+    setText(L"Die Welle\n10 dreht sich.\nDas Lager 12 steht.\n");
+    paragraphStarts() = {0, 10, 25};
+
+    textBox->WriteText(4, L"große ");
+    EXPECT_EQ(paragraphStarts(), (std::vector<uint32_t>{0, 16, 31}));
+    scanAndWait();
+    EXPECT_FALSE(hasBZ(L"10"));
+    EXPECT_TRUE(hasBZ(L"12"));
+
+    // Replacing the break by a space merges the paragraphs
+    textBox->Remove(15, 16);
+    textBox->WriteText(15, L" ");
+    EXPECT_EQ(paragraphStarts(), (std::vector<uint32_t>{0, 31}));
+    scanAndWait();
+    EXPECT_TRUE(hasBZ(L"10"));
+}
+
 class UIStateManagementTest : public MainWindowTestBase {};
 
 TEST_F(UIStateManagementTest, BzListPopulated) {
@@ -193,11 +307,142 @@ TEST_F(ContextMenuTest, ClearErrorPersists) {
     EXPECT_TRUE(window->getContext().clearedErrors.count(L"10"));
 }
 
+TEST_F(ContextMenuTest, ClearErrorFromTreeMenu) {
+    setText(L"Die Welle 10 dreht. Das Getriebe 10 steht.");
+    scanAndWait();
+    ASSERT_FALSE(window->getWrongTermBzPositions().empty());
+    const unsigned int row = treeRow(L"10");
+    EXPECT_TRUE(window->getTreeModel()->bzRow(row)->flagged);
+
+    EXPECT_TRUE(contextMenu(false, row, "Clear error"));
+    scanAndWait();
+
+    EXPECT_TRUE(window->getContext().clearedErrors.count(L"10"));
+    EXPECT_TRUE(window->getWrongTermBzPositions().empty());
+    EXPECT_FALSE(window->getTreeModel()->bzRow(treeRow(L"10"))->flagged);
+
+    EXPECT_TRUE(contextMenu(false, treeRow(L"10"), "Restore error"));
+    scanAndWait();
+    EXPECT_FALSE(window->getContext().clearedErrors.count(L"10"));
+    EXPECT_FALSE(window->getWrongTermBzPositions().empty());
+}
+
+TEST_F(ContextMenuTest, ClearErrorFromTermMenu) {
+    setText(L"Das Lager 10 und das Lager 12.");
+    scanAndWait();
+    ASSERT_NE(window->getTermModel()->termRow(0), nullptr);
+    ASSERT_EQ(window->getTermModel()->termRow(0)->bzs.size(), 2u);
+    EXPECT_TRUE(window->getTermModel()->termRow(0)->flagged);
+
+    EXPECT_TRUE(contextMenu(true, 0, "Clear error for '10'"));
+    scanAndWait();
+
+    EXPECT_TRUE(window->getContext().clearedErrors.count(L"10"));
+    EXPECT_FALSE(window->getContext().clearedErrors.count(L"12"));
+}
+
+TEST_F(ContextMenuTest, IgnoreWordFromTermMenu) {
+    setText(L"Die Welle 10 und das Getriebe 12.");
+    scanAndWait();
+    ASSERT_TRUE(hasBZ(L"12"));
+    const unsigned int row = window->getTermModel()->termRow(0)->term == L"Getriebe" ? 0 : 1;
+
+    EXPECT_TRUE(contextMenu(true, row, "Never treat 'Getriebe' as a term"));
+    scanAndWait();
+    EXPECT_TRUE(window->getContext().ignoredWords.count(L"Getriebe"));
+    EXPECT_FALSE(hasBZ(L"12"));
+    EXPECT_TRUE(hasBZ(L"10"));
+
+    window->testRestoreIgnoredWords();
+    scanAndWait();
+    EXPECT_TRUE(hasBZ(L"12"));
+}
+
+TEST_F(ContextMenuTest, ToggleMultiWordFromTreeMenu) {
+    setText(L"Das Lager 10 und das Lager 12.");
+    scanAndWait();
+
+    const std::wstring baseStem = window->getContext().db.bzToStems.at(L"10").begin()->back();
+
+    EXPECT_TRUE(contextMenu(false, treeRow(L"10"), "Enable multi-word mode"));
+    scanAndWait();
+
+    EXPECT_TRUE(window->getContext().manualMultiWordToggles.count(baseStem));
+    EXPECT_TRUE(window->getContext().multiWordBaseStems.count(baseStem));
+}
+
+class ExportTest : public MainWindowTestBase {};
+
+TEST_F(ExportTest, WritesPublishedResults) {
+    setText(L"Die Welle 10 dreht. Das Getriebe 10 steht.");
+    scanAndWait();
+    const TestSupport::TempPath report(".json");
+    EXPECT_TRUE(exportReport(report.path()));
+    EXPECT_NE(report.read().find("Getriebe"), std::string::npos);
+}
+
+TEST_F(ExportTest, RefusedWhileRescanPending) {
+    setText(L"Die Welle 10 dreht.");
+    scanAndWait();
+    // Edited, the debounce timer has not fired yet
+    setText(L"Die Welle 10 dreht. Das Getriebe 10 steht.");
+    wxCommandEvent event(wxEVT_TEXT);
+    window->testDebounceFunc(event);
+
+    const TestSupport::TempPath report(".json");
+    EXPECT_FALSE(exportReport(report.path()));
+    EXPECT_FALSE(std::filesystem::exists(report.path()));
+
+    scanAndWait();
+    EXPECT_TRUE(exportReport(report.path()));
+}
+
+class ScanInProgressTest : public MainWindowTestBase {};
+
+TEST_F(ScanInProgressTest, ClearErrorChosenDuringScanIsQueued) {
+    setText(L"Die Welle 10 dreht. Das Getriebe 10 steht.");
+    scanAndWait();
+
+    // The menu opened before the scan started; choosing must neither block nor be lost
+    std::optional<RunningScan> scan;
+    EXPECT_TRUE(contextMenu(false, treeRow(L"10"), "Clear error", [&] { scan.emplace(dataMutex()); }));
+    EXPECT_EQ(pendingDecisions(), 1u);
+    scan.reset();
+
+    // Applied when the scan is published, which starts the rescan that drops the error
+    scanAndWait();
+    EXPECT_EQ(pendingDecisions(), 0u);
+    EXPECT_TRUE(window->getContext().clearedErrors.count(L"10"));
+    scanAndWait();
+    EXPECT_TRUE(window->getWrongTermBzPositions().empty());
+}
+
+TEST_F(ScanInProgressTest, NoContextMenuDuringScan) {
+    setText(L"Die Welle 10 dreht. Das Getriebe 10 steht.");
+    scanAndWait();
+    const unsigned int row = treeRow(L"10");
+    RunningScan scan(dataMutex());
+    EXPECT_FALSE(contextMenu(false, row, "Clear error"));
+    EXPECT_FALSE(contextMenu(true, 0, "Clear error for '10'"));
+}
+
+TEST_F(ScanInProgressTest, ExportRefusedDuringScan) {
+    setText(L"Die Welle 10 dreht. Das Getriebe 10 steht.");
+    scanAndWait();
+    const TestSupport::TempPath report(".json");
+    {
+        RunningScan scan(dataMutex());
+        EXPECT_FALSE(exportReport(report.path()));
+    }
+    EXPECT_FALSE(std::filesystem::exists(report.path()));
+    EXPECT_TRUE(exportReport(report.path()));
+}
+
 class LanguageSwitchingTest : public MainWindowTestBase {};
 
 TEST_F(LanguageSwitchingTest, DefaultAnalyzerIsGerman) {
     auto german = dynamic_cast<GermanTextAnalyzer*>(
-        window->m_currentAnalyzer.get());
+        window->getAnalyzer());
     EXPECT_NE(german, nullptr);
 }
 
@@ -207,7 +452,7 @@ TEST_F(LanguageSwitchingTest, CanSwitchLanguages) {
         selector->SetSelection(1);
         window->testOnLanguageChanged();
         auto english = dynamic_cast<EnglishTextAnalyzer*>(
-            window->m_currentAnalyzer.get());
+            window->getAnalyzer());
         EXPECT_NE(english, nullptr);
     }
 }
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "MemoryReport.h"
+#include "ScanPipeline.h"
+#include "CorpusGenerator.h"
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Test suite for the memory accounting and the per-input memory budget
+ */
+
+// heapBytes estimates
+
+TEST(MemoryUsageTest, ShortStringHasNoHeapBytes) {
+  EXPECT_EQ(MemoryUsage::heapBytes(std::wstring(L"ab")), 0u);
+}
+
+TEST(MemoryUsageTest, LongStringCountsCapacity) {
+  std::wstring text(1000, L'x');
+  EXPECT_GE(MemoryUsage::heapBytes(text), 1000 * sizeof(wchar_t));
+}
+
+TEST(MemoryUsageTest, VectorCountsCapacityAndElements) {
+  std::vector<size_t> numbers;
+  numbers.reserve(100);
+  EXPECT_EQ(MemoryUsage::heapBytes(numbers), 100 * sizeof(size_t));
+
+  std::vector<std::wstring> words(2, std::wstring(100, L'a'));
+  EXPECT_GE(MemoryUsage::heapBytes(words), 2 * sizeof(std::wstring) + 200 * sizeof(wchar_t));
+}
+
+TEST(MemoryUsageTest, NodeContainersCountNodes) {
+  std::map<int, int> tree{{1, 1}, {2, 2}, {3, 3}};
+  EXPECT_EQ(MemoryUsage::heapBytes(tree),
+            3 * (MemoryUsage::TREE_NODE_OVERHEAD + sizeof(std::pair<const int, int>)));
+
+  std::unordered_map<int, int> hash{{1, 1}, {2, 2}};
+  EXPECT_GE(MemoryUsage::heapBytes(hash), 2 * (MemoryUsage::HASH_NODE_OVERHEAD + sizeof(std::pair<const int, int>)));
+}
+
+// Report
+
+TEST(MemoryReportTest, TotalsAndLookup) {
+  MemoryReport report;
+  report.add("a", 1000);
+  report.add("b", 3000, true);
+  report.setInputCharacters(2000);
+
+  EXPECT_EQ(report.totalBytes(), 4000u);
+  EXPECT_EQ(report.bytesOf("b"), 3000u);
+  EXPECT_EQ(report.bytesOf("missing"), 0u);
+  EXPECT_DOUBLE_EQ(report.bytesPerMillionCharacters(), 2e6);
+}
+
+TEST(MemoryReportTest, WriteListsLargestFirst) {
+  MemoryReport report;
+  report.add("small", 10);
+  report.add("large", 5000, true);
+
+  std::ostringstream out;
+  report.write(out);
+  const std::string text = out.str();
+
+  EXPECT_LT(text.find("large"), text.find("small"));
+  EXPECT_NE(text.find("(during scan)"), std::string::npos);
+  EXPECT_NE(text.find("Total (estimated)"), std::string::npos);
+}
+
+// Budget on a generated document
+
+class MemoryBudgetTest : public ::testing::Test {
+protected:
+  static MemoryReport scanReport(size_t targetChars) {
+    CorpusGenerator::Options options;
+    options.targetChars = targetChars;
+    options.missingNumberPercent = 5;
+    options.conflictPercent = 2;
+    options.wrongArticlePercent = 2;
+    const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+
+    ScanPipeline pipeline;
+    pipeline.run(corpus.text);
+
+    MemoryReport report;
+    pipeline.reportMemory(report, corpus.text);
+    return report;
+  }
+};
+
+TEST_F(MemoryBudgetTest, ReportsEveryMajorStructure) {
+  const MemoryReport report = scanReport(50000);
+
+  EXPECT_GT(report.bytesOf("Document text (wchar_t)"), 0u);
+  EXPECT_GT(report.bytesOf("Match iterator: position map"), 0u);
+  EXPECT_GT(report.bytesOf("OccurrenceTable"), 0u);
+  EXPECT_GT(report.bytesOf("ReferenceDatabase: bzToStems"), 0u);
+  EXPECT_GT(report.bytesOf("Stem cache"), 0u);
+}
+
+TEST_F(MemoryBudgetTest, StaysWithinBudgetPerMillionCharacters) {
+  const MemoryReport report = scanReport(500000);
+  const double perMillion = report.bytesPerMillionCharacters();
+  std::ostringstream table;
+  report.write(table);
+  SCOPED_TRACE(table.str());
+
+  // Measured about 14 MB per million characters, over half of it the match
+  // iterator's position map; the budget leaves headroom for library
+  // differences but catches a structure that grows per character
+  EXPECT_LT(perMillion, 20e6);
+
+  size_t steadyState = 0;
+  for (const MemoryReport::Entry& entry : report.entries()) {
+    if (!entry.transient) {
+      steadyState += entry.bytes;
+    }
+  }
+  EXPECT_LT(static_cast<double>(steadyState) * 1e6 / static_cast<double>(report.inputCharacters()), 8e6);
+}
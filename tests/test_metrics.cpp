@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "Metrics.h"
+#include "ScanPipeline.h"
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/**
+ * Test suite for the metrics registry and the scan counters feeding it
+ * The registry is process-global, so every test starts from zeroed values.
+ */
+class MetricsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Metrics::resetAll();
+  }
+
+  static std::string exposition() {
+    std::ostringstream out;
+    Metrics::writeText(out);
+    return out.str();
+  }
+
+  static uint64_t counterValue(const std::string& name, const std::string& labels = "") {
+    return Metrics::counter(name, "", labels).value();
+  }
+};
+
+// Counters
+TEST_F(MetricsTest, CounterReturnsSameInstanceForSameName) {
+  Metrics::Counter& first = Metrics::counter("test_same_total", "Test counter");
+  Metrics::Counter& second = Metrics::counter("test_same_total", "Test counter");
+  EXPECT_EQ(&first, &second);
+
+  Metrics::Counter& labelled = Metrics::counter("test_same_total", "Test counter", "kind=\"a\"");
+  EXPECT_NE(&first, &labelled);
+}
+
+TEST_F(MetricsTest, CounterAddsAcrossThreads) {
+  Metrics::Counter& counter = Metrics::counter("test_threads_total", "Test counter");
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&counter] {
+      for (int i = 0; i < 10000; ++i) {
+        counter.add();
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  EXPECT_EQ(counter.value(), 40000u);
+
+  Metrics::resetAll();
+  EXPECT_EQ(counter.value(), 0u);
+}
+
+// Histograms
+TEST_F(MetricsTest, HistogramBucketsAndQuantiles) {
+  Metrics::Histogram& histogram = Metrics::histogram("test_latency_ms", "Test histogram", {1, 10, 100});
+  histogram.observe(0.5);
+  histogram.observe(1.0);   // Upper bounds are inclusive
+  histogram.observe(5.0);
+  histogram.observe(500.0);
+
+  std::vector<uint64_t> expected = {2, 1, 0, 1};
+  EXPECT_EQ(histogram.bucketCounts(), expected);
+  EXPECT_EQ(histogram.count(), 4u);
+  EXPECT_DOUBLE_EQ(histogram.sum(), 506.5);
+  EXPECT_DOUBLE_EQ(histogram.quantileUpperBound(0.5), 1.0);
+  EXPECT_DOUBLE_EQ(histogram.quantileUpperBound(0.75), 10.0);
+  EXPECT_TRUE(std::isinf(histogram.quantileUpperBound(1.0)));
+}
+
+TEST_F(MetricsTest, SizeLabels) {
+  EXPECT_EQ(Metrics::sizeLabel(0), "size=\"10K\"");
+  EXPECT_EQ(Metrics::sizeLabel(10'000), "size=\"100K\"");
+  EXPECT_EQ(Metrics::sizeLabel(999'999), "size=\"1M\"");
+  EXPECT_EQ(Metrics::sizeLabel(50'000'000), "size=\"10M+\"");
+}
+
+// Exposition
+TEST_F(MetricsTest, TextExpositionFormat) {
+  Metrics::counter("test_expo_total", "Exposition counter", "pattern=\"x\"").add(3);
+  Metrics::Histogram& histogram =
+      Metrics::histogram("test_expo_ms", "Exposition histogram", {1, 2}, "size=\"10K\"");
+  histogram.observe(1.5);
+  histogram.observe(7);
+
+  const std::string text = exposition();
+  EXPECT_NE(text.find("# HELP test_expo_total Exposition counter\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_expo_total counter\n"), std::string::npos);
+  EXPECT_NE(text.find("test_expo_total{pattern=\"x\"} 3\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_expo_ms histogram\n"), std::string::npos);
+  EXPECT_NE(text.find("test_expo_ms_bucket{size=\"10K\",le=\"1\"} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("test_expo_ms_bucket{size=\"10K\",le=\"2\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("test_expo_ms_bucket{size=\"10K\",le=\"+Inf\"} 2\n"), std::string::npos);
+  EXPECT_NE(text.find("test_expo_ms_sum{size=\"10K\"} 8.5\n"), std::string::npos);
+  EXPECT_NE(text.find("test_expo_ms_count{size=\"10K\"} 2\n"), std::string::npos);
+}
+
+// Scan instrumentation
+TEST_F(MetricsTest, ScanPipelineFeedsCounters) {
+  const std::wstring text =
+      L"Die Vorrichtung 10 hat ein Gehäuse 12. Die Vorrichtung 10 und das Gehäuse 12 "
+      L"sind verbunden. Der erste Hebel 14 und der zweite Hebel 16 greifen in die Welle.";
+
+  ScanPipeline pipeline(true);
+  pipeline.run(text);
+
+  EXPECT_EQ(counterValue("bz_scans_total"), 1u);
+  EXPECT_EQ(counterValue("bz_ordinal_stems_detected_total"), 1u);
+  EXPECT_EQ(counterValue("bz_terms_recorded_total", "pattern=\"two_word\""), 2u);
+  EXPECT_EQ(counterValue("bz_terms_recorded_total", "pattern=\"single_word\""), 4u);
+  // "erste Hebel 14" also matches the single-word pattern as "Hebel 14"
+  EXPECT_EQ(counterValue("bz_overlap_rejections_total"), 2u);
+  EXPECT_GT(counterValue("bz_stem_cache_misses_total"), 0u);
+  EXPECT_EQ(counterValue("bz_set_style_calls_total"), 0u);  // Headless: nothing styled
+
+  // A second scan of the same text answers every stem from the cache
+  const uint64_t missesAfterFirst = counterValue("bz_stem_cache_misses_total");
+  pipeline.run(text);
+  EXPECT_EQ(counterValue("bz_stem_cache_misses_total"), missesAfterFirst);
+  EXPECT_GT(counterValue("bz_stem_cache_hits_total"), 0u);
+
+  Metrics::Histogram& latency =
+      Metrics::histogram("bz_scan_duration_ms", "", Metrics::LATENCY_BUCKETS_MS, "size=\"10K\"");
+  EXPECT_EQ(latency.count(), 2u);
+}
+
+TEST_F(MetricsTest, IgnoredWordSkipsAreCounted) {
+  ScanPipeline pipeline(true);
+  pipeline.run(L"Wie in Figur 3 gezeigt, hat die Vorrichtung 10 eine Welle 12.");
+
+  EXPECT_EQ(counterValue("bz_ignored_word_skips_total"), 1u);
+  EXPECT_EQ(counterValue("bz_terms_recorded_total", "pattern=\"single_word\""), 2u);
+}
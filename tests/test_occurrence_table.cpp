@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "OccurrenceTable.h"
+#include "AnalysisContext.h"
+#include "TextScanner.h"
+#include "GermanTextAnalyzer.h"
+#include "RegexPatterns.h"
+#include <re2/re2.h>
+
+// Interning
+TEST(OccurrenceTableTest, Intern_ReturnsStableDenseIds) {
+  OccurrenceTable table;
+  uint32_t a = table.internBz(L"10");
+  uint32_t b = table.internBz(L"20");
+  EXPECT_EQ(a, 0u);
+  EXPECT_EQ(b, 1u);
+  EXPECT_EQ(table.internBz(L"10"), a);
+  EXPECT_EQ(table.findBz(L"20"), b);
+  EXPECT_EQ(table.findBz(L"30"), OccurrenceTable::NO_ID);
+  EXPECT_EQ(table.bzName(b), L"20");
+
+  StemVector stem = {L"lag"};
+  uint32_t s = table.internStem(stem);
+  EXPECT_EQ(table.internStem(stem), s);
+  EXPECT_EQ(table.stem(s), stem);
+  EXPECT_EQ(table.findStem({L"other"}), OccurrenceTable::NO_ID);
+}
+
+// Two appended runs (like the two scan passes) come out in document order
+TEST(OccurrenceTableTest, Finalize_MergesRunsIntoDocumentOrder) {
+  OccurrenceTable table;
+  uint32_t bz10 = table.internBz(L"10");
+  uint32_t bz20 = table.internBz(L"20");
+  uint32_t stemA = table.internStem({L"a"});
+  uint32_t stemB = table.internStem({L"b"});
+
+  // First run
+  table.add(bz20, stemB, 5, 3, OccurrenceKind::MULTI_WORD);
+  table.add(bz20, stemB, 40, 3, OccurrenceKind::MULTI_WORD);
+  // Second run
+  table.add(bz10, stemA, 0, 2, OccurrenceKind::SINGLE_WORD);
+  table.add(bz10, stemA, 20, 2, OccurrenceKind::SINGLE_WORD);
+  table.add(bz10, stemA, 60, 2, OccurrenceKind::SINGLE_WORD);
+  table.finalize();
+
+  ASSERT_EQ(table.size(), 5u);
+  std::vector<size_t> starts;
+  for (size_t i = 0; i < table.size(); ++i) {
+    starts.push_back(table.start(i));
+  }
+  EXPECT_EQ(starts, (std::vector<size_t>{0, 5, 20, 40, 60}));
+  EXPECT_EQ(table.bzId(1), bz20);
+  EXPECT_EQ(table.kind(1), OccurrenceKind::MULTI_WORD);
+  EXPECT_EQ(table.length(2), 2u);
+}
+
+TEST(OccurrenceTableTest, Finalize_MergesOddNumberOfRuns) {
+  OccurrenceTable table;
+  uint32_t bz = table.internBz(L"1");
+  uint32_t stem = table.internStem({L"x"});
+  for (size_t start : {30, 31, 10, 11, 20, 21, 0}) {
+    table.add(bz, stem, start, 1, OccurrenceKind::SINGLE_WORD);
+  }
+  table.finalize();
+
+  std::vector<size_t> starts;
+  for (auto [start, len] : table.positionsOfBz(bz)) {
+    starts.push_back(start);
+  }
+  EXPECT_EQ(starts, (std::vector<size_t>{0, 10, 11, 20, 21, 30, 31}));
+}
+
+// CSR views
+TEST(OccurrenceTableTest, Positions_PerKeySlicesInDocumentOrder) {
+  OccurrenceTable table;
+  uint32_t bz10 = table.internBz(L"10");
+  uint32_t bz20 = table.internBz(L"20");
+  uint32_t stemA = table.internStem({L"a"});
+  uint32_t stemB = table.internStem({L"b"});
+
+  table.add(bz10, stemA, 0, 4, OccurrenceKind::SINGLE_WORD);
+  table.add(bz20, stemB, 10, 5, OccurrenceKind::SINGLE_WORD);
+  table.add(bz10, stemB, 30, 6, OccurrenceKind::SINGLE_WORD);
+  table.finalize();
+
+  PositionRange bz10Positions = table.positionsOfBz(bz10);
+  ASSERT_EQ(bz10Positions.size(), 2u);
+  EXPECT_EQ(bz10Positions[0], (std::pair<size_t, size_t>{0, 4}));
+  EXPECT_EQ(bz10Positions.back(), (std::pair<size_t, size_t>{30, 6}));
+
+  PositionRange stemBPositions = table.positionsOfStem(stemB);
+  ASSERT_EQ(stemBPositions.size(), 2u);
+  EXPECT_EQ(stemBPositions.front().first, 10u);
+  EXPECT_EQ(stemBPositions[1].first, 30u);
+
+  EXPECT_TRUE(table.positionsOfBz(OccurrenceTable::NO_ID).empty());
+}
+
+TEST(OccurrenceTableTest, HasOccurrenceStartingAt) {
+  OccurrenceTable table;
+  uint32_t bz = table.internBz(L"10");
+  uint32_t stem = table.internStem({L"a"});
+  table.add(bz, stem, 12, 3, OccurrenceKind::SINGLE_WORD);
+  table.add(bz, stem, 3, 3, OccurrenceKind::SINGLE_WORD);
+  table.finalize();
+
+  EXPECT_TRUE(table.hasOccurrenceStartingAt(3));
+  EXPECT_TRUE(table.hasOccurrenceStartingAt(12));
+  EXPECT_FALSE(table.hasOccurrenceStartingAt(4));
+}
+
+TEST(OccurrenceTableTest, FirstSpelling_FirstOccurrenceWithoutNumber) {
+  const std::wstring text = L"Das Lager 12 und die Lager 12";
+  OccurrenceTable table;
+  uint32_t bz = table.internBz(L"12");
+  uint32_t stem = table.internStem({L"lag"});
+  uint32_t unused = table.internStem({L"well"});
+  table.add(bz, stem, 21, 8, OccurrenceKind::SINGLE_WORD);
+  table.add(bz, stem, 4, 8, OccurrenceKind::SINGLE_WORD);
+  table.finalize();
+
+  EXPECT_EQ(table.firstSpelling(stem, text), L"Lager");
+  EXPECT_EQ(table.firstSpelling(unused, text), L"");
+  EXPECT_EQ(table.firstSpelling(OccurrenceTable::NO_ID, text), L"");
+  EXPECT_EQ(table.firstSpelling(stem, L"Das"), L"");  // Positions past the end of another text
+}
+
+TEST(OccurrenceTableTest, Clear_ResetsEverything) {
+  OccurrenceTable table;
+  table.add(table.internBz(L"10"), table.internStem({L"a"}), 0, 1, OccurrenceKind::SINGLE_WORD);
+  table.finalize();
+  table.clear();
+
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.bzCount(), 0u);
+  EXPECT_EQ(table.stemCount(), 0u);
+  EXPECT_FALSE(table.isFinalized());
+}
+
+// Scanner integration: single-word and two-word passes land in one ordered table
+TEST(OccurrenceTableTest, ScanText_ProducesDocumentOrder) {
+  GermanTextAnalyzer analyzer;
+  re2::RE2 singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN);
+  re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+  AnalysisContext ctx;
+  ctx.multiWordBaseStems.insert(analyzer.createStemVector(L"Lager")[0]);
+
+  std::wstring text = L"Welle 5 und erstes Lager 10 sowie Welle 5";
+  TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+
+  const OccurrenceTable& occurrences = ctx.db.occurrences;
+  ASSERT_TRUE(occurrences.isFinalized());
+  ASSERT_EQ(occurrences.size(), 3u);
+  EXPECT_EQ(occurrences.kind(1), OccurrenceKind::MULTI_WORD);
+  for (size_t i = 1; i < occurrences.size(); ++i) {
+    EXPECT_LT(occurrences.start(i - 1), occurrences.start(i));
+  }
+  EXPECT_EQ(ctx.db.positionsOfBz(L"5").size(), 2u);
+  EXPECT_TRUE(ctx.db.positionsOfBz(L"99").empty());
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "PatentXmlReader.h"
+#include "ScanPipeline.h"
+#include <stdexcept>
+#include <string>
+
+/**
+ * Test suite for PatentXmlReader
+ * Section text, offsets and language selection on EP (ST.36) and DocDB samples.
+ */
+namespace {
+
+using SectionKind = PatentXmlReader::SectionKind;
+
+const std::string EP_DOCUMENT = R"xml(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE ep-patent-document PUBLIC "-//EPO//EP PATENT DOCUMENT 1.5//EN" "ep-patent-document-v1-5.dtd">
+<ep-patent-document id="EP1234567B1" file="EP01234567NWB1.xml" lang="de" country="EP" doc-number="1234567">
+  <SDOBI lang="de"><B540><B541>de</B541><B542>Getriebe</B542></B540></SDOBI>
+  <abstract id="abst" lang="de">
+    <p id="pa01" num="0001">Ein Getriebe mit einer Welle (10).</p>
+  </abstract>
+  <description id="desc" lang="de">
+    <heading id="h0001">BESCHREIBUNG</heading>
+    <p id="p0001" num="0001">Die Welle 10 ist im
+      Lager 12 gelagert, siehe <figref idref="f0001">Fig. 1</figref>.</p>
+    <p id="p0002" num="0002">Es gilt <maths id="math0001" num="(1)"><math><mi>x</mi></math></maths> f&#xFC;r das Lager 12.</p>
+    <tables id="tabl0001" num="0001"><table><tgroup cols="2"><tbody>
+      <row><entry>Welle</entry><entry>10</entry></row>
+    </tbody></tgroup></table></tables>
+  </description>
+  <claims id="claims01" lang="de">
+    <claim id="c-de-01-0001" num="0001"><claim-text>Getriebe, umfassend:
+      <claim-text>eine Welle (10) und</claim-text>
+      <claim-text>ein Lager (12).</claim-text></claim-text></claim>
+  </claims>
+  <claims id="claims02" lang="en">
+    <claim id="c-en-01-0001" num="0001"><claim-text>A gear comprising a shaft (10).</claim-text></claim>
+  </claims>
+  <claims id="claims03" lang="fr">
+    <claim id="c-fr-01-0001" num="0001"><claim-text>Engrenage comprenant un arbre (10).</claim-text></claim>
+  </claims>
+</ep-patent-document>
+)xml";
+
+const std::string DOCDB_DOCUMENT = R"xml(<?xml version="1.0" encoding="UTF-8"?>
+<exch:exchange-documents xmlns:exch="http://www.epo.org/exchange">
+<exch:exchange-document country="DE" doc-number="102020000001" kind="A1">
+  <exch:bibliographic-data><exch:invention-title lang="de">Lager</exch:invention-title></exch:bibliographic-data>
+  <exch:abstract lang="en" data-format="docdba"><exch:p>A bearing (12) for a shaft (10).</exch:p></exch:abstract>
+  <exch:abstract lang="de" data-format="original"><exch:p>Ein Lager (12) f&#252;r eine Welle (10).</exch:p></exch:abstract>
+</exch:exchange-document>
+</exch:exchange-documents>
+)xml";
+
+std::wstring sectionText(const std::wstring& text, const PatentXmlReader::Section& section) {
+  return text.substr(section.begin, section.end - section.begin);
+}
+
+} // namespace
+
+TEST(PatentXmlReaderTest, ExtractsSectionsOfAnEpDocument) {
+  std::wstring text;
+  const PatentXmlReader::Document document = PatentXmlReader::read(EP_DOCUMENT.data(), EP_DOCUMENT.size(), text);
+
+  EXPECT_EQ(document.language, "de");
+  EXPECT_EQ(document.skippedSections, 2u);  // English and French claims
+  ASSERT_EQ(document.sections.size(), 3u);
+  EXPECT_EQ(document.sections[0].kind, SectionKind::ABSTRACT);
+  EXPECT_EQ(document.sections[1].kind, SectionKind::DESCRIPTION);
+  EXPECT_EQ(document.sections[2].kind, SectionKind::CLAIMS);
+
+  EXPECT_EQ(sectionText(text, document.sections[0]), L"Ein Getriebe mit einer Welle (10).\n");
+  EXPECT_EQ(sectionText(text, document.sections[1]),
+            L"BESCHREIBUNG\n"
+            L"Die Welle 10 ist im Lager 12 gelagert, siehe Fig. 1.\n"
+            L"Es gilt für das Lager 12.\n"
+            L"Welle 10\n");
+  EXPECT_EQ(sectionText(text, document.sections[2]),
+            L"Getriebe, umfassend:\neine Welle (10) und\nein Lager (12).\n");
+
+  // Sections are contiguous and cover the whole text
+  EXPECT_EQ(document.sections[0].begin, 0u);
+  EXPECT_EQ(document.sections[1].begin, document.sections[0].end);
+  EXPECT_EQ(document.sections[2].begin, document.sections[1].end);
+  EXPECT_EQ(document.sections[2].end, text.size());
+}
+
+TEST(PatentXmlReaderTest, RequestedLanguageSelectsSections) {
+  std::wstring text;
+  const PatentXmlReader::Document document =
+      PatentXmlReader::read(EP_DOCUMENT.data(), EP_DOCUMENT.size(), text, "EN");
+  EXPECT_EQ(document.language, "en");
+  ASSERT_EQ(document.sections.size(), 1u);
+  EXPECT_EQ(document.sections[0].kind, SectionKind::CLAIMS);
+  EXPECT_EQ(text, L"A gear comprising a shaft (10).\n");
+  EXPECT_EQ(document.skippedSections, 4u);
+}
+
+TEST(PatentXmlReaderTest, MatchesDocDbElementsByLocalName) {
+  std::wstring text;
+  PatentXmlReader::Document document = PatentXmlReader::read(DOCDB_DOCUMENT.data(), DOCDB_DOCUMENT.size(), text);
+  // No lang on the root: the first section decides
+  EXPECT_EQ(document.language, "en");
+  EXPECT_EQ(text, L"A bearing (12) for a shaft (10).\n");
+
+  document = PatentXmlReader::read(DOCDB_DOCUMENT.data(), DOCDB_DOCUMENT.size(), text, "de");
+  EXPECT_EQ(text, L"Ein Lager (12) für eine Welle (10).\n");
+  ASSERT_EQ(document.sections.size(), 1u);
+  EXPECT_EQ(document.sections[0].language, "de");
+}
+
+TEST(PatentXmlReaderTest, SectionAtMapsPositions) {
+  std::wstring text;
+  const PatentXmlReader::Document document = PatentXmlReader::read(EP_DOCUMENT.data(), EP_DOCUMENT.size(), text);
+  EXPECT_EQ(document.sectionAt(0)->kind, SectionKind::ABSTRACT);
+  EXPECT_EQ(document.sectionAt(document.sections[1].begin)->kind, SectionKind::DESCRIPTION);
+  EXPECT_EQ(document.sectionAt(document.sections[2].end - 1)->kind, SectionKind::CLAIMS);
+  EXPECT_EQ(document.sectionAt(text.size()), nullptr);
+}
+
+TEST(PatentXmlReaderTest, ReusesTheTextBuffer) {
+  std::wstring text;
+  PatentXmlReader::read(EP_DOCUMENT.data(), EP_DOCUMENT.size(), text);
+  const size_t capacity = text.capacity();
+  PatentXmlReader::read(DOCDB_DOCUMENT.data(), DOCDB_DOCUMENT.size(), text);
+  EXPECT_EQ(text, L"A bearing (12) for a shaft (10).\n");
+  EXPECT_EQ(text.capacity(), capacity);
+}
+
+TEST(PatentXmlReaderTest, RejectsUnsupportedInput) {
+  std::wstring text;
+  const std::string latin1 = "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?><doc/>";
+  EXPECT_THROW(PatentXmlReader::read(latin1.data(), latin1.size(), text), std::runtime_error);
+  const std::string utf16("\xFF\xFE<\0d\0", 6);
+  EXPECT_THROW(PatentXmlReader::read(utf16.data(), utf16.size(), text), std::runtime_error);
+  const std::string truncated = EP_DOCUMENT.substr(0, EP_DOCUMENT.find("<claim-text>"));
+  EXPECT_THROW(PatentXmlReader::read(truncated.data(), truncated.size(), text), std::runtime_error);
+
+  EXPECT_TRUE(PatentXmlReader::looksLikeXml("\xEF\xBB\xBF \n<doc/>", 10));
+  EXPECT_FALSE(PatentXmlReader::looksLikeXml("Die Welle 10", 12));
+}
+
+TEST(PatentXmlReaderTest, FeedsTheHeadlessScanner) {
+  std::wstring text;
+  const PatentXmlReader::Document document = PatentXmlReader::read(EP_DOCUMENT.data(), EP_DOCUMENT.size(), text);
+  ScanPipeline pipeline(document.language == "de");
+  pipeline.run(text);
+
+  const auto& bzToStems = pipeline.context().db.bzToStems;
+  EXPECT_EQ(bzToStems.count(L"10"), 1u);
+  EXPECT_EQ(bzToStems.count(L"12"), 1u);
+  // The formula was left out, so nothing of it became a term
+  EXPECT_EQ(text.find(L"x"), std::wstring::npos);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "PerfGate.h"
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Test suite for PerfGate
+ * Timing-dependent parts are only checked structurally; the baseline format
+ * and the verdicts are exact.
+ */
+using Baseline = PerfGate::Baseline;
+
+static PerfGate::Measurement measurement(const std::string& name, double normalized) {
+  PerfGate::Measurement m;
+  m.name = name;
+  m.normalized = normalized;
+  m.seconds = normalized;
+  return m;
+}
+
+TEST(PerfGateTest, BaselineRoundTrip) {
+  Baseline baseline;
+  baseline["TextScanner::scanText/5MB"] = {6.917, 0.15};
+  baseline["ScanPipeline::run/cold-cache/1MB"] = {0.796, 0.2};
+
+  std::stringstream file;
+  PerfGate::saveBaseline(file, baseline);
+  Baseline loaded = PerfGate::loadBaseline(file);
+
+  ASSERT_EQ(loaded.size(), 2u);
+  EXPECT_DOUBLE_EQ(loaded["TextScanner::scanText/5MB"].normalized, 6.917);
+  EXPECT_DOUBLE_EQ(loaded["TextScanner::scanText/5MB"].tolerance, 0.15);
+  EXPECT_DOUBLE_EQ(loaded["ScanPipeline::run/cold-cache/1MB"].tolerance, 0.2);
+}
+
+TEST(PerfGateTest, LoadAcceptsEmptyWorkloadsAndDefaultsTolerance) {
+  std::istringstream empty(R"({"version": 2, "workloads": {}})");
+  EXPECT_TRUE(PerfGate::loadBaseline(empty).empty());
+
+  std::istringstream noTolerance(R"({"version": 2, "workloads": {"a": {"normalized": 2}}})");
+  Baseline baseline = PerfGate::loadBaseline(noTolerance);
+  EXPECT_DOUBLE_EQ(baseline["a"].normalized, 2.0);
+  EXPECT_DOUBLE_EQ(baseline["a"].tolerance, 0.15);
+}
+
+TEST(PerfGateTest, LoadRejectsMalformedFiles) {
+  const char* files[] = {
+      "",
+      R"({"workloads": {}})",
+      R"({"version": 3, "workloads": {}})",
+      R"({"version": 2, "workloads": {"a": {"normalized": x}}})",
+      R"({"version": 2, "workloads": {"a": {"speed": 1}}})",
+      R"({"version": 2, "workloads": {}} trailing)",
+  };
+  for (const char* text : files) {
+    std::istringstream in(text);
+    EXPECT_THROW(PerfGate::loadBaseline(in), std::runtime_error) << text;
+  }
+}
+
+TEST(PerfGateTest, LoadRejectsCalibrationLoopBaselines) {
+  std::istringstream in(R"({"version": 1, "workloads": {"a": {"normalized": 2}}})");
+  try {
+    PerfGate::loadBaseline(in);
+    FAIL() << "version 1 accepted";
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find("--update"), std::string::npos) << e.what();
+  }
+}
+
+TEST(PerfGateTest, RegressionBeyondToleranceFails) {
+  const PerfGate::BaselineEntry entry{1.0, 0.15};
+
+  // Throughput ratio = baseline / current: 1/1.15 = 0.87 is within 15 %
+  EXPECT_FALSE(PerfGate::judge(measurement("w", 1.15), entry).regressed);
+  // 1/1.2 = 0.83 is a 17 % throughput drop
+  auto slow = PerfGate::judge(measurement("w", 1.2), entry);
+  EXPECT_TRUE(slow.regressed);
+  EXPECT_NEAR(slow.throughputRatio, 1.0 / 1.2, 1e-12);
+
+  // Faster never fails
+  EXPECT_FALSE(PerfGate::judge(measurement("w", 0.5), entry).regressed);
+}
+
+TEST(PerfGateTest, WorkloadWithoutBaselineIsNotGated) {
+  auto verdict = PerfGate::judge(measurement("new", 100.0), std::nullopt);
+  EXPECT_FALSE(verdict.regressed);
+  EXPECT_FALSE(verdict.baseline.has_value());
+}
+
+TEST(PerfGateTest, UpdateKeepsTolerancesAndUnmeasuredEntries) {
+  Baseline baseline;
+  baseline["kept"] = {3.0, 0.3};
+  baseline["remeasured"] = {1.0, 0.25};
+
+  std::vector<PerfGate::Workload> workloads = {{"remeasured", 0.15, {}, [] {}},
+                                               {"added", 0.05, {}, [] {}}};
+  Baseline result = PerfGate::updated(baseline, workloads,
+                                      {measurement("remeasured", 2.0), measurement("added", 4.0)});
+
+  EXPECT_DOUBLE_EQ(result["kept"].normalized, 3.0);
+  EXPECT_DOUBLE_EQ(result["remeasured"].normalized, 2.0);
+  EXPECT_DOUBLE_EQ(result["remeasured"].tolerance, 0.25);
+  EXPECT_DOUBLE_EQ(result["added"].normalized, 4.0);
+  EXPECT_DOUBLE_EQ(result["added"].tolerance, 0.05);
+}
+
+TEST(PerfGateTest, MeasureRunsReferenceBeforeEveryRepetition) {
+  std::vector<std::string> log;
+  auto workload = [&](const std::string& name) {
+    return PerfGate::Workload{name, 0.15, [&log, name] { log.push_back(name + " setup"); },
+                              [&log, name] { log.push_back(name); }};
+  };
+  std::vector<PerfGate::Workload> workloads = {workload("a"), workload("b")};
+  PerfGate::Workload reference = workload("ref");
+  reference.run = [&log] {
+    log.push_back("ref");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  };
+  std::vector<PerfGate::Measurement> measurements = PerfGate::measure(workloads, reference, 2);
+
+  // Round-robin: a slow spell cannot take every repetition of one workload
+  const std::vector<std::string> round = {"ref setup", "ref", "a setup", "a", "ref setup", "ref", "b setup", "b"};
+  std::vector<std::string> expected = round;
+  expected.insert(expected.end(), round.begin(), round.end());
+  EXPECT_EQ(log, expected);
+
+  ASSERT_EQ(measurements.size(), 2u);
+  EXPECT_EQ(measurements[0].name, "a");
+  EXPECT_EQ(measurements[1].name, "b");
+  for (const PerfGate::Measurement& m : measurements) {
+    EXPECT_GE(m.referenceSeconds, 0.001);
+    EXPECT_DOUBLE_EQ(m.referenceSeconds, measurements[0].referenceSeconds);
+    EXPECT_DOUBLE_EQ(m.normalized, m.seconds / m.referenceSeconds);
+  }
+}
@@ -2,6 +2,7 @@
 #include "RE2RegexHelper.h"
 #include "RegexPatterns.h"
 #include <re2/re2.h>
+#include <stdexcept>
 
 class RE2RegexHelperTest : public ::testing::Test {
 protected:
@@ -102,6 +103,18 @@ TEST_F(RE2RegexHelperTest, MatchIterator_CaptureGroups) {
   EXPECT_EQ(match[2], L"10a");
 }
 
+TEST_F(RE2RegexHelperTest, MatchIterator_RejectsTooManyGroups) {
+  std::wstring text = L"abcdefgh";
+  re2::RE2 seven("(a)(b)(c)(d)(e)(f)(g)");
+  RE2RegexHelper::MatchIterator iter(text, seven);
+  ASSERT_TRUE(iter.hasNext());
+  EXPECT_EQ(iter.next()[7], L"g");
+
+  // An eighth group would not fit in MatchResult
+  re2::RE2 eight("(a)(b)(c)(d)(e)(f)(g)(h)");
+  EXPECT_THROW(RE2RegexHelper::MatchIterator(text, eight), std::invalid_argument);
+}
+
 // Test UTF-8 conversion and position mapping
 TEST_F(RE2RegexHelperTest, UTF8Conversion_BasicASCII) {
   std::wstring text = L"test";
@@ -240,7 +253,7 @@ TEST_F(RE2RegexHelperTest, ThreeCharMinimum_SingleWord) {
   std::vector<std::wstring> words;
   while (iter.hasNext()) {
     auto match = iter.next();
-    words.push_back(match[1]);
+    words.emplace_back(match[1]);
   }
 
   ASSERT_EQ(words.size(), 2);
@@ -268,7 +281,7 @@ TEST_F(RE2RegexHelperTest, ThreeCharMinimum_TwoWords) {
   std::vector<std::pair<std::wstring, std::wstring>> wordPairs;
   while (iter.hasNext()) {
     auto match = iter.next();
-    wordPairs.push_back({match[1], match[2]});
+    wordPairs.emplace_back(match[1], match[2]);
   }
 
   ASSERT_EQ(wordPairs.size(), 2);
@@ -287,7 +300,7 @@ TEST_F(RE2RegexHelperTest, ThreeCharMinimum_GermanArticlesIgnored) {
   std::vector<std::wstring> words;
   while (iter.hasNext()) {
     auto match = iter.next();
-    words.push_back(match[1]);
+    words.emplace_back(match[1]);
   }
 
   // Should match all: "der", "die", "das", and "Lager" all have 3+ chars
@@ -323,7 +336,7 @@ TEST_F(RE2RegexHelperTest, ThreeCharMinimum_NoShortWords) {
   std::vector<std::wstring> words;
   while (iter.hasNext()) {
     auto match = iter.next();
-    words.push_back(match[0]);
+    words.emplace_back(match[0]);
   }
 
   ASSERT_EQ(words.size(), 2);
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "ReportExporter.h"
+#include "ScanPipeline.h"
+#include "CorpusGenerator.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+/**
+ * Test suite for ReportExporter
+ * JSON, CSV and SARIF content of a known scan, escaping and bounded stream writes.
+ */
+namespace {
+
+using TestSupport::TEXT;
+
+std::string exportText(ReportExporter::Format format, const ReportExporter::Report& report) {
+  std::ostringstream out;
+  ReportExporter::write(out, format, report);
+  return out.str();
+}
+
+// Records the size of every write that reaches the stream buffer
+class PieceCounter : public std::streambuf {
+public:
+  size_t pieces = 0;
+  size_t largest = 0;
+  size_t total = 0;
+
+protected:
+  std::streamsize xsputn(const char*, std::streamsize count) override {
+    ++pieces;
+    largest = std::max(largest, static_cast<size_t>(count));
+    total += static_cast<size_t>(count);
+    return count;
+  }
+  int_type overflow(int_type c) override { return xsputn(nullptr, 1) == 1 ? c : traits_type::eof(); }
+};
+
+} // namespace
+
+TEST(ReportExporterTest, JsonListsReferencesAndErrors) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  const std::string json =
+      exportText(ReportExporter::Format::JSON, ReportExporter::fromPipeline(pipeline, TEXT, "a.txt", "de"));
+
+  EXPECT_NE(json.find("\"source\": \"a.txt\""), std::string::npos);
+  EXPECT_NE(json.find("\"reference_numbers\": 4, \"conflicting\": 1"), std::string::npos);
+  EXPECT_NE(json.find("{\"bz\": \"10\", \"conflict\": true, \"cleared\": false, "
+                      "\"words\": [\"Getriebe\", \"Welle\"]"),
+            std::string::npos);
+  // Terms in order of first appearance, occurrences as [start, end)
+  EXPECT_NE(json.find("{\"term\": \"Welle\", \"stem\": [\"well\"], \"occurrences\": [[4, 12], [66, 74]]}, "
+                      "{\"term\": \"Getriebe\""),
+            std::string::npos);
+  EXPECT_NE(json.find("{\"kind\": \"wrong_term\", \"start\": 43, \"end\": 54, \"line\": 2, \"column\": 5, "
+                      "\"bz\": \"10\", \"text\": \"Getriebe 10\"}"),
+            std::string::npos);
+  EXPECT_EQ(json.back(), '\n');
+}
+
+TEST(ReportExporterTest, ClearedNumbersAreNotConflicts) {
+  ScanPipeline pipeline(true);
+  pipeline.context().clearedErrors.insert(L"10");
+  pipeline.run(TEXT);
+  const std::string json =
+      exportText(ReportExporter::Format::JSON, ReportExporter::fromPipeline(pipeline, TEXT, "", "de"));
+  EXPECT_NE(json.find("\"conflicting\": 0"), std::string::npos);
+  EXPECT_NE(json.find("{\"bz\": \"10\", \"conflict\": false, \"cleared\": true"), std::string::npos);
+  EXPECT_EQ(json.find("\"kind\": \"wrong_term\""), std::string::npos);
+}
+
+TEST(ReportExporterTest, TermWithTwoNumbersConflicts) {
+  // Each BZ has a single term, but Welle carries both
+  const std::wstring text = L"Die Welle 10 dreht. Die Welle 12 steht.\n";
+  ScanPipeline pipeline(true);
+  pipeline.run(text);
+  const std::string json =
+      exportText(ReportExporter::Format::JSON, ReportExporter::fromPipeline(pipeline, text, "", "de"));
+  EXPECT_NE(json.find("\"reference_numbers\": 2, \"conflicting\": 2"), std::string::npos);
+  EXPECT_NE(json.find("{\"bz\": \"10\", \"conflict\": true"), std::string::npos);
+  EXPECT_NE(json.find("{\"bz\": \"12\", \"conflict\": true"), std::string::npos);
+}
+
+TEST(ReportExporterTest, CsvHasOneRowPerOccurrenceAndError) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  const std::string csv =
+      exportText(ReportExporter::Format::CSV, ReportExporter::fromPipeline(pipeline, TEXT, "a.txt", "de"));
+
+  EXPECT_EQ(csv.rfind("kind,bz,term,start,end,line,column,text\r\n", 0), 0u);
+  EXPECT_NE(csv.find("\r\nreference,12,Lager,20,28,1,21,Lager 12\r\n"), std::string::npos);
+  EXPECT_NE(csv.find("\r\nwrong_term,10,,66,74,2,28,Welle 10\r\n"), std::string::npos);
+  const size_t rows = static_cast<size_t>(std::count(csv.begin(), csv.end(), '\n'));
+  EXPECT_EQ(rows, 1 + 6 + pipeline.noNumberErrors().size() + pipeline.wrongTermBzErrors().size() +
+                      pipeline.wrongArticleErrors().size());
+}
+
+TEST(ReportExporterTest, EscapesFieldsAndStrings) {
+  ScanPipeline pipeline(true);
+  const std::wstring text = L"Er sagte \"ja\", dann\tnein.";
+  pipeline.run(text);
+  ErrorPositions quoted;
+  quoted.emplace_back(9, 19);  // "ja", dann
+  quoted.emplace_back(19, 24);  // \tnein
+  const ReportExporter::Report report{"dir\\b \"c\".txt", "de", text, pipeline.context(), quoted,
+                                      pipeline.wrongTermBzErrors(), pipeline.wrongArticleErrors(), quoted};
+
+  const std::string csv = exportText(ReportExporter::Format::CSV, report);
+  EXPECT_NE(csv.find("missing_number,,,9,19,1,10,\"\"\"ja\"\", dann\"\r\n"), std::string::npos);
+
+  const std::string json = exportText(ReportExporter::Format::JSON, report);
+  EXPECT_NE(json.find("\"source\": \"dir\\\\b \\\"c\\\".txt\""), std::string::npos);
+  EXPECT_NE(json.find("\"text\": \"\\\"ja\\\", dann\""), std::string::npos);
+  EXPECT_NE(json.find("\"text\": \"\\tnein\""), std::string::npos);
+
+  const std::string sarif = exportText(ReportExporter::Format::SARIF, report);
+  EXPECT_NE(sarif.find("\"uri\": \"dir/b%20%22c%22.txt\""), std::string::npos);
+}
+
+TEST(ReportExporterTest, SarifHasRulesAndRegions) {
+  ScanPipeline pipeline(true);
+  pipeline.run(TEXT);
+  const std::string sarif =
+      exportText(ReportExporter::Format::SARIF, ReportExporter::fromPipeline(pipeline, TEXT, "a.txt", "de"));
+
+  EXPECT_NE(sarif.find("\"version\": \"2.1.0\""), std::string::npos);
+  EXPECT_NE(sarif.find("{\"id\": \"missing-number\""), std::string::npos);
+  EXPECT_NE(sarif.find("{\"id\": \"wrong-term\""), std::string::npos);
+  EXPECT_NE(sarif.find("{\"id\": \"wrong-article\""), std::string::npos);
+  // endColumn points behind the region
+  EXPECT_NE(sarif.find("\"region\": {\"startLine\": 2, \"startColumn\": 5, \"endLine\": 2, \"endColumn\": 16, "
+                       "\"charOffset\": 43, \"charLength\": 11, \"snippet\": {\"text\": \"Getriebe 10\"}}"),
+            std::string::npos);
+  size_t results = 0;
+  for (size_t pos = sarif.find("\"ruleId\""); pos != std::string::npos; pos = sarif.find("\"ruleId\"", pos + 1)) {
+    ++results;
+  }
+  EXPECT_EQ(results, pipeline.noNumberErrors().size() + pipeline.wrongTermBzErrors().size() +
+                         pipeline.wrongArticleErrors().size());
+}
+
+TEST(ReportExporterTest, StreamsInBoundedPieces) {
+  CorpusGenerator::Options options;
+  options.targetChars = 300000;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ScanPipeline pipeline(true);
+  pipeline.run(corpus.text);
+
+  PieceCounter counter;
+  std::ostream out(&counter);
+  ReportExporter::write(out, ReportExporter::Format::CSV,
+                        ReportExporter::fromPipeline(pipeline, corpus.text, "corpus.txt", "de"));
+  EXPECT_GT(counter.total, 256u * 1024);
+  EXPECT_GT(counter.pieces, 3u);
+  EXPECT_LT(counter.largest, 80u * 1024);
+}
+
+TEST(ReportExporterTest, ParsesFormatNames) {
+  ReportExporter::Format format = ReportExporter::Format::JSON;
+  EXPECT_TRUE(ReportExporter::parseFormat("sarif", format));
+  EXPECT_EQ(format, ReportExporter::Format::SARIF);
+  EXPECT_STREQ(ReportExporter::extension(format), ".sarif");
+  EXPECT_TRUE(ReportExporter::parseFormat("csv", format));
+  EXPECT_EQ(format, ReportExporter::Format::CSV);
+  EXPECT_FALSE(ReportExporter::parseFormat("xml", format));
+  EXPECT_EQ(format, ReportExporter::Format::CSV);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "ResultCache.h"
+#include "ScanPipeline.h"
+#include "ScanSnapshot.h"
+#include "CorpusGenerator.h"
+#include "TestSupport.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Test suite for ResultCache
+ * A hit must reproduce the scan exactly; other text, language or settings must miss.
+ */
+namespace {
+
+using TestSupport::TEXT;
+
+size_t fileCount(const std::filesystem::path& directory) {
+  size_t count = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    count += entry.is_regular_file();
+  }
+  return count;
+}
+
+} // namespace
+
+TEST(ResultCacheTest, HitReproducesTheScan) {
+  const TestSupport::TempPath dir;
+  ResultCache cache(dir.path());
+  ScanPipeline scanned(true);
+  EXPECT_FALSE(cache.lookup(scanned, TEXT));
+  scanned.run(TEXT);
+  cache.store(scanned, TEXT);
+  EXPECT_EQ(cache.entryCount(), 1u);
+  EXPECT_EQ(fileCount(dir.path()), 1u);
+
+  ScanPipeline cached(true);
+  ASSERT_TRUE(cache.lookup(cached, TEXT));
+  EXPECT_EQ(ScanSnapshot::firstDivergence(ScanSnapshot::capture(scanned), ScanSnapshot::capture(cached)),
+            std::nullopt);
+
+  // Storing the same analysis again adds nothing
+  cache.store(cached, TEXT);
+  EXPECT_EQ(cache.entryCount(), 1u);
+}
+
+TEST(ResultCacheTest, KeyCoversTextLanguageAndSettings) {
+  ScanPipeline pipeline(true);
+  const uint64_t key = ResultCache::key(TEXT, true, pipeline.context());
+  EXPECT_EQ(ResultCache::key(TEXT, true, pipeline.context()), key);
+  EXPECT_NE(ResultCache::key(TEXT + L" ", true, pipeline.context()), key);
+  EXPECT_NE(ResultCache::key(TEXT, false, pipeline.context()), key);
+  const std::vector<uint32_t> paragraphs{0, 39};
+  EXPECT_NE(ResultCache::key(TEXT, true, pipeline.context(), paragraphs), key);
+
+  pipeline.context().manualMultiWordToggles.insert(L"lag");
+  const uint64_t toggled = ResultCache::key(TEXT, true, pipeline.context());
+  EXPECT_NE(toggled, key);
+  pipeline.context().manualMultiWordToggles.clear();
+  pipeline.context().manuallyDisabledMultiWord.insert(L"lag");
+  EXPECT_NE(ResultCache::key(TEXT, true, pipeline.context()), key);
+  EXPECT_NE(ResultCache::key(TEXT, true, pipeline.context()), toggled);
+  pipeline.context().manuallyDisabledMultiWord.clear();
+
+  pipeline.context().clearedErrors.insert(L"10");
+  EXPECT_NE(ResultCache::key(TEXT, true, pipeline.context()), key);
+  pipeline.context().clearedErrors.clear();
+  pipeline.context().ignoredWords.insert(L"Getriebe");
+  EXPECT_NE(ResultCache::key(TEXT, true, pipeline.context()), key);
+  pipeline.context().ignoredWords.clear();
+  pipeline.context().clearedTextAnchors.add(TEXT, 4, 12);
+  EXPECT_NE(ResultCache::key(TEXT, true, pipeline.context()), key);
+}
+
+TEST(ResultCacheTest, OtherSettingsMiss) {
+  const TestSupport::TempPath dir;
+  ResultCache cache(dir.path());
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  cache.store(scanned, TEXT);
+
+  ScanPipeline english(false);
+  EXPECT_FALSE(cache.lookup(english, TEXT));
+  ScanPipeline toggled(true);
+  toggled.context().manualMultiWordToggles.insert(L"lag");
+  EXPECT_FALSE(cache.lookup(toggled, TEXT));
+  ScanPipeline edited(true);
+  EXPECT_FALSE(cache.lookup(edited, TEXT + L"Neu."));
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsed) {
+  const TestSupport::TempPath dir;
+  ResultCache probe(dir.path());
+  ScanPipeline pipeline(true);
+  const std::wstring texts[3] = {TEXT, TEXT + L"Zwei.", TEXT + L"Drei."};
+  pipeline.run(texts[0]);
+  probe.store(pipeline, texts[0]);
+  const uint64_t entryBytes = probe.sizeBytes();
+  ASSERT_GT(entryBytes, 0u);
+
+  // Room for two entries
+  ResultCache cache(dir.path(), entryBytes * 2 + entryBytes / 2);
+  EXPECT_EQ(cache.entryCount(), 1u);
+  pipeline.run(texts[1]);
+  cache.store(pipeline, texts[1]);
+  ScanPipeline reader(true);
+  ASSERT_TRUE(cache.lookup(reader, texts[0]));  // texts[1] is now the oldest
+  pipeline.run(texts[2]);
+  cache.store(pipeline, texts[2]);
+
+  EXPECT_EQ(cache.entryCount(), 2u);
+  EXPECT_LE(cache.sizeBytes(), cache.maxBytes());
+  EXPECT_EQ(fileCount(dir.path()), 2u);
+  EXPECT_TRUE(cache.lookup(reader, texts[0]));
+  EXPECT_FALSE(cache.lookup(reader, texts[1]));
+  EXPECT_TRUE(cache.lookup(reader, texts[2]));
+}
+
+TEST(ResultCacheTest, ReopenedCacheFindsEntries) {
+  const TestSupport::TempPath dir;
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  {
+    ResultCache cache(dir.path());
+    cache.store(scanned, TEXT);
+  }
+  ResultCache reopened(dir.path());
+  EXPECT_EQ(reopened.entryCount(), 1u);
+  ScanPipeline cached(true);
+  EXPECT_TRUE(reopened.lookup(cached, TEXT));
+}
+
+TEST(ResultCacheTest, DamagedEntryIsDroppedAndMisses) {
+  const TestSupport::TempPath dir;
+  ResultCache cache(dir.path());
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  cache.store(scanned, TEXT);
+  for (const auto& entry : std::filesystem::directory_iterator(dir.path())) {
+    std::ofstream(entry.path(), std::ios::binary | std::ios::trunc) << "garbage";
+  }
+
+  ScanPipeline pipeline(true);
+  EXPECT_FALSE(cache.lookup(pipeline, TEXT));
+  EXPECT_EQ(cache.entryCount(), 0u);
+  EXPECT_EQ(fileCount(dir.path()), 0u);
+  pipeline.run(TEXT);
+  cache.store(pipeline, TEXT);
+  EXPECT_TRUE(cache.lookup(pipeline, TEXT));
+}
+
+TEST(ResultCacheTest, LargeCorpusHit) {
+  CorpusGenerator::Options options;
+  options.targetChars = 300000;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  const TestSupport::TempPath dir;
+  ResultCache cache(dir.path());
+  ScanPipeline scanned(true);
+  scanned.run(corpus.text);
+  cache.store(scanned, corpus.text);
+
+  ScanPipeline cached(true);
+  ASSERT_TRUE(cache.lookup(cached, corpus.text));
+  EXPECT_EQ(cached.lastTimings().scanMs, 0);
+  EXPECT_EQ(ScanSnapshot::firstDivergence(ScanSnapshot::capture(scanned), ScanSnapshot::capture(cached)),
+            std::nullopt);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "ScanArena.h"
+#include "AnalysisContext.h"
+#include "TextScanner.h"
+#include "GermanTextAnalyzer.h"
+#include "RegexPatterns.h"
+#include <re2/re2.h>
+
+// Accounting
+TEST(ScanArenaTest, CountsBytesUntilReset) {
+  ScanArena arena(4096);
+  {
+    std::pmr::vector<int> values(arena.resource());
+    values.reserve(100);
+    EXPECT_GE(arena.bytesInUse(), 100 * sizeof(int));
+  }
+  // Deallocation does not give memory back before reset
+  EXPECT_GE(arena.bytesInUse(), 100 * sizeof(int));
+
+  size_t used = arena.bytesInUse();
+  arena.reset();
+  EXPECT_EQ(arena.bytesInUse(), 0u);
+  EXPECT_EQ(arena.lastScanBytes(), used);
+  EXPECT_EQ(arena.peakBytes(), used);
+}
+
+TEST(ScanArenaTest, PeakTracksLargestScan) {
+  ScanArena arena(4096);
+  {
+    std::pmr::vector<char> big(10000, 'x', arena.resource());
+  }
+  arena.reset();
+  {
+    std::pmr::vector<char> small(100, 'x', arena.resource());
+  }
+  arena.reset();
+
+  EXPECT_EQ(arena.lastScanBytes(), 100u);
+  EXPECT_EQ(arena.peakBytes(), 10000u);
+}
+
+// High-water reuse
+TEST(ScanArenaTest, BufferGrowsToHighWaterMark) {
+  ScanArena arena(4096);
+  EXPECT_EQ(arena.bufferSize(), 4096u);
+  {
+    std::pmr::vector<char> big(100000, 'x', arena.resource());
+  }
+  arena.reset();
+  EXPECT_GE(arena.bufferSize(), 100000u);
+
+  // A second scan of the same size does not grow the buffer again
+  size_t size = arena.bufferSize();
+  {
+    std::pmr::vector<char> big(100000, 'x', arena.resource());
+  }
+  arena.reset();
+  EXPECT_EQ(arena.bufferSize(), size);
+}
+
+// Rescanning through AnalysisContext releases and reuses the arena
+TEST(ScanArenaTest, AnalysisContext_RescanReusesArena) {
+  GermanTextAnalyzer analyzer;
+  re2::RE2 singleWordRegex(RegexPatterns::SINGLE_WORD_PATTERN);
+  re2::RE2 twoWordRegex(RegexPatterns::TWO_WORD_PATTERN);
+  AnalysisContext ctx;
+
+  std::wstring text;
+  for (int i = 0; i < 200; ++i) {
+    text += L"Lager " + std::to_wstring(i) + L" und Welle " + std::to_wstring(i + 1000) + L". ";
+  }
+
+  TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+  size_t firstScan = ctx.arena.bytesInUse();
+  EXPECT_GT(firstScan, 0u);
+  EXPECT_EQ(ctx.db.bzToStems.size(), 400u);
+
+  ctx.clearResults();
+  EXPECT_EQ(ctx.arena.bytesInUse(), 0u);
+  EXPECT_TRUE(ctx.db.bzToStems.empty());
+  EXPECT_TRUE(ctx.db.occurrences.empty());
+  size_t buffer = ctx.arena.bufferSize();
+
+  TextScanner::scanText(text, analyzer, singleWordRegex, twoWordRegex, ctx);
+  EXPECT_EQ(ctx.arena.bytesInUse(), firstScan);
+  EXPECT_EQ(ctx.db.bzToStems.size(), 400u);
+  EXPECT_EQ(ctx.db.positionsOfBz(L"10").size(), 1u);
+
+  ctx.clearResults();
+  EXPECT_EQ(ctx.arena.bufferSize(), buffer);
+  EXPECT_EQ(ctx.arena.peakBytes(), firstScan);
+}
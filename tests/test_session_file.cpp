@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "SessionFile.h"
+#include "ScanPipeline.h"
+#include "ScanSnapshot.h"
+#include "CorpusGenerator.h"
+#include "TestSupport.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Test suite for SessionFile
+ * Restoring a saved session must reproduce the scan exactly; damaged files must be rejected.
+ */
+using TestSupport::TEXT;
+
+TEST(SessionFileTest, RestoreReproducesTheScan) {
+  ScanPipeline scanned(true);
+  scanned.context().clearedErrors.insert(L"12");
+  scanned.context().manualMultiWordToggles.insert(L"getrieb");
+  scanned.context().clearedTextAnchors.add(TEXT, 4, 12);
+  scanned.context().ignoredWords.insert(L"Getriebe");
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+
+  const SessionFile session(file.path());
+  EXPECT_TRUE(session.matches(TEXT));
+  EXPECT_TRUE(session.german());
+  EXPECT_EQ(session.textLength(), TEXT.size());
+
+  ScanPipeline restored(true);
+  ASSERT_TRUE(restored.restore(session, TEXT));
+  EXPECT_EQ(ScanSnapshot::firstDivergence(ScanSnapshot::capture(scanned), ScanSnapshot::capture(restored)),
+            std::nullopt);
+  const AnalysisContext& ctx = restored.context();
+  EXPECT_EQ(ctx.clearedErrors, scanned.context().clearedErrors);
+  EXPECT_EQ(ctx.manualMultiWordToggles, scanned.context().manualMultiWordToggles);
+  EXPECT_EQ(ctx.ignoredWords, scanned.context().ignoredWords);
+  EXPECT_EQ(ctx.autoDetectedMultiWordStems, scanned.context().autoDetectedMultiWordStems);
+  EXPECT_EQ(ctx.clearedTextAnchors.anchors(), scanned.context().clearedTextAnchors.anchors());
+  EXPECT_TRUE(ctx.clearedTextAnchors.contains(4, 12));
+  EXPECT_EQ(ctx.db.stemToBz.size(), scanned.context().db.stemToBz.size());
+  EXPECT_EQ(ctx.db.occurrences.stemCount(), scanned.context().db.occurrences.stemCount());
+}
+
+TEST(SessionFileTest, RestoresLargeCorpus) {
+  CorpusGenerator::Options options;
+  options.targetChars = 200000;
+  const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+  ScanPipeline scanned(true);
+  scanned.run(corpus.text);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), corpus.text, true, scanned.context());
+
+  ScanPipeline restored(true);
+  ASSERT_TRUE(restored.restore(SessionFile(file.path()), corpus.text));
+  EXPECT_EQ(ScanSnapshot::firstDivergence(ScanSnapshot::capture(scanned), ScanSnapshot::capture(restored)),
+            std::nullopt);
+}
+
+TEST(SessionFileTest, DetectionResultsAreRestoredWithoutDetecting) {
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  TestSupport::TempPath plain(".bzsession");
+  SessionFile::save(plain.path(), TEXT, true, scanned.context());
+  EXPECT_FALSE(SessionFile(plain.path()).hasDetection());
+
+  TestSupport::TempPath full(".bzsession");
+  scanned.save(full.path(), TEXT);
+  ASSERT_TRUE(SessionFile(full.path()).hasDetection());
+  ScanPipeline restored(true);
+  ASSERT_TRUE(restored.restore(SessionFile(full.path()), TEXT));
+  EXPECT_EQ(ScanSnapshot::firstDivergence(ScanSnapshot::capture(scanned), ScanSnapshot::capture(restored)),
+            std::nullopt);
+
+  // The lists come from the file, not from a detection pass
+  ErrorPositions noNumber{{0, 3}};
+  const ErrorPositions none;
+  const std::vector<std::wstring> conflicting{L"12"};
+  const SessionFile::Detection detection{&noNumber, &none, &none, &conflicting};
+  TestSupport::TempPath made(".bzsession");
+  SessionFile::save(made.path(), TEXT, true, scanned.context(), &detection);
+  ScanPipeline fromFile(true);
+  ASSERT_TRUE(fromFile.restore(SessionFile(made.path()), TEXT));
+  EXPECT_EQ(fromFile.noNumberErrors(), noNumber);
+  EXPECT_TRUE(fromFile.wrongArticleErrors().empty());
+  EXPECT_EQ(fromFile.allErrors(), noNumber);
+  EXPECT_EQ(fromFile.conflictingBz(), conflicting);
+}
+
+TEST(SessionFileTest, ChangedTextKeepsDecisions) {
+  ScanPipeline scanned(true);
+  scanned.context().clearedErrors.insert(L"10");
+  scanned.context().manuallyDisabledMultiWord.insert(L"erst lag");
+  scanned.context().ignoredWords.insert(L"Getriebe");
+  scanned.context().clearedTextAnchors.add(TEXT, 4, 12);
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+
+  const std::wstring edited = L"Neu. " + TEXT;
+  const SessionFile session(file.path());
+  EXPECT_FALSE(session.matches(edited));
+  ScanPipeline pipeline(true);
+  EXPECT_FALSE(pipeline.restore(session, edited));
+  EXPECT_TRUE(pipeline.context().db.occurrences.empty());
+
+  session.restoreDecisions(pipeline.context());
+  EXPECT_EQ(pipeline.context().clearedErrors, scanned.context().clearedErrors);
+  EXPECT_EQ(pipeline.context().manuallyDisabledMultiWord, scanned.context().manuallyDisabledMultiWord);
+  EXPECT_EQ(pipeline.context().ignoredWords, scanned.context().ignoredWords);
+  // The cleared "Welle 10" moved by the inserted sentence
+  ASSERT_EQ(pipeline.context().clearedTextAnchors.size(), 1u);
+  pipeline.run(edited);
+  EXPECT_TRUE(pipeline.context().clearedTextAnchors.contains(9, 17));
+  EXPECT_FALSE(pipeline.context().clearedTextAnchors.contains(4, 12));
+}
+
+TEST(SessionFileTest, OtherAnalyzerVersionRescans) {
+  ScanPipeline scanned(true);
+  scanned.context().clearedErrors.insert(L"10");
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+  EXPECT_EQ(SessionFile(file.path()).analyzerVersion(), SessionFile::ANALYZER_VERSION);
+
+  // Saved by an older analyzer (0: before the version was recorded)
+  std::string bytes = file.read();
+  const uint32_t older = 0;
+  std::memcpy(bytes.data() + 36, &older, 4);
+  file.write(bytes);
+
+  const SessionFile session(file.path());
+  EXPECT_FALSE(session.matches(TEXT));
+  ScanPipeline pipeline(true);
+  EXPECT_FALSE(pipeline.restore(session, TEXT));
+  session.restoreDecisions(pipeline.context());
+  EXPECT_EQ(pipeline.context().clearedErrors, scanned.context().clearedErrors);
+}
+
+TEST(SessionFileTest, SaveDropsAnchorsNotFoundInTheText) {
+  ScanPipeline scanned(true);
+  scanned.context().clearedTextAnchors.add(TEXT, 4, 12);
+  scanned.context().clearedTextAnchors.add(L"Eine Achse 20 fehlt.", 5, 13);
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+
+  ScanPipeline restored(true);
+  ASSERT_TRUE(restored.restore(SessionFile(file.path()), TEXT));
+  ASSERT_EQ(restored.context().clearedTextAnchors.size(), 1u);
+  EXPECT_EQ(restored.context().clearedTextAnchors.anchors()[0], scanned.context().clearedTextAnchors.anchors()[0]);
+}
+
+TEST(SessionFileTest, LanguageMustMatch) {
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+  ScanPipeline english(false);
+  EXPECT_FALSE(english.restore(SessionFile(file.path()), TEXT));
+}
+
+TEST(SessionFileTest, RejectsDamagedFiles) {
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+  const std::string bytes = file.read();
+
+  file.write(bytes.substr(0, bytes.size() / 2));
+  EXPECT_THROW(SessionFile{file.path()}, std::runtime_error);
+
+  std::string magic = bytes;
+  magic[0] = 'X';
+  file.write(magic);
+  EXPECT_THROW(SessionFile{file.path()}, std::runtime_error);
+
+  std::string version = bytes;
+  version[8] = 99;
+  file.write(version);
+  EXPECT_THROW(SessionFile{file.path()}, std::runtime_error);
+
+  // First occurrence row: BZ ID far beyond the names
+  std::string occurrence = bytes;
+  const size_t directory = 40;
+  for (size_t i = 0; i < 13; ++i) {
+    uint32_t id;
+    std::memcpy(&id, bytes.data() + directory + i * 24, 4);
+    if (id == 5) {
+      uint32_t count;
+      uint64_t offset;
+      std::memcpy(&count, bytes.data() + directory + i * 24 + 4, 4);
+      std::memcpy(&offset, bytes.data() + directory + i * 24 + 8, 8);
+      occurrence[offset + 3 * count * 4 + 3] = 0x7F;
+    }
+  }
+  file.write(occurrence);
+  EXPECT_THROW(SessionFile{file.path()}, std::runtime_error);
+
+  EXPECT_THROW(SessionFile{file.path() + ".missing"}, std::runtime_error);
+}
+
+TEST(SessionFileTest, SkipsUnknownSections) {
+  ScanPipeline scanned(true);
+  scanned.run(TEXT);
+  TestSupport::TempPath file(".bzsession");
+  SessionFile::save(file.path(), TEXT, true, scanned.context());
+  std::string bytes = file.read();
+
+  // Renumber the (empty) cleared-anchors section as one a later version added
+  for (size_t i = 0; i < 13; ++i) {
+    uint32_t id;
+    std::memcpy(&id, bytes.data() + 40 + i * 24, 4);
+    if (id == 13) {
+      id = 1000;
+      std::memcpy(bytes.data() + 40 + i * 24, &id, 4);
+    }
+  }
+  file.write(bytes);
+  ScanPipeline restored(true);
+  ASSERT_TRUE(restored.restore(SessionFile(file.path()), TEXT));
+  EXPECT_EQ(ScanSnapshot::capture(restored), ScanSnapshot::capture(scanned));
+}
+
+TEST(SessionFileTest, PathIsNextToTheDocument) {
+  EXPECT_EQ(SessionFile::pathFor("/a/b.docx"), "/a/b.docx.bzsession");
+  EXPECT_EQ(SessionFile::hashText(L"a"), SessionFile::hashText(L"a"));
+  EXPECT_NE(SessionFile::hashText(L"ab"), SessionFile::hashText(L"ba"));
+}
@@ -23,7 +23,7 @@ protected:
     void clearDataStructures() {
         ctx.clearResults();
         ctx.multiWordBaseStems.clear();
-        ctx.clearedTextPositions.clear();
+        ctx.clearedTextAnchors.clear();
     }
 
     // Analyzer
@@ -130,11 +130,11 @@ TEST_F(TextScannerTest, PositionTrackingSingleWord) {
 
     TextScanner::scanText(text, analyzer, *singleWordRegex, *twoWordRegex, ctx);
 
-    // Verify bzToPositions contains correct position for "10"
-    ASSERT_TRUE(ctx.db.bzToPositions.count(L"10"));
-    ASSERT_FALSE(ctx.db.bzToPositions[L"10"].empty());
+    // Verify the occurrence table contains correct position for "10"
+    PositionRange positions = ctx.db.positionsOfBz(L"10");
+    ASSERT_FALSE(positions.empty());
 
-    auto [start, len] = ctx.db.bzToPositions[L"10"][0];
+    auto [start, len] = positions[0];
     EXPECT_EQ(start, 0); // "Lager" starts at position 0
     EXPECT_GT(len, 0);   // Should have non-zero length
 
@@ -156,11 +156,11 @@ TEST_F(TextScannerTest, PositionTrackingTwoWord) {
     // Create expected two-word stem
     StemVector expectedStem = analyzer.createMultiWordStemVector(L"erstes", L"Lager");
 
-    // Verify stemToPositions has correct range
-    ASSERT_TRUE(ctx.db.stemToPositions.count(expectedStem));
-    ASSERT_FALSE(ctx.db.stemToPositions[expectedStem].empty());
+    // Verify the stem's positions have the correct range
+    PositionRange positions = ctx.db.positionsOfStem(expectedStem);
+    ASSERT_FALSE(positions.empty());
 
-    auto [start, len] = ctx.db.stemToPositions[expectedStem][0];
+    auto [start, len] = positions[0];
     EXPECT_EQ(start, 0); // "erstes Lager" starts at position 0
     EXPECT_GT(len, 0);
 
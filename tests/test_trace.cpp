@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "Trace.h"
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+/**
+ * Test suite for the tracing subsystem
+ * Tracing is process-global, so every test starts from a cleared, enabled state.
+ */
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Trace::clear();
+    Trace::setEnabled(true);
+  }
+
+  void TearDown() override {
+    Trace::setEnabled(false);
+    Trace::clear();
+  }
+
+  static std::vector<Trace::Event> eventsNamed(const char* name) {
+    std::vector<Trace::Event> result;
+    for (const auto& event : Trace::snapshot()) {
+      if (std::strcmp(event.name, name) == 0) {
+        result.push_back(event);
+      }
+    }
+    return result;
+  }
+};
+
+// Spans
+TEST_F(TraceTest, SpanRecordsDurationAndThread) {
+  {
+    BZ_TRACE_SCOPE("outer");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  auto events = eventsNamed("outer");
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].phase, Trace::Phase::SPAN);
+  EXPECT_GE(events[0].value, 2'000'000);
+  EXPECT_EQ(events[0].threadId, Trace::currentThreadId());
+}
+
+TEST_F(TraceTest, NestedSpansAreOrderedByStart) {
+  {
+    BZ_TRACE_SCOPE("parent");
+    BZ_TRACE_SCOPE("child");
+  }
+
+  auto events = Trace::snapshot();
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_STREQ(events[0].name, "parent");
+  EXPECT_STREQ(events[1].name, "child");
+  EXPECT_GE(events[0].value, events[1].value);
+}
+
+TEST_F(TraceTest, DisabledRecordsNothing) {
+  Trace::setEnabled(false);
+  {
+    BZ_TRACE_SCOPE("ignored");
+    BZ_TRACE_COUNTER("ignoredCounter", 1);
+    BZ_TRACE_INSTANT("ignoredInstant");
+  }
+  EXPECT_TRUE(Trace::snapshot().empty());
+}
+
+TEST_F(TraceTest, CountersAndInstants) {
+  BZ_TRACE_COUNTER("bytes", 4096);
+  BZ_TRACE_INSTANT("edit");
+
+  auto counters = eventsNamed("bytes");
+  ASSERT_EQ(counters.size(), 1u);
+  EXPECT_EQ(counters[0].phase, Trace::Phase::COUNTER);
+  EXPECT_EQ(counters[0].value, 4096);
+
+  auto instants = eventsNamed("edit");
+  ASSERT_EQ(instants.size(), 1u);
+  EXPECT_EQ(instants[0].phase, Trace::Phase::INSTANT);
+}
+
+// Threads
+TEST_F(TraceTest, ThreadsRecordIntoSeparateBuffers) {
+  std::thread worker([] {
+    Trace::setThreadName("Worker");
+    BZ_TRACE_SCOPE("workerSpan");
+  });
+  worker.join();
+  {
+    BZ_TRACE_SCOPE("mainSpan");
+  }
+
+  auto workerEvents = eventsNamed("workerSpan");
+  auto mainEvents = eventsNamed("mainSpan");
+  ASSERT_EQ(workerEvents.size(), 1u);
+  ASSERT_EQ(mainEvents.size(), 1u);
+  EXPECT_NE(workerEvents[0].threadId, mainEvents[0].threadId);
+}
+
+TEST_F(TraceTest, FinishedThreadBufferIsReused) {
+  uint32_t firstId = 0;
+  uint32_t secondId = 0;
+  std::thread([&] { firstId = Trace::currentThreadId(); }).join();
+  std::thread([&] { secondId = Trace::currentThreadId(); }).join();
+  EXPECT_EQ(firstId, secondId);
+}
+
+// Ring buffer
+TEST_F(TraceTest, RingBufferKeepsNewestEvents) {
+  const size_t total = Trace::RING_CAPACITY + 100;
+  for (size_t i = 0; i < total; ++i) {
+    BZ_TRACE_COUNTER("tick", i);
+  }
+
+  auto events = eventsNamed("tick");
+  ASSERT_EQ(events.size(), Trace::RING_CAPACITY - 1);
+  EXPECT_EQ(events.front().value, 101);
+  EXPECT_EQ(events.back().value, static_cast<int64_t>(total - 1));
+}
+
+TEST_F(TraceTest, ClearDropsRecordedEvents) {
+  BZ_TRACE_INSTANT("before");
+  Trace::clear();
+  BZ_TRACE_INSTANT("after");
+
+  EXPECT_TRUE(eventsNamed("before").empty());
+  EXPECT_EQ(eventsNamed("after").size(), 1u);
+}
+
+// Export
+TEST_F(TraceTest, ChromeJsonExport) {
+  Trace::setThreadName("UI");
+  {
+    BZ_TRACE_SCOPE("scan \"quoted\"");
+  }
+  {
+    BZ_TRACE_SCOPE("two\nlines\x01");
+  }
+  BZ_TRACE_COUNTER("arena", 12);
+
+  std::ostringstream out;
+  Trace::writeChromeJson(out);
+  const std::string json = out.str();
+
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [", 0), 0u);
+  EXPECT_NE(json.find("\"ph\": \"M\""), std::string::npos);
+  EXPECT_NE(json.find("{\"name\": \"UI\"}"), std::string::npos);
+  EXPECT_NE(json.find("\"name\": \"scan \\\"quoted\\\"\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\": \"two\\nlines\\u0001\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\": \"X\", \"dur\": "), std::string::npos);
+  EXPECT_NE(json.find("\"ph\": \"C\", \"args\": {\"value\": 12}"), std::string::npos);
+  EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+}
@@ -0,0 +1,293 @@
+// Batch reference-number check (bz_batch)
+//
+// Scans many documents on several threads. Patent XML (ST.36 publications, DocDB) contributes its abstract,
+// description and claims (see PatentXmlReader.h); other files are read like File -> Open (text, .docx).
+// Prints one tab-separated line per file, in argument order, with the error counts and, for XML, the errors per
+// section ("description=3 claims=1"; "-" for files without sections, so every line has all ten columns). Files
+// that cannot be scanned get "<file>\terror\t<message>". Directories are searched recursively for .xml, .txt and
+// .docx files.
+//
+// Usage: bz_batch [options] <file-or-directory>...
+//   --lang auto|de|en     Language; auto uses the XML lang attribute, German otherwise (default auto)
+//   --threads N           Worker threads (default: number of cores)
+//   --report FORMAT       Also write a json, csv or sarif report per file (ReportExporter)
+//   --report-dir DIR      Where reports go (default .); named after the input path, '/' replaced by '_'
+//   --cache-dir DIR       Reuse the results of documents analyzed before (ResultCache); repeated and identical
+//                         documents skip the scan
+//   --cache-size MB       Size limit of the cache directory, least recently used entries go first (default 256)
+//
+// Exit status 0 if every file was scanned, 1 if any could not be read or is in a language other than de/en.
+
+#include "DocumentLoader.h"
+#include "MappedFile.h"
+#include "PatentXmlReader.h"
+#include "ReportExporter.h"
+#include "ResultCache.h"
+#include "ScanPipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: bz_batch [--lang auto|de|en] [--threads N] [--report json|csv|sarif] [--report-dir DIR]\n"
+                 "                [--cache-dir DIR] [--cache-size MB] <file-or-directory>...\n"
+                 "Output: one tab-separated line per file; the sections column is \"-\" for files without\n"
+                 "sections (not patent XML), failed files read <file>, \"error\", <message>.\n";
+}
+
+struct ReportOptions {
+    std::optional<ReportExporter::Format> format;
+    std::filesystem::path directory = ".";
+};
+
+// "docs/a/b.xml" -> "docs_a_b.xml.json": unique per input, flat in the report directory
+std::filesystem::path reportPathFor(const ReportOptions& options, const std::string& input) {
+    std::string name = input;
+    std::replace_if(name.begin(), name.end(), [](char c) { return c == '/' || c == '\\' || c == ':'; }, '_');
+    return options.directory / (name + ReportExporter::extension(*options.format));
+}
+
+std::vector<std::string> collectFiles(const std::vector<std::string>& arguments) {
+    std::vector<std::string> files;
+    for (const std::string& argument : arguments) {
+        if (!std::filesystem::is_directory(argument)) {
+            files.push_back(argument);
+            continue;
+        }
+        std::vector<std::string> found;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(argument)) {
+            const std::string extension = entry.path().extension().string();
+            if (entry.is_regular_file() && (extension == ".xml" || extension == ".txt" || extension == ".docx")) {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+// One per thread: pipelines compile their regexes once, the text buffer keeps its capacity
+class Worker {
+public:
+    Worker(const std::string& forcedLanguage, const ReportOptions& report, ResultCache* cache,
+           std::atomic<size_t>& cacheHits)
+        : m_forcedLanguage(forcedLanguage), m_report(report), m_cache(cache), m_cacheHits(cacheHits) {}
+
+    std::string scan(const std::string& path) {
+        MappedFile file(path);
+        PatentXmlReader::Document document;
+        bool xml = PatentXmlReader::looksLikeXml(file.data(), file.size());
+        if (xml) {
+            document = PatentXmlReader::read(file.data(), file.size(), m_text, m_forcedLanguage);
+            m_paragraphStarts.clear();
+        } else {
+            m_text.clear();
+            m_paragraphStarts =
+                DocumentLoader::load(file, [this](std::wstring&& chunk, size_t, size_t) { m_text += chunk; })
+                    .paragraphStarts;
+        }
+
+        const std::string language =
+            !m_forcedLanguage.empty() ? m_forcedLanguage : document.language.empty() ? "de" : document.language;
+        if (language != "de" && language != "en") {
+            throw std::runtime_error("unsupported language " + language);
+        }
+        ScanPipeline& pipeline = this->pipeline(language == "de");
+        if (m_cache && m_cache->lookup(pipeline, m_text, m_paragraphStarts)) {
+            ++m_cacheHits;
+        } else {
+            pipeline.run(m_text, m_paragraphStarts);
+            if (m_cache) {
+                try {
+                    m_cache->store(pipeline, m_text, m_paragraphStarts);
+                } catch (const std::exception&) {
+                    // Only a lost speed-up; the results are complete
+                }
+            }
+        }
+
+        if (m_report.format) {
+            const std::filesystem::path reportPath = reportPathFor(m_report, path);
+            if (!ReportExporter::writeFile(reportPath.string(), *m_report.format,
+                                           ReportExporter::fromPipeline(pipeline, m_text, path, language))) {
+                throw std::runtime_error("cannot write " + reportPath.string());
+            }
+        }
+
+        std::string line = path + "\t" + language + "\t" + std::to_string(m_text.size()) + "\t" +
+                           std::to_string(pipeline.context().db.bzToStems.size()) + "\t" +
+                           std::to_string(pipeline.conflictingBz().size()) + "\t" +
+                           std::to_string(pipeline.noNumberErrors().size()) + "\t" +
+                           std::to_string(pipeline.wrongTermBzErrors().size()) + "\t" +
+                           std::to_string(pipeline.wrongArticleErrors().size()) + "\t" +
+                           std::to_string(pipeline.allErrors().size()) + "\t";
+
+        // Errors per section, e.g. "description=3 claims=1"
+        std::vector<size_t> perSection(document.sections.size(), 0);
+        for (const auto& [start, end] : pipeline.allErrors()) {
+            if (const PatentXmlReader::Section* section = document.sectionAt(static_cast<size_t>(start))) {
+                ++perSection[section - document.sections.data()];
+            }
+        }
+        for (size_t i = 0; i < document.sections.size(); ++i) {
+            line += (i > 0 ? " " : "") + std::string(PatentXmlReader::name(document.sections[i].kind)) + "=" +
+                    std::to_string(perSection[i]);
+        }
+        if (document.sections.empty()) {
+            line += "-";
+        }
+        return line;
+    }
+
+private:
+    ScanPipeline& pipeline(bool german) {
+        std::unique_ptr<ScanPipeline>& pipeline = german ? m_german : m_english;
+        if (!pipeline) {
+            pipeline = std::make_unique<ScanPipeline>(german);
+        }
+        return *pipeline;
+    }
+
+    std::string m_forcedLanguage;
+    const ReportOptions& m_report;
+    ResultCache* m_cache;
+    std::atomic<size_t>& m_cacheHits;
+    std::wstring m_text;
+    std::vector<uint32_t> m_paragraphStarts;  // Word documents only
+    std::unique_ptr<ScanPipeline> m_german;
+    std::unique_ptr<ScanPipeline> m_english;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string language;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> arguments;
+    ReportOptions report;
+    std::string cacheDirectory;
+    uint64_t cacheBytes = ResultCache::DEFAULT_MAX_BYTES;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--lang") {
+                language = next();
+                if (language != "auto" && language != "de" && language != "en") {
+                    throw std::invalid_argument("unknown language " + language);
+                }
+                if (language == "auto") {
+                    language.clear();
+                }
+            } else if (arg == "--report") {
+                const std::string name = next();
+                ReportExporter::Format format;
+                if (!ReportExporter::parseFormat(name, format)) {
+                    throw std::invalid_argument("unknown report format " + name);
+                }
+                report.format = format;
+            } else if (arg == "--report-dir") {
+                report.directory = next();
+            } else if (arg == "--cache-dir") {
+                cacheDirectory = next();
+            } else if (arg == "--cache-size") {
+                cacheBytes = std::stoull(next()) << 20;
+            } else if (arg == "--threads") {
+                threads = std::max<size_t>(1, std::stoull(next()));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                arguments.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_batch: " << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+
+    if (arguments.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    if (report.format) {
+        std::error_code error;
+        std::filesystem::create_directories(report.directory, error);
+        if (error) {
+            std::cerr << "bz_batch: cannot create " << report.directory.string() << ": " << error.message() << "\n";
+            return 2;
+        }
+    }
+
+    std::unique_ptr<ResultCache> cache;
+    if (!cacheDirectory.empty()) {
+        try {
+            cache = std::make_unique<ResultCache>(cacheDirectory, cacheBytes);
+        } catch (const std::exception& e) {
+            std::cerr << "bz_batch: " << e.what() << "\n";
+            return 2;
+        }
+    }
+
+    const std::vector<std::string> files = collectFiles(arguments);
+    std::vector<std::string> lines(files.size());
+    std::atomic<size_t> nextFile{0};
+    std::atomic<size_t> failures{0};
+    std::atomic<size_t> cacheHits{0};
+    const auto started = std::chrono::steady_clock::now();
+
+    std::vector<std::jthread> pool;
+    for (size_t t = 0; t < std::min(threads, files.size()); ++t) {
+        pool.emplace_back([&] {
+            Worker worker(language, report, cache.get(), cacheHits);
+            for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+                try {
+                    lines[i] = worker.scan(files[i]);
+                } catch (const std::exception& e) {
+                    lines[i] = files[i] + "\terror\t" + e.what();
+                    ++failures;
+                }
+            }
+        });
+    }
+    pool.clear();  // Joins
+
+    std::cout << "file\tlang\tcharacters\treference_numbers\tconflicting\tmissing\twrong_term\twrong_article"
+                 "\tall_errors\tsections\n";
+    for (const std::string& line : lines) {
+        std::cout << line << "\n";
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cerr << "bz_batch: " << files.size() << " files in " << seconds << " s ("
+              << (seconds > 0 ? static_cast<size_t>(files.size() * 60 / seconds) : 0) << " files/min, "
+              << failures.load() << " failed)\n";
+    if (cache) {
+        std::cerr << "bz_batch: " << cacheHits.load() << " results from the cache, " << cache->entryCount()
+                  << " entries, " << (cache->sizeBytes() >> 20) << " MB\n";
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,309 @@
+// Headless reference-number check (bz_cli)
+//
+// Scans a text file (UTF-8, UTF-16 or Latin-1, or .docx, as File -> Open) the same way the GUI does and prints the
+// reference numbers with their terms plus the error counts. Patent XML is reduced to abstract, description and
+// claims first (PatentXmlReader).
+//
+// Usage: bz_cli [options] <text-file>
+//   --lang de|en          Language (default de)
+//   --repeat N            Scan N times, e.g. to warm the stem cache (default 1)
+//   --stats               Print the metrics registry after the report
+//   --metrics-file PATH   Also write the metrics as a text exposition file
+//   --memory-report       Print the estimated memory per structure
+//   --quiet               Omit the per-number and conflict listing
+//   --report FORMAT       Print a json, csv or sarif report instead of the listing and counts
+//   --report-file PATH    Write the report to PATH; the format defaults to the extension
+//   --max-errors N        Exit with status 3 if there are more than N errors (for CI gates)
+//   --session PATH        Reuse the results saved in PATH if it matches the text (and keep its cleared
+//                         errors otherwise); the scan results are saved back to PATH
+//   --cache-dir DIR       Take the results from the result cache in DIR if this text was analyzed before with
+//                         the same settings, else scan and add them (ResultCache, default limit 256 MB)
+//   --ignore-words PATH   Never treat the words in PATH (UTF-8, one per line) as terms, like the built-in
+//                         "Figur"/"figure"; replaces the list a --session recorded, and is part of the
+//                         --cache-dir key
+
+#include "ScanPipeline.h"
+#include "DocumentLoader.h"
+#include "MappedFile.h"
+#include "PatentXmlReader.h"
+#include "RE2RegexHelper.h"
+#include "Metrics.h"
+#include "ReportExporter.h"
+#include "ResultCache.h"
+#include "SessionFile.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: bz_cli [--lang de|en] [--repeat N] [--stats] [--metrics-file PATH]\n"
+                 "              [--memory-report] [--quiet] [--report json|csv|sarif] [--report-file PATH]\n"
+                 "              [--max-errors N] [--session PATH] [--cache-dir DIR]\n"
+                 "              [--ignore-words PATH] <text-file>\n";
+}
+
+// Terms sorted for stable output
+std::string joinTerms(const std::pmr::unordered_set<std::wstring>& words) {
+    std::string joined;
+    for (const auto& word : std::set<std::wstring>(words.begin(), words.end())) {
+        if (!joined.empty()) {
+            joined += "; ";
+        }
+        joined += RE2RegexHelper::wstringToUtf8(word);
+    }
+    return joined;
+}
+
+// One word per line; blank lines are skipped
+std::vector<std::wstring> readWordList(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("cannot read " + path);
+    }
+    std::vector<std::wstring> words;
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        const size_t end = line.find_last_not_of(" \t\r");
+        words.push_back(RE2RegexHelper::utf8ToWstring(line.substr(begin, end - begin + 1)));
+    }
+    return words;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool useGerman = true;
+    size_t repeat = 1;
+    bool printStats = false;
+    bool quiet = false;
+    bool memoryReport = false;
+    std::string metricsPath;
+    std::string textPath;
+    std::optional<ReportExporter::Format> reportFormat;
+    std::string reportPath;
+    std::optional<size_t> maxErrors;
+    std::string sessionPath;
+    std::string cacheDirectory;
+    std::string ignoreWordsPath;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--lang") {
+                const std::string lang = next();
+                if (lang != "de" && lang != "en") {
+                    throw std::invalid_argument("unknown language " + lang);
+                }
+                useGerman = lang == "de";
+            } else if (arg == "--repeat") {
+                repeat = std::stoull(next());
+            } else if (arg == "--stats") {
+                printStats = true;
+            } else if (arg == "--metrics-file") {
+                metricsPath = next();
+            } else if (arg == "--memory-report") {
+                memoryReport = true;
+            } else if (arg == "--quiet") {
+                quiet = true;
+            } else if (arg == "--report") {
+                const std::string name = next();
+                ReportExporter::Format format;
+                if (!ReportExporter::parseFormat(name, format)) {
+                    throw std::invalid_argument("unknown report format " + name);
+                }
+                reportFormat = format;
+            } else if (arg == "--report-file") {
+                reportPath = next();
+            } else if (arg == "--max-errors") {
+                maxErrors = std::stoull(next());
+            } else if (arg == "--session") {
+                sessionPath = next();
+            } else if (arg == "--cache-dir") {
+                cacheDirectory = next();
+            } else if (arg == "--ignore-words") {
+                ignoreWordsPath = next();
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("unknown option " + arg);
+            } else if (textPath.empty()) {
+                textPath = arg;
+            } else {
+                throw std::invalid_argument("unexpected argument " + arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_cli: " << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+
+    if (textPath.empty()) {
+        printUsage();
+        return 2;
+    }
+    // With a report file the format may come from its extension
+    const bool reportToFile = !reportPath.empty();
+    if (reportToFile && !reportFormat) {
+        const std::string extension = std::filesystem::path(reportPath).extension().string();
+        ReportExporter::Format format;
+        if (extension.empty() || !ReportExporter::parseFormat(extension.substr(1), format)) {
+            std::cerr << "bz_cli: cannot tell the report format of " << reportPath << ", use --report\n";
+            return 2;
+        }
+        reportFormat = format;
+    }
+
+    std::wstring text;
+    std::vector<uint32_t> paragraphStarts;  // Word documents only
+    try {
+        MappedFile file(textPath);
+        if (PatentXmlReader::looksLikeXml(file.data(), file.size())) {
+            PatentXmlReader::read(file.data(), file.size(), text, useGerman ? "de" : "en");
+        } else {
+            paragraphStarts =
+                DocumentLoader::load(file, [&](std::wstring&& chunk, size_t, size_t) { text += chunk; })
+                    .paragraphStarts;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_cli: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::optional<std::unordered_set<std::wstring>> ignoredWords;
+    if (!ignoreWordsPath.empty()) {
+        try {
+            const std::vector<std::wstring> words = readWordList(ignoreWordsPath);
+            ignoredWords.emplace(words.begin(), words.end());
+        } catch (const std::exception& e) {
+            std::cerr << "bz_cli: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    ScanPipeline pipeline(useGerman);
+    bool restored = false;
+    std::error_code missing;
+    if (!sessionPath.empty() && std::filesystem::exists(sessionPath, missing)) {
+        try {
+            const SessionFile session(sessionPath);
+            restored = pipeline.restore(session, text);
+            if (!restored) {
+                session.restoreDecisions(pipeline.context());
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "bz_cli: ignoring " << e.what() << "\n";
+        }
+    }
+    // Results restored with other ignored words are scanned again
+    if (ignoredWords) {
+        restored = restored && pipeline.context().ignoredWords == *ignoredWords;
+        pipeline.context().ignoredWords = std::move(*ignoredWords);
+    }
+    std::unique_ptr<ResultCache> cache;
+    bool cached = false;
+    if (!cacheDirectory.empty() && !restored) {
+        try {
+            cache = std::make_unique<ResultCache>(cacheDirectory);
+            cached = cache->lookup(pipeline, text, paragraphStarts);
+        } catch (const std::exception& e) {
+            std::cerr << "bz_cli: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < repeat && !restored && !cached; ++i) {
+        pipeline.run(text, paragraphStarts);
+    }
+    if (cache && !cached) {
+        try {
+            cache->store(pipeline, text, paragraphStarts);
+        } catch (const std::exception& e) {
+            std::cerr << "bz_cli: " << e.what() << "\n";
+        }
+    }
+    if (!sessionPath.empty() && !restored) {
+        try {
+            pipeline.save(sessionPath, text);
+        } catch (const std::exception& e) {
+            std::cerr << "bz_cli: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    const ReportExporter::Report report =
+        ReportExporter::fromPipeline(pipeline, text, textPath, useGerman ? "de" : "en");
+    const bool exceeded = maxErrors && pipeline.allErrors().size() > *maxErrors;
+    if (reportToFile && !ReportExporter::writeFile(reportPath, *reportFormat, report)) {
+        std::cerr << "bz_cli: cannot write " << reportPath << "\n";
+        return 1;
+    }
+    if (reportFormat && !reportToFile) {
+        ReportExporter::write(std::cout, *reportFormat, report);
+        return exceeded ? 3 : 0;
+    }
+
+    const ReferenceDatabase& db = pipeline.context().db;
+    if (!quiet) {
+        for (const auto& [bz, stems] : db.bzToStems) {
+            auto words = db.bzToOriginalWords.find(bz);
+            std::cout << RE2RegexHelper::wstringToUtf8(bz) << "\t"
+                      << (words != db.bzToOriginalWords.end() ? joinTerms(words->second) : "") << "\n";
+        }
+        std::cout << "\n";
+        // Terms and numbers tangled together, one line per connected group
+        const ConflictGraph& conflicts = pipeline.context().conflicts;
+        for (size_t i = 0; i < conflicts.size(); ++i) {
+            std::cout << "Conflict: " << RE2RegexHelper::wstringToUtf8(conflicts.describe(i, db.occurrences, text))
+                      << "\n";
+        }
+        if (!conflicts.empty()) {
+            std::cout << "\n";
+        }
+    }
+
+    std::cout << "Reference numbers:      " << db.bzToStems.size() << "\n"
+              << "Conflicting numbers:    " << pipeline.conflictingBz().size() << "\n"
+              << "Missing numbers:        " << pipeline.noNumberErrors().size() << "\n"
+              << "Wrong term/number:      " << pipeline.wrongTermBzErrors().size() << "\n"
+              << "Wrong articles:         " << pipeline.wrongArticleErrors().size() << "\n"
+              << "All errors:             " << pipeline.allErrors().size() << "\n";
+
+    if (memoryReport) {
+        MemoryReport report;
+        pipeline.reportMemory(report, text);
+        std::cout << "\n";
+        report.write(std::cout);
+    }
+
+    if (printStats) {
+        std::cout << "\n";
+        Metrics::writeText(std::cout);
+    }
+
+    if (!metricsPath.empty() && !Metrics::writeTextFile(metricsPath)) {
+        std::cerr << "bz_cli: cannot write " << metricsPath << "\n";
+        return 1;
+    }
+    return exceeded ? 3 : 0;
+}
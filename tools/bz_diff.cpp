@@ -0,0 +1,99 @@
+// Differential oracle (bz_diff)
+//
+// Scans a synthetic corpus and random mutations of it with the frozen
+// ReferenceScanner and with ScanPipeline and reports the first input on which
+// their results differ, shrunk to a minimal diverging text and the decisions
+// it still needs (see DifferentialHarness.h).
+//
+// Usage: bz_diff [options]
+//   --lang de|en          Language (default de)
+//   --chars N             Corpus size in characters (default 20000)
+//   --mutations N         Mutated inputs after the corpus (default 500)
+//   --edits N             Maximum edits per mutation (default 4)
+//   --seed N              Corpus and mutation seed (default 1)
+//   --no-minimize         Report the diverging input as found
+//
+// Exit status 0 if the engines agreed on every input, 1 on divergence.
+
+#include "DifferentialHarness.h"
+#include "RE2RegexHelper.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: bz_diff [--lang de|en] [--chars N] [--mutations N] [--edits N] [--seed N]\n"
+                 "               [--no-minimize]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    DifferentialHarness::Options options;
+    options.corpus.targetChars = 20000;
+    options.corpus.missingNumberPercent = 5;
+    options.corpus.conflictPercent = 5;
+    options.corpus.wrongArticlePercent = 5;
+    options.mutations = 500;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--lang") {
+                const std::string lang = next();
+                if (lang != "de" && lang != "en") {
+                    throw std::invalid_argument("unknown language " + lang);
+                }
+                options.corpus.language =
+                    lang == "de" ? CorpusGenerator::Language::GERMAN : CorpusGenerator::Language::ENGLISH;
+            } else if (arg == "--chars") {
+                options.corpus.targetChars = std::stoull(next());
+            } else if (arg == "--mutations") {
+                options.mutations = std::stoull(next());
+            } else if (arg == "--edits") {
+                options.maxEditsPerMutation = std::stoull(next());
+            } else if (arg == "--seed") {
+                options.seed = static_cast<uint32_t>(std::stoul(next()));
+                options.corpus.seed = options.seed;
+            } else if (arg == "--no-minimize") {
+                options.minimize = false;
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_diff: " << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+
+    const bool useGerman = options.corpus.language == CorpusGenerator::Language::GERMAN;
+    const auto divergence =
+        DifferentialHarness::run(options, DifferentialHarness::referenceEngine(useGerman),
+                                 DifferentialHarness::pipelineEngine(useGerman), &std::cerr);
+    if (!divergence) {
+        std::cout << "Engines agree on " << options.mutations + 1 << " inputs\n";
+        return 0;
+    }
+
+    std::cout << "Divergence at input " << divergence->iteration
+              << (divergence->iteration == 0 ? " (unmodified corpus)" : "") << "\n"
+              << divergence->description << "\n"
+              << "Input: " << divergence->input.text.size() << " characters, minimized to "
+              << divergence->minimized.text.size() << ":\n"
+              << RE2RegexHelper::wstringToUtf8(divergence->minimized.text) << "\n"
+              << divergence->minimized.decisions.describe();
+    return 1;
+}
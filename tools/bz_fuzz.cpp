@@ -0,0 +1,61 @@
+// Differential fuzz target (bz_fuzz)
+//
+// libFuzzer entry point: decodes each input as UTF-8 and aborts when the
+// ReferenceScanner and ScanPipeline disagree on it, after printing the first
+// difference. The first byte selects the language (lowest bit) and seeds
+// random decisions for the text (DifferentialHarness::decide).
+//
+// Build with clang and -DBUILD_FUZZER=ON, then for example:
+//   bz_fuzz -max_len=4096 corpus_dir/
+//
+// Built with -DBZ_FUZZ_STANDALONE (any compiler) it instead replays the given
+// input files once, to reproduce a crash without libFuzzer.
+
+#include "DifferentialHarness.h"
+#include "RE2RegexHelper.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    // Engines are reused across inputs, as the GUI reuses its pipeline across scans
+    static const DifferentialHarness::Engine german[] = {DifferentialHarness::referenceEngine(true),
+                                                         DifferentialHarness::pipelineEngine(true)};
+    static const DifferentialHarness::Engine english[] = {DifferentialHarness::referenceEngine(false),
+                                                          DifferentialHarness::pipelineEngine(false)};
+
+    const bool useGerman = size == 0 || (data[0] & 1) == 0;
+    const auto& engines = useGerman ? german : english;
+    DifferentialHarness::Input input(DifferentialHarness::decodeFuzzInput(data, size));
+    std::mt19937 rng(size == 0 ? 0 : data[0] >> 1);
+    DifferentialHarness::decide(input, engines[0](input), rng);
+
+    if (auto difference = DifferentialHarness::compare(input, engines[0], engines[1])) {
+        std::cerr << "bz_fuzz: engines diverge (" << (useGerman ? "de" : "en") << "): " << *difference
+                  << "\nInput: " << RE2RegexHelper::wstringToUtf8(input.text) << "\n"
+                  << input.decisions.describe();
+        std::abort();
+    }
+    return 0;
+}
+
+#ifdef BZ_FUZZ_STANDALONE
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::cerr << "bz_fuzz: cannot read " << argv[i] << "\n";
+            return 1;
+        }
+        const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,132 @@
+// Edit-to-highlight latency harness (bz_replay)
+//
+// Replays a recorded edit session through the GUI's scan scheduling and
+// reports edit-to-highlight latency and UI-thread stalls (see LatencyReplay.h).
+//
+// Usage: bz_replay [options] <session-file>
+//   --lang de|en            Language (default de)
+//   --debounce MS           Debounce delay (default 500, as in MainWindow)
+//   --style-cost-us N       Modelled SetStyle cost per highlighted error (default 0)
+//
+//        bz_replay --synthesize [--bursts N] [--seed N] <text-file> <session-out>
+//   Writes a synthetic typing session on top of a UTF-8 document.
+//
+// Sessions are recorded from the GUI with BZ_RECORD_SESSION=<file>.
+
+#include "LatencyReplay.h"
+#include "RE2RegexHelper.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: bz_replay [--lang de|en] [--debounce MS] [--style-cost-us N] <session-file>\n"
+                 "       bz_replay --synthesize [--bursts N] [--seed N] <text-file> <session-out>\n";
+}
+
+void printDistribution(const char* label, const std::vector<double>& values) {
+    using Report = LatencyReplay::Report;
+    std::printf("%-22s p50 %8.1f  p95 %8.1f  p99 %8.1f  max %8.1f ms  (n=%zu)\n", label,
+                Report::percentile(values, 0.50), Report::percentile(values, 0.95),
+                Report::percentile(values, 0.99), Report::percentile(values, 1.0), values.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LatencyReplay::Options options;
+    EditSession::SynthesisOptions synthesis;
+    bool synthesize = false;
+    std::vector<std::string> paths;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--lang") {
+                const std::string lang = next();
+                if (lang != "de" && lang != "en") {
+                    throw std::invalid_argument("unknown language " + lang);
+                }
+                options.useGerman = lang == "de";
+            } else if (arg == "--debounce") {
+                options.debounceMs = std::stod(next());
+            } else if (arg == "--style-cost-us") {
+                options.styleCostPerErrorUs = std::stod(next());
+            } else if (arg == "--synthesize") {
+                synthesize = true;
+            } else if (arg == "--bursts") {
+                synthesis.bursts = std::stoull(next());
+            } else if (arg == "--seed") {
+                synthesis.seed = static_cast<uint32_t>(std::stoul(next()));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                paths.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_replay: " << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+
+    if (paths.size() != (synthesize ? 2u : 1u)) {
+        printUsage();
+        return 2;
+    }
+
+    std::ifstream in(paths[0], std::ios::binary);
+    if (!in) {
+        std::cerr << "bz_replay: cannot read " << paths[0] << "\n";
+        return 1;
+    }
+
+    if (synthesize) {
+        std::ostringstream raw;
+        raw << in.rdbuf();
+        EditSession session = EditSession::synthesize(RE2RegexHelper::utf8ToWstring(raw.str()), synthesis);
+        std::ofstream out(paths[1], std::ios::binary);
+        session.save(out);
+        if (!out) {
+            std::cerr << "bz_replay: cannot write " << paths[1] << "\n";
+            return 1;
+        }
+        std::cout << "Wrote " << session.edits.size() << " edits to " << paths[1] << "\n";
+        return 0;
+    }
+
+    EditSession session;
+    try {
+        session = EditSession::load(in);
+    } catch (const std::exception& e) {
+        std::cerr << "bz_replay: " << paths[0] << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    const LatencyReplay::Report report = LatencyReplay::replay(session, options);
+
+    std::printf("Edits: %zu  scans: %zu (%zu cancelled early)  UI updates: %zu  session: %.1f s\n",
+                session.edits.size(), report.scansStarted, report.scansCancelled, report.uiUpdates,
+                report.sessionMs / 1000.0);
+    printDistribution("Edit-to-highlight", report.editLatencyMs);
+    printDistribution("UI stall", report.uiStallMs);
+    printDistribution("Input delay", report.inputDelayMs);
+    std::printf("%-22s %.1f ms\n", "UI stall total", LatencyReplay::Report::total(report.uiStallMs));
+    return 0;
+}
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Generate include/CharClassTables.h, the two-level character class lookup
+used by CharClass.h.
+
+The classes mirror what the RE2 patterns in RegexPatterns.h match:
+  LETTER  \\p{L}  (general categories Lu, Ll, Lt, Lm, Lo)
+  DIGIT   \\d     (ASCII 0-9 only, as in RE2)
+  SPACE   \\s     (tab, LF, FF, CR and space, as in RE2)
+
+Usage: python3 tools/gen_char_class_tables.py > include/CharClassTables.h
+"""
+import sys
+import unicodedata
+
+LETTER, DIGIT, SPACE = 1, 2, 4
+BLOCK_SHIFT = 7
+BLOCK_SIZE = 1 << BLOCK_SHIFT
+RE2_SPACE = {0x09, 0x0A, 0x0C, 0x0D, 0x20}
+
+
+def flags_of(cp):
+    f = 0
+    if unicodedata.category(chr(cp)).startswith("L"):
+        f |= LETTER
+    if 0x30 <= cp <= 0x39:
+        f |= DIGIT
+    if cp in RE2_SPACE:
+        f |= SPACE
+    return f
+
+
+def main():
+    flags = [flags_of(cp) for cp in range(0x110000)]
+    last = max(cp for cp, f in enumerate(flags) if f)
+    limit = (last // BLOCK_SIZE + 1) * BLOCK_SIZE
+
+    blocks, stage1 = {}, []
+    for start in range(0, limit, BLOCK_SIZE):
+        block = tuple(flags[start:start + BLOCK_SIZE])
+        stage1.append(blocks.setdefault(block, len(blocks)))
+    if len(blocks) > 256:
+        sys.exit("too many distinct blocks for a uint8_t stage-1 index")
+    stage2 = [f for block, _ in sorted(blocks.items(), key=lambda kv: kv[1]) for f in block]
+
+    def rows(values, per_line):
+        for i in range(0, len(values), per_line):
+            yield "    " + ", ".join(str(v) for v in values[i:i + per_line]) + ","
+
+    out = sys.stdout
+    out.write("// Generated by tools/gen_char_class_tables.py from Unicode "
+              f"{unicodedata.unidata_version}. Do not edit by hand.\n")
+    out.write("#pragma once\n#include <cstdint>\n\n")
+    out.write("namespace CharClass::detail {\n")
+    out.write(f"    constexpr uint32_t BLOCK_SHIFT = {BLOCK_SHIFT};\n")
+    out.write(f"    constexpr uint32_t TABLE_LIMIT = 0x{limit:X};\n\n")
+    out.write(f"    // Block index per {BLOCK_SIZE} code points ({len(stage1)} entries)\n")
+    out.write("    inline constexpr uint8_t STAGE1[] = {\n")
+    out.write("\n".join("    " + r for r in rows(stage1, 24)) + "\n    };\n\n")
+    out.write(f"    // {len(blocks)} distinct blocks of class flags\n")
+    out.write("    inline constexpr uint8_t STAGE2[] = {\n")
+    out.write("\n".join("    " + r for r in rows(stage2, 32)) + "\n    };\n")
+    out.write("}\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+// Synthetic patent-text corpus generator (bz_corpus_gen)
+//
+// Writes a German or English patent-style description and a JSON ground-truth
+// file with the expected reference database and every planted error.
+//
+// Usage: bz_corpus_gen [options] <text-out> [<truth-out>]
+//   --lang de|en          Language (default de)
+//   --size N[K|M]         Target size in characters (default 100K)
+//   --vocab N             Distinct numbered terms (default 30)
+//   --density P           Percent of sentences with references (default 70)
+//   --ordinals N          "erste/zweite X" pairs (default 2)
+//   --multiword N         "oberes/unteres X" pairs (default 1)
+//   --no-umlauts          Transliterate ä/ö/ü/ß
+//   --missing P           Percent of mentions without number
+//   --conflict P          Percent of mentions with another term's number
+//   --article P           Percent of mentions with the wrong article
+//   --seed N              Random seed (default 42)
+
+#include "CorpusGenerator.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: bz_corpus_gen [--lang de|en] [--size N[K|M]] [--vocab N] [--density P]\n"
+                 "                     [--ordinals N] [--multiword N] [--no-umlauts]\n"
+                 "                     [--missing P] [--conflict P] [--article P] [--seed N]\n"
+                 "                     <text-out> [<truth-out>]\n";
+}
+
+size_t parseSize(const std::string& value) {
+    size_t multiplier = 1;
+    std::string digits = value;
+    if (!digits.empty() && (digits.back() == 'K' || digits.back() == 'k')) {
+        multiplier = 1000;
+        digits.pop_back();
+    } else if (!digits.empty() && (digits.back() == 'M' || digits.back() == 'm')) {
+        multiplier = 1000 * 1000;
+        digits.pop_back();
+    }
+    return std::stoull(digits) * multiplier;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CorpusGenerator::Options options;
+    std::string textPath;
+    std::string truthPath;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--lang") {
+                const std::string lang = next();
+                if (lang != "de" && lang != "en") {
+                    throw std::invalid_argument("unknown language " + lang);
+                }
+                options.language = lang == "de" ? CorpusGenerator::Language::GERMAN
+                                                : CorpusGenerator::Language::ENGLISH;
+            } else if (arg == "--size") {
+                options.targetChars = parseSize(next());
+            } else if (arg == "--vocab") {
+                options.vocabularySize = std::stoull(next());
+            } else if (arg == "--density") {
+                options.referenceDensity = std::stoi(next());
+            } else if (arg == "--ordinals") {
+                options.ordinalPairs = std::stoull(next());
+            } else if (arg == "--multiword") {
+                options.multiWordPairs = std::stoull(next());
+            } else if (arg == "--no-umlauts") {
+                options.umlauts = false;
+            } else if (arg == "--missing") {
+                options.missingNumberPercent = std::stoi(next());
+            } else if (arg == "--conflict") {
+                options.conflictPercent = std::stoi(next());
+            } else if (arg == "--article") {
+                options.wrongArticlePercent = std::stoi(next());
+            } else if (arg == "--seed") {
+                options.seed = static_cast<uint32_t>(std::stoul(next()));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return EXIT_SUCCESS;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("unknown option " + arg);
+            } else if (textPath.empty()) {
+                textPath = arg;
+            } else if (truthPath.empty()) {
+                truthPath = arg;
+            } else {
+                throw std::invalid_argument("too many arguments");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bz_corpus_gen: " << e.what() << "\n";
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (textPath.empty()) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (truthPath.empty()) {
+        truthPath = textPath + ".truth.json";
+    }
+
+    const CorpusGenerator::Corpus corpus = CorpusGenerator::generate(options);
+
+    std::ofstream textOut(textPath, std::ios::binary);
+    std::ofstream truthOut(truthPath, std::ios::binary);
+    if (!textOut || !truthOut) {
+        std::cerr << "bz_corpus_gen: cannot open output files\n";
+        return EXIT_FAILURE;
+    }
+    CorpusGenerator::writeText(textOut, corpus.text);
+    CorpusGenerator::writeGroundTruth(truthOut, options, corpus.truth);
+
+    const auto& truth = corpus.truth;
+    std::cout << "Wrote " << corpus.text.size() << " characters to " << textPath << "\n"
+              << "  terms:           " << truth.bzToOriginalWords.size() << "\n"
+              << "  missing numbers: " << truth.count(CorpusGenerator::ErrorKind::MISSING_NUMBER) << "\n"
+              << "  wrong articles:  " << truth.count(CorpusGenerator::ErrorKind::WRONG_ARTICLE) << "\n"
+              << "  conflicts:       " << truth.count(CorpusGenerator::ErrorKind::CONFLICT) << "\n"
+              << "Ground truth in " << truthPath << "\n";
+    return EXIT_SUCCESS;
+}